@@ -25,6 +25,14 @@ int main()
         std::chrono::duration<double> elapsed_s_fplus = endTimeFPlus - startTimeFPlus;
         std::cout << "(check: " << result_fplus << "), elapsed time fplus:    " << elapsed_s_fplus.count() << "s\n";
 
+        // FunctionalPlus, fused lazy pipeline
+        Time startTimeFPlusLazy = std::chrono::system_clock::now();
+        const auto result_fplus_lazy = fwd::apply(
+            numbers(0, 15000000), fwd::lazy::transform(times_3), fwd::lazy::drop_if(is_odd_int), fwd::lazy::transform(as_string_length), fwd::lazy::sum());
+        Time endTimeFPlusLazy = std::chrono::system_clock::now();
+        std::chrono::duration<double> elapsed_s_fplus_lazy = endTimeFPlusLazy - startTimeFPlusLazy;
+        std::cout << "(check: " << result_fplus_lazy << "), elapsed time fplus lazy: " << elapsed_s_fplus_lazy.count() << "s\n";
+
         // range-v3
         Time startTimeRangev3 = std::chrono::system_clock::now();
         using namespace ranges;
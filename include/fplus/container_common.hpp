@@ -13,6 +13,7 @@
 
 #include <fplus/internal/container_common.hpp>
 #include <fplus/internal/invoke.hpp>
+#include <fplus/internal/lazy_ranges.hpp>
 #include <fplus/internal/meta.hpp>
 
 #include <algorithm>
@@ -1720,29 +1721,72 @@ Container nub_by(BinaryPredicate p, const Container& xs)
     return result;
 }
 
+namespace internal {
+
+    // Key type of the elements of a container with respect to f.
+    template <typename F, typename Container>
+    using key_of_t = std::decay_t<internal::invoke_result_t<F,
+        const typename Container::value_type&>>;
+
+    template <typename Container, typename F>
+    Container nub_on(std::true_type /* is_hashable */, F f, const Container& xs)
+    {
+        std::unordered_set<key_of_t<F, Container>> seen;
+        Container result;
+        auto itOut = internal::get_back_inserter(result);
+        for (const auto& x : xs) {
+            if (seen.insert(internal::invoke(f, x)).second) {
+                *itOut = x;
+            }
+        }
+        return result;
+    }
+
+    template <typename Container, typename F>
+    Container nub_on(std::false_type /* is_hashable */, F f, const Container& xs)
+    {
+        return nub_by(is_equal_by(f), xs);
+    }
+
+    template <typename Container>
+    Container nub(std::true_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return nub_on(std::true_type(), identity<T>, xs);
+    }
+
+    template <typename Container>
+    Container nub(std::false_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return nub_by(std::equal_to<T>(), xs);
+    }
+}
+
 // API search type: nub_on : ((a -> b), [a]) -> [a]
 // fwd bind count: 1
 // Makes the elements in a container unique
 // with respect to their function value.
 // nub_on((mod 10), [12,32,15]) == [12,15]
-// O(n^2)
+// O(n) if the function values are hashable, O(n^2) otherwise.
 template <typename Container, typename F>
 Container nub_on(F f, const Container& xs)
 {
-    return nub_by(is_equal_by(f), xs);
+    return internal::nub_on(
+        internal::is_hashable<internal::key_of_t<F, Container>>(), f, xs);
 }
 
 // API search type: nub : [a] -> [a]
 // fwd bind count: 0
 // Makes the elements in a container unique.
 // nub([1,2,2,3,2]) == [1,2,3]
-// O(n^2)
+// O(n) if the elements are hashable, O(n^2) otherwise.
 // Also known as distinct.
 template <typename Container>
 Container nub(const Container& xs)
 {
     typedef typename Container::value_type T;
-    return nub_by(std::equal_to<T>(), xs);
+    return internal::nub(internal::is_hashable<T>(), xs);
 }
 
 // API search type: all_unique_by_eq : (((a, a) -> Bool), [a]) -> Bool
@@ -1758,29 +1802,63 @@ bool all_unique_by_eq(BinaryPredicate p, const Container& xs)
     return size_of_cont(nub_by(p, xs)) == size_of_cont(xs);
 }
 
+namespace internal {
+    template <typename Container, typename F>
+    bool all_unique_on(std::true_type /* is_hashable */, F f, const Container& xs)
+    {
+        std::unordered_set<key_of_t<F, Container>> seen;
+        for (const auto& x : xs) {
+            if (!seen.insert(internal::invoke(f, x)).second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Container, typename F>
+    bool all_unique_on(std::false_type /* is_hashable */, F f, const Container& xs)
+    {
+        return all_unique_by_eq(is_equal_by(f), xs);
+    }
+
+    template <typename Container>
+    bool all_unique(std::true_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return all_unique_on(std::true_type(), identity<T>, xs);
+    }
+
+    template <typename Container>
+    bool all_unique(std::false_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return all_unique_by_eq(std::equal_to<T>(), xs);
+    }
+}
+
 // API search type: all_unique_on : ((a -> b), [a]) -> Bool
 // fwd bind count: 1
 // Checks if all elements in a container are unique
 // with respect to their function values.
 // Returns true for empty containers.
-// O(n^2)
+// O(n) if the function values are hashable, O(n^2) otherwise.
 template <typename Container, typename F>
 bool all_unique_on(F f, const Container& xs)
 {
-    return all_unique_by_eq(is_equal_by(f), xs);
+    return internal::all_unique_on(
+        internal::is_hashable<internal::key_of_t<F, Container>>(), f, xs);
 }
 
 // API search type: all_unique : [a] -> Bool
 // fwd bind count: 0
 // Checks if all elements in a container are unique.
 // Returns true for empty containers.
-// O(n^2)
+// O(n) if the elements are hashable, O(n^2) otherwise.
 template <typename Container>
 bool all_unique(const Container& xs)
 {
     typedef typename Container::value_type T;
-    auto comp = std::equal_to<T>();
-    return all_unique_by_eq(comp, xs);
+    return internal::all_unique(internal::is_hashable<T>(), xs);
 }
 
 // API search type: is_strictly_sorted_by : (((a, a) -> Bool), [a]) -> Bool
@@ -1986,6 +2064,33 @@ ContainerOut numbers(const T start, const T end)
     return numbers_step<T, ContainerOut>(start, end, 1);
 }
 
+// API search type: numbers_step_lazy : (a, a, a) -> [a]
+// fwd bind count: 2
+// Same as numbers_step, but the numbers are computed on access
+// instead of being stored, so the memory usage is constant.
+// numbers_step_lazy(2, 9, 2) == [2, 4, 6, 8]
+template <typename T>
+internal::numbers_step_range<T> numbers_step_lazy(
+    const T start, const T end, const T step)
+{
+    return internal::numbers_step_range<T>(start, end, step);
+}
+
+// API search type: numbers_lazy : (a, a) -> [a]
+// fwd bind count: 1
+// Same as numbers, but the numbers are computed on access
+// instead of being stored, so the memory usage is constant.
+// Can be passed to every function only reading its input,
+// e.g. sum(numbers_lazy(0, 15000000)) does not allocate.
+// Functions returning a container of the same type as their input
+// need a real container, e.g. convert_container<std::vector<T>>(...).
+// numbers_lazy(2, 9) == [2, 3, 4, 5, 6, 7, 8]
+template <typename T>
+internal::numbers_step_range<T> numbers_lazy(const T start, const T end)
+{
+    return numbers_step_lazy<T>(start, end, 1);
+}
+
 // API search type: singleton_seq : a -> [a]
 // fwd bind count: 0
 // Construct a sequence containing a single value.
@@ -2055,32 +2160,112 @@ typename Container::value_type last(const Container& xs)
     return xs.back();
 }
 
+// Accumulates the count, mean, variance, minimum and maximum
+// of a stream of values in a single pass and constant memory,
+// using Welford's numerically stable update.
+// Accumulators filled independently, e.g. on different threads,
+// can be combined with merge.
+template <typename Result = double>
+class running_stats {
+public:
+    running_stats()
+        : count_(0)
+        , mean_(0)
+        , m2_(0)
+        , min_(0)
+        , max_(0)
+    {
+    }
+
+    template <typename T>
+    void add(const T& value)
+    {
+        const Result x = static_cast<Result>(value);
+        ++count_;
+        const Result delta = x - mean_;
+        mean_ += delta / static_cast<Result>(count_);
+        m2_ += delta * (x - mean_);
+        if (count_ == 1) {
+            min_ = x;
+            max_ = x;
+        } else {
+            min_ = std::min(min_, x);
+            max_ = std::max(max_, x);
+        }
+    }
+
+    // Combines the statistics of both streams,
+    // see Chan et al., "Updating Formulae and a Pairwise Algorithm
+    // for Computing Sample Variances", 1979.
+    void merge(const running_stats& other)
+    {
+        if (other.count_ == 0) {
+            return;
+        }
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        const Result n_a = static_cast<Result>(count_);
+        const Result n_b = static_cast<Result>(other.count_);
+        const Result n = n_a + n_b;
+        const Result delta = other.mean_ - mean_;
+        mean_ += delta * (n_b / n);
+        m2_ += other.m2_ + delta * delta * (n_a * n_b / n);
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::size_t count() const { return count_; }
+
+    // The following are only meaningful if count() != 0.
+    Result mean() const { return mean_; }
+    Result minimum() const { return min_; }
+    Result maximum() const { return max_; }
+    // population variance
+    Result variance() const { return m2_ / static_cast<Result>(count_); }
+    // sample variance, count() must be at least 2
+    Result sample_variance() const { return m2_ / static_cast<Result>(count_ - 1); }
+    Result stddev() const { return std::sqrt(variance()); }
+    Result sample_stddev() const { return std::sqrt(sample_variance()); }
+
+private:
+    std::size_t count_;
+    Result mean_;
+    Result m2_;
+    Result min_;
+    Result max_;
+};
+
+// API search type: get_running_stats : [a] -> RunningStats a
+// fwd bind count: 0
+// Accumulates count, mean, variance, minimum and maximum
+// of all elements in a single pass.
+// get_running_stats([1, 3, 7, 4]).mean() == 3.75
+template <typename Result = double, typename Container>
+running_stats<Result> get_running_stats(const Container& xs)
+{
+    running_stats<Result> stats;
+    for (const auto& x : xs) {
+        stats.add(x);
+    }
+    return stats;
+}
+
 // API search type: mean_stddev : [a] -> (a, a)
 // fwd bind count: 0
 // Calculates the mean and the population standard deviation.
 // mean_stddev([4, 8]) == (6, 2)
 // mean_stddev([1, 3, 7, 4]) == (3.75, 2.5)
+// Single pass without allocations, also works with lists.
 // xs must be non-empty.
 template <typename Result, typename Container>
 std::pair<Result, Result> mean_stddev(const Container& xs)
 {
-    assert(size_of_cont(xs) != 0);
-
-    // http://stackoverflow.com/a/7616783/1866775
-    Result sum = static_cast<Result>(
-        internal::accumulate(xs.begin(), xs.end(),
-            static_cast<typename Container::value_type>(0)));
-    Result mean = sum / static_cast<Result>(xs.size());
-
-    std::vector<Result> diff(xs.size());
-    std::transform(xs.begin(), xs.end(), diff.begin(),
-        [mean](Result x) {
-            return x - mean;
-        });
-    Result sq_sum = std::inner_product(
-        diff.begin(), diff.end(), diff.begin(), static_cast<Result>(0));
-    Result stddev = std::sqrt(sq_sum / static_cast<Result>(xs.size()));
-    return std::make_pair(mean, stddev);
+    assert(!is_empty(xs));
+    const auto stats = get_running_stats<Result>(xs);
+    return std::make_pair(stats.mean(), stats.stddev());
 }
 
 // API search type: count_occurrences_by : ((a -> b), [a]) -> Map b Int
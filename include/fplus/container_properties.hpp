@@ -21,6 +21,8 @@
 #include <cstdint>
 #include <numeric>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace fplus {
 
@@ -465,9 +467,61 @@ Result mean_using_doubles(const Container& xs)
         return round<double, Result>(result_as_double);
 }
 
+namespace internal {
+
+    // Partially sorts ys[lo, hi) such that every ys[idx]
+    // for idx in [first, last) is the element a full sort would put there.
+    // The indices must be sorted, unique and within [lo, hi).
+    // Every std::nth_element call halves the remaining indices,
+    // so this costs O(n * log(number of indices)).
+    template <typename T>
+    void nth_elements(std::vector<T>& ys, std::size_t lo, std::size_t hi,
+        const std::size_t* first, const std::size_t* last)
+    {
+        while (first != last) {
+            const std::size_t* mid = first + (last - first) / 2;
+            const auto it_begin = std::begin(ys);
+            std::nth_element(
+                add_to_iterator(it_begin, lo),
+                add_to_iterator(it_begin, *mid),
+                add_to_iterator(it_begin, hi));
+            nth_elements(ys, lo, *mid, first, mid);
+            lo = *mid + 1;
+            first = mid + 1;
+        }
+    }
+
+    template <typename T>
+    void nth_elements(std::vector<T>& ys, std::vector<std::size_t> idxs)
+    {
+        std::sort(std::begin(idxs), std::end(idxs));
+        idxs.erase(std::unique(std::begin(idxs), std::end(idxs)), std::end(idxs));
+        nth_elements(ys, 0, ys.size(), idxs.data(), idxs.data() + idxs.size());
+    }
+
+    template <typename Container>
+    std::vector<typename Container::value_type> as_vector(const Container& xs)
+    {
+        return std::vector<typename Container::value_type>(std::begin(xs), std::end(xs));
+    }
+
+    template <typename Result>
+    Result from_double(std::true_type /* is_integral */, double x)
+    {
+        return round<double, Result>(x);
+    }
+
+    template <typename Result>
+    Result from_double(std::false_type /* is_integral */, double x)
+    {
+        return static_cast<Result>(x);
+    }
+}
+
 // API search type: median : [a] -> a
 // fwd bind count: 0
 // median([5, 6, 4, 3, 2, 6, 7, 9, 3]) == 5
+// O(n), using selection instead of sorting.
 // Unsafe! Crashes on an empty sequence.
 template <typename Container,
     typename Result = typename Container::value_type>
@@ -476,25 +530,60 @@ Result median(const Container& xs)
     assert(is_not_empty(xs));
 
     if (size_of_cont(xs) == 1)
-        return static_cast<Result>(xs.front());
-
-    // std::nth_element (instead of sorting)
-    // would be faster for random-access containers
-    // but not work at all on other containers like std::list.
-    auto xsSorted = sort(xs);
-    if (is_odd(size_of_cont(xsSorted))) {
-        auto it = std::begin(xsSorted);
-        internal::advance_iterator(it, size_of_cont(xsSorted) / 2);
-        return static_cast<Result>(*it);
+        return static_cast<Result>(*std::begin(xs));
+
+    auto ys = internal::as_vector(xs);
+    const auto mid = internal::add_to_iterator(std::begin(ys), ys.size() / 2);
+    std::nth_element(std::begin(ys), mid, std::end(ys));
+    if (is_odd(ys.size())) {
+        return static_cast<Result>(*mid);
     } else {
-        auto it1 = std::begin(xsSorted);
-        internal::advance_iterator(it1, size_of_cont(xsSorted) / 2 - 1);
-        auto it2 = it1;
-        ++it2;
-        return static_cast<Result>(*it1 + *it2) / static_cast<Result>(2);
+        const auto lower = std::max_element(std::begin(ys), mid);
+        return static_cast<Result>(*lower + *mid) / static_cast<Result>(2);
     }
 }
 
+// API search type: quantiles : ([Float], [a]) -> [a]
+// fwd bind count: 1
+// Returns the values below which the given fractions of the elements lie.
+// Interpolates linearly between the two closest ranks,
+// rounding the result for integral types.
+// Fractions outside of [0, 1] are clamped.
+// quantiles([0, 0.5, 0.9, 1], [1.0, 3.0, 2.0, 4.0, 5.0]) == [1.0, 3.0, 4.6, 5.0]
+// quantiles([0, 0.5, 0.9, 1], [1, 3, 2, 4, 5]) == [1, 3, 5, 5]
+// O(n * log(number of fractions)), all fractions share one selection.
+// Unsafe! Crashes on an empty sequence.
+template <typename ContainerPs, typename Container,
+    typename Result = typename Container::value_type>
+std::vector<Result> quantiles(const ContainerPs& ps, const Container& xs)
+{
+    assert(is_not_empty(xs));
+    auto ys = internal::as_vector(xs);
+    const std::size_t last_idx = ys.size() - 1;
+    std::vector<double> positions;
+    std::vector<std::size_t> idxs;
+    for (const auto& p : ps) {
+        const double clamped = std::min(std::max(static_cast<double>(p), 0.0), 1.0);
+        const double position = clamped * static_cast<double>(last_idx);
+        const std::size_t lower = floor<double, std::size_t>(position);
+        positions.push_back(position);
+        idxs.push_back(lower);
+        idxs.push_back(std::min(lower + 1, last_idx));
+    }
+    internal::nth_elements(ys, idxs);
+
+    std::vector<Result> result;
+    result.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const double lower = static_cast<double>(ys[idxs[2 * i]]);
+        const double upper = static_cast<double>(ys[idxs[2 * i + 1]]);
+        const double fraction = positions[i] - static_cast<double>(idxs[2 * i]);
+        const double value = lower + fraction * (upper - lower);
+        result.push_back(internal::from_double<Result>(std::is_integral<Result>(), value));
+    }
+    return result;
+}
+
 // API search type: all_unique_by_less : (((a, a) -> Bool), [a]) -> Bool
 // fwd bind count: 1
 // Returns true for empty containers.
@@ -6,6 +6,11 @@
 
 #pragma once
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 namespace fplus {
 namespace fwd {
 
@@ -112,5 +117,362 @@ namespace fwd {
 
 #include "fwd_instances.autogenerated_defines"
 
+    // Lazy pipelines, fusing all element-wise stages into one loop.
+    // fwd::apply(numbers(0, 100),
+    //     fwd::lazy::transform(times_3),
+    //     fwd::lazy::drop_if(is_odd_int),
+    //     fwd::lazy::sum())
+    // A stage applied to a container (or to the result of another stage)
+    // does not process anything. It only returns a lazy_view
+    // remembering the source and the stages.
+    // A terminal (sum, product, fold_left, convert_container) then runs
+    // the source through all stages element by element,
+    // so no intermediate containers are allocated.
+    // A temporary source container is moved into the view,
+    // a named one is only referenced and thus must outlive the view.
+    namespace internal {
+        template <typename Source, typename... Stages>
+        class lazy_view;
+
+        template <typename T, typename... Stages>
+        struct lazy_output_type {
+            typedef T type;
+        };
+
+        template <typename T, typename Stage, typename... Stages>
+        struct lazy_output_type<T, Stage, Stages...>
+            : lazy_output_type<typename Stage::template output_t<T>, Stages...> {
+        };
+
+        template <typename Source, typename... Stages>
+        class lazy_view {
+        public:
+            typedef typename std::decay_t<Source>::value_type source_value_type;
+            typedef typename lazy_output_type<source_value_type, Stages...>::type value_type;
+
+            lazy_view(Source source, std::tuple<Stages...> stages)
+                : source_(std::forward<Source>(source))
+                , stages_(std::move(stages))
+            {
+            }
+
+            template <typename Stage>
+            lazy_view<Source, Stages..., Stage> append(const Stage& stage) const&
+            {
+                return { source_, std::tuple_cat(stages_, std::make_tuple(stage)) };
+            }
+
+            template <typename Stage>
+            lazy_view<Source, Stages..., Stage> append(const Stage& stage) &&
+            {
+                return { std::forward<Source>(source_),
+                    std::tuple_cat(std::move(stages_), std::make_tuple(stage)) };
+            }
+
+            // Feeds the elements through all stages into sink,
+            // until the source is exhausted or a stage or the sink returns false.
+            template <typename Sink>
+            void run(Sink sink) const
+            {
+                auto fused = wrap_stages<0>(std::move(sink),
+                    std::integral_constant<bool, sizeof...(Stages) == 0>());
+                for (const auto& x : source_) {
+                    if (!fused(x)) {
+                        return;
+                    }
+                }
+            }
+
+        private:
+            template <std::size_t Idx, typename Sink>
+            Sink wrap_stages(Sink sink, std::true_type) const
+            {
+                return sink;
+            }
+
+            template <std::size_t Idx, typename Sink>
+            auto wrap_stages(Sink sink, std::false_type) const
+            {
+                return std::get<Idx>(stages_).wrap(wrap_stages<Idx + 1>(std::move(sink),
+                    std::integral_constant<bool, Idx + 1 == sizeof...(Stages)>()));
+            }
+
+            Source source_;
+            std::tuple<Stages...> stages_;
+        };
+
+        template <typename T>
+        struct is_lazy_view : std::false_type {
+        };
+
+        template <typename Source, typename... Stages>
+        struct is_lazy_view<lazy_view<Source, Stages...>> : std::true_type {
+        };
+
+        template <typename View>
+        View&& as_lazy_view(View&& view, std::true_type)
+        {
+            return std::forward<View>(view);
+        }
+
+        template <typename Container>
+        lazy_view<const Container&> as_lazy_view(const Container& xs, std::false_type)
+        {
+            return { xs, std::tuple<>() };
+        }
+
+        template <typename Container,
+            typename = std::enable_if_t<!std::is_lvalue_reference<Container>::value>>
+        lazy_view<Container> as_lazy_view(Container&& xs, std::false_type)
+        {
+            return { std::move(xs), std::tuple<>() };
+        }
+
+        template <typename X>
+        decltype(auto) as_lazy_view(X&& x)
+        {
+            return as_lazy_view(std::forward<X>(x),
+                is_lazy_view<std::decay_t<X>>());
+        }
+
+        // Base of all stages, appending the stage to the view it is applied to.
+        template <typename Stage>
+        struct lazy_stage {
+            template <typename X>
+            auto operator()(X&& x) const
+            {
+                return as_lazy_view(std::forward<X>(x))
+                    .append(static_cast<const Stage&>(*this));
+            }
+        };
+
+        template <typename F>
+        struct lazy_transform_stage : lazy_stage<lazy_transform_stage<F>> {
+            explicit lazy_transform_stage(F f)
+                : f_(f)
+            {
+            }
+            template <typename T>
+            using output_t = std::decay_t<fplus::internal::invoke_result_t<F, T>>;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [f = f_, sink](auto&& x) mutable {
+                    return sink(fplus::internal::invoke(f, std::forward<decltype(x)>(x)));
+                };
+            }
+            F f_;
+        };
+
+        template <typename F>
+        struct lazy_transform_with_idx_stage : lazy_stage<lazy_transform_with_idx_stage<F>> {
+            explicit lazy_transform_with_idx_stage(F f)
+                : f_(f)
+            {
+            }
+            template <typename T>
+            using output_t = std::decay_t<fplus::internal::invoke_result_t<F, std::size_t, T>>;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [f = f_, sink, idx = std::size_t(0)](auto&& x) mutable {
+                    return sink(fplus::internal::invoke(f, idx++, std::forward<decltype(x)>(x)));
+                };
+            }
+            F f_;
+        };
+
+        template <typename Pred, bool Keep>
+        struct lazy_filter_stage : lazy_stage<lazy_filter_stage<Pred, Keep>> {
+            explicit lazy_filter_stage(Pred pred)
+                : pred_(pred)
+            {
+            }
+            template <typename T>
+            using output_t = T;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [pred = pred_, sink](auto&& x) mutable {
+                    if (static_cast<bool>(fplus::internal::invoke(pred, x)) != Keep) {
+                        return true;
+                    }
+                    return static_cast<bool>(sink(std::forward<decltype(x)>(x)));
+                };
+            }
+            Pred pred_;
+        };
+
+        struct lazy_take_stage : lazy_stage<lazy_take_stage> {
+            explicit lazy_take_stage(std::size_t n)
+                : n_(n)
+            {
+            }
+            template <typename T>
+            using output_t = T;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [n = n_, sink, taken = std::size_t(0)](auto&& x) mutable {
+                    if (taken == n) {
+                        return false;
+                    }
+                    ++taken;
+                    return sink(std::forward<decltype(x)>(x)) && taken < n;
+                };
+            }
+            std::size_t n_;
+        };
+
+        struct lazy_drop_stage : lazy_stage<lazy_drop_stage> {
+            explicit lazy_drop_stage(std::size_t n)
+                : n_(n)
+            {
+            }
+            template <typename T>
+            using output_t = T;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [n = n_, sink, dropped = std::size_t(0)](auto&& x) mutable {
+                    if (dropped < n) {
+                        ++dropped;
+                        return true;
+                    }
+                    return static_cast<bool>(sink(std::forward<decltype(x)>(x)));
+                };
+            }
+            std::size_t n_;
+        };
+
+        template <typename F, typename Acc>
+        struct lazy_fold_left_terminal {
+            template <typename X>
+            Acc operator()(X&& x) const
+            {
+                Acc acc = init_;
+                as_lazy_view(std::forward<X>(x)).run([this, &acc](auto&& y) {
+                    acc = fplus::internal::invoke(f_, std::move(acc), std::forward<decltype(y)>(y));
+                    return true;
+                });
+                return acc;
+            }
+            F f_;
+            Acc init_;
+        };
+
+        struct lazy_sum_terminal {
+            template <typename X>
+            auto operator()(X&& x) const
+            {
+                typedef typename std::decay_t<decltype(as_lazy_view(std::forward<X>(x)))>::value_type T;
+                T result = T();
+                as_lazy_view(std::forward<X>(x)).run([&result](const auto& y) {
+                    result = result + y;
+                    return true;
+                });
+                return result;
+            }
+        };
+
+        struct lazy_product_terminal {
+            template <typename X>
+            auto operator()(X&& x) const
+            {
+                typedef typename std::decay_t<decltype(as_lazy_view(std::forward<X>(x)))>::value_type T;
+                T result = T(1);
+                as_lazy_view(std::forward<X>(x)).run([&result](const auto& y) {
+                    result *= y;
+                    return true;
+                });
+                return result;
+            }
+        };
+
+        template <typename ContainerOut>
+        struct lazy_convert_container_terminal {
+            template <typename X>
+            ContainerOut operator()(X&& x) const
+            {
+                ContainerOut ys;
+                auto it = fplus::internal::get_back_inserter<ContainerOut>(ys);
+                as_lazy_view(std::forward<X>(x)).run([&it](auto&& y) {
+                    *it = std::forward<decltype(y)>(y);
+                    return true;
+                });
+                return ys;
+            }
+        };
+    } // namespace internal
+
+    namespace lazy {
+        // Lazy version of fwd::transform.
+        template <typename F>
+        auto transform(F f)
+        {
+            return internal::lazy_transform_stage<F>(f);
+        }
+
+        // Lazy version of fwd::transform_with_idx.
+        template <typename F>
+        auto transform_with_idx(F f)
+        {
+            return internal::lazy_transform_with_idx_stage<F>(f);
+        }
+
+        // Lazy version of fwd::keep_if.
+        template <typename Pred>
+        auto keep_if(Pred pred)
+        {
+            return internal::lazy_filter_stage<Pred, true>(pred);
+        }
+
+        // Lazy version of fwd::drop_if.
+        template <typename Pred>
+        auto drop_if(Pred pred)
+        {
+            return internal::lazy_filter_stage<Pred, false>(pred);
+        }
+
+        // Lazy version of fwd::take.
+        // Stops consuming the source after n elements.
+        inline auto take(std::size_t n)
+        {
+            return internal::lazy_take_stage(n);
+        }
+
+        // Lazy version of fwd::drop.
+        inline auto drop(std::size_t n)
+        {
+            return internal::lazy_drop_stage(n);
+        }
+
+        // Runs a lazy pipeline like fwd::fold_left.
+        template <typename F, typename Acc>
+        auto fold_left(F f, const Acc& init)
+        {
+            return internal::lazy_fold_left_terminal<F, Acc> { f, init };
+        }
+
+        // Runs a lazy pipeline like fwd::sum.
+        inline auto sum()
+        {
+            return internal::lazy_sum_terminal();
+        }
+
+        // Runs a lazy pipeline like fwd::product.
+        inline auto product()
+        {
+            return internal::lazy_product_terminal();
+        }
+
+        // Runs a lazy pipeline, collecting the results in a ContainerOut.
+        template <typename ContainerOut>
+        auto convert_container()
+        {
+            return internal::lazy_convert_container_terminal<ContainerOut>();
+        }
+    } // namespace lazy
+
 } // namespace fwd
 } // namespace fplus
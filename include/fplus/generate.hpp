@@ -51,6 +51,20 @@ ContainerOut generate_by_idx(F f, std::size_t amount)
     return ys;
 }
 
+// API search type: generate_by_idx_lazy : ((Int -> a), Int) -> [a]
+// fwd bind count: 1
+// Same as generate_by_idx, but f(i) is only called
+// when element i is accessed, and the result is not stored.
+// generate_by_idx_lazy(f, 3) == [f(0), f(1), f(2)]
+template <typename F,
+    typename T = std::decay_t<internal::invoke_result_t<F, std::size_t>>>
+internal::generate_by_idx_range<F, T> generate_by_idx_lazy(F f, std::size_t amount)
+{
+    internal::
+        trigger_static_asserts<internal::unary_function_tag, F, std::size_t>();
+    return internal::generate_by_idx_range<F, T>(f, amount);
+}
+
 // API search type: repeat : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Create a sequence containing xs concatenated n times.
@@ -62,6 +76,17 @@ Container repeat(std::size_t n, const Container& xs)
     return concat(xss);
 }
 
+// API search type: repeat_lazy : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as repeat, but only one copy of xs is stored.
+// repeat_lazy(3, [1, 2]) == [1, 2, 1, 2, 1, 2]
+template <typename Container,
+    typename T = typename Container::value_type>
+internal::repeat_range<T> repeat_lazy(std::size_t n, const Container& xs)
+{
+    return internal::repeat_range<T>(n, xs);
+}
+
 // API search type: infixes : (Int, [a]) -> [[a]]
 // fwd bind count: 1
 // Return als possible infixed of xs with a given length.
@@ -86,6 +111,25 @@ ContainerOut infixes(std::size_t length, const ContainerIn& xs)
     return result;
 }
 
+// API search type: infixes_view : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Same as infixes, but the infixes are views into xs
+// computed on access, so memory usage does not grow with length.
+// xs has to outlive the result.
+// infixes_view(3, [1,2,3,4,5,6]) == [[1,2,3], [2,3,4], [3,4,5], [4,5,6]]
+// length must be > 0
+template <typename ContainerIn>
+internal::window_range<ContainerIn> infixes_view(std::size_t length, const ContainerIn& xs)
+{
+    assert(length > 0);
+    const std::size_t size = size_of_cont(xs);
+    const std::size_t n_windows = size < length ? 0 : size - length + 1;
+    return internal::window_range<ContainerIn>(xs, n_windows, length, 1);
+}
+
+template <typename ContainerIn>
+void infixes_view(std::size_t, const ContainerIn&&) = delete;
+
 // API search type: carthesian_product_with_where : (((a, b) -> c), ((a -> b), Bool), [a], [b]) -> [c]
 // fwd bind count: 3
 // carthesian_product_with_where(make_pair, always(true), "ABC", "XY")
@@ -341,6 +385,18 @@ ContainerOut iterate(F f, std::size_t size, const T& x)
     return result;
 }
 
+// API search type: iterate_lazy : ((a -> a), Int, a) -> [a]
+// fwd bind count: 2
+// Same as iterate, but the values are computed while iterating
+// instead of being stored, so the memory usage is constant.
+// Every pass over the sequence applies f again.
+// iterate_lazy((*2), 5, 3) = [3, 6, 12, 24, 48]
+template <typename F, typename T>
+internal::iterate_range<F, T> iterate_lazy(F f, std::size_t size, const T& x)
+{
+    return internal::iterate_range<F, T>(f, size, x);
+}
+
 // API search type: iterate_maybe : ((a -> Maybe a), a) -> [a]
 // fwd bind count: 1
 // Repeatedly apply a function to a value (starting with x)
@@ -0,0 +1,202 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <fplus/internal/token_search.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Aho-Corasick automaton finding all occurrences
+    // of many tokens in one pass over the input.
+    // Bytes use a dense transition table (a DFA with 256 columns),
+    // other element types follow failure links
+    // over per-node lists of outgoing edges.
+    // Empty tokens are ignored. Of equal tokens,
+    // only the first one is reported.
+    template <typename T>
+    class aho_corasick_automaton {
+    public:
+        explicit aho_corasick_automaton(const std::vector<std::vector<T>>& tokens)
+            : nodes_(1)
+            , edges_(1)
+            , dense_goto_()
+            , token_sizes_()
+        {
+            token_sizes_.reserve(tokens.size());
+            for (std::size_t idx = 0; idx < tokens.size(); ++idx) {
+                token_sizes_.push_back(tokens[idx].size());
+                insert(tokens[idx], idx);
+            }
+            link(is_byte_like<T>());
+        }
+
+        std::size_t token_count() const { return token_sizes_.size(); }
+        std::size_t token_size(std::size_t token_idx) const
+        {
+            return token_sizes_[token_idx];
+        }
+
+        // Calls on_match(idx, token_idx) for every occurrence
+        // of every token in [first, last),
+        // ordered by the position of their ends.
+        template <typename Iterator, typename F>
+        void for_each_match(Iterator first, Iterator last, F on_match) const
+        {
+            std::size_t state = 0;
+            std::size_t end_idx = 1;
+            for (; first != last; ++first, ++end_idx) {
+                state = next_state(state, *first, is_byte_like<T>());
+                std::size_t out = nodes_[state].token_idx != none
+                    ? state
+                    : nodes_[state].output_link;
+                while (out != none) {
+                    const std::size_t token_idx = nodes_[out].token_idx;
+                    on_match(end_idx - token_sizes_[token_idx], token_idx);
+                    out = nodes_[out].output_link;
+                }
+            }
+        }
+
+    private:
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t alphabet_size = 256;
+
+        // token_idx: token ending here, none if no token ends here
+        // output_link: longest proper suffix state a token ends in
+        struct node {
+            std::size_t fail = 0;
+            std::size_t token_idx = none;
+            std::size_t output_link = none;
+        };
+
+        std::size_t find_edge(std::size_t state, const T& x) const
+        {
+            for (const auto& edge : edges_[state]) {
+                if (edge.first == x) {
+                    return edge.second;
+                }
+            }
+            return none;
+        }
+
+        void insert(const std::vector<T>& token, std::size_t token_idx)
+        {
+            if (token.empty()) {
+                return;
+            }
+            std::size_t state = 0;
+            for (const T& x : token) {
+                std::size_t child = find_edge(state, x);
+                if (child == none) {
+                    child = nodes_.size();
+                    nodes_.emplace_back();
+                    edges_.emplace_back();
+                    edges_[state].emplace_back(x, child);
+                }
+                state = child;
+            }
+            if (nodes_[state].token_idx == none) {
+                nodes_[state].token_idx = token_idx;
+            }
+        }
+
+        void set_output_link(std::size_t state)
+        {
+            const node& fail = nodes_[nodes_[state].fail];
+            nodes_[state].output_link = fail.token_idx != none
+                ? nodes_[state].fail
+                : fail.output_link;
+        }
+
+        // Breadth-first, so the failure state of a node
+        // is complete before the node itself is processed.
+        void link(std::true_type /* is_byte_like */)
+        {
+            dense_goto_.assign(nodes_.size() * alphabet_size, 0);
+            for (const auto& edge : edges_[0]) {
+                dense_goto_[to_byte(edge.first)] = edge.second;
+            }
+            std::deque<std::size_t> queue;
+            for (const auto& edge : edges_[0]) {
+                queue.push_back(edge.second);
+            }
+            while (!queue.empty()) {
+                const std::size_t state = queue.front();
+                queue.pop_front();
+                set_output_link(state);
+                const std::size_t* const fail_row = &dense_goto_[nodes_[state].fail * alphabet_size];
+                std::size_t* const row = &dense_goto_[state * alphabet_size];
+                std::copy(fail_row, fail_row + alphabet_size, row);
+                for (const auto& edge : edges_[state]) {
+                    nodes_[edge.second].fail = fail_row[to_byte(edge.first)];
+                    row[to_byte(edge.first)] = edge.second;
+                    queue.push_back(edge.second);
+                }
+            }
+            edges_.clear();
+            edges_.shrink_to_fit();
+        }
+
+        void link(std::false_type /* is_byte_like */)
+        {
+            std::deque<std::size_t> queue;
+            for (const auto& edge : edges_[0]) {
+                queue.push_back(edge.second);
+            }
+            while (!queue.empty()) {
+                const std::size_t state = queue.front();
+                queue.pop_front();
+                set_output_link(state);
+                for (const auto& edge : edges_[state]) {
+                    nodes_[edge.second].fail = next_state(
+                        nodes_[state].fail, edge.first, std::false_type());
+                    queue.push_back(edge.second);
+                }
+            }
+        }
+
+        std::size_t next_state(std::size_t state, const T& x,
+            std::true_type /* is_byte_like */) const
+        {
+            return dense_goto_[state * alphabet_size + to_byte(x)];
+        }
+
+        std::size_t next_state(std::size_t state, const T& x,
+            std::false_type /* is_byte_like */) const
+        {
+            for (;;) {
+                const std::size_t child = find_edge(state, x);
+                if (child != none) {
+                    return child;
+                }
+                if (state == 0) {
+                    return 0;
+                }
+                state = nodes_[state].fail;
+            }
+        }
+
+        static unsigned char to_byte(const T& x)
+        {
+            return static_cast<unsigned char>(x);
+        }
+
+        std::vector<node> nodes_;
+        std::vector<std::vector<std::pair<T, std::size_t>>> edges_;
+        std::vector<std::size_t> dense_goto_;
+        std::vector<std::size_t> token_sizes_;
+    };
+}
+}
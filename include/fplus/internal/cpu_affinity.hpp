@@ -0,0 +1,150 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace fplus {
+namespace internal {
+
+    // Where a logical CPU sits in the machine.
+    struct cpu_location {
+        std::size_t cpu;
+        std::size_t package;
+        std::size_t core;
+    };
+
+    // Reads one number from the sysfs topology of a CPU,
+    // returning fallback if it is not available.
+    inline std::size_t read_cpu_topology_value(std::size_t cpu,
+        const std::string& name, std::size_t fallback)
+    {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+        std::size_t value = fallback;
+        if (!(file >> value)) {
+            return fallback;
+        }
+        return value;
+    }
+
+    // The CPUs the process is allowed to run on.
+    // Without OS support, all CPUs are assumed to be on one package.
+    inline std::vector<cpu_location> allowed_cpu_locations()
+    {
+        std::vector<cpu_location> result;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (std::size_t id = 0; id < static_cast<std::size_t>(CPU_SETSIZE); ++id) {
+                if (CPU_ISSET(id, &set)) {
+                    result.push_back({ id,
+                        read_cpu_topology_value(id, "physical_package_id", 0),
+                        read_cpu_topology_value(id, "core_id", id) });
+                }
+            }
+        }
+#endif
+        if (result.empty()) {
+            const std::size_t n = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            for (std::size_t cpu = 0; cpu < n; ++cpu) {
+                result.push_back({ cpu, 0, cpu });
+            }
+        }
+        return result;
+    }
+
+    // Orders the CPUs such that neighboring threads share
+    // as much as possible: hyper-threads of one core are adjacent,
+    // and a package is filled before the next one is used.
+    inline std::vector<cpu_location> compact_cpu_order(
+        std::vector<cpu_location> cpus)
+    {
+        std::sort(std::begin(cpus), std::end(cpus),
+            [](const cpu_location& a, const cpu_location& b) {
+                return std::tie(a.package, a.core, a.cpu)
+                    < std::tie(b.package, b.core, b.cpu);
+            });
+        return cpus;
+    }
+
+    // Orders the CPUs such that neighboring threads share
+    // as little as possible: the packages are used round-robin,
+    // and every physical core gets one thread
+    // before hyper-threads are used.
+    inline std::vector<cpu_location> scatter_cpu_order(
+        const std::vector<cpu_location>& cpus)
+    {
+        // sibling_rank: 0 for the first hyper-thread of a core, 1 for the second, ...
+        // package_rank: position within the package after ordering by sibling_rank
+        struct ranked_cpu {
+            cpu_location location;
+            std::size_t sibling_rank;
+            std::size_t package_rank;
+        };
+        std::vector<ranked_cpu> ranked;
+        const auto compact = compact_cpu_order(cpus);
+        for (std::size_t i = 0; i < compact.size(); ++i) {
+            const bool is_sibling = i > 0
+                && compact[i].package == compact[i - 1].package
+                && compact[i].core == compact[i - 1].core;
+            ranked.push_back({ compact[i],
+                is_sibling ? ranked.back().sibling_rank + 1 : 0, 0 });
+        }
+        std::stable_sort(std::begin(ranked), std::end(ranked),
+            [](const ranked_cpu& a, const ranked_cpu& b) {
+                return std::tie(a.location.package, a.sibling_rank)
+                    < std::tie(b.location.package, b.sibling_rank);
+            });
+        for (std::size_t i = 1; i < ranked.size(); ++i) {
+            if (ranked[i].location.package == ranked[i - 1].location.package) {
+                ranked[i].package_rank = ranked[i - 1].package_rank + 1;
+            }
+        }
+        std::stable_sort(std::begin(ranked), std::end(ranked),
+            [](const ranked_cpu& a, const ranked_cpu& b) {
+                return std::tie(a.package_rank, a.location.package)
+                    < std::tie(b.package_rank, b.location.package);
+            });
+        std::vector<cpu_location> result;
+        result.reserve(ranked.size());
+        for (const auto& r : ranked) {
+            result.push_back(r.location);
+        }
+        return result;
+    }
+
+    // Restricts the calling thread to one CPU.
+    // Returns false if this is not supported or not allowed.
+    inline bool pin_current_thread_to_cpu(std::size_t cpu)
+    {
+#if defined(__linux__)
+        if (cpu >= static_cast<std::size_t>(CPU_SETSIZE)) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+}
+}
@@ -0,0 +1,132 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FPLUS_HAS_MMAP
+#endif
+
+namespace fplus {
+namespace internal {
+
+    // How the pages of a mapped file are going to be accessed.
+    enum class file_access {
+        normal,
+        sequential,
+        random,
+        will_need
+    };
+
+    // The read-only content of a file.
+    // Regular files are mapped into memory, so pages are only loaded
+    // when they are accessed. Other files (pipes, procfs, ...)
+    // and systems without mmap fall back to reading the whole content.
+    class file_mapping {
+    public:
+        // Returns nullptr if the file can not be opened.
+        static std::unique_ptr<file_mapping> open(const std::string& filename)
+        {
+            std::unique_ptr<file_mapping> result(new file_mapping());
+#ifdef FPLUS_HAS_MMAP
+            const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return nullptr;
+            }
+            struct stat info;
+            const bool is_regular = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+            if (is_regular && info.st_size == 0) {
+                ::close(fd);
+                return result;
+            }
+            if (is_regular) {
+                const std::size_t size = static_cast<std::size_t>(info.st_size);
+                void* const addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (addr != MAP_FAILED) {
+                    result->data_ = static_cast<const char*>(addr);
+                    result->size_ = size;
+                    result->is_mapped_ = true;
+                    return result;
+                }
+            } else {
+                ::close(fd);
+            }
+#endif
+            std::ifstream input(filename, std::ios::binary);
+            if (!input.good()) {
+                return nullptr;
+            }
+            result->buffer_.assign(std::istreambuf_iterator<char>(input),
+                std::istreambuf_iterator<char>());
+            result->data_ = result->buffer_.data();
+            result->size_ = result->buffer_.size();
+            return result;
+        }
+        file_mapping(const file_mapping&) = delete;
+        file_mapping& operator=(const file_mapping&) = delete;
+        ~file_mapping()
+        {
+#ifdef FPLUS_HAS_MMAP
+            if (is_mapped_) {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+        }
+        const char* data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+        // Passes the expected access pattern on to the OS.
+        // Returns false if the hint could not be applied,
+        // which is always the case for content that is not mapped.
+        bool advise(file_access access) const
+        {
+#ifdef FPLUS_HAS_MMAP
+            if (!is_mapped_) {
+                return false;
+            }
+            int advice = POSIX_MADV_NORMAL;
+            if (access == file_access::sequential) {
+                advice = POSIX_MADV_SEQUENTIAL;
+            } else if (access == file_access::random) {
+                advice = POSIX_MADV_RANDOM;
+            } else if (access == file_access::will_need) {
+                advice = POSIX_MADV_WILLNEED;
+            }
+            return ::posix_madvise(const_cast<char*>(data_), size_, advice) == 0;
+#else
+            (void)access;
+            return false;
+#endif
+        }
+
+    private:
+        file_mapping()
+            : data_(nullptr)
+            , size_(0)
+            , is_mapped_(false)
+            , buffer_()
+        {
+        }
+        const char* data_;
+        std::size_t size_;
+        bool is_mapped_;
+        std::string buffer_;
+    };
+}
+}
+
+#undef FPLUS_HAS_MMAP
@@ -0,0 +1,448 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <fplus/container_traits.hpp>
+#include <fplus/internal/invoke.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Read-only sequences computing their elements on access
+    // instead of storing them, returned by the *_lazy functions.
+    // They provide the interface of a const container
+    // (value_type, const_iterator, begin, end, size, empty),
+    // so functions only reading their input accept them as is.
+    // Functions returning a container of the input type
+    // need a real container, see convert_container.
+
+    // Random-access iterator over a range providing operator[].
+    // Dereferencing returns the element by value.
+    template <typename Range>
+    class lazy_idx_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename Range::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef value_type reference;
+
+        lazy_idx_iterator()
+            : range_(nullptr)
+            , idx_(0)
+        {
+        }
+        lazy_idx_iterator(const Range* range, std::size_t idx)
+            : range_(range)
+            , idx_(idx)
+        {
+        }
+        value_type operator*() const { return (*range_)[idx_]; }
+        value_type operator[](difference_type n) const
+        {
+            return (*range_)[offset(n)];
+        }
+        lazy_idx_iterator& operator++()
+        {
+            ++idx_;
+            return *this;
+        }
+        lazy_idx_iterator operator++(int)
+        {
+            lazy_idx_iterator result = *this;
+            ++idx_;
+            return result;
+        }
+        lazy_idx_iterator& operator--()
+        {
+            --idx_;
+            return *this;
+        }
+        lazy_idx_iterator operator--(int)
+        {
+            lazy_idx_iterator result = *this;
+            --idx_;
+            return result;
+        }
+        lazy_idx_iterator& operator+=(difference_type n)
+        {
+            idx_ = offset(n);
+            return *this;
+        }
+        lazy_idx_iterator& operator-=(difference_type n)
+        {
+            idx_ = offset(-n);
+            return *this;
+        }
+        friend lazy_idx_iterator operator+(lazy_idx_iterator it, difference_type n)
+        {
+            return it += n;
+        }
+        friend lazy_idx_iterator operator+(difference_type n, lazy_idx_iterator it)
+        {
+            return it += n;
+        }
+        friend lazy_idx_iterator operator-(lazy_idx_iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(const lazy_idx_iterator& a, const lazy_idx_iterator& b)
+        {
+            return static_cast<difference_type>(a.idx_) - static_cast<difference_type>(b.idx_);
+        }
+        friend bool operator==(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ == b.idx_; }
+        friend bool operator!=(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ != b.idx_; }
+        friend bool operator<(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ < b.idx_; }
+        friend bool operator>(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ > b.idx_; }
+        friend bool operator<=(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ <= b.idx_; }
+        friend bool operator>=(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ >= b.idx_; }
+
+    private:
+        std::size_t offset(difference_type n) const
+        {
+            return static_cast<std::size_t>(static_cast<difference_type>(idx_) + n);
+        }
+        const Range* range_;
+        std::size_t idx_;
+    };
+
+    // Common interface of the ranges with index-based element access.
+    template <typename Derived, typename T>
+    class lazy_idx_range {
+    public:
+        typedef T value_type;
+        typedef lazy_idx_iterator<Derived> const_iterator;
+        typedef const_iterator iterator;
+        typedef std::size_t size_type;
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const_iterator begin() const { return const_iterator(derived(), 0); }
+        const_iterator end() const { return const_iterator(derived(), size_); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    protected:
+        explicit lazy_idx_range(std::size_t size)
+            : size_(size)
+        {
+        }
+
+    private:
+        const Derived* derived() const { return static_cast<const Derived*>(this); }
+        std::size_t size_;
+    };
+
+    // start, start + step, start + 2 * step, ... while < end
+    template <typename T>
+    class numbers_step_range : public lazy_idx_range<numbers_step_range<T>, T> {
+    public:
+        numbers_step_range(T start, T end, T step)
+            : lazy_idx_range<numbers_step_range<T>, T>(count(start, end, step))
+            , start_(start)
+            , step_(step)
+        {
+        }
+        T operator[](std::size_t idx) const
+        {
+            return static_cast<T>(start_ + static_cast<T>(idx) * step_);
+        }
+
+    private:
+        static std::size_t count(T start, T end, T step)
+        {
+            if (!(step > 0) || !(start < end)) {
+                return 0;
+            }
+            std::size_t n = static_cast<std::size_t>((end - start) / step);
+            // Correct rounding of the division.
+            while (n > 0 && !(start + static_cast<T>(n - 1) * step < end)) {
+                --n;
+            }
+            while (start + static_cast<T>(n) * step < end) {
+                ++n;
+            }
+            return n;
+        }
+        T start_;
+        T step_;
+    };
+
+    // f(0), f(1), ..., f(size - 1)
+    template <typename F, typename T>
+    class generate_by_idx_range : public lazy_idx_range<generate_by_idx_range<F, T>, T> {
+    public:
+        generate_by_idx_range(F f, std::size_t size)
+            : lazy_idx_range<generate_by_idx_range<F, T>, T>(size)
+            , f_(f)
+        {
+        }
+        T operator[](std::size_t idx) const
+        {
+            return internal::invoke(f_, idx);
+        }
+
+    private:
+        F f_;
+    };
+
+    // The elements of xs, n times in a row.
+    template <typename T>
+    class repeat_range : public lazy_idx_range<repeat_range<T>, T> {
+    public:
+        template <typename Container>
+        repeat_range(std::size_t n, const Container& xs)
+            : lazy_idx_range<repeat_range<T>, T>(n * xs.size())
+            , xs_(std::begin(xs), std::end(xs))
+        {
+        }
+        const T& operator[](std::size_t idx) const
+        {
+            return xs_[idx % xs_.size()];
+        }
+
+    private:
+        std::vector<T> xs_;
+    };
+
+    // x, f(x), f(f(x)), ... (size elements)
+    // Every element is computed from its predecessor,
+    // so the iterators only support forward traversal.
+    // They carry the current value, to which they return references.
+    template <typename F, typename T>
+    class iterate_range {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+
+        class const_iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T* pointer;
+            typedef const T& reference;
+
+            const_iterator(const iterate_range* range, std::size_t idx)
+                : range_(range)
+                , idx_(idx)
+                , current_(range->x_)
+            {
+            }
+            const T& operator*() const { return current_; }
+            const T* operator->() const { return &current_; }
+            const_iterator& operator++()
+            {
+                ++idx_;
+                if (idx_ < range_->size_) {
+                    current_ = internal::invoke(range_->f_, current_);
+                }
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator result = *this;
+                ++*this;
+                return result;
+            }
+            friend bool operator==(const const_iterator& a, const const_iterator& b) { return a.idx_ == b.idx_; }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a.idx_ != b.idx_; }
+
+        private:
+            const iterate_range* range_;
+            std::size_t idx_;
+            T current_;
+        };
+        typedef const_iterator iterator;
+
+        iterate_range(F f, std::size_t size, const T& x)
+            : f_(f)
+            , size_(size)
+            , x_(x)
+        {
+        }
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size_); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    private:
+        F f_;
+        std::size_t size_;
+        T x_;
+    };
+
+    // Non-owning view of the elements in [first, last).
+    template <typename Iterator>
+    class iterator_range {
+    public:
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+        typedef Iterator const_iterator;
+        typedef Iterator iterator;
+        typedef std::size_t size_type;
+
+        iterator_range(Iterator first, Iterator last, std::size_t size)
+            : first_(first)
+            , last_(last)
+            , size_(size)
+        {
+        }
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const_iterator begin() const { return first_; }
+        const_iterator end() const { return last_; }
+        const_iterator cbegin() const { return first_; }
+        const_iterator cend() const { return last_; }
+        decltype(auto) operator[](std::size_t idx) const
+        {
+            return *std::next(first_,
+                static_cast<typename std::iterator_traits<Iterator>::difference_type>(idx));
+        }
+
+    private:
+        Iterator first_;
+        Iterator last_;
+        std::size_t size_;
+    };
+
+    template <typename Iterator>
+    Iterator advanced_iterator(Iterator it, std::size_t n)
+    {
+        return std::next(it,
+            static_cast<typename std::iterator_traits<Iterator>::difference_type>(n));
+    }
+
+    // Windows into a container, window idx covering
+    // the elements [idx * step, idx * step + length),
+    // cut off at the end of the container.
+    // The windows are computed on access
+    // in O(1) for random-access containers.
+    template <typename Container,
+        typename Window = iterator_range<typename Container::const_iterator>>
+    class window_range : public lazy_idx_range<window_range<Container>, Window> {
+    public:
+        window_range(const Container& xs, std::size_t n_windows,
+            std::size_t length, std::size_t step)
+            : lazy_idx_range<window_range<Container>, Window>(n_windows)
+            , first_(std::begin(xs))
+            , xs_size_(static_cast<std::size_t>(
+                  std::distance(std::begin(xs), std::end(xs))))
+            , length_(length)
+            , step_(step)
+        {
+        }
+        Window operator[](std::size_t idx) const
+        {
+            const std::size_t begin_idx = std::min(idx * step_, xs_size_);
+            const std::size_t end_idx = std::min(begin_idx + length_, xs_size_);
+            const auto it = advanced_iterator(first_, begin_idx);
+            return Window(it, advanced_iterator(it, end_idx - begin_idx),
+                end_idx - begin_idx);
+        }
+
+    private:
+        typename Container::const_iterator first_;
+        std::size_t xs_size_;
+        std::size_t length_;
+        std::size_t step_;
+    };
+
+    // Every step-th element of a container, without copying them.
+    template <typename Container,
+        typename T = typename Container::value_type>
+    class stride_range : public lazy_idx_range<stride_range<Container>, T> {
+    public:
+        stride_range(const Container& xs, std::size_t step)
+            : lazy_idx_range<stride_range<Container>, T>(
+                (static_cast<std::size_t>(std::distance(std::begin(xs), std::end(xs)))
+                    + step - 1)
+                / step)
+            , first_(std::begin(xs))
+            , step_(step)
+        {
+        }
+        const T& operator[](std::size_t idx) const
+        {
+            return *advanced_iterator(first_, idx * step_);
+        }
+
+    private:
+        typename Container::const_iterator first_;
+        std::size_t step_;
+    };
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#endif
+
+    // Results of transformations of lazy ranges are stored in vectors.
+    template <class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<numbers_step_range<T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class F, class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<generate_by_idx_range<F, T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<repeat_range<T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class F, class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<iterate_range<F, T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class Iterator, class NewT, int SizeOffset>
+    struct same_cont_new_t<iterator_range<Iterator>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class Container, class Window, class NewT, int SizeOffset>
+    struct same_cont_new_t<window_range<Container, Window>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class Container, class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<stride_range<Container, T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+
+    template <class T>
+    struct has_order<numbers_step_range<T>> : public std::true_type {
+    };
+    template <class F, class T>
+    struct has_order<generate_by_idx_range<F, T>> : public std::true_type {
+    };
+    template <class T>
+    struct has_order<repeat_range<T>> : public std::true_type {
+    };
+    template <class F, class T>
+    struct has_order<iterate_range<F, T>> : public std::true_type {
+    };
+    template <class Iterator>
+    struct has_order<iterator_range<Iterator>> : public std::true_type {
+    };
+    template <class Container, class Window>
+    struct has_order<window_range<Container, Window>> : public std::true_type {
+    };
+    template <class Container, class T>
+    struct has_order<stride_range<Container, T>> : public std::true_type {
+    };
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+}
+}
@@ -0,0 +1,209 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Reads a file chunk by chunk into a reusable buffer
+    // and splits the content into lines on the fly,
+    // so memory usage does not depend on the size of the file.
+    // Lines are split like split_lines does it,
+    // i.e. "\r\n", "\r" and "\n" are line breaks,
+    // and empty lines are only returned if allow_empty is set.
+    class chunked_line_reader {
+    public:
+        // Returns nullptr if the file can not be opened.
+        static std::unique_ptr<chunked_line_reader> open(
+            const std::string& filename, bool allow_empty, std::size_t chunk_size)
+        {
+            std::unique_ptr<chunked_line_reader> result(
+                new chunked_line_reader(filename, allow_empty, chunk_size));
+            if (!result->input_.good()) {
+                return nullptr;
+            }
+            return result;
+        }
+        chunked_line_reader(const chunked_line_reader&) = delete;
+        chunked_line_reader& operator=(const chunked_line_reader&) = delete;
+
+        // Reads the next line into line, reusing its capacity.
+        // Returns false if there are no more lines.
+        bool next(std::string& line)
+        {
+            line.clear();
+            if (finished_) {
+                return false;
+            }
+            for (;;) {
+                if (pos_ == end_ && !fill()) {
+                    finished_ = true;
+                    return !line.empty() || allow_empty_;
+                }
+                if (skip_line_feed_) {
+                    skip_line_feed_ = false;
+                    if (buffer_[pos_] == '\n') {
+                        ++pos_;
+                        continue;
+                    }
+                }
+                const char* const first = buffer_.data() + pos_;
+                const char* const last = buffer_.data() + end_;
+                const char* const line_break = std::find_if(first, last,
+                    [](char c) { return c == '\n' || c == '\r'; });
+                line.append(first, line_break);
+                if (line_break == last) {
+                    pos_ = end_;
+                    continue;
+                }
+                skip_line_feed_ = *line_break == '\r';
+                pos_ += static_cast<std::size_t>(line_break - first) + 1;
+                if (!line.empty() || allow_empty_) {
+                    return true;
+                }
+            }
+        }
+
+        // Reads the next lines, about chunk_size bytes in total,
+        // reusing the strings already present in lines.
+        // Returns false if there are no more lines.
+        bool next_batch(std::vector<std::string>& lines)
+        {
+            std::size_t n = 0;
+            std::size_t n_bytes = 0;
+            while (n_bytes < chunk_size_) {
+                if (n == lines.size()) {
+                    lines.emplace_back();
+                }
+                if (!next(lines[n])) {
+                    break;
+                }
+                n_bytes += lines[n].size() + 1;
+                ++n;
+            }
+            lines.resize(n);
+            return n > 0;
+        }
+
+    private:
+        chunked_line_reader(const std::string& filename,
+            bool allow_empty, std::size_t chunk_size)
+            : input_(filename, std::ios::binary)
+            , allow_empty_(allow_empty)
+            , chunk_size_(std::max<std::size_t>(1, chunk_size))
+            , buffer_(chunk_size_)
+            , pos_(0)
+            , end_(0)
+            , skip_line_feed_(false)
+            , finished_(false)
+        {
+        }
+
+        bool fill()
+        {
+            if (!input_) {
+                return false;
+            }
+            input_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            pos_ = 0;
+            end_ = static_cast<std::size_t>(input_.gcount());
+            return end_ > 0;
+        }
+
+        std::ifstream input_;
+        bool allow_empty_;
+        std::size_t chunk_size_;
+        std::vector<char> buffer_;
+        std::size_t pos_;
+        std::size_t end_;
+        bool skip_line_feed_;
+        bool finished_;
+    };
+
+    // The lines of a text file, read on iteration.
+    // Every call to begin() opens the file anew,
+    // so the range can be traversed more than once.
+    // An unreadable file looks like an empty one.
+    class text_file_line_range {
+    public:
+        typedef std::string value_type;
+        typedef std::size_t size_type;
+
+        class const_iterator {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef std::string value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const std::string* pointer;
+            typedef const std::string& reference;
+
+            const_iterator()
+                : reader_()
+                , line_()
+            {
+            }
+            explicit const_iterator(std::shared_ptr<chunked_line_reader> reader)
+                : reader_(std::move(reader))
+                , line_()
+            {
+                ++*this;
+            }
+            const std::string& operator*() const { return line_; }
+            const std::string* operator->() const { return &line_; }
+            const_iterator& operator++()
+            {
+                if (reader_ && !reader_->next(line_)) {
+                    reader_.reset();
+                }
+                return *this;
+            }
+            friend bool operator==(const const_iterator& a, const const_iterator& b)
+            {
+                return a.reader_ == b.reader_;
+            }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b)
+            {
+                return a.reader_ != b.reader_;
+            }
+
+        private:
+            std::shared_ptr<chunked_line_reader> reader_;
+            std::string line_;
+        };
+        typedef const_iterator iterator;
+
+        text_file_line_range(const std::string& filename,
+            bool allow_empty, std::size_t chunk_size)
+            : filename_(filename)
+            , allow_empty_(allow_empty)
+            , chunk_size_(chunk_size)
+        {
+        }
+        const_iterator begin() const
+        {
+            std::shared_ptr<chunked_line_reader> reader = chunked_line_reader::open(filename_, allow_empty_, chunk_size_);
+            return reader ? const_iterator(std::move(reader)) : const_iterator();
+        }
+        const_iterator end() const { return const_iterator(); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    private:
+        std::string filename_;
+        bool allow_empty_;
+        std::size_t chunk_size_;
+    };
+}
+}
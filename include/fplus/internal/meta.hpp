@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <type_traits>
+#include <utility>
 
 namespace fplus {
 namespace internal {
@@ -187,5 +190,18 @@ namespace internal {
 
     template <std::size_t N>
     using make_reverse_index_sequence = make_reverse_integer_sequence<std::size_t, N>;
+
+    // Can T be used as the key of a std::unordered_set,
+    // i.e. is std::hash<T> usable and are values comparable with ==?
+    template <typename T, typename = void>
+    struct is_hashable : std::false_type {
+    };
+
+    template <typename T>
+    struct is_hashable<T,
+        void_t<decltype(std::hash<T>()(std::declval<const T&>())),
+            decltype(std::declval<const T&>() == std::declval<const T&>())>>
+        : std::is_convertible<decltype(std::hash<T>()(std::declval<const T&>())), std::size_t> {
+    };
 }
 }
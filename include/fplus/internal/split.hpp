@@ -7,7 +7,13 @@
 #pragma once
 
 #include <iterator>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 #include <fplus/compare.hpp>
 #include <fplus/container_common.hpp>
@@ -26,5 +32,54 @@ namespace internal {
         };
         return fplus::transform(attach_label, grouped);
     }
+
+#if __cplusplus >= 201703L
+    template <typename T>
+    struct is_string_view : std::false_type {
+    };
+    template <typename CharT, typename Traits>
+    struct is_string_view<std::basic_string_view<CharT, Traits>> : std::true_type {
+    };
+
+    // The *_view splitting functions return views into their input,
+    // so it must outlive the result. Temporary strings are rejected.
+    // String is the deduced type of a forwarding reference.
+    template <typename String>
+    auto as_string_view(const std::remove_reference_t<String>& str)
+    {
+        static_assert(std::is_lvalue_reference<String>::value
+                || is_string_view<std::decay_t<String>>::value,
+            "The result would refer to a temporary string.");
+        typedef std::decay_t<String> Str;
+        return std::basic_string_view<typename Str::value_type,
+            typename Str::traits_type>(str.data(), str.size());
+    }
+
+    // Splits str into the segments between separators,
+    // with the same handling of empty segments as split_by.
+    // find_sep(str, pos) returns the begin and the end
+    // of the first separator at or after pos,
+    // or npos as begin if there is none.
+    template <typename CharT, typename Traits, typename FindSep>
+    std::vector<std::basic_string_view<CharT, Traits>> split_string_view(
+        FindSep find_sep, bool allow_empty,
+        std::basic_string_view<CharT, Traits> str)
+    {
+        typedef std::basic_string_view<CharT, Traits> View;
+        std::vector<View> result;
+        std::size_t start = 0;
+        for (;;) {
+            const std::pair<std::size_t, std::size_t> sep = find_sep(str, start);
+            const std::size_t stop = sep.first == View::npos ? str.size() : sep.first;
+            if (start != stop || allow_empty) {
+                result.push_back(str.substr(start, stop - start));
+            }
+            if (sep.first == View::npos) {
+                return result;
+            }
+            start = sep.second;
+        }
+    }
+#endif
 }
 }
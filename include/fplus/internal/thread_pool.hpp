@@ -0,0 +1,249 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Number of chunks a parallel job over n items is split into,
+    // so that idle workers can pick up the remaining work
+    // when the chunks turn out to be unevenly expensive.
+    inline std::size_t parallel_chunk_count(
+        std::size_t n_items, std::size_t n_workers)
+    {
+        return std::min(n_items, std::max<std::size_t>(1, 4 * n_workers));
+    }
+
+    // First index of chunk idx when splitting n items into n_chunks chunks.
+    // The chunk sizes differ by at most one.
+    inline std::size_t parallel_chunk_begin(
+        std::size_t n_items, std::size_t n_chunks, std::size_t idx)
+    {
+        const std::size_t base = n_items / n_chunks;
+        const std::size_t rest = n_items % n_chunks;
+        return idx * base + std::min(idx, rest);
+    }
+
+    // A fixed set of worker threads, each owning a task queue.
+    // Workers take tasks from the back of their own queue
+    // and steal from the front of the other queues when running dry.
+    // The threads are created once and live as long as the pool.
+    class thread_pool {
+    public:
+        typedef std::function<void()> task;
+
+        explicit thread_pool(std::size_t n_threads)
+            : queues_()
+            , threads_()
+            , wake_mutex_()
+            , wake_cv_()
+            , pending_(0)
+            , next_queue_(0)
+            , stop_(false)
+        {
+            n_threads = std::max<std::size_t>(1, n_threads);
+            for (std::size_t i = 0; i < n_threads; ++i) {
+                queues_.push_back(std::make_unique<task_queue>());
+            }
+            for (std::size_t i = 0; i < n_threads; ++i) {
+                threads_.emplace_back([this, i]() { worker_loop(i); });
+            }
+        }
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stop_ = true;
+            }
+            wake_cv_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        std::size_t size() const
+        {
+            return threads_.size();
+        }
+
+        void submit(task t)
+        {
+            const std::size_t idx = next_queue_.fetch_add(1) % queues_.size();
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                ++pending_;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues_[idx]->mutex);
+                queues_[idx]->tasks.push_back(std::move(t));
+            }
+            wake_cv_.notify_one();
+        }
+
+        // Calls f(i) for every i in [0, n_chunks) and blocks until all
+        // calls are finished. The calling thread works on the chunks too,
+        // so nested use from inside a task can not dead-lock the pool.
+        // The first exception thrown by f is rethrown to the caller.
+        // At most max_helpers pool threads join the calling thread.
+        template <typename F>
+        void run_chunks(std::size_t n_chunks, F f,
+            std::size_t max_helpers = static_cast<std::size_t>(-1))
+        {
+            if (n_chunks == 0) {
+                return;
+            }
+            if (n_chunks == 1) {
+                f(std::size_t(0));
+                return;
+            }
+            const auto job = std::make_shared<chunk_job>(n_chunks);
+            F* f_ptr = &f;
+            const std::size_t n_helpers = std::min(
+                std::min(size(), max_helpers), n_chunks - 1);
+            for (std::size_t i = 0; i < n_helpers; ++i) {
+                submit([job, f_ptr]() { job->work(f_ptr); });
+            }
+            job->work(&f);
+            job->wait();
+            if (job->error) {
+                std::rethrow_exception(job->error);
+            }
+        }
+
+    private:
+        struct task_queue {
+            task_queue()
+                : mutex()
+                , tasks()
+            {
+            }
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+        // Shared state of one run_chunks call.
+        // Helpers that start after all chunks have been claimed
+        // only touch this object, never the (possibly dead) function.
+        struct chunk_job {
+            explicit chunk_job(std::size_t n)
+                : n_chunks(n)
+                , next(0)
+                , done(0)
+                , mutex()
+                , cv()
+                , error()
+            {
+            }
+            template <typename F>
+            void work(F* f)
+            {
+                for (;;) {
+                    const std::size_t idx = next.fetch_add(1);
+                    if (idx >= n_chunks) {
+                        return;
+                    }
+                    try {
+                        (*f)(idx);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    if (done.fetch_add(1) + 1 == n_chunks) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        cv.notify_all();
+                    }
+                }
+            }
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]() { return done.load() == n_chunks; });
+            }
+            const std::size_t n_chunks;
+            std::atomic<std::size_t> next;
+            std::atomic<std::size_t> done;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::exception_ptr error;
+        };
+
+        bool pop_or_steal(std::size_t idx, task& t)
+        {
+            {
+                task_queue& own = *queues_[idx];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    t = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t i = 1; i < queues_.size(); ++i) {
+                task_queue& other = *queues_[(idx + i) % queues_.size()];
+                std::lock_guard<std::mutex> lock(other.mutex);
+                if (!other.tasks.empty()) {
+                    t = std::move(other.tasks.front());
+                    other.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void worker_loop(std::size_t idx)
+        {
+            for (;;) {
+                task t;
+                if (pop_or_steal(idx, t)) {
+                    --pending_;
+                    t();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_cv_.wait(lock, [this]() {
+                    return stop_ || pending_.load() > 0;
+                });
+                if (stop_ && pending_.load() == 0) {
+                    return;
+                }
+            }
+        }
+
+        std::vector<std::unique_ptr<task_queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex wake_mutex_;
+        std::condition_variable wake_cv_;
+        std::atomic<std::size_t> pending_;
+        std::atomic<std::size_t> next_queue_;
+        bool stop_;
+    };
+
+    // The process-wide pool used by the *_parallelly functions.
+    // Its threads are started on first use and joined at program exit.
+    inline thread_pool& default_thread_pool()
+    {
+        static thread_pool pool(std::thread::hardware_concurrency());
+        return pool;
+    }
+}
+}
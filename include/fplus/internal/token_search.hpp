@@ -0,0 +1,366 @@
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#pragma once
+
+#include <fplus/internal/meta.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Containers storing their elements contiguously, e.g. std::vector,
+    // std::string and std::array, but not std::vector<bool>.
+    template <typename Container, typename = void>
+    struct has_contiguous_data : std::false_type {
+    };
+    template <typename Container>
+    struct has_contiguous_data<Container,
+        void_t<decltype(std::declval<const Container&>().data())>>
+        : std::is_same<decltype(std::declval<const Container&>().data()),
+              const typename Container::value_type*> {
+    };
+
+    // Elements that can be compared with memchr and memcmp.
+    template <typename T>
+    struct is_byte_like
+        : std::integral_constant<bool,
+              std::is_integral<T>::value && sizeof(T) == 1
+                  && !std::is_same<T, bool>::value> {
+    };
+
+    // Elements whose operator< is a strict total order consistent with ==.
+    template <typename T>
+    struct is_totally_ordered
+        : std::integral_constant<bool,
+              std::is_integral<T>::value || std::is_enum<T>::value> {
+    };
+
+    enum class token_search_strategy {
+        empty,
+        byte_scan,
+        byte_horspool,
+        two_way,
+        hashed_horspool,
+        naive
+    };
+
+    // Byte tokens from this length on use Boyer-Moore-Horspool,
+    // shorter ones are found by memchr-ing their first element.
+    constexpr std::size_t byte_horspool_min_token_size = 4;
+
+    // Finds all (possibly overlapping) occurrences of a token
+    // in contiguous sequences of elements.
+    // The algorithm is chosen once on construction:
+    //  - bytes: memchr for short tokens, Boyer-Moore-Horspool for longer ones
+    //  - other integral and enum types: Two-Way (O(n), constant space)
+    //  - other hashable types: Boyer-Moore-Horspool with a hashed shift table
+    //  - everything else: comparison at every offset (O(n*m))
+    template <typename T>
+    class token_search_engine {
+    public:
+        explicit token_search_engine(std::vector<T> token)
+            : token_(std::move(token))
+            , strategy_(select_strategy(token_.size()))
+            , byte_shifts_()
+            , hashed_shifts_()
+            , suffix_(0)
+            , period_(0)
+            , is_periodic_(false)
+        {
+            prepare(strategy_tag<T>());
+        }
+
+        const std::vector<T>& token() const { return token_; }
+        token_search_strategy strategy() const { return strategy_; }
+
+        // Calls on_match(idx) for every occurrence of the token in xs,
+        // in ascending order, as long as on_match returns true.
+        template <typename F>
+        void for_each_match(const T* xs, std::size_t n, F on_match) const
+        {
+            const std::size_t m = token_.size();
+            if (m > n) {
+                return;
+            }
+            switch (strategy_) {
+            case token_search_strategy::empty:
+                for (std::size_t j = 0; j <= n; ++j) {
+                    if (!on_match(j)) {
+                        return;
+                    }
+                }
+                return;
+            case token_search_strategy::byte_scan:
+                return byte_scan(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::byte_horspool:
+                return byte_horspool(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::two_way:
+                return two_way(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::hashed_horspool:
+                return hashed_horspool(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::naive:
+                break;
+            }
+            for (std::size_t j = 0; j <= n - m; ++j) {
+                if (std::equal(xs + j, xs + j + m, token_.data()) && !on_match(j)) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        struct byte_tag {
+        };
+        struct ordered_tag {
+        };
+        struct hashed_tag {
+        };
+        struct generic_tag {
+        };
+        template <typename U>
+        using strategy_tag = std::conditional_t<is_byte_like<U>::value, byte_tag,
+            std::conditional_t<is_totally_ordered<U>::value, ordered_tag,
+                std::conditional_t<is_hashable<U>::value, hashed_tag, generic_tag>>>;
+
+        static token_search_strategy select_strategy(std::size_t m)
+        {
+            if (m == 0) {
+                return token_search_strategy::empty;
+            }
+            if (std::is_same<strategy_tag<T>, byte_tag>::value) {
+                return m < byte_horspool_min_token_size
+                    ? token_search_strategy::byte_scan
+                    : token_search_strategy::byte_horspool;
+            }
+            if (std::is_same<strategy_tag<T>, ordered_tag>::value) {
+                return token_search_strategy::two_way;
+            }
+            if (std::is_same<strategy_tag<T>, hashed_tag>::value) {
+                return m == 1 ? token_search_strategy::naive
+                              : token_search_strategy::hashed_horspool;
+            }
+            return token_search_strategy::naive;
+        }
+
+        static unsigned char to_byte(T x)
+        {
+            return static_cast<unsigned char>(x);
+        }
+
+        void prepare(byte_tag)
+        {
+            if (strategy_ != token_search_strategy::byte_horspool) {
+                return;
+            }
+            const std::size_t m = token_.size();
+            byte_shifts_.fill(m);
+            for (std::size_t i = 0; i + 1 < m; ++i) {
+                byte_shifts_[to_byte(token_[i])] = m - 1 - i;
+            }
+        }
+
+        void prepare(ordered_tag)
+        {
+            if (strategy_ != token_search_strategy::two_way) {
+                return;
+            }
+            const std::size_t m = token_.size();
+            suffix_ = critical_factorization(period_);
+            is_periodic_ = period_ + suffix_ <= m
+                && std::equal(token_.data(), token_.data() + suffix_,
+                    token_.data() + period_);
+            if (!is_periodic_) {
+                period_ = std::max(suffix_, m - suffix_) + 1;
+            }
+        }
+
+        void prepare(hashed_tag)
+        {
+            if (strategy_ != token_search_strategy::hashed_horspool) {
+                return;
+            }
+            const std::size_t m = token_.size();
+            for (std::size_t i = 0; i + 1 < m; ++i) {
+                hashed_shifts_[token_[i]] = m - 1 - i;
+            }
+        }
+
+        void prepare(generic_tag)
+        {
+        }
+
+        template <typename F>
+        void byte_scan(const T* xs, std::size_t n, F on_match, byte_tag) const
+        {
+            const std::size_t m = token_.size();
+            const std::size_t last = n - m;
+            std::size_t j = 0;
+            while (j <= last) {
+                const void* const found = std::memchr(xs + j, to_byte(token_[0]), last - j + 1);
+                if (found == nullptr) {
+                    return;
+                }
+                j = static_cast<std::size_t>(static_cast<const T*>(found) - xs);
+                if (std::memcmp(xs + j + 1, token_.data() + 1, m - 1) == 0 && !on_match(j)) {
+                    return;
+                }
+                ++j;
+            }
+        }
+
+        template <typename F>
+        void byte_horspool(const T* xs, std::size_t n, F on_match, byte_tag) const
+        {
+            const std::size_t m = token_.size();
+            const T token_last = token_[m - 1];
+            for (std::size_t j = 0; j <= n - m;) {
+                const T x = xs[j + m - 1];
+                if (x == token_last
+                    && std::memcmp(xs + j, token_.data(), m - 1) == 0
+                    && !on_match(j)) {
+                    return;
+                }
+                j += byte_shifts_[to_byte(x)];
+            }
+        }
+
+        // Splits the token into u and v = token[suffix..] such that
+        // the local period at the split equals the period of the token.
+        // Returns the position of the split and sets period
+        // to the period of v.
+        // See Crochemore & Perrin, "Two-way string-matching", 1991.
+        std::size_t critical_factorization(std::size_t& period) const
+        {
+            const std::size_t m = token_.size();
+            const std::size_t none = std::numeric_limits<std::size_t>::max();
+            const auto max_suffix = [&](bool reversed, std::size_t& p) {
+                // Index arithmetic wraps around on purpose: ms + k == k - 1
+                // as long as no maximal suffix has been found yet.
+                std::size_t ms = none;
+                std::size_t j = 0;
+                std::size_t k = 1;
+                p = 1;
+                while (j + k < m) {
+                    const T& a = token_[j + k];
+                    const T& b = token_[ms + k];
+                    if (reversed ? b < a : a < b) {
+                        j += k;
+                        k = 1;
+                        p = j - ms;
+                    } else if (a == b) {
+                        if (k != p) {
+                            ++k;
+                        } else {
+                            j += p;
+                            k = 1;
+                        }
+                    } else {
+                        ms = j++;
+                        k = 1;
+                        p = 1;
+                    }
+                }
+                return ms + 1;
+            };
+            std::size_t p = 1;
+            std::size_t p_rev = 1;
+            const std::size_t suffix = max_suffix(false, p);
+            const std::size_t suffix_rev = max_suffix(true, p_rev);
+            if (suffix_rev < suffix) {
+                period = p;
+                return suffix;
+            }
+            period = p_rev;
+            return suffix_rev;
+        }
+
+        template <typename F>
+        void two_way(const T* xs, std::size_t n, F on_match, ordered_tag) const
+        {
+            const std::size_t m = token_.size();
+            const T* const token = token_.data();
+            // Number of token elements known to match
+            // at the start of the current window (periodic tokens only).
+            std::size_t memory = 0;
+            for (std::size_t j = 0; j <= n - m;) {
+                std::size_t i = std::max(suffix_, memory);
+                while (i < m && token[i] == xs[i + j]) {
+                    ++i;
+                }
+                if (i < m) {
+                    j += i - suffix_ + 1;
+                    memory = 0;
+                    continue;
+                }
+                i = suffix_;
+                while (i > memory && token[i - 1] == xs[i - 1 + j]) {
+                    --i;
+                }
+                if (i <= memory && !on_match(j)) {
+                    return;
+                }
+                // Two occurrences are at least one period apart.
+                j += period_;
+                memory = is_periodic_ ? m - period_ : 0;
+            }
+        }
+
+        template <typename F>
+        void hashed_horspool(const T* xs, std::size_t n, F on_match, hashed_tag) const
+        {
+            const std::size_t m = token_.size();
+            const T& token_last = token_[m - 1];
+            for (std::size_t j = 0; j <= n - m;) {
+                const T& x = xs[j + m - 1];
+                if (x == token_last
+                    && std::equal(xs + j, xs + j + m - 1, token_.data())
+                    && !on_match(j)) {
+                    return;
+                }
+                const auto it = hashed_shifts_.find(x);
+                j += it == hashed_shifts_.end() ? m : it->second;
+            }
+        }
+
+        template <typename F, typename Tag>
+        void byte_scan(const T*, std::size_t, F, Tag) const
+        {
+        }
+        template <typename F, typename Tag>
+        void byte_horspool(const T*, std::size_t, F, Tag) const
+        {
+        }
+        template <typename F, typename Tag>
+        void two_way(const T*, std::size_t, F, Tag) const
+        {
+        }
+        template <typename F, typename Tag>
+        void hashed_horspool(const T*, std::size_t, F, Tag) const
+        {
+        }
+
+        std::vector<T> token_;
+        token_search_strategy strategy_;
+        std::array<std::size_t, 256> byte_shifts_;
+        std::conditional_t<is_hashable<T>::value,
+            std::unordered_map<T, std::size_t>, generic_tag>
+            hashed_shifts_;
+        std::size_t suffix_;
+        std::size_t period_;
+        bool is_periodic_;
+    };
+}
+}
@@ -9,8 +9,17 @@
 #include <fplus/maybe.hpp>
 #include <fplus/result.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
 
 namespace fplus {
 
@@ -110,27 +119,114 @@ namespace internal {
             result = str;
         }
     };
+
+    // The fast paths below parse [first, last) completely,
+    // without allocations, exceptions or locale lookups.
+    // They only accept the plain notation ("-42", "4.2e1"),
+    // and return false for everything else,
+    // including subnormal floating-point values,
+    // which std::from_chars accepts but std::sto* rejects.
+    // The lenient std::sto* functions then decide,
+    // so the set of accepted inputs does not change.
+
+    template <typename T>
+    bool read_value_fast(const char* first, const char* last,
+        T& result, std::true_type /* is_integral */)
+    {
+#if __cplusplus >= 201703L
+        const auto parsed = std::from_chars(first, last, result);
+        return parsed.ec == std::errc() && parsed.ptr == last;
+#else
+        typedef std::make_unsigned_t<T> U;
+        const bool negative = first != last && *first == '-';
+        if (negative) {
+            if (!std::is_signed<T>::value) {
+                return false;
+            }
+            ++first;
+        }
+        if (first == last) {
+            return false;
+        }
+        const U max_value = static_cast<U>(std::numeric_limits<T>::max());
+        const U limit = negative ? static_cast<U>(max_value + 1) : max_value;
+        U value = 0;
+        for (; first != last; ++first) {
+            const U digit = static_cast<U>(static_cast<unsigned char>(*first) - '0');
+            if (digit > 9 || value > (limit - digit) / 10) {
+                return false;
+            }
+            value = static_cast<U>(value * 10 + digit);
+        }
+        result = negative
+            ? static_cast<T>(-static_cast<T>(value - 1) - 1)
+            : static_cast<T>(value);
+        return true;
+#endif
+    }
+
+    template <typename T>
+    bool read_value_fast(const char* first, const char* last,
+        T& result, std::false_type /* is_integral */)
+    {
+#if defined(__cpp_lib_to_chars)
+        if (std::is_floating_point<T>::value) {
+            const auto parsed = std::from_chars(first, last, result);
+            return parsed.ec == std::errc() && parsed.ptr == last
+                && std::fpclassify(result) != FP_SUBNORMAL;
+        }
+#endif
+        (void)first;
+        (void)last;
+        (void)result;
+        return false;
+    }
+
+    inline bool read_value_fast(const char*, const char*,
+        std::string&, std::false_type)
+    {
+        return false;
+    }
+
+    template <typename T>
+    bool read_value_fast(const char* first, const char* last, T& result)
+    {
+        return read_value_fast(first, last, result,
+            std::integral_constant<bool,
+                std::is_integral<T>::value && !std::is_same<T, bool>::value>());
+    }
+
+    template <typename T>
+    result<T, std::string> read_value_result_slow(const std::string& str)
+    {
+        try {
+            T result;
+            std::size_t num_chars_used = 0;
+            internal::helper_read_value_struct<T>::read(str,
+                result, num_chars_used);
+            if (num_chars_used != str.size()) {
+                return error<T>(std::string("String not fully parsable."));
+            }
+            return ok<T, std::string>(result);
+        } catch (const std::invalid_argument& e) {
+            return error<T, std::string>(e.what());
+        } catch (const std::out_of_range& e) {
+            return error<T, std::string>(e.what());
+        }
+    }
 }
 
 // API search type: read_value_result : String -> Result a
 // Try to deserialize a value.
+// Plain numbers are parsed without the overhead of std::stoi etc.
 template <typename T>
 result<T, std::string> read_value_result(const std::string& str)
 {
-    try {
-        T result;
-        std::size_t num_chars_used = 0;
-        internal::helper_read_value_struct<T>::read(str,
-            result, num_chars_used);
-        if (num_chars_used != str.size()) {
-            return error<T>(std::string("String not fully parsable."));
-        }
+    T result;
+    if (internal::read_value_fast(str.data(), str.data() + str.size(), result)) {
         return ok<T, std::string>(result);
-    } catch (const std::invalid_argument& e) {
-        return error<T, std::string>(e.what());
-    } catch (const std::out_of_range& e) {
-        return error<T, std::string>(e.what());
     }
+    return internal::read_value_result_slow<T>(str);
 }
 
 // API search type: read_value : String -> Maybe a
@@ -178,4 +274,39 @@ T read_value_unsafe(const std::string& str)
     return unsafe_get_just(to_maybe(read_value_result<T>(str)));
 }
 
+// API search type: read_values : (Char, String) -> Result [a] String
+// Deserializes all fields of a delimited buffer, e.g. a column of numbers.
+// The fields are parsed in place, without creating a string for each one.
+// A delimiter at the very end of the buffer is ignored,
+// so newline-terminated lines can be parsed directly.
+// If a field can not be parsed, the error names its index.
+// read_values<int>(',', "1,2,3") == Ok [1,2,3]
+// read_values<int>('\n', "1\n2\n") == Ok [1,2]
+// read_values<int>(',', "1,x,3") == Error "Field 1: ..."
+template <typename T>
+result<std::vector<T>, std::string> read_values(char delimiter, const std::string& str)
+{
+    const char* first = str.data();
+    const char* const last = str.data() + str.size();
+    std::vector<T> values;
+    values.reserve(static_cast<std::size_t>(std::count(first, last, delimiter)) + 1);
+    while (first != last) {
+        const char* const field_end = std::find(first, last, delimiter);
+        T value;
+        if (internal::read_value_fast(first, field_end, value)) {
+            values.push_back(value);
+        } else {
+            const auto slow_result = internal::read_value_result_slow<T>(
+                std::string(first, field_end));
+            if (is_error(slow_result)) {
+                return error<std::vector<T>, std::string>(
+                    "Field " + std::to_string(values.size()) + ": " + unsafe_get_error(slow_result));
+            }
+            values.push_back(unsafe_get_ok(slow_result));
+        }
+        first = field_end == last ? last : field_end + 1;
+    }
+    return ok<std::vector<T>, std::string>(std::move(values));
+}
+
 } // namespace fplus
@@ -8,8 +8,14 @@
 
 #include <fplus/compare.hpp>
 #include <fplus/container_common.hpp>
+#include <fplus/search.hpp>
 #include <fplus/split.hpp>
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
 namespace fplus {
 
 namespace internal {
@@ -110,4 +116,76 @@ Container replace_tokens(const Container& source, const Container& dest, const C
     return join(dest, splitted);
 }
 
+// API search type: replace_tokens_many : ([[a]], [[a]], [a]) -> [a]
+// fwd bind count: 2
+// Replace all segments matching one of the sources
+// with the dest of the same index, scanning only once.
+// Of overlapping matches, the one starting first wins,
+// and of those starting at the same position, the longest one.
+// Empty sources are ignored.
+// sources and dests must have the same size.
+// replace_tokens_many(["haha", "h"], ["hihi", "H"], "oh, hahaha!")
+// == "oH, hihiHa!"
+// O(n + k), where k is the number of matches,
+// plus the time to compile the sources.
+template <typename ContainerTokens, typename Container>
+Container replace_tokens_many(const ContainerTokens& sources,
+    const ContainerTokens& dests, const Container& xs)
+{
+    return replace_tokens_many(compiled_tokens<Container>(sources), dests, xs);
+}
+
+// Overload of replace_tokens_many for compiled sources.
+template <typename ContainerTokens, typename Container>
+Container replace_tokens_many(const compiled_tokens<Container>& sources,
+    const ContainerTokens& dests, const Container& xs)
+{
+    assert(size_of_cont(dests) == sources.size());
+    const std::size_t n = size_of_cont(xs);
+    // For every position, the index of the longest source starting there.
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> longest(n, none);
+    sources.for_each_match(xs, [&](std::size_t idx, std::size_t token_idx) {
+        if (longest[idx] == none
+            || sources.token_size(longest[idx]) < sources.token_size(token_idx)) {
+            longest[idx] = token_idx;
+        }
+    });
+
+    std::vector<typename ContainerTokens::const_iterator> dest_its;
+    dest_its.reserve(sources.size());
+    for (auto it = std::begin(dests); it != std::end(dests); ++it) {
+        dest_its.push_back(it);
+    }
+    std::size_t result_size = 0;
+    for (std::size_t idx = 0; idx < n;) {
+        if (longest[idx] == none) {
+            ++result_size;
+            ++idx;
+        } else {
+            result_size += size_of_cont(*dest_its[longest[idx]]);
+            idx += sources.token_size(longest[idx]);
+        }
+    }
+
+    Container result;
+    internal::prepare_container(result, result_size);
+    auto itOut = internal::get_back_inserter(result);
+    std::size_t skip = 0;
+    std::size_t idx = 0;
+    for (const auto& x : xs) {
+        if (skip > 0) {
+            --skip;
+        } else if (longest[idx] == none) {
+            *itOut = x;
+        } else {
+            const auto& dest = *dest_its[longest[idx]];
+            itOut = std::copy(std::begin(dest), std::end(dest), itOut);
+            skip = sources.token_size(longest[idx]) - 1;
+        }
+        ++idx;
+    }
+    return result;
+}
+
 } // namespace fplus
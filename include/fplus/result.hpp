@@ -14,8 +14,12 @@
 #include <fplus/internal/invoke.hpp>
 
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace fplus {
 
@@ -23,61 +27,199 @@ template <typename Ok, typename Error>
 class result;
 
 template <typename Ok, typename Error>
-result<Ok, Error> ok(const Ok& val);
+result<Ok, Error> ok(Ok val);
 
 template <typename Ok, typename Error>
 result<Ok, Error> error(const Error& error);
 
+namespace internal {
+
+    struct result_ok_tag {
+    };
+    struct result_error_tag {
+    };
+
+    // Holds an Ok or an Error in place, discriminated by is_ok_.
+    template <typename Ok, typename Error>
+    class result_storage_base {
+    public:
+        bool is_ok() const { return is_ok_; }
+        const Ok& ok_value() const
+        {
+            return *reinterpret_cast<const Ok*>(&value_);
+        }
+        const Error& error_value() const
+        {
+            return *reinterpret_cast<const Error*>(&value_);
+        }
+
+    protected:
+        result_storage_base(result_ok_tag, const Ok& val)
+            : is_ok_(true)
+            , value_()
+        {
+            new (&value_) Ok(val);
+        }
+        result_storage_base(result_ok_tag, Ok&& val)
+            : is_ok_(true)
+            , value_()
+        {
+            new (&value_) Ok(std::move(val));
+        }
+        result_storage_base(result_error_tag, const Error& err)
+            : is_ok_(false)
+            , value_()
+        {
+            new (&value_) Error(err);
+        }
+        explicit result_storage_base(bool is_ok)
+            : is_ok_(is_ok)
+            , value_()
+        {
+        }
+        Ok& ok_value()
+        {
+            return *reinterpret_cast<Ok*>(&value_);
+        }
+        Error& error_value()
+        {
+            return *reinterpret_cast<Error*>(&value_);
+        }
+        void copy_content(const result_storage_base& other)
+        {
+            is_ok_ = other.is_ok_;
+            if (is_ok_)
+                new (&value_) Ok(other.ok_value());
+            else
+                new (&value_) Error(other.error_value());
+        }
+        void move_content(result_storage_base&& other)
+        {
+            is_ok_ = other.is_ok_;
+            if (is_ok_)
+                new (&value_) Ok(std::move(other.ok_value()));
+            else
+                new (&value_) Error(std::move(other.error_value()));
+        }
+        void destruct_content()
+        {
+            if (is_ok_)
+                ok_value().~Ok();
+            else
+                error_value().~Error();
+        }
+        // No content would be left if the move threw after the old
+        // content has been destroyed, so this terminates instead.
+        void replace_content(result_storage_base&& other) noexcept
+        {
+            destruct_content();
+            move_content(std::move(other));
+        }
+        bool is_ok_;
+        static constexpr std::size_t value_size = sizeof(Ok) > sizeof(Error) ? sizeof(Ok) : sizeof(Error);
+        static constexpr std::size_t value_align = alignof(Ok) > alignof(Error) ? alignof(Ok) : alignof(Error);
+        typename std::aligned_storage<value_size, value_align>::type value_;
+    };
+
+    template <typename Ok, typename Error,
+        bool IsTriviallyCopyable = std::is_trivially_copyable<Ok>::value
+            && std::is_trivially_copyable<Error>::value>
+    class result_storage;
+
+    // Trivially copyable alternatives are copied bytewise,
+    // so the whole result is trivially copyable too.
+    template <typename Ok, typename Error>
+    class result_storage<Ok, Error, true>
+        : public result_storage_base<Ok, Error> {
+    public:
+        template <typename Tag, typename T>
+        result_storage(Tag tag, T&& val)
+            : result_storage_base<Ok, Error>(tag, std::forward<T>(val))
+        {
+        }
+    };
+
+    template <typename Ok, typename Error>
+    class result_storage<Ok, Error, false>
+        : public result_storage_base<Ok, Error> {
+        static constexpr bool is_nothrow_movable = std::is_nothrow_move_constructible<Ok>::value
+            && std::is_nothrow_move_constructible<Error>::value;
+
+    public:
+        template <typename Tag, typename T>
+        result_storage(Tag tag, T&& val)
+            : result_storage_base<Ok, Error>(tag, std::forward<T>(val))
+        {
+        }
+        result_storage(const result_storage& other)
+            : result_storage_base<Ok, Error>(other.is_ok_)
+        {
+            this->copy_content(other);
+        }
+        result_storage(result_storage&& other) noexcept(is_nothrow_movable)
+            : result_storage_base<Ok, Error>(other.is_ok_)
+        {
+            this->move_content(std::move(other));
+        }
+        // The new content is built in a temporary first,
+        // so a throwing copy leaves *this unchanged.
+        result_storage& operator=(const result_storage& other)
+        {
+            if (this != &other) {
+                result_storage tmp(other);
+                this->replace_content(std::move(tmp));
+            }
+            return *this;
+        }
+        result_storage& operator=(result_storage&& other) noexcept(is_nothrow_movable)
+        {
+            if (this != &other) {
+                if (is_nothrow_movable) {
+                    this->replace_content(std::move(other));
+                } else {
+                    result_storage tmp(std::move(other));
+                    this->replace_content(std::move(tmp));
+                }
+            }
+            return *this;
+        }
+        ~result_storage()
+        {
+            this->destruct_content();
+        }
+    };
+}
+
 // Can hold a value of type Ok or an error of type Error.
+// The value is stored in place, so no heap allocation is involved,
+// and the result is trivially copyable if Ok and Error are.
 template <typename Ok, typename Error>
 class result {
 public:
-    bool is_ok() const { return static_cast<bool>(ptr_ok_); }
-    bool is_error() const { return static_cast<bool>(ptr_error_); }
+    bool is_ok() const { return storage_.is_ok(); }
+    bool is_error() const { return !is_ok(); }
     const Ok& unsafe_get_ok() const
     {
-        check_either_or_invariant();
         assert(is_ok());
-        return *ptr_ok_;
+        return storage_.ok_value();
     }
     const Error& unsafe_get_error() const
     {
-        check_either_or_invariant();
         assert(is_error());
-        return *ptr_error_;
+        return storage_.error_value();
     }
     typedef Ok ok_t;
     typedef Error error_t;
 
-    result(const result<Ok, Error>& other)
-        : ptr_ok_(other.is_ok() ? ptr_ok(new Ok(other.unsafe_get_ok())) : ptr_ok())
-        , ptr_error_(other.is_error() ? ptr_error(new Error(other.unsafe_get_error())) : ptr_error())
-    {
-        check_either_or_invariant();
-    }
-    result<Ok, Error>& operator=(const result<Ok, Error>& other)
-    {
-        ptr_ok_ = other.is_ok() ? ptr_ok(new Ok(other.unsafe_get_ok())) : ptr_ok();
-        ptr_error_ = other.is_error() ? ptr_error(new Error(other.unsafe_get_error())) : ptr_error();
-        return *this;
-    }
-
 private:
-    void check_either_or_invariant() const
-    {
-        assert(is_ok() != is_error());
-    }
-    result()
-        : ptr_ok_(ptr_ok())
-        , ptr_error_(ptr_error())
+    template <typename Tag, typename T>
+    result(Tag tag, T&& val)
+        : storage_(tag, std::forward<T>(val))
     {
     }
-    typedef std::unique_ptr<Ok> ptr_ok;
-    typedef std::unique_ptr<Error> ptr_error;
-    friend result<Ok, Error> ok<Ok, Error>(const Ok& ok);
+    friend result<Ok, Error> ok<Ok, Error>(Ok ok);
     friend result<Ok, Error> error<Ok, Error>(const Error& error);
-    ptr_ok ptr_ok_;
-    ptr_error ptr_error_;
+    internal::result_storage<Ok, Error> storage_;
 };
 
 // API search type: is_ok : Result a b -> Bool
@@ -130,12 +272,11 @@ Ok ok_with_default(const Ok& defaultValue, const result<Ok, Error>& result)
 // API search type: ok : a -> Result a b
 // fwd bind count: 0
 // Wrap a value in a result as a Ok.
+// The value is moved into the result.
 template <typename Ok, typename Error>
-result<Ok, Error> ok(const Ok& val)
+result<Ok, Error> ok(Ok val)
 {
-    result<Ok, Error> x;
-    x.ptr_ok_.reset(new Ok(val));
-    return x;
+    return result<Ok, Error>(internal::result_ok_tag(), std::move(val));
 }
 
 // API search type: error : b -> Result a b
@@ -144,9 +285,7 @@ result<Ok, Error> ok(const Ok& val)
 template <typename Ok, typename Error>
 result<Ok, Error> error(const Error& error)
 {
-    result<Ok, Error> x;
-    x.ptr_error_.reset(new Error(error));
-    return x;
+    return result<Ok, Error>(internal::result_error_tag(), error);
 }
 
 // API search type: to_maybe : Result a b -> Maybe a
@@ -11,7 +11,12 @@
 #include <fplus/generate.hpp>
 #include <fplus/maybe.hpp>
 
+#include <fplus/internal/aho_corasick.hpp>
+#include <fplus/internal/token_search.hpp>
+
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace fplus {
 
@@ -128,36 +133,104 @@ ContainerOut find_all_idxs_of(const T& x, const Container& xs)
     return find_all_idxs_by(is_equal_to(x), xs);
 }
 
+// A token prepared for being searched in containers.
+// The search algorithm and its tables are set up once on construction,
+// so the same token can be looked for in many containers cheaply.
+// Containers storing their elements contiguously
+// (std::vector, std::string, std::array, ...) are searched
+// with memchr or Boyer-Moore-Horspool for bytes,
+// Two-Way for other integral types,
+// and Boyer-Moore-Horspool with a hashed shift table for other hashable types.
+// Everything else is compared at every offset.
+template <typename Container>
+class compiled_token {
+public:
+    typedef typename Container::value_type value_type;
+
+    explicit compiled_token(const Container& token)
+        : token_(token)
+        , engine_(std::vector<value_type>(std::begin(token), std::end(token)))
+    {
+    }
+    const Container& token() const { return token_; }
+    std::size_t size() const { return engine_.token().size(); }
+
+    // Calls on_match(idx) for every (possibly overlapping) occurrence
+    // of the token in xs, in ascending order, as long as on_match returns true.
+    template <typename F>
+    void for_each_match(const Container& xs, F on_match) const
+    {
+        for_each_match(internal::has_contiguous_data<Container>(), xs, on_match);
+    }
+
+private:
+    template <typename F>
+    void for_each_match(std::true_type, const Container& xs, F on_match) const
+    {
+        engine_.for_each_match(xs.data(), size_of_cont(xs), on_match);
+    }
+
+    template <typename F>
+    void for_each_match(std::false_type, const Container& xs, F on_match) const
+    {
+        const std::size_t m = size();
+        const std::size_t n = size_of_cont(xs);
+        if (m > n)
+            return;
+        auto itInBegin = std::begin(xs);
+        auto itInEnd = itInBegin;
+        internal::advance_iterator(itInEnd, m);
+        for (std::size_t idx = 0;; ++idx) {
+            if (std::equal(itInBegin, itInEnd, std::begin(token_)) && !on_match(idx))
+                return;
+            if (idx == n - m)
+                return;
+            ++itInBegin;
+            ++itInEnd;
+        }
+    }
+
+    Container token_;
+    internal::token_search_engine<value_type> engine_;
+};
+
+// API search type: compile_token : [a] -> CompiledToken a
+// fwd bind count: 0
+// Prepares a token for being searched in many containers.
+// The result can be passed to find_all_instances_of_token,
+// find_all_instances_of_token_non_overlapping
+// and find_first_instance_of_token instead of the token itself.
+template <typename Container>
+compiled_token<Container> compile_token(const Container& token)
+{
+    return compiled_token<Container>(token);
+}
+
 // API search type: find_all_instances_of_token : ([a], [a]) -> [Int]
 // fwd bind count: 1
 // Returns the starting indices of all segments matching token.
 // find_all_instances_of_token("haha", "oh, hahaha!") == [4, 6]
+// O(n) for contiguous containers of integral types,
+// see compiled_token for details.
 template <typename ContainerOut = std::vector<std::size_t>, typename Container>
 ContainerOut find_all_instances_of_token(const Container& token,
     const Container& xs)
 {
-    if (size_of_cont(token) > size_of_cont(xs))
-        return ContainerOut();
+    return find_all_instances_of_token<ContainerOut>(
+        compiled_token<Container>(token), xs);
+}
 
-    auto itInBegin = std::begin(xs);
-    auto itInEnd = itInBegin;
-    internal::advance_iterator(itInEnd, size_of_cont(token));
-    std::size_t idx = 0;
+// Overload of find_all_instances_of_token for compiled tokens.
+template <typename ContainerOut = std::vector<std::size_t>, typename Container>
+ContainerOut find_all_instances_of_token(
+    const compiled_token<Container>& token, const Container& xs)
+{
     ContainerOut result;
     auto outIt = internal::get_back_inserter(result);
-    std::size_t last_possible_idx = size_of_cont(xs) - size_of_cont(token);
-    auto check_and_push = [&]() {
-        if (std::equal(itInBegin, itInEnd, std::begin(token))) {
-            *outIt = idx;
-        }
-    };
-    while (idx != last_possible_idx) {
-        check_and_push();
-        ++itInBegin;
-        ++itInEnd;
-        ++idx;
-    }
-    check_and_push();
+    token.for_each_match(xs, [&](std::size_t idx) {
+        *outIt = idx;
+        return true;
+    });
     return result;
 }
 
@@ -169,16 +242,28 @@ ContainerOut find_all_instances_of_token(const Container& token,
 template <typename ContainerOut = std::vector<std::size_t>, typename Container>
 ContainerOut find_all_instances_of_token_non_overlapping(const Container& token, const Container& xs)
 {
-    auto overlapping_instances = find_all_instances_of_token<ContainerOut>(
-        token, xs);
+    return find_all_instances_of_token_non_overlapping<ContainerOut>(
+        compiled_token<Container>(token), xs);
+}
+
+// Overload of find_all_instances_of_token_non_overlapping for compiled tokens.
+template <typename ContainerOut = std::vector<std::size_t>, typename Container>
+ContainerOut find_all_instances_of_token_non_overlapping(
+    const compiled_token<Container>& token, const Container& xs)
+{
     ContainerOut result;
     auto outIt = internal::get_back_inserter(result);
-    std::size_t token_size = size_of_cont(token);
-    for (const auto idx : overlapping_instances) {
-        if (result.empty() || result.back() + token_size <= idx) {
+    const std::size_t token_size = token.size();
+    bool found = false;
+    std::size_t next_possible_idx = 0;
+    token.for_each_match(xs, [&](std::size_t idx) {
+        if (!found || next_possible_idx <= idx) {
             *outIt = idx;
+            found = true;
+            next_possible_idx = idx + token_size;
         }
-    }
+        return true;
+    });
     return result;
 }
 
@@ -189,26 +274,108 @@ ContainerOut find_all_instances_of_token_non_overlapping(const Container& token,
 template <typename Container>
 maybe<std::size_t> find_first_instance_of_token(const Container& token, const Container& xs)
 {
-    if (size_of_cont(token) > size_of_cont(xs))
-        return nothing<std::size_t>();
+    return find_first_instance_of_token(compiled_token<Container>(token), xs);
+}
 
-    auto itInBegin = std::begin(xs);
-    auto itInEnd = itInBegin;
-    internal::advance_iterator(itInEnd, size_of_cont(token));
-    std::size_t idx = 0;
-    std::size_t last_possible_idx = size_of_cont(xs) - size_of_cont(token);
-    while (idx != last_possible_idx) {
-        if (std::equal(itInBegin, itInEnd, std::begin(token))) {
-            return just(idx);
-        }
-        ++itInBegin;
-        ++itInEnd;
-        ++idx;
+// Overload of find_first_instance_of_token for compiled tokens.
+template <typename Container>
+maybe<std::size_t> find_first_instance_of_token(
+    const compiled_token<Container>& token, const Container& xs)
+{
+    maybe<std::size_t> result;
+    token.for_each_match(xs, [&](std::size_t idx) {
+        result = just(idx);
+        return false;
+    });
+    return result;
+}
+
+// Many tokens prepared for being searched in containers at once.
+// They are compiled into an Aho-Corasick automaton,
+// which finds all occurrences of all tokens
+// in a single pass over a container.
+// Empty tokens never match.
+template <typename Container>
+class compiled_tokens {
+public:
+    typedef typename Container::value_type value_type;
+
+    template <typename ContainerTokens>
+    explicit compiled_tokens(const ContainerTokens& tokens)
+        : automaton_(to_vectors(tokens))
+    {
+    }
+    std::size_t size() const { return automaton_.token_count(); }
+    std::size_t token_size(std::size_t token_idx) const
+    {
+        return automaton_.token_size(token_idx);
+    }
+
+    // Calls on_match(idx, token_idx) for every (possibly overlapping)
+    // occurrence of every token in xs, ordered by the position of their ends.
+    // Of equal tokens, only the first one is reported.
+    template <typename F>
+    void for_each_match(const Container& xs, F on_match) const
+    {
+        automaton_.for_each_match(std::begin(xs), std::end(xs), on_match);
     }
-    if (std::equal(itInBegin, itInEnd, std::begin(token))) {
-        return just(idx);
+
+private:
+    template <typename ContainerTokens>
+    static std::vector<std::vector<value_type>> to_vectors(const ContainerTokens& tokens)
+    {
+        std::vector<std::vector<value_type>> result;
+        result.reserve(size_of_cont(tokens));
+        for (const auto& token : tokens) {
+            result.emplace_back(std::begin(token), std::end(token));
+        }
+        return result;
     }
-    return nothing<std::size_t>();
+
+    internal::aho_corasick_automaton<value_type> automaton_;
+};
+
+// API search type: compile_tokens : [[a]] -> CompiledTokens a
+// fwd bind count: 0
+// Prepares many tokens for being searched in containers at once.
+// The result can be passed to find_all_instances_of_tokens
+// and replace_tokens_many instead of the tokens themselves.
+template <typename ContainerTokens,
+    typename Container = typename ContainerTokens::value_type>
+compiled_tokens<Container> compile_tokens(const ContainerTokens& tokens)
+{
+    return compiled_tokens<Container>(tokens);
+}
+
+// API search type: find_all_instances_of_tokens : ([[a]], [a]) -> [(Int, Int)]
+// fwd bind count: 1
+// Returns the starting indices of all segments matching one of the tokens,
+// each paired with the index of the matching token,
+// sorted by starting index and then by token index.
+// Empty tokens are ignored, of equal tokens only the first one is reported.
+// find_all_instances_of_tokens(["haha", "ah"], "oh, hahaha!")
+// == [(4, 0), (5, 1), (6, 0), (7, 1)]
+// O(n + k * log(k)), where k is the number of matches,
+// plus the time to compile the tokens.
+template <typename ContainerTokens,
+    typename Container = typename ContainerTokens::value_type>
+std::vector<std::pair<std::size_t, std::size_t>> find_all_instances_of_tokens(
+    const ContainerTokens& tokens, const Container& xs)
+{
+    return find_all_instances_of_tokens(compiled_tokens<Container>(tokens), xs);
+}
+
+// Overload of find_all_instances_of_tokens for compiled tokens.
+template <typename Container>
+std::vector<std::pair<std::size_t, std::size_t>> find_all_instances_of_tokens(
+    const compiled_tokens<Container>& tokens, const Container& xs)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> result;
+    tokens.for_each_match(xs, [&](std::size_t idx, std::size_t token_idx) {
+        result.emplace_back(idx, token_idx);
+    });
+    std::sort(std::begin(result), std::end(result));
+    return result;
 }
 
 } // namespace fplus
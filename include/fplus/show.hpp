@@ -13,13 +13,111 @@
 
 #include <iomanip>
 #include <ios>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <ostream>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
 
 namespace fplus {
 
+namespace internal {
+    // Numbers that show formats without a std::ostringstream,
+    // producing the same characters the stream would.
+    // Character types and bool are not among them,
+    // because the stream does not show them as numbers.
+    // Floating-point numbers need std::to_chars.
+    template <typename T>
+    struct is_fast_showable
+        : std::integral_constant<bool,
+              (std::is_integral<T>::value
+#if defined(__cpp_lib_to_chars)
+                  || std::is_floating_point<T>::value
+#endif
+                  )
+                  && !std::is_same<T, bool>::value
+                  && !std::is_same<T, char>::value
+                  && !std::is_same<T, signed char>::value
+                  && !std::is_same<T, unsigned char>::value
+                  && !std::is_same<T, wchar_t>::value
+                  && !std::is_same<T, char16_t>::value
+                  && !std::is_same<T, char32_t>::value> {
+    };
+
+    template <typename T>
+    bool is_negative_number(T x, std::true_type /* is_signed */)
+    {
+        return x < 0;
+    }
+
+    template <typename T>
+    bool is_negative_number(T, std::false_type /* is_signed */)
+    {
+        return false;
+    }
+
+    template <typename T>
+    void show_number_append(std::string& out, T x, std::true_type /* is_integral */)
+    {
+        char buffer[std::numeric_limits<T>::digits10 + 3];
+#if __cplusplus >= 201703L
+        const auto converted = std::to_chars(std::begin(buffer), std::end(buffer), x);
+        out.append(buffer, converted.ptr);
+#else
+        typedef std::make_unsigned_t<T> U;
+        const bool negative = is_negative_number(x, std::is_signed<T>());
+        U value = negative
+            ? static_cast<U>(U(0) - static_cast<U>(x))
+            : static_cast<U>(x);
+        char* const last = std::end(buffer);
+        char* first = last;
+        do {
+            *--first = static_cast<char>('0' + value % 10);
+            value = static_cast<U>(value / 10);
+        } while (value != 0);
+        if (negative) {
+            *--first = '-';
+        }
+        out.append(first, last);
+#endif
+    }
+
+#if defined(__cpp_lib_to_chars)
+    // Same as the default format of a stream, i.e. "%.6g".
+    template <typename T>
+    void show_number_append(std::string& out, T x, std::false_type /* is_integral */)
+    {
+        char buffer[64];
+        const auto converted = std::to_chars(std::begin(buffer), std::end(buffer),
+            x, std::chars_format::general, 6);
+        out.append(buffer, converted.ptr);
+    }
+#endif
+
+    template <typename T>
+    std::string show_value(const T& x, std::true_type /* is_fast_showable */)
+    {
+        std::string result;
+        show_number_append(result, x, std::is_integral<T>());
+        return result;
+    }
+
+    template <typename T>
+    std::string show_value(const T& x, std::false_type /* is_fast_showable */)
+    {
+        std::ostringstream ss;
+        ss << x;
+        return ss.str();
+    }
+}
+
 // API search type: show : a -> String
 // fwd bind count: 0
 // 42 -> "42"
@@ -30,12 +128,12 @@ namespace fplus {
 // Pair to String
 // std::vector<std::list<T>> to String
 // std::vector<T> to String
+// Integers (and floating-point numbers if std::to_chars supports them)
+// are converted without the overhead of a std::ostringstream.
 template <typename T>
 std::string show(const T& x)
 {
-    std::ostringstream ss;
-    ss << x;
-    return ss.str();
+    return internal::show_value(x, internal::is_fast_showable<T>());
 }
 
 // string identity
@@ -85,6 +183,62 @@ std::string show(const std::deque<T, A>& xs)
     return show_cont(xs);
 }
 
+namespace internal {
+    template <typename T>
+    void show_append(std::string& out, const T& x, std::true_type /* is_fast_showable */)
+    {
+        show_number_append(out, x, std::is_integral<T>());
+    }
+
+    template <typename T>
+    void show_append(std::string& out, const T& x, std::false_type /* is_fast_showable */)
+    {
+        out += show(x);
+    }
+
+    template <typename T>
+    void show_append(std::string& out, const T& x)
+    {
+        show_append(out, x, is_fast_showable<T>());
+    }
+
+    inline void show_append(std::string& out, const std::string& x)
+    {
+        out += x;
+    }
+
+    // Shows all elements of xs into one buffer.
+    // Whenever the buffer holds at least flush_size chars,
+    // it is passed to flush and cleared afterwards.
+    template <typename Container, typename Flush>
+    void show_cont_into(std::string& buffer,
+        Flush flush, std::size_t flush_size,
+        const std::string& separator,
+        const std::string& prefix, const std::string& suffix,
+        const Container& xs,
+        std::size_t new_line_every_nth_elem)
+    {
+        const std::string newline = std::string("\n") + std::string(prefix.size(), ' ');
+        buffer += prefix;
+        std::size_t i = 0;
+        for (const auto& x : xs) {
+            if (i != 0) {
+                buffer += separator;
+                if (new_line_every_nth_elem != 0 && i % new_line_every_nth_elem == 0) {
+                    buffer += newline;
+                }
+            }
+            show_append(buffer, x);
+            if (buffer.size() >= flush_size) {
+                flush(buffer);
+                buffer.clear();
+            }
+            ++i;
+        }
+        buffer += suffix;
+    }
+}
+
 // API search type: show_cont_with_frame_and_newlines : (String, String, String, [a], Int) -> String
 // fwd bind count: 3
 // show_cont_with_frame_and_newlines (",", "(", ")", [1, 2, 3, 4, 5], 2)
@@ -98,24 +252,13 @@ std::string show_cont_with_frame_and_newlines(
     const Container& xs,
     std::size_t new_line_every_nth_elem)
 {
-    std::vector<std::string> elemStrs;
-    elemStrs.reserve(xs.size());
-    if (new_line_every_nth_elem == 0) {
-        for (const auto& x : xs) {
-            elemStrs.push_back(show(x));
-        }
-    } else {
-        std::size_t i = 0;
-        std::string newline = std::string("\n") + std::string(prefix.size(), ' ');
-        for (const auto& x : xs) {
-            if (i && i % new_line_every_nth_elem == 0)
-                elemStrs.push_back(newline + show(x));
-            else
-                elemStrs.push_back(show(x));
-            ++i;
-        }
-    }
-    return prefix + join(separator, elemStrs) + suffix;
+    std::string result;
+    result.reserve(prefix.size() + suffix.size()
+        + size_of_cont(xs) * (separator.size() + 1));
+    internal::show_cont_into(result, [](const std::string&) {},
+        std::numeric_limits<std::size_t>::max(),
+        separator, prefix, suffix, xs, new_line_every_nth_elem);
+    return result;
 }
 
 // API search type: show_cont_with_frame : (String, String, String, [a]) -> String
@@ -149,6 +292,48 @@ std::string show_cont(const Container& xs)
     return show_cont_with(", ", xs);
 }
 
+// API search type: show_cont_with_frame_to : (OStream, String, String, String, [a]) -> Io ()
+// Writes the same as show_cont_with_frame into a stream.
+// The text is passed on in pieces of about 64 KiB,
+// so no string holding the whole output is built.
+template <typename Container>
+void show_cont_with_frame_to(std::ostream& os,
+    const std::string& separator,
+    const std::string& prefix, const std::string& suffix,
+    const Container& xs)
+{
+    const std::size_t flush_size = 1 << 16;
+    const auto write = [&os](const std::string& buffer) {
+        os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    };
+    std::string buffer;
+    buffer.reserve(flush_size + 64);
+    internal::show_cont_into(buffer, write, flush_size,
+        separator, prefix, suffix, xs, 0);
+    write(buffer);
+}
+
+// API search type: show_cont_to : (OStream, [a]) -> Io ()
+// Writes the same as show_cont into a stream,
+// without building a string holding the whole output.
+// show_cont_to(std::cout, [1, 2, 3]) prints "[1, 2, 3]"
+template <typename Container>
+void show_cont_to(std::ostream& os, const Container& xs)
+{
+    show_cont_with_frame_to(os, ", ", "[", "]", xs);
+}
+
+// API search type: show_to_buffer : (String, a) -> Io ()
+// Appends show(x) to buffer.
+// Numbers are formatted directly into the buffer,
+// so filling a reused buffer does not allocate.
+// show_to_buffer(buffer, 42) appends "42"
+template <typename T>
+void show_to_buffer(std::string& buffer, const T& x)
+{
+    internal::show_append(buffer, x);
+}
+
 // API search type: show_maybe : Maybe a -> String
 // fwd bind count: 0
 // show_maybe(Just 42) -> "Just 42"
@@ -9,11 +9,16 @@
 #include <fplus/container_common.hpp>
 #include <fplus/function_traits.hpp>
 #include <fplus/generate.hpp>
+#include <fplus/result.hpp>
+#include <fplus/internal/file_mapping.hpp>
 #include <fplus/internal/invoke.hpp>
+#include <fplus/internal/line_reader.hpp>
+#include <fplus/internal/thread_pool.hpp>
 #include <fplus/string_tools.hpp>
 
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <condition_variable>
 #include <cstdint>
 #include <fstream>
@@ -21,11 +26,17 @@
 #include <future>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <streambuf>
 #include <string>
 #include <thread>
 #include <vector>
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
 namespace fplus {
 
 // Executes a function f in a fixed interval,
@@ -302,6 +313,22 @@ void parallel_for_each_n_threads(size_t n_threads, F f, const Container& xs)
     fplus::transform_parallelly_n_threads(n_threads, f_dummy_return, xs);
 }
 
+// API search type: parallel_for_each_placed : (ThreadPlacement, Io a, [a]) -> Io ()
+// fwd bind count: 2
+// Runs the function `f` in parallel on all the container elements,
+// using one thread per entry of the placement, each pinned to its CPU.
+// The function will perform its side effects, and nothing is returned.
+template <typename F, typename Container>
+void parallel_for_each_placed(const thread_placement& placement, F f, const Container& xs)
+{
+    using IdxType = typename Container::value_type;
+    auto f_dummy_return = [&f](const IdxType& v) {
+        f(v);
+        return true;
+    };
+    fplus::transform_parallelly_placed(placement, f_dummy_return, xs);
+}
+
 // API search type: execute_serially_until_failure : [Io Bool] -> Io Bool
 // Returns a function that (when called) executes the given side effects
 // one after another until one of them returns false.
@@ -324,7 +351,8 @@ std::function<bool()> execute_serially_until_failure(const Container& effs)
 
 // API search type: execute_parallelly : [Io a] -> Io [a]
 // Returns a function that (when called) executes the given side effects
-// in parallel (one thread each) and returns the collected results.
+// in parallel (on the thread pool of transform_parallelly)
+// and returns the collected results.
 template <typename Container>
 auto execute_parallelly(const Container& effs)
 {
@@ -353,6 +381,23 @@ auto execute_parallelly_n_threads(std::size_t n, const Container& effs)
     };
 }
 
+// API search type: execute_parallelly_placed : (ThreadPlacement, [Io a]) -> Io [a]
+// Returns a function that (when called) executes the given side effects
+// in parallel (one thread per entry of the placement, each pinned to its CPU)
+// and returns the collected results.
+template <typename Container>
+auto execute_parallelly_placed(const thread_placement& placement, const Container& effs)
+{
+    return [placement, effs] {
+        // Bluntly re-using the transform implementation to execute side effects.
+        return transform_parallelly_placed(
+            placement, [](const auto& eff) {
+                return internal::invoke(eff);
+            },
+            effs);
+    };
+}
+
 // API search type: execute_fire_and_forget : Io a -> Io a
 // Returns a function that (when called) executes the given side effect
 // in a new thread and returns immediately.
@@ -457,6 +502,445 @@ inline std::function<std::vector<std::string>()> read_text_file_lines(
     };
 }
 
+// API search type: read_text_file_lines_lazy : (Bool, String) -> [String]
+// Returns the lines of a text file as a range
+// that reads the file in chunks of 1 MiB while being iterated,
+// so memory usage does not grow with the size of the file.
+// Lines spanning chunk boundaries are joined correctly.
+// Iterating yields a reference to a line buffer that is reused,
+// so the range is meant to be consumed by a range-based for loop
+// or as the source of a lazy pipeline, e.g.:
+// fwd::apply(read_text_file_lines_lazy(false, "huge.txt"),
+//     fwd::lazy::keep_if(is_relevant),
+//     fwd::lazy::transform(parse),
+//     fwd::lazy::fold_left(combine, init))
+// Every traversal reads the file anew.
+// An unreadable file results in no lines.
+inline internal::text_file_line_range read_text_file_lines_lazy(
+    bool allow_empty, const std::string& filename)
+{
+    return internal::text_file_line_range(filename, allow_empty, 1 << 20);
+}
+
+// API search type: for_each_line_parallelly : ((String -> Io ()), Bool, String) -> Io Bool
+// Calls f on every line of a text file, using the default thread pool.
+// The file is read in batches of lines of about 1 MiB each.
+// While one group of batches (one per thread) is processed,
+// the next group is read, so memory usage is bounded
+// by two groups, independently of the size of the file.
+// The order in which the lines are processed is unspecified.
+// Returns false if the file could not be opened.
+template <typename F>
+bool for_each_line_parallelly(F f, bool allow_empty, const std::string& filename)
+{
+    const auto reader = internal::chunked_line_reader::open(filename, allow_empty, 1 << 20);
+    if (!reader) {
+        return false;
+    }
+    internal::thread_pool& pool = internal::default_thread_pool();
+    typedef std::vector<std::vector<std::string>> batch_group;
+    const auto read_group = [&reader, &pool](batch_group& group) -> bool {
+        group.resize(pool.size() + 1);
+        std::size_t n = 0;
+        while (n < group.size() && reader->next_batch(group[n])) {
+            ++n;
+        }
+        group.resize(n);
+        return n > 0;
+    };
+    const auto process_group = [&f, &pool](const batch_group& group) {
+        pool.run_chunks(group.size(), [&f, &group](std::size_t idx) {
+            for (const auto& line : group[idx]) {
+                internal::invoke(f, line);
+            }
+        });
+    };
+    batch_group current;
+    batch_group next;
+    bool has_current = read_group(current);
+    while (has_current) {
+        auto processing = std::async(std::launch::async,
+            [&process_group, &current]() { process_group(current); });
+        const bool has_next = read_group(next);
+        processing.get();
+        std::swap(current, next);
+        has_current = has_next;
+    }
+    return true;
+}
+
+// Expected access pattern of a mapped_file.
+typedef internal::file_access file_access_hint;
+
+// Read-only view of the content of a file mapped into memory,
+// as returned by read_mapped_file.
+// Nothing is copied when opening it: pages are loaded on first access.
+// Copies share the mapping, which is released with the last one.
+// It behaves like a const container of chars.
+// With C++17, str() returns a std::string_view of the whole content,
+// which can be split without copying, e.g. with split_lines_view.
+class mapped_file {
+public:
+    typedef char value_type;
+    typedef const char* const_iterator;
+    typedef const_iterator iterator;
+    typedef std::size_t size_type;
+
+    mapped_file()
+        : mapping_()
+    {
+    }
+    explicit mapped_file(std::shared_ptr<const internal::file_mapping> mapping)
+        : mapping_(std::move(mapping))
+    {
+    }
+    const char* data() const { return mapping_ ? mapping_->data() : nullptr; }
+    std::size_t size() const { return mapping_ ? mapping_->size() : 0; }
+    bool empty() const { return size() == 0; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    char operator[](std::size_t idx) const { return data()[idx]; }
+    // Tells the OS how the content is going to be accessed,
+    // e.g. file_access_hint::sequential doubles the read-ahead
+    // and file_access_hint::random disables it.
+    // Returns false if the hint could not be applied.
+    bool advise(file_access_hint hint) const
+    {
+        return mapping_ && mapping_->advise(hint);
+    }
+#if __cplusplus >= 201703L
+    std::string_view str() const
+    {
+        return std::string_view(data(), size());
+    }
+#endif
+
+private:
+    std::shared_ptr<const internal::file_mapping> mapping_;
+};
+
+// API search type: read_mapped_file_maybe : (FileAccessHint, String) -> Io (Maybe MappedFile)
+// Returns a function that (when called) maps a file into memory
+// and applies the given access hint.
+// In contrast to read_text_file_maybe no content is copied.
+inline std::function<maybe<mapped_file>()> read_mapped_file_maybe(
+    file_access_hint hint, const std::string& filename)
+{
+    return [filename, hint]() -> maybe<mapped_file> {
+        std::shared_ptr<const internal::file_mapping> mapping = internal::file_mapping::open(filename);
+        if (!mapping)
+            return {};
+        mapping->advise(hint);
+        return just(mapped_file(std::move(mapping)));
+    };
+}
+
+// API search type: read_mapped_file : (FileAccessHint, String) -> Io MappedFile
+// Returns a function that (when called) maps a file into memory
+// and applies the given access hint.
+// This function then returns an empty mapped_file if the file could not be read.
+inline std::function<mapped_file()> read_mapped_file(
+    file_access_hint hint, const std::string& filename)
+{
+    return [filename, hint]() -> mapped_file {
+        return just_with_default(
+            mapped_file(),
+            read_mapped_file_maybe(hint, filename)());
+    };
+}
+
+// Writes text into a file, replacing it if it already exists.
+// The text is collected in a reusable buffer of buffer_size bytes,
+// which is written out whenever it is full,
+// so large outputs can be produced piece by piece.
+// Errors are remembered and reported by flush and close,
+// which return the total number of bytes written so far.
+// The destructor closes the file, ignoring errors.
+//
+// Example usage:
+//
+// buffered_file_writer writer("out.txt");
+// for (const auto& x : xs) {
+//     writer.write_line(show(x));
+// }
+// const auto written = writer.close();
+class buffered_file_writer {
+public:
+    explicit buffered_file_writer(const std::string& filename,
+        std::size_t buffer_size = 1 << 20)
+        : filename_(filename)
+        , output_(filename)
+        , buffer_()
+        , buffer_size_(std::max<std::size_t>(1, buffer_size))
+        , bytes_written_(0)
+        , error_()
+    {
+        buffer_.reserve(buffer_size_);
+        if (!output_.good()) {
+            error_ = "Can not open file for writing: " + filename_;
+        }
+    }
+    buffered_file_writer(const buffered_file_writer&) = delete;
+    buffered_file_writer& operator=(const buffered_file_writer&) = delete;
+    ~buffered_file_writer()
+    {
+        close();
+    }
+    void write(const std::string& str)
+    {
+        if (buffer_.size() + str.size() > buffer_size_) {
+            write_buffer();
+        }
+        if (str.size() >= buffer_size_) {
+            write_to_file(str.data(), str.size());
+        } else {
+            buffer_ += str;
+        }
+    }
+    void write(char c)
+    {
+        if (buffer_.size() == buffer_size_) {
+            write_buffer();
+        }
+        buffer_ += c;
+    }
+    void write_line(const std::string& line)
+    {
+        write(line);
+        write('\n');
+    }
+    // Writes out the buffer and flushes the file.
+    result<std::size_t, std::string> flush()
+    {
+        write_buffer();
+        if (error_.empty() && output_.is_open() && !output_.flush()) {
+            error_ = "Can not write to file: " + filename_;
+        }
+        return get_result();
+    }
+    // Flushes and closes the file. Further writes are errors.
+    result<std::size_t, std::string> close()
+    {
+        if (!output_.is_open()) {
+            write_buffer();
+            return get_result();
+        }
+        flush();
+        output_.close();
+        if (error_.empty() && output_.fail()) {
+            error_ = "Can not close file: " + filename_;
+        }
+        return get_result();
+    }
+
+private:
+    void write_buffer()
+    {
+        write_to_file(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+    void write_to_file(const char* data, std::size_t size)
+    {
+        if (size == 0 || !error_.empty()) {
+            return;
+        }
+        if (!output_.is_open() || !output_.write(data, static_cast<std::streamsize>(size))) {
+            error_ = "Can not write to file: " + filename_;
+            return;
+        }
+        bytes_written_ += size;
+    }
+    result<std::size_t, std::string> get_result() const
+    {
+        if (!error_.empty()) {
+            return error<std::size_t>(error_);
+        }
+        return ok<std::size_t, std::string>(bytes_written_);
+    }
+    std::string filename_;
+    std::ofstream output_;
+    std::string buffer_;
+    std::size_t buffer_size_;
+    std::size_t bytes_written_;
+    std::string error_;
+};
+
+// Like buffered_file_writer, but full buffers are handed over
+// to a background thread writing them into the file,
+// so the producer can continue computing in the meantime.
+// At most max_pending_buffers full buffers wait for being written.
+// If the writer thread falls behind, the producer waits,
+// which bounds the memory usage.
+// Written buffers are reused.
+// The writing functions must only be called from one thread at a time.
+class async_file_writer {
+public:
+    explicit async_file_writer(const std::string& filename,
+        std::size_t buffer_size = 1 << 20,
+        std::size_t max_pending_buffers = 4)
+        : filename_(filename)
+        , output_(filename)
+        , buffer_()
+        , buffer_size_(std::max<std::size_t>(1, buffer_size))
+        , max_pending_buffers_(std::max<std::size_t>(1, max_pending_buffers))
+        , mutex_()
+        , cv_()
+        , pending_()
+        , free_()
+        , is_writing_(false)
+        , stop_(false)
+        , bytes_written_(0)
+        , error_()
+        , thread_()
+    {
+        buffer_.reserve(buffer_size_);
+        if (!output_.good()) {
+            error_ = "Can not open file for writing: " + filename_;
+        }
+        thread_ = std::thread([this]() { writer_loop(); });
+    }
+    async_file_writer(const async_file_writer&) = delete;
+    async_file_writer& operator=(const async_file_writer&) = delete;
+    ~async_file_writer()
+    {
+        close();
+    }
+    void write(const std::string& str)
+    {
+        if (buffer_.size() + str.size() > buffer_size_) {
+            hand_over_buffer();
+        }
+        buffer_ += str;
+        if (buffer_.size() >= buffer_size_) {
+            hand_over_buffer();
+        }
+    }
+    void write(char c)
+    {
+        buffer_ += c;
+        if (buffer_.size() >= buffer_size_) {
+            hand_over_buffer();
+        }
+    }
+    void write_line(const std::string& line)
+    {
+        write(line);
+        write('\n');
+    }
+    // Waits until everything written so far is in the file.
+    result<std::size_t, std::string> flush()
+    {
+        hand_over_buffer();
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return pending_.empty() && !is_writing_; });
+        if (error_.empty() && output_.is_open() && !output_.flush()) {
+            error_ = "Can not write to file: " + filename_;
+        }
+        return get_result();
+    }
+    // Flushes, stops the writer thread and closes the file.
+    // Further writes are errors.
+    result<std::size_t, std::string> close()
+    {
+        if (!thread_.joinable()) {
+            hand_over_buffer();
+            std::lock_guard<std::mutex> lock(mutex_);
+            return get_result();
+        }
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (output_.is_open()) {
+            output_.close();
+            if (error_.empty() && output_.fail()) {
+                error_ = "Can not close file: " + filename_;
+            }
+        }
+        return get_result();
+    }
+
+private:
+    void hand_over_buffer()
+    {
+        if (buffer_.empty()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!thread_.joinable()) {
+            if (error_.empty()) {
+                error_ = "Can not write to closed file: " + filename_;
+            }
+            buffer_.clear();
+            return;
+        }
+        cv_.wait(lock, [this]() { return pending_.size() < max_pending_buffers_; });
+        pending_.push_back(std::move(buffer_));
+        if (free_.empty()) {
+            buffer_ = std::string();
+            buffer_.reserve(buffer_size_);
+        } else {
+            buffer_ = std::move(free_.back());
+            free_.pop_back();
+        }
+        cv_.notify_all();
+    }
+    void writer_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            std::string buffer = std::move(pending_.front());
+            pending_.pop_front();
+            is_writing_ = true;
+            const bool skip = !error_.empty();
+            lock.unlock();
+            const bool success = skip
+                || output_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            lock.lock();
+            is_writing_ = false;
+            if (!skip && !success) {
+                error_ = "Can not write to file: " + filename_;
+            } else if (!skip) {
+                bytes_written_ += buffer.size();
+            }
+            buffer.clear();
+            free_.push_back(std::move(buffer));
+            cv_.notify_all();
+        }
+    }
+    result<std::size_t, std::string> get_result() const
+    {
+        if (!error_.empty()) {
+            return error<std::size_t>(error_);
+        }
+        return ok<std::size_t, std::string>(bytes_written_);
+    }
+    std::string filename_;
+    std::ofstream output_;
+    std::string buffer_;
+    std::size_t buffer_size_;
+    std::size_t max_pending_buffers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::string> pending_;
+    std::vector<std::string> free_;
+    bool is_writing_;
+    bool stop_;
+    std::size_t bytes_written_;
+    std::string error_;
+    std::thread thread_;
+};
+
 // API search type: write_text_file : (String, String) -> Io Bool
 // Returns a function that (when called) writes content into a text file,
 // replacing it if it already exists.
@@ -487,15 +971,25 @@ inline std::function<bool()> write_binary_file(const std::string& filename,
 // API search type: write_text_file_lines : (String, [String], Bool) -> Io Bool
 // Returns a function that (when called) writes lines into a text file,
 // replacing it if it already exists.
+// The lines are streamed through a buffered_file_writer
+// instead of being joined into one string first.
 inline std::function<bool()> write_text_file_lines(bool trailing_newline,
     const std::string& filename,
-    const std::vector<std::string>& lines)
+    std::vector<std::string> lines)
 {
-    std::string content = join(std::string("\n"), lines);
-    if (trailing_newline) {
-        content += "\n";
-    }
-    return write_text_file(filename, content);
+    return [filename, trailing_newline, lines = std::move(lines)]() -> bool {
+        buffered_file_writer writer(filename);
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            if (i != 0) {
+                writer.write('\n');
+            }
+            writer.write(lines[i]);
+        }
+        if (trailing_newline) {
+            writer.write('\n');
+        }
+        return is_ok(writer.close());
+    };
 }
 
 // API search type: execute_effect : Io a -> a
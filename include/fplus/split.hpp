@@ -136,16 +136,93 @@ ContainerOut group_globally_by(BinaryPredicate p, const ContainerIn& xs)
     return result;
 }
 
+namespace internal {
+
+    // Groups by hashing the keys, keeping the order of first occurrence.
+    // Returns the keys of the groups alongside the groups.
+    template <typename ContainerOut, typename F, typename ContainerIn>
+    auto group_globally_on_hashed(F f, const ContainerIn& xs)
+    {
+        typedef typename ContainerOut::value_type InnerContainerOut;
+        typedef key_of_t<F, ContainerIn> Key;
+        std::unordered_map<Key, std::size_t> group_idxs;
+        std::vector<Key> keys;
+        ContainerOut result;
+        for (const auto& x : xs) {
+            auto key = internal::invoke(f, x);
+            const auto it = group_idxs.find(key);
+            if (it == group_idxs.end()) {
+                group_idxs.emplace(key, result.size());
+                keys.push_back(std::move(key));
+                *internal::get_back_inserter(result) = InnerContainerOut(1, x);
+            } else {
+                *internal::get_back_inserter(result[it->second]) = x;
+            }
+        }
+        return std::make_pair(std::move(keys), std::move(result));
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on(std::true_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        return group_globally_on_hashed<std::vector<ContainerIn>>(f, xs).second;
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on(std::false_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        return group_globally_by(is_equal_by(f), xs);
+    }
+
+    template <typename ContainerIn>
+    auto group_globally(std::true_type /* is_hashable */, const ContainerIn& xs)
+    {
+        typedef typename ContainerIn::value_type T;
+        return group_globally_on(std::true_type(), identity<T>, xs);
+    }
+
+    template <typename ContainerIn>
+    auto group_globally(std::false_type /* is_hashable */, const ContainerIn& xs)
+    {
+        typedef typename ContainerIn::value_type T;
+        auto pred = [](const T& x, const T& y) { return x == y; };
+        return group_globally_by(pred, xs);
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on_labeled(std::true_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        auto keys_and_groups = group_globally_on_hashed<std::vector<ContainerIn>>(f, xs);
+        std::vector<std::pair<key_of_t<F, ContainerIn>, ContainerIn>> result;
+        result.reserve(keys_and_groups.first.size());
+        for (std::size_t i = 0; i < keys_and_groups.first.size(); ++i) {
+            result.emplace_back(std::move(keys_and_groups.first[i]),
+                std::move(keys_and_groups.second[i]));
+        }
+        return result;
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on_labeled(std::false_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        const auto group = [](auto f1, const auto& xs1) {
+            return group_globally_by(f1, xs1);
+        };
+        return internal::group_on_labeled_impl(group, f, xs);
+    }
+}
+
 // API search type: group_globally_on : ((a -> b), [a]) -> [[a]]
 // fwd bind count: 1
 // Arrange elements equal after applying a transformer into groups.
 // group_globally_on((mod 10), [12,34,22]) == [[12,22],[34]]
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group_on
+// O(n) if the transformation results are hashable, O(n^2) otherwise.
+// If you need O(n*log(n)) for non-hashable ones, sort and then use group_on
 template <typename F, typename ContainerIn>
 auto group_globally_on(F f, const ContainerIn& xs)
 {
-    return group_globally_by(is_equal_by(f), xs);
+    return internal::group_globally_on(
+        internal::is_hashable<internal::key_of_t<F, ContainerIn>>(), f, xs);
 }
 
 // API search type: group_globally_on_labeled : ((a -> b), [a]) -> [(b, [a])]
@@ -153,24 +230,21 @@ auto group_globally_on(F f, const ContainerIn& xs)
 // Arrange elements equal after applying a transformer into groups,
 // adding the transformation result as a label to the group.
 // group_globally_on_labeled((mod 10), [12,34,22]) == [(2,[12,22]),(4, [34])]
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group_on_labeled
+// O(n) if the transformation results are hashable, O(n^2) otherwise.
+// If you need O(n*log(n)) for non-hashable ones, sort and then use group_on_labeled
 template <typename F, typename ContainerIn>
 auto group_globally_on_labeled(F f, const ContainerIn& xs)
 {
-    const auto group = [](auto f1, const auto& xs1) {
-        return group_globally_by(f1, xs1);
-    };
-
-    return internal::group_on_labeled_impl(group, f, xs);
+    return internal::group_globally_on_labeled(
+        internal::is_hashable<internal::key_of_t<F, ContainerIn>>(), f, xs);
 }
 
 // API search type: group_globally : [a] -> [[a]]
 // fwd bind count: 0
 // Arrange equal elements into groups.
 // group_globally([1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2,2,2],[3],[4],[5,5]]
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group
+// O(n) if the elements are hashable, O(n^2) otherwise.
+// If you need O(n*log(n)) for non-hashable ones, sort and then use group
 template <typename ContainerIn,
     typename ContainerOut = typename std::vector<ContainerIn>>
 ContainerOut group_globally(const ContainerIn& xs)
@@ -179,8 +253,7 @@ ContainerOut group_globally(const ContainerIn& xs)
                       typename ContainerOut::value_type>::value,
         "Containers do not match.");
     typedef typename ContainerIn::value_type T;
-    auto pred = [](const T& x, const T& y) { return x == y; };
-    return group_globally_by(pred, xs);
+    return internal::group_globally(internal::is_hashable<T>(), xs);
 }
 
 // API search type: cluster_by : (((a, a) -> Bool), [a]) -> [[a]]
@@ -492,6 +565,24 @@ ContainerOut split_every(std::size_t n, const ContainerIn& xs)
         xs);
 }
 
+// API search type: split_every_view : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Same as split_every, but the chunks are views into xs
+// computed on access, so no element is copied.
+// xs has to outlive the result.
+// split_every_view(3, [0,1,2,3,4,5,6,7]) == [[0,1,2],[3,4,5],[6,7]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> split_every_view(std::size_t n, const ContainerIn& xs)
+{
+    assert(n > 0);
+    const std::size_t n_chunks = std::max<std::size_t>(1,
+        div_pos_int_ceil(size_of_cont(xs), n));
+    return internal::window_range<ContainerIn>(xs, n_chunks, n, n);
+}
+
+template <typename ContainerIn>
+void split_every_view(std::size_t, const ContainerIn&&) = delete;
+
 // API search type: split_evenly : (Int, [a]) -> [[a]]
 // fwd bind count: 1
 // Split a sequence into n similarly-sized chunks.
@@ -510,6 +601,23 @@ ContainerOut split_evenly(std::size_t n, const ContainerIn& xs)
         xs);
 }
 
+// API search type: split_evenly_view : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Same as split_evenly, but the chunks are views into xs
+// computed on access, so no element is copied.
+// xs has to outlive the result.
+// split_evenly_view(2, [0,1,2,3,4]) == [[0,1,2],[3,4]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> split_evenly_view(std::size_t n, const ContainerIn& xs)
+{
+    const std::size_t every_n = std::max<std::size_t>(1,
+        div_pos_int_ceil(size_of_cont(xs), n));
+    return split_every_view(every_n, xs);
+}
+
+template <typename ContainerIn>
+void split_evenly_view(std::size_t, const ContainerIn&&) = delete;
+
 // API search type: split_by_token : ([a], Bool, [a]) -> [[a]]
 // fwd bind count: 2
 // Split a sequence at every segment matching a token.
@@ -540,6 +648,86 @@ ContainerOut split_by_token(const ContainerIn& token,
     return result;
 }
 
+#if __cplusplus >= 201703L
+
+// The following *_view versions of the splitting functions
+// return std::basic_string_view segments pointing into the input
+// instead of copying every segment into a new string.
+// The input has to outlive the result, so temporaries are not accepted.
+// They have no fwd instances, since they need C++17.
+
+// API search type: split_by_view : ((Char -> Bool), Bool, String) -> [StringView]
+// Split a string at every character fulfilling a predicate.
+// split_by_view(is_whitespace, false, "a b  c") == ["a", "b", "c"]
+// O(n)
+template <typename UnaryPredicate, typename String>
+auto split_by_view(UnaryPredicate pred, bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    return internal::split_string_view([&pred](View s, std::size_t pos) {
+        const auto it = std::find_if(std::begin(s) + static_cast<std::ptrdiff_t>(pos), std::end(s), pred);
+        const std::size_t idx = it == std::end(s)
+            ? View::npos
+            : static_cast<std::size_t>(std::distance(std::begin(s), it));
+        return std::make_pair(idx, idx + 1);
+    },
+        allow_empty, view);
+}
+
+// API search type: split_view : (Char, Bool, String) -> [StringView]
+// Split a string at every occurrence of a character.
+// split_view(',', true, "a,,b") == ["a", "", "b"]
+// O(n)
+template <typename String, typename Char>
+auto split_view(Char x, bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    return internal::split_string_view([x](View s, std::size_t pos) {
+        const std::size_t idx = s.find(x, pos);
+        return std::make_pair(idx, idx + 1);
+    },
+        allow_empty, view);
+}
+
+// API search type: split_one_of_view : (String, Bool, String) -> [StringView]
+// Split a string at every character present in delimiters.
+// split_one_of_view(" o", false, "How are u?") == ["H","w","are","u?"]
+// O(n * m), m being the number of delimiters
+template <typename Delimiters, typename String>
+auto split_one_of_view(const Delimiters& delimiters,
+    bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    const View delims(delimiters.data(), delimiters.size());
+    return internal::split_string_view([delims](View s, std::size_t pos) {
+        const std::size_t idx = s.find_first_of(delims, pos);
+        return std::make_pair(idx, idx + 1);
+    },
+        allow_empty, view);
+}
+
+// API search type: split_by_token_view : (String, Bool, String) -> [StringView]
+// Split a string at every non-overlapping occurrence of a token.
+// split_by_token_view(", ", true, "foo, bar, baz") == ["foo", "bar", "baz"]
+// An empty token does not split the string.
+template <typename Token, typename String>
+auto split_by_token_view(const Token& token, bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    const View tok(token.data(), token.size());
+    return internal::split_string_view([tok](View s, std::size_t pos) {
+        const std::size_t idx = tok.empty() ? View::npos : s.find(tok, pos);
+        return std::make_pair(idx, idx + tok.size());
+    },
+        allow_empty, view);
+}
+
+#endif
+
 // API search type: run_length_encode_by : (((a, a) -> Bool), [a]) -> [(Int, a)]
 // fwd bind count: 1
 // RLE using a specific binary predicate as equality check.
@@ -632,6 +820,26 @@ ContainerOut divvy(std::size_t length, std::size_t step, const ContainerIn& xs)
     return result;
 }
 
+// API search type: divvy_view : (Int, Int, [a]) -> [[a]]
+// fwd bind count: 2
+// Same as divvy, but the subsequences are views into xs
+// computed on access, so memory usage does not grow with length.
+// xs has to outlive the result.
+// divvy_view(5, 2, [0,1,2,3,4,5,6,7,8,9]) == [[0,1,2,3,4],[2,3,4,5,6],[4,5,6,7,8]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> divvy_view(
+    std::size_t length, std::size_t step, const ContainerIn& xs)
+{
+    assert(length > 0);
+    assert(step > 0);
+    const std::size_t size = size_of_cont(xs);
+    const std::size_t n_windows = size < length ? 0 : (size - length) / step + 1;
+    return internal::window_range<ContainerIn>(xs, n_windows, length, step);
+}
+
+template <typename ContainerIn>
+void divvy_view(std::size_t, std::size_t, const ContainerIn&&) = delete;
+
 // API search type: aperture : (Int, [a]) -> [[a]]
 // fwd bind count: 1
 // Generates overlapping subsequences.
@@ -654,6 +862,21 @@ ContainerOut aperture(std::size_t length, const ContainerIn& xs)
     return result;
 }
 
+// API search type: aperture_view : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Same as aperture, but the subsequences are views into xs
+// computed on access, so memory usage does not grow with length.
+// xs has to outlive the result.
+// aperture_view(5, [0,1,2,3,4,5,6]) == [[0,1,2,3,4],[1,2,3,4,5],[2,3,4,5,6]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> aperture_view(std::size_t length, const ContainerIn& xs)
+{
+    return divvy_view(length, 1, xs);
+}
+
+template <typename ContainerIn>
+void aperture_view(std::size_t, const ContainerIn&&) = delete;
+
 // API search type: stride : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Keeps every nth element.
@@ -676,37 +899,82 @@ Container stride(std::size_t step, const Container& xs)
     return ys;
 }
 
-// API search type: winsorize : (Float, [Float]) -> [Float]
+// API search type: stride_view : (Int, [a]) -> [a]
 // fwd bind count: 1
-// Winsorizing
-// winsorize(0.1, [1,3,4,4,4,4,4,4,6,8]) == [3,3,4,4,4,4,4,4,6,6]
+// Same as stride, but the elements are not copied.
+// xs has to outlive the result.
+// stride_view(3, [0,1,2,3,4,5,6,7]) == [0,3,6]
 template <typename Container>
-Container winsorize(double trim_ratio, const Container& xs)
+internal::stride_range<Container> stride_view(std::size_t step, const Container& xs)
 {
-    if (size_of_cont(xs) == 1 || size_of_cont(xs) == 0) {
-        return xs;
+    assert(step > 0);
+    return internal::stride_range<Container>(xs, step);
+}
+
+template <typename Container>
+void stride_view(std::size_t, const Container&&) = delete;
+
+namespace internal {
+
+    template <typename Container>
+    Container winsorize(internal::reuse_container_t,
+        double trim_ratio, Container&& xs)
+    {
+        const std::size_t n = size_of_cont(xs);
+        if (n == 1 || n == 0) {
+            return std::forward<Container>(xs);
+        }
+        trim_ratio = std::max(trim_ratio, 0.0);
+        std::size_t amount = floor<double, std::size_t>(
+            trim_ratio * static_cast<double>(n));
+        amount = std::min(n / 2, amount);
+        if (amount == 0) {
+            return std::forward<Container>(xs);
+        }
+        typedef typename Container::value_type T;
+        if (2 * amount == n) {
+            const T m = median(xs);
+            std::fill(std::begin(xs), std::end(xs), m);
+            return std::forward<Container>(xs);
+        }
+        auto ys = internal::as_vector(xs);
+        internal::nth_elements(ys, { amount, n - 1 - amount });
+        const T lower = ys[amount];
+        const T upper = ys[n - 1 - amount];
+        for (auto& x : xs) {
+            if (x < lower) {
+                x = lower;
+            } else if (upper < x) {
+                x = upper;
+            }
+        }
+        return std::forward<Container>(xs);
     }
-    trim_ratio = std::max(trim_ratio, 0.0);
-    const auto xs_sorted = sort(xs);
-    std::size_t amount = floor<double, std::size_t>(
-        trim_ratio * static_cast<double>(size_of_cont(xs_sorted)));
-    amount = std::min(size_of_cont(xs_sorted) / 2, amount);
-    const auto parts = split_at_idxs(
-        std::vector<std::size_t>({ amount, size_of_cont(xs_sorted) - amount }),
-        xs_sorted);
-    assert(size_of_cont(parts) == 3);
-    typedef typename Container::value_type T;
-    if (is_empty(parts[1])) {
-        return Container(size_of_cont(xs_sorted), median(xs_sorted));
-    } else {
-        const T lower = parts[1].front();
-        const T upper = parts[1].back();
-        const auto result = concat(std::vector<Container>({ Container(amount, lower),
-            parts[1],
-            Container(amount, upper) }));
-        assert(size_of_cont(result) == size_of_cont(xs_sorted));
-        return result;
+
+    template <typename Container>
+    Container winsorize(internal::create_new_container_t,
+        double trim_ratio, const Container& xs)
+    {
+        auto ys = xs;
+        return winsorize(internal::reuse_container_t(), trim_ratio, std::move(ys));
     }
+
+} // namespace internal
+
+// API search type: winsorize : (Float, [Float]) -> [Float]
+// fwd bind count: 1
+// Winsorizing: Clamps the given ratio of the smallest elements
+// to the smallest remaining one and the same ratio of the largest
+// elements to the largest remaining one, keeping the order of the elements.
+// winsorize(0.1, [1,3,4,4,4,4,4,4,6,8]) == [3,3,4,4,4,4,4,4,6,6]
+// winsorize(0.1, [4,4,4,3,8,4,6,4,1,4]) == [4,4,4,3,6,4,6,4,3,4]
+// O(n), using selection instead of sorting.
+// Clamps in place when given an rvalue.
+template <typename Container>
+auto winsorize(double trim_ratio, Container&& xs)
+{
+    return internal::winsorize(internal::can_reuse_v<Container> {},
+        trim_ratio, std::forward<Container>(xs));
 }
 
 // API search type: separate_on : ((a -> b), [a]) -> [[a]]
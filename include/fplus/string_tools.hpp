@@ -73,6 +73,43 @@ ContainerOut split_lines(bool allowEmpty, const String& str)
     return split_by(is_line_break<String>, allowEmpty, clean_newlines(str));
 }
 
+#if __cplusplus >= 201703L
+
+// API search type: split_words_view : (Bool, String) -> [StringView]
+// Splits a string by non-letter and non-digit characters.
+// Returns views into str instead of copies, see split_by_view.
+// split_words_view(false, "How are you?") == ["How", "are", "you"]
+template <typename String>
+auto split_words_view(bool allow_empty, String&& str)
+{
+    typedef std::decay_t<String> Str;
+    return split_by_view(logical_not(is_letter_or_digit<Str>),
+        allow_empty, std::forward<String>(str));
+}
+
+// API search type: split_lines_view : (Bool, String) -> [StringView]
+// Splits a string by the found newlines.
+// Returns views into str instead of copies, see split_by_view.
+// Windows ("\r\n") and mac ("\r") newlines are recognized directly,
+// so unlike split_lines no cleaned copy of str is needed.
+// split_lines_view(false, "Hi,\r\nhow are you?") == ["Hi,", "how are you?"]
+template <typename String>
+auto split_lines_view(bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    return internal::split_string_view([](View s, std::size_t pos) {
+        const typename View::value_type line_breaks[] = { '\r', '\n' };
+        const std::size_t idx = s.find_first_of(line_breaks, pos, 2);
+        const bool is_crlf = idx != View::npos && s[idx] == '\r'
+            && idx + 1 < s.size() && s[idx + 1] == '\n';
+        return std::make_pair(idx, idx + (is_crlf ? 2 : 1));
+    },
+        allow_empty, view);
+}
+
+#endif
+
 // API search type: trim_whitespace_left : String -> String
 // fwd bind count: 0
 // trim_whitespace_left("    text  ") == "text  "
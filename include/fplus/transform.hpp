@@ -17,14 +17,23 @@
 #include <fplus/split.hpp>
 
 #include <fplus/internal/asserts/functions.hpp>
+#include <fplus/internal/cpu_affinity.hpp>
 #include <fplus/internal/invoke.hpp>
+#include <fplus/internal/thread_pool.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstdint>
-#include <future>
+#include <exception>
+#include <functional>
 #include <iterator>
 #include <mutex>
 #include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace fplus {
 
@@ -283,13 +292,959 @@ auto apply_function_n_times(F f, std::size_t n, const FIn& x)
     return y;
 }
 
+// How the adaptive scheduler distributed the chunks of one parallel run
+// of a *_parallelly function (not the *_n_threads ones) on the thread pool.
+// n_sampled_chunks chunks are processed by one thread
+// to measure their cost, while the other threads already process chunks.
+// The ones left after that are handed out
+// to n_threads threads in tasks of chunks_per_task chunks.
+// n_threads == 1 means the rest was processed serially,
+// because parallelization would not have paid off.
+// Jobs with no more chunks than threads are not sampled,
+// every chunk gets its own thread.
+struct parallel_schedule {
+    std::size_t n_chunks;
+    std::size_t n_sampled_chunks;
+    double sampled_seconds;
+    double estimated_remaining_seconds;
+    std::size_t n_threads;
+    std::size_t chunks_per_task;
+};
+
+namespace internal {
+
+    class parallel_schedule_observer_slot {
+    public:
+        typedef std::function<void(const parallel_schedule&)> observer;
+        parallel_schedule_observer_slot()
+            : mutex_()
+            , observer_()
+            , is_set_(false)
+        {
+        }
+        observer exchange(observer new_observer)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_set_ = static_cast<bool>(new_observer);
+            std::swap(observer_, new_observer);
+            return new_observer;
+        }
+        void notify(const parallel_schedule& schedule)
+        {
+            if (!is_set_.load()) {
+                return;
+            }
+            observer current;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                current = observer_;
+            }
+            if (current) {
+                current(schedule);
+            }
+        }
+
+    private:
+        std::mutex mutex_;
+        observer observer_;
+        std::atomic<bool> is_set_;
+    };
+
+    inline parallel_schedule_observer_slot& parallel_schedule_observer()
+    {
+        static parallel_schedule_observer_slot slot;
+        return slot;
+    }
+}
+
+// Installs a function that is called with the parallel_schedule
+// chosen for every parallel run of a *_parallelly function,
+// e.g. to log it when tuning an application.
+// It is called from the thread invoking the *_parallelly function.
+// Returns the previously installed observer.
+// Pass an empty std::function to uninstall it.
+inline std::function<void(const parallel_schedule&)>
+set_parallel_schedule_observer(
+    std::function<void(const parallel_schedule&)> observer)
+{
+    return internal::parallel_schedule_observer().exchange(std::move(observer));
+}
+
+// Describes on which logical CPUs the threads
+// of a *_parallelly_placed function run, one thread per entry.
+// The same CPU may occur multiple times.
+// On systems without support for thread affinity (currently everything
+// but Linux) or if pinning a thread fails, the thread runs unpinned.
+struct thread_placement {
+    std::vector<std::size_t> cpus;
+};
+
+// API search type: thread_placement_on_cpus : [Int] -> ThreadPlacement
+// One thread for each of the given CPU ids.
+inline thread_placement thread_placement_on_cpus(
+    const std::vector<std::size_t>& cpus)
+{
+    return { cpus };
+}
+
+namespace internal {
+    inline thread_placement thread_placement_from_order(
+        const std::vector<cpu_location>& order, std::size_t n_threads)
+    {
+        std::vector<std::size_t> cpus;
+        cpus.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i) {
+            cpus.push_back(order[i % order.size()].cpu);
+        }
+        return { cpus };
+    }
+}
+
+// API search type: compact_thread_placement : Int -> ThreadPlacement
+// n threads packed as densely as possible onto the CPUs
+// the process may use, i.e. hyper-threads of one core first,
+// and one package (socket / NUMA node) before the next one.
+// Good for threads that share a lot of data.
+// Wraps around if there are more threads than CPUs.
+inline thread_placement compact_thread_placement(std::size_t n_threads)
+{
+    return internal::thread_placement_from_order(
+        internal::compact_cpu_order(internal::allowed_cpu_locations()),
+        n_threads);
+}
+
+// API search type: scatter_thread_placement : Int -> ThreadPlacement
+// n threads spread as widely as possible over the CPUs
+// the process may use, i.e. alternating between the packages,
+// and using hyper-threads only after every physical core got a thread.
+// Good for threads that need much memory bandwidth.
+// Wraps around if there are more threads than CPUs.
+inline thread_placement scatter_thread_placement(std::size_t n_threads)
+{
+    return internal::thread_placement_from_order(
+        internal::scatter_cpu_order(internal::allowed_cpu_locations()),
+        n_threads);
+}
+
+namespace internal {
+
+    // Index-based read access to the elements of a container.
+    // Non-random-access containers get a temporary table of iterators.
+    template <typename Container,
+        bool IsRandomAccess = std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<
+                typename Container::const_iterator>::iterator_category>::value>
+    class indexed_elems {
+    public:
+        explicit indexed_elems(const Container& xs)
+            : its_()
+        {
+            its_.reserve(size_of_cont(xs));
+            for (auto it = std::cbegin(xs); it != std::cend(xs); ++it) {
+                its_.push_back(it);
+            }
+        }
+        decltype(auto) operator[](std::size_t idx) const
+        {
+            return *its_[idx];
+        }
+
+    private:
+        std::vector<typename Container::const_iterator> its_;
+    };
+
+    template <typename Container>
+    class indexed_elems<Container, true> {
+    public:
+        explicit indexed_elems(const Container& xs)
+            : begin_(std::cbegin(xs))
+        {
+        }
+        decltype(auto) operator[](std::size_t idx) const
+        {
+            return begin_[static_cast<std::ptrdiff_t>(idx)];
+        }
+
+    private:
+        typename Container::const_iterator begin_;
+    };
+
+    // Pre-sized output of a parallel transformation.
+    // Every slot is written exactly once, by whichever thread
+    // processes the corresponding input element.
+    // Types without a default constructor or move assignment, and bool
+    // (std::vector<bool> packs neighboring slots into one byte),
+    // are stored as maybes.
+    template <typename Y,
+        bool Direct = std::is_default_constructible<Y>::value
+            && std::is_move_assignable<Y>::value
+            && !std::is_same<Y, bool>::value>
+    class parallel_output_slots {
+    public:
+        explicit parallel_output_slots(std::size_t n)
+            : ys_(n)
+        {
+        }
+        void set(std::size_t idx, Y&& y)
+        {
+            ys_[idx] = std::move(y);
+        }
+        template <typename ContainerOut>
+        ContainerOut get(std::true_type)
+        {
+            return std::move(ys_);
+        }
+        template <typename ContainerOut>
+        ContainerOut get(std::false_type)
+        {
+            return convert_container<ContainerOut>(ys_);
+        }
+        template <typename ContainerOut>
+        ContainerOut get()
+        {
+            return get<ContainerOut>(
+                std::is_same<ContainerOut, std::vector<Y>> {});
+        }
+
+    private:
+        std::vector<Y> ys_;
+    };
+
+    template <typename Y>
+    class parallel_output_slots<Y, false> {
+    public:
+        explicit parallel_output_slots(std::size_t n)
+            : ys_(n)
+        {
+        }
+        void set(std::size_t idx, Y&& y)
+        {
+            ys_[idx] = std::move(y);
+        }
+        template <typename ContainerOut>
+        ContainerOut get()
+        {
+            ContainerOut result;
+            internal::prepare_container(result, ys_.size());
+            auto it = internal::get_back_inserter<ContainerOut>(result);
+            for (auto& y : ys_) {
+                *it = std::move(y.unsafe_get_just());
+            }
+            return result;
+        }
+
+    private:
+        std::vector<maybe<Y>> ys_;
+    };
+
+    // Calls worker() on n threads, the calling thread being one of them,
+    // and rethrows the first exception thrown by any of them.
+    template <typename F>
+    void run_on_n_threads(std::size_t n, F worker)
+    {
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        const auto guarded_worker = [&]() {
+            try {
+                worker();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        for (std::size_t i = 1; i < n; ++i) {
+            threads.emplace_back(guarded_worker);
+        }
+        guarded_worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Chunk runners process n_chunks chunks by calling f(chunk_idx),
+    // know how many workers they have at their disposal
+    // and into how many chunks a job over n items should be split.
+
+    // Runs the chunks on a thread pool.
+    struct pool_chunk_runner {
+        thread_pool& pool;
+        std::size_t n_workers() const
+        {
+            return pool.size();
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return parallel_chunk_count(n_items, n_workers());
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            pool.run_chunks(n_chunks, f);
+        }
+    };
+
+    // Tuning constants of adaptive_chunk_runner.
+    // Time spent sampling chunks before deciding.
+    const double adaptive_sample_seconds = 50e-6;
+    // Minimum work an additional thread has to get to be worth using it.
+    const double adaptive_min_seconds_per_thread = 100e-6;
+    // Desired duration of one task, to keep the queue overhead low.
+    const double adaptive_task_seconds = 50e-6;
+
+    // Chooses how the n_rest chunks left after sampling are distributed,
+    // given that n_sampled chunks took sampled_seconds on one thread.
+    inline parallel_schedule adaptive_schedule(std::size_t n_chunks,
+        std::size_t n_sampled, double sampled_seconds,
+        std::size_t n_rest, std::size_t n_workers)
+    {
+        const double seconds_per_chunk = sampled_seconds
+            / static_cast<double>(std::max<std::size_t>(1, n_sampled));
+        const double rest_seconds = seconds_per_chunk * static_cast<double>(n_rest);
+        const double max_threads = std::min(
+            static_cast<double>(std::min(n_workers + 1, n_rest)),
+            rest_seconds / adaptive_min_seconds_per_thread);
+        const std::size_t n_threads = std::max<std::size_t>(1,
+            static_cast<std::size_t>(max_threads));
+        std::size_t chunks_per_task = std::max<std::size_t>(1, n_rest);
+        if (n_threads > 1) {
+            // Leave some slack to balance unevenly expensive chunks.
+            const std::size_t max_chunks_per_task = std::max<std::size_t>(1,
+                n_rest / (4 * n_threads));
+            chunks_per_task = static_cast<std::size_t>(std::max(1.0,
+                std::ceil(std::min(static_cast<double>(max_chunks_per_task),
+                    adaptive_task_seconds / seconds_per_chunk))));
+        }
+        return { n_chunks, n_sampled, sampled_seconds, rest_seconds,
+            n_threads, chunks_per_task };
+    }
+
+    // Runs many small chunks on a thread pool,
+    // choosing the number of threads and the grain size at run time:
+    // Jobs with no more chunks than threads are handed to the pool directly.
+    // Otherwise all threads start claiming chunks one by one,
+    // while the first of them measures the cost of its chunks.
+    // From that, the remaining work is estimated.
+    // If it does not justify more threads, the surplus ones stop,
+    // down to the sampling thread processing the rest on its own.
+    // The others continue in tasks of as many chunks
+    // as are needed to make the claiming overhead negligible.
+    // The chosen schedule is reported to the parallel_schedule_observer.
+    struct adaptive_chunk_runner {
+        thread_pool& pool;
+        std::size_t n_workers() const
+        {
+            return pool.size();
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return std::min(n_items, 64 * (n_workers() + 1));
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            if (n_chunks == 0) {
+                return;
+            }
+            const std::size_t max_threads = n_workers() + 1;
+            if (n_chunks <= max_threads) {
+                parallel_schedule_observer().notify({ n_chunks, 0, 0, 0, n_chunks, 1 });
+                pool.run_chunks(n_chunks, f);
+                return;
+            }
+
+            typedef std::chrono::steady_clock clock;
+            // Chunks are claimed from next_chunk, chunks_per_task at a time.
+            // Threads ranked at or above n_threads stop claiming.
+            // The sampling thread has rank 0.
+            std::atomic<std::size_t> next_chunk(0);
+            std::atomic<std::size_t> chunks_per_task(1);
+            std::atomic<std::size_t> n_threads(max_threads);
+            std::atomic<std::size_t> next_rank(0);
+            parallel_schedule schedule = { n_chunks, 0, 0, 0, max_threads, 1 };
+            const auto sample = [&]() {
+                const std::size_t max_sampled = std::max<std::size_t>(1, n_chunks / 8);
+                const auto sample_start = clock::now();
+                std::size_t n_sampled = 0;
+                double sampled_seconds = 0;
+                while (n_sampled < max_sampled
+                    && sampled_seconds < adaptive_sample_seconds) {
+                    const std::size_t chunk_idx = next_chunk.fetch_add(1);
+                    if (chunk_idx >= n_chunks) {
+                        break;
+                    }
+                    f(chunk_idx);
+                    ++n_sampled;
+                    sampled_seconds = std::chrono::duration<double>(
+                        clock::now() - sample_start)
+                                          .count();
+                }
+                const std::size_t n_claimed = std::min(n_chunks, next_chunk.load());
+                schedule = adaptive_schedule(n_chunks, n_sampled, sampled_seconds,
+                    n_chunks - n_claimed, n_workers());
+                chunks_per_task.store(schedule.chunks_per_task);
+                n_threads.store(schedule.n_threads);
+            };
+            pool.run_chunks(
+                max_threads, [&](std::size_t) {
+                    const std::size_t rank = next_rank.fetch_add(1);
+                    if (rank == 0) {
+                        sample();
+                    }
+                    while (rank < n_threads.load()) {
+                        const std::size_t n = chunks_per_task.load();
+                        const std::size_t begin = next_chunk.fetch_add(n);
+                        if (begin >= n_chunks) {
+                            return;
+                        }
+                        const std::size_t end = std::min(n_chunks, begin + n);
+                        for (std::size_t chunk_idx = begin; chunk_idx < end; ++chunk_idx) {
+                            f(chunk_idx);
+                        }
+                    }
+                },
+                n_workers());
+            parallel_schedule_observer().notify(schedule);
+        }
+    };
+
+    inline adaptive_chunk_runner default_chunk_runner()
+    {
+        return { default_thread_pool() };
+    }
+
+    // Runs the chunks on n new threads,
+    // which claim the next free chunk from a shared counter.
+    struct n_threads_chunk_runner {
+        std::size_t n;
+        std::size_t n_workers() const
+        {
+            return n;
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return parallel_chunk_count(n_items, n_workers());
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            std::atomic<std::size_t> next_chunk(0);
+            run_on_n_threads(
+                std::max<std::size_t>(1, std::min(n, n_chunks)), [&]() {
+                    for (;;) {
+                        const std::size_t chunk_idx = next_chunk.fetch_add(1);
+                        if (chunk_idx >= n_chunks) {
+                            return;
+                        }
+                        f(chunk_idx);
+                    }
+                });
+        }
+    };
+
+    // Runs the chunks on one new thread per entry of a thread_placement,
+    // every thread pinned to its CPU.
+    // There is one contiguous chunk per thread and the assignment is static,
+    // so a thread always works on the same slice of the data.
+    struct placed_chunk_runner {
+        const thread_placement& placement;
+        std::size_t n_workers() const
+        {
+            return placement.cpus.size();
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return std::min(n_items, n_workers());
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            const std::size_t n_threads = std::min(n_chunks, n_workers());
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            const auto worker = [&](std::size_t thread_idx) {
+                pin_current_thread_to_cpu(placement.cpus[thread_idx]);
+                try {
+                    for (std::size_t chunk_idx = thread_idx; chunk_idx < n_chunks;
+                         chunk_idx += n_threads) {
+                        f(chunk_idx);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(n_threads);
+            for (std::size_t i = 0; i < n_threads; ++i) {
+                threads.emplace_back(worker, i);
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
+
+    // Iterators to the first element of every chunk
+    // plus the end iterator of the container.
+    template <typename Container>
+    std::vector<typename Container::const_iterator> chunk_begin_iterators(
+        const Container& xs, std::size_t n_chunks)
+    {
+        const std::size_t n = size_of_cont(xs);
+        std::vector<typename Container::const_iterator> result;
+        result.reserve(n_chunks + 1);
+        result.push_back(std::cbegin(xs));
+        for (std::size_t i = 0; i < n_chunks; ++i) {
+            const auto chunk_size = parallel_chunk_begin(n, n_chunks, i + 1)
+                - parallel_chunk_begin(n, n_chunks, i);
+            result.push_back(std::next(
+                result.back(), static_cast<std::ptrdiff_t>(chunk_size)));
+        }
+        return result;
+    }
+
+    // Every chunk is folded sequentially into one partial result,
+    // then the partial results are joined from left to right.
+    // So binary_f only needs to be associative,
+    // and the memory overhead is one value per chunk.
+    template <typename ChunkRunner, typename UnaryF, typename BinaryF,
+        typename Container>
+    auto transform_reduce_1_chunked(const ChunkRunner& run_chunks,
+        UnaryF unary_f,
+        BinaryF binary_f,
+        const Container& xs)
+    {
+        assert(is_not_empty(xs));
+        using X = typename Container::value_type;
+        using T = std::decay_t<internal::invoke_result_t<UnaryF, X>>;
+        const std::size_t n_chunks = run_chunks.chunk_count(size_of_cont(xs));
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+        std::vector<maybe<T>> partials(n_chunks);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            auto it = chunk_begins[chunk_idx];
+            const auto end = chunk_begins[chunk_idx + 1];
+            T acc = internal::invoke(unary_f, *it);
+            for (++it; it != end; ++it) {
+                acc = internal::invoke(binary_f, std::move(acc),
+                    internal::invoke(unary_f, *it));
+            }
+            partials[chunk_idx] = std::move(acc);
+        });
+        T result = std::move(partials.front().unsafe_get_just());
+        for (std::size_t i = 1; i < n_chunks; ++i) {
+            result = internal::invoke(binary_f, std::move(result),
+                std::move(partials[i].unsafe_get_just()));
+        }
+        return result;
+    }
+
+    // Identity function handing out references to the elements,
+    // so a plain reduction does not copy them.
+    struct pass_elem_through {
+        template <typename T>
+        const T& operator()(const T& x) const
+        {
+            return x;
+        }
+    };
+
+    // Parallel stream compaction:
+    // 1. Every chunk evaluates the predicate and counts its matches.
+    // 2. An exclusive prefix sum over the (few) chunk counts
+    //    yields the output offset of every chunk.
+    // 3. Every chunk copies its elements into the pre-sized outputs.
+    // Only the requested sides of the partition are filled.
+    template <typename ChunkRunner, typename Pred, typename Container>
+    std::pair<Container, Container> partition_chunked(
+        const ChunkRunner& run_chunks,
+        Pred pred,
+        const Container& xs,
+        bool fill_matching,
+        bool fill_not_matching)
+    {
+        using T = typename Container::value_type;
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+
+        // Avoid a temporary std::vector<bool>.
+        std::vector<std::uint8_t> flags(n, 0);
+        std::vector<std::size_t> matching_offsets(n_chunks + 1, 0);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx);
+            std::size_t count = 0;
+            for (auto it = chunk_begins[chunk_idx];
+                 it != chunk_begins[chunk_idx + 1]; ++it, ++idx) {
+                if (internal::invoke(pred, *it)) {
+                    flags[idx] = 1;
+                    ++count;
+                }
+            }
+            matching_offsets[chunk_idx + 1] = count;
+        });
+        for (std::size_t i = 1; i <= n_chunks; ++i) {
+            matching_offsets[i] += matching_offsets[i - 1];
+        }
+        const std::size_t n_matching = matching_offsets.back();
+
+        parallel_output_slots<T> matching(fill_matching ? n_matching : 0);
+        parallel_output_slots<T> not_matching(
+            fill_not_matching ? n - n_matching : 0);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            const std::size_t chunk_begin = parallel_chunk_begin(n, n_chunks, chunk_idx);
+            std::size_t idx = chunk_begin;
+            std::size_t idx_matching = matching_offsets[chunk_idx];
+            std::size_t idx_not_matching = chunk_begin - idx_matching;
+            for (auto it = chunk_begins[chunk_idx];
+                 it != chunk_begins[chunk_idx + 1]; ++it, ++idx) {
+                if (flags[idx]) {
+                    if (fill_matching) {
+                        matching.set(idx_matching, T(*it));
+                    }
+                    ++idx_matching;
+                } else {
+                    if (fill_not_matching) {
+                        not_matching.set(idx_not_matching, T(*it));
+                    }
+                    ++idx_not_matching;
+                }
+            }
+        });
+        return { matching.template get<Container>(),
+            not_matching.template get<Container>() };
+    }
+
+    // Searches the chunks in parallel for an element fulfilling pred.
+    // Found indices are published through a shared atomic minimum,
+    // and every chunk stops as soon as it can not improve on it anymore,
+    // i.e. all remaining work is cancelled cooperatively.
+    // Returns the lowest matching index,
+    // or any matching index if any_match_suffices is set.
+    template <typename ChunkRunner, typename Pred, typename Container>
+    maybe<std::size_t> find_first_idx_by_chunked(
+        const ChunkRunner& run_chunks, Pred pred, const Container& xs,
+        bool any_match_suffices)
+    {
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+        std::atomic<std::size_t> found_idx(n);
+        const auto is_done = [&](std::size_t idx) {
+            const std::size_t found = found_idx.load(std::memory_order_relaxed);
+            return any_match_suffices ? found != n : idx >= found;
+        };
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx);
+            for (auto it = chunk_begins[chunk_idx];
+                 it != chunk_begins[chunk_idx + 1] && !is_done(idx); ++it, ++idx) {
+                if (internal::invoke(pred, *it)) {
+                    std::size_t found = found_idx.load();
+                    while (idx < found
+                        && !found_idx.compare_exchange_weak(found, idx)) {
+                    }
+                    return;
+                }
+            }
+        });
+        if (found_idx.load() == n) {
+            return nothing<std::size_t>();
+        }
+        return just(found_idx.load());
+    }
+
+    // Two-pass parallel prefix scan:
+    // 1. Every chunk (but the last) is folded into one partial result.
+    // 2. An exclusive scan over the (few) partial results
+    //    yields the carry-in value of every chunk.
+    // 3. Every chunk scans its elements starting with its carry-in,
+    //    writing directly into the pre-sized output.
+    // If init is a just, it is the first element of the output
+    // and the carry-in of the first chunk.
+    template <typename ContainerOut, typename ChunkRunner, typename F,
+        typename Container>
+    ContainerOut scan_left_chunked(const ChunkRunner& run_chunks, F f,
+        const maybe<typename Container::value_type>& init, const Container& xs)
+    {
+        using T = typename Container::value_type;
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+        const std::size_t out_offset = init.is_just() ? 1 : 0;
+        parallel_output_slots<T> ys(n + out_offset);
+        if (init.is_just()) {
+            ys.set(0, T(init.unsafe_get_just()));
+        }
+
+        std::vector<maybe<T>> partials(n_chunks);
+        if (n_chunks > 1) {
+            run_chunks(n_chunks - 1, [&](std::size_t chunk_idx) {
+                auto it = chunk_begins[chunk_idx];
+                T acc = *it;
+                for (++it; it != chunk_begins[chunk_idx + 1]; ++it) {
+                    acc = internal::invoke(f, std::move(acc), *it);
+                }
+                partials[chunk_idx] = std::move(acc);
+            });
+        }
+
+        std::vector<maybe<T>> carries(n_chunks);
+        if (n_chunks > 0) {
+            carries[0] = init;
+        }
+        for (std::size_t i = 1; i < n_chunks; ++i) {
+            if (carries[i - 1].is_just()) {
+                carries[i] = internal::invoke(f,
+                    carries[i - 1].unsafe_get_just(),
+                    partials[i - 1].unsafe_get_just());
+            } else {
+                carries[i] = partials[i - 1];
+            }
+        }
+
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx) + out_offset;
+            auto it = chunk_begins[chunk_idx];
+            T acc = carries[chunk_idx].is_just()
+                ? internal::invoke(f, carries[chunk_idx].unsafe_get_just(), *it)
+                : T(*it);
+            ys.set(idx++, T(acc));
+            for (++it; it != chunk_begins[chunk_idx + 1]; ++it) {
+                acc = internal::invoke(f, std::move(acc), *it);
+                ys.set(idx++, T(acc));
+            }
+        });
+        return ys.template get<ContainerOut>();
+    }
+
+    // Moves the stable merge of [a, a_end) and [b, b_end) to out.
+    // On equivalence the element of the first range goes first.
+    template <typename Compare, typename InIt, typename OutIt>
+    void move_merge(Compare comp,
+        InIt a, InIt a_end, InIt b, InIt b_end, OutIt out)
+    {
+        while (a != a_end && b != b_end) {
+            if (internal::invoke(comp, *b, *a)) {
+                *out = std::move(*b);
+                ++b;
+            } else {
+                *out = std::move(*a);
+                ++a;
+            }
+            ++out;
+        }
+        out = std::move(a, a_end, out);
+        std::move(b, b_end, out);
+    }
+
+    // Number of elements taken from [a, a + size_a)
+    // when the first k elements of the stable merge of
+    // [a, a + size_a) and [b, b + size_b) are taken (merge path).
+    template <typename Compare, typename It>
+    std::size_t merge_path_split(Compare comp,
+        It a, std::size_t size_a, It b, std::size_t size_b, std::size_t k)
+    {
+        std::size_t lo = k > size_b ? k - size_b : 0;
+        std::size_t hi = std::min(k, size_a);
+        while (lo < hi) {
+            const std::size_t i = lo + (hi - lo) / 2;
+            const std::size_t j = k - i;
+            if (!internal::invoke(comp,
+                    b[static_cast<std::ptrdiff_t>(j - 1)],
+                    a[static_cast<std::ptrdiff_t>(i)])) {
+                lo = i + 1;
+            } else {
+                hi = i;
+            }
+        }
+        return lo;
+    }
+
+    // Parallel merge sort of a random-access range.
+    // Every worker sorts one contiguous run,
+    // then neighboring runs are merged pairwise in rounds,
+    // ping-ponging between the range and one buffer.
+    // Every merge is split along its merge path into pieces,
+    // so all workers are busy even in the last rounds.
+    // The merges are stable, so the result is stable
+    // if the runs are sorted stably.
+    // The runs are coarse by design, so this expects a pool_chunk_runner
+    // and not the sampling adaptive_chunk_runner.
+    template <typename ChunkRunner, typename Compare, typename It>
+    void merge_sort_parallelly(const ChunkRunner& run_chunks,
+        bool stable, Compare comp, It first, It last)
+    {
+        using T = typename std::iterator_traits<It>::value_type;
+        const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+        const std::size_t n_workers = std::max<std::size_t>(1, run_chunks.n_workers());
+        const std::size_t n_runs = std::min(n_workers, n / 2);
+        const auto sort_range = [&](It begin, It end) {
+            if (stable) {
+                std::stable_sort(begin, end, comp);
+            } else {
+                std::sort(begin, end, comp);
+            }
+        };
+        // Neighboring elements of a std::vector<bool> share their bytes.
+        if (n_runs < 2 || std::is_same<T, bool>::value) {
+            sort_range(first, last);
+            return;
+        }
+
+        std::vector<std::size_t> bounds;
+        for (std::size_t i = 0; i <= n_runs; ++i) {
+            bounds.push_back(parallel_chunk_begin(n, n_runs, i));
+        }
+        const auto at = [](auto it, std::size_t idx) {
+            return std::next(it, static_cast<std::ptrdiff_t>(idx));
+        };
+        run_chunks(n_runs, [&](std::size_t run_idx) {
+            sort_range(at(first, bounds[run_idx]), at(first, bounds[run_idx + 1]));
+        });
+
+        std::vector<T> buffer(
+            std::make_move_iterator(first), std::make_move_iterator(last));
+        bool in_buffer = true;
+        while (bounds.size() > 2) {
+            const auto merge_round = [&](auto src, auto dst) {
+                const std::size_t n_pairs = (bounds.size() - 1) / 2;
+                // Every pair is split into pieces of about n / n_workers elements.
+                std::vector<std::size_t> pieces_begin = { 0 };
+                for (std::size_t p = 0; p < n_pairs; ++p) {
+                    const std::size_t pair_size = bounds[2 * p + 2] - bounds[2 * p];
+                    pieces_begin.push_back(pieces_begin.back()
+                        + std::max<std::size_t>(1, n_workers * pair_size / n));
+                }
+                const std::size_t n_pieces = pieces_begin.back();
+                const bool has_lonely_run = (bounds.size() - 1) % 2 == 1;
+                run_chunks(n_pieces + (has_lonely_run ? 1 : 0), [&](std::size_t piece_idx) {
+                    if (piece_idx == n_pieces) {
+                        const std::size_t begin = bounds[bounds.size() - 2];
+                        std::move(at(src, begin), at(src, n), at(dst, begin));
+                        return;
+                    }
+                    const std::size_t p = static_cast<std::size_t>(std::distance(
+                        pieces_begin.begin(),
+                        std::upper_bound(pieces_begin.begin(), pieces_begin.end(), piece_idx)) - 1);
+                    const std::size_t begin_a = bounds[2 * p];
+                    const std::size_t begin_b = bounds[2 * p + 1];
+                    const std::size_t size_a = begin_b - begin_a;
+                    const std::size_t size_b = bounds[2 * p + 2] - begin_b;
+                    const std::size_t n_pair_pieces = pieces_begin[p + 1] - pieces_begin[p];
+                    const std::size_t piece = piece_idx - pieces_begin[p];
+                    const std::size_t k_begin = parallel_chunk_begin(size_a + size_b, n_pair_pieces, piece);
+                    const std::size_t k_end = parallel_chunk_begin(size_a + size_b, n_pair_pieces, piece + 1);
+                    const auto a = at(src, begin_a);
+                    const auto b = at(src, begin_b);
+                    const std::size_t i_begin = merge_path_split(comp, a, size_a, b, size_b, k_begin);
+                    const std::size_t i_end = merge_path_split(comp, a, size_a, b, size_b, k_end);
+                    move_merge(comp,
+                        at(a, i_begin), at(a, i_end),
+                        at(b, k_begin - i_begin), at(b, k_end - i_end),
+                        at(dst, begin_a + k_begin));
+                });
+            };
+            if (in_buffer) {
+                merge_round(buffer.begin(), first);
+            } else {
+                merge_round(first, buffer.begin());
+            }
+            in_buffer = !in_buffer;
+            std::vector<std::size_t> merged_bounds;
+            for (std::size_t i = 0; i < bounds.size(); i += 2) {
+                merged_bounds.push_back(bounds[i]);
+            }
+            if (merged_bounds.back() != n) {
+                merged_bounds.push_back(n);
+            }
+            bounds = merged_bounds;
+        }
+        if (in_buffer) {
+            run_chunks(n_workers, [&](std::size_t chunk_idx) {
+                const std::size_t begin = parallel_chunk_begin(n, n_workers, chunk_idx);
+                const std::size_t end = parallel_chunk_begin(n, n_workers, chunk_idx + 1);
+                std::move(at(buffer.begin(), begin), at(buffer.begin(), end), at(first, begin));
+            });
+        }
+    }
+
+    template <typename ChunkRunner, typename Compare, typename T>
+    std::list<T> sort_by_parallelly(internal::reuse_container_t,
+        const ChunkRunner&, bool stable, Compare comp, std::list<T>&& xs)
+    {
+        // std::list<T>::sort is stable, and lists can not be split cheaply.
+        (void)stable;
+        xs.sort(comp);
+        return std::forward<std::list<T>>(xs);
+    }
+
+    template <typename ChunkRunner, typename Compare, typename Container>
+    Container sort_by_parallelly(internal::reuse_container_t,
+        const ChunkRunner& run_chunks, bool stable, Compare comp,
+        Container&& xs)
+    {
+        merge_sort_parallelly(run_chunks, stable, comp,
+            std::begin(xs), std::end(xs));
+        return std::forward<Container>(xs);
+    }
+
+    template <typename ChunkRunner, typename Compare, typename Container>
+    Container sort_by_parallelly(internal::create_new_container_t,
+        const ChunkRunner& run_chunks, bool stable, Compare comp,
+        const Container& xs)
+    {
+        auto result = xs;
+        return sort_by_parallelly(internal::reuse_container_t(),
+            run_chunks, stable, comp, std::move(result));
+    }
+
+    // Applies f to contiguous chunks of xs,
+    // writing every result directly into its output slot.
+    template <typename ContainerOut, typename ChunkRunner, typename F,
+        typename ContainerIn>
+    ContainerOut transform_parallelly_chunked(
+        const ChunkRunner& run_chunks, F f, const ContainerIn& xs)
+    {
+        using X = typename ContainerIn::value_type;
+        using Y = std::decay_t<internal::invoke_result_t<F, X>>;
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const indexed_elems<ContainerIn> elems(xs);
+        parallel_output_slots<Y> ys(n);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            const std::size_t end = parallel_chunk_begin(n, n_chunks, chunk_idx + 1);
+            for (std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx);
+                 idx < end; ++idx) {
+                ys.set(idx, internal::invoke(f, elems[idx]));
+            }
+        });
+        return ys.template get<ContainerOut>();
+    }
+
+} // namespace internal
+
 // API search type: transform_parallelly : ((a -> b), [a]) -> [b]
 // fwd bind count: 1
 // transform_parallelly((*2), [1, 3, 4]) == [2, 6, 8]
-// Same as transform, but can utilize multiple CPUs by using std::launch::async.
-// Only makes sense if one run of the provided function
-// takes enough time to justify the synchronization overhead.
-// One thread per container element is spawned.
+// Same as transform, but can utilize multiple CPUs.
+// The elements are processed in contiguous chunks
+// by a process-wide pool of worker threads,
+// which is created once and then reused by all *_parallelly functions.
+// The cost of f is measured on the first elements,
+// and the remaining ones are only distributed to other threads
+// if this is estimated to pay off, otherwise they are processed serially.
+// set_parallel_schedule_observer allows to inspect these decisions.
 // Check out transform_parallelly_n_threads to limit the number of threads.
 template <typename F, typename ContainerIn>
 auto transform_parallelly(F f, const ContainerIn& xs)
@@ -298,28 +1253,17 @@ auto transform_parallelly(F f, const ContainerIn& xs)
         same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
     using X = typename ContainerIn::value_type;
     internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
-    auto handles = transform([&f](const X& x) {
-        return std::async(std::launch::async, [&x, &f]() {
-            return internal::invoke(f, x);
-        });
-    },
-        xs);
-
-    ContainerOut ys;
-    internal::prepare_container(ys, size_of_cont(xs));
-    auto it = internal::get_back_inserter<ContainerOut>(ys);
-    for (auto& handle : handles) {
-        *it = handle.get();
-    }
-    return ys;
+    return internal::transform_parallelly_chunked<ContainerOut>(
+        internal::default_chunk_runner(), f, xs);
 }
 
 // API search type: transform_parallelly_n_threads : (Int, (a -> b), [a]) -> [b]
 // fwd bind count: 2
 // transform_parallelly_n_threads(4, (*2), [1, 3, 4]) == [2, 6, 8]
 // Same as transform, but uses n threads in parallel.
-// Only makes sense if one run of the provided function
-// takes enough time to justify the synchronization overhead.
+// The threads claim contiguous ranges of elements from a shared counter
+// and write the results directly into the pre-sized output,
+// so no locking is involved.
 // Can be used for applying the MapReduce pattern.
 template <typename F, typename ContainerIn>
 auto transform_parallelly_n_threads(std::size_t n, F f, const ContainerIn& xs)
@@ -327,64 +1271,41 @@ auto transform_parallelly_n_threads(std::size_t n, F f, const ContainerIn& xs)
     using ContainerOut = typename internal::
         same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
     using X = typename ContainerIn::value_type;
-    using Y = internal::invoke_result_t<F, X>;
-    using x_ptr_t = const X*;
-    auto queue = transform_convert<std::vector<x_ptr_t>>(
-        [](const X& x) -> x_ptr_t {
-            return &x;
-        },
-        xs);
-
-    std::mutex queue_mutex;
-    std::mutex thread_results_mutex;
-    std::map<std::size_t, std::decay_t<Y>> thread_results;
-    std::size_t queue_idx = 0;
-
-    const auto worker_func = [&]() {
-        for (;;) {
-            std::size_t idx = std::numeric_limits<std::size_t>::max();
-            x_ptr_t x_ptr = nullptr;
-            {
-                std::lock_guard<std::mutex> queue_lock(queue_mutex);
-                if (queue_idx == queue.size()) {
-                    return;
-                }
-                idx = queue_idx;
-                x_ptr = queue[idx];
-                ++queue_idx;
-            }
-
-            const auto y = internal::invoke(f, *x_ptr);
-
-            {
-                std::lock_guard<std::mutex> thread_results_lock(
-                    thread_results_mutex);
-                thread_results.insert(std::make_pair(idx, y));
-            }
-        }
-    };
-
-    const auto create_thread = [&]() -> std::thread {
-        return std::thread(worker_func);
-    };
-    auto threads = generate<std::vector<std::thread>>(create_thread, n);
-
-    for (auto& thread : threads) {
-        thread.join();
-    }
+    internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
+    return internal::transform_parallelly_chunked<ContainerOut>(
+        internal::n_threads_chunk_runner { n }, f, xs);
+}
 
-    return get_map_values<decltype(thread_results), ContainerOut>(
-        thread_results);
+// API search type: transform_parallelly_placed : (ThreadPlacement, (a -> b), [a]) -> [b]
+// fwd bind count: 2
+// transform_parallelly_placed(compact_thread_placement(4), (*2), [1, 3, 4]) == [2, 6, 8]
+// Same as transform, but uses one thread per entry of the placement,
+// each one pinned to its CPU and working on one contiguous slice of xs.
+// Useful on multi-socket machines to keep threads from migrating
+// and reading their data across the interconnect.
+// The output is allocated and initialized by the calling thread,
+// so its memory stays on the NUMA node of the caller.
+template <typename F, typename ContainerIn>
+auto transform_parallelly_placed(
+    const thread_placement& placement, F f, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::
+        same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
+    using X = typename ContainerIn::value_type;
+    internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
+    assert(!placement.cpus.empty());
+    return internal::transform_parallelly_chunked<ContainerOut>(
+        internal::placed_chunk_runner { placement }, f, xs);
 }
 
 // API search type: reduce_parallelly : (((a, a) -> a), a, [a]) -> a
 // fwd bind count: 2
 // reduce_parallelly((+), 0, [1, 2, 3]) == (0+1+2+3) == 6
-// Same as reduce, but can utilize multiple CPUs by using std::launch::async.
-// Combines the initial value and all elements of the sequence
-// using the given function in unspecified order.
-// The set of f, init and value_type should form a commutative monoid.
-// One thread per container element is spawned.
+// Same as reduce, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f, init and value_type should form a monoid.
 // Check out reduce_parallelly_n_threads to limit the number of threads.
 template <typename F, typename Container>
 typename Container::value_type reduce_parallelly(
@@ -392,28 +1313,19 @@ typename Container::value_type reduce_parallelly(
 {
     if (is_empty(xs)) {
         return init;
-    } else if (size_of_cont(xs) == 1) {
-        return internal::invoke(f, init, xs.front());
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly(f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_parallelly(f, init, transform_result);
     }
+    return internal::invoke(f, init,
+        internal::transform_reduce_1_chunked(internal::default_chunk_runner(),
+            internal::pass_elem_through(), f, xs));
 }
 
 // API search type: reduce_parallelly_n_threads : (Int, ((a, a) -> a), a, [a]) -> a
 // fwd bind count: 3
 // reduce_parallelly_n_threads(2, (+), 0, [1, 2, 3]) == (0+1+2+3) == 6
-// Same as reduce, but can utilize multiple CPUs by using std::launch::async.
-// Combines the initial value and all elements of the sequence
-// using the given function in unspecified order.
-// The set of f, init and value_type should form a commutative monoid.
+// Same as reduce, but uses n threads in parallel.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f, init and value_type should form a monoid.
 template <typename F, typename Container>
 typename Container::value_type reduce_parallelly_n_threads(
     std::size_t n,
@@ -421,74 +1333,249 @@ typename Container::value_type reduce_parallelly_n_threads(
 {
     if (is_empty(xs)) {
         return init;
-    } else if (size_of_cont(xs) == 1) {
-        return internal::invoke(f, init, xs.front());
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly_n_threads(n, f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_parallelly_n_threads(n, f, init, transform_result);
     }
+    return internal::invoke(f, init,
+        internal::transform_reduce_1_chunked(
+            internal::n_threads_chunk_runner { n }, internal::pass_elem_through(), f, xs));
 }
 
 // API search type: reduce_1_parallelly : (((a, a) -> a), [a]) -> a
 // fwd bind count: 1
 // reduce_1_parallelly((+), [1, 2, 3]) == (1+2+3) == 6
-// Same as reduce_1, but can utilize multiple CPUs by using std::launch::async.
-// Joins all elements of the sequence using the given function
-// in unspecified order.
-// The set of f and value_type should form a commutative semigroup.
-// One thread per container element is spawned.
+// Same as reduce_1, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f and value_type should form a semigroup.
 // Check out reduce_1_parallelly_n_threads to limit the number of threads.
 template <typename F, typename Container>
 typename Container::value_type reduce_1_parallelly(F f, const Container& xs)
 {
-    assert(is_not_empty(xs));
-    if (size_of_cont(xs) == 1) {
-        return xs.front();
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly(f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_1_parallelly(f, transform_result);
-    }
+    return internal::transform_reduce_1_chunked(
+        internal::default_chunk_runner(), internal::pass_elem_through(), f, xs);
 }
 
 // API search type: reduce_1_parallelly_n_threads : (Int, ((a, a) -> a), [a]) -> a
 // fwd bind count: 2
 // reduce_1_parallelly_n_threads(2, (+), [1, 2, 3]) == (1+2+3) == 6
-// Same as reduce_1, but can utilize multiple CPUs by using std::launch::async.
-// Joins all elements of the sequence using the given function
-// in unspecified order.
-// The set of f and value_type should form a commutative semigroup.
+// Same as reduce_1, but uses n threads in parallel.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f and value_type should form a semigroup.
 template <typename F, typename Container>
 typename Container::value_type reduce_1_parallelly_n_threads(
     std::size_t n, F f, const Container& xs)
+{
+    return internal::transform_reduce_1_chunked(
+        internal::n_threads_chunk_runner { n }, internal::pass_elem_through(), f, xs);
+}
+
+// API search type: scan_left_parallelly : (((a, a) -> a), a, [a]) -> [a]
+// fwd bind count: 2
+// scan_left_parallelly((+), 0, [1, 2, 3]) == [0, 1, 3, 6]
+// Same as scan_left, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// Every chunk of the sequence is folded in parallel,
+// then every chunk is scanned in parallel,
+// starting with the combined result of the chunks before it.
+// So f is called about twice as often as by scan_left.
+// The set of f, init and value_type should form a monoid.
+// Check out scan_left_parallelly_n_threads to limit the number of threads.
+template <typename F, typename ContainerIn>
+auto scan_left_parallelly(F f,
+    const typename ContainerIn::value_type& init, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 1>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::default_chunk_runner(), f, just(init), xs);
+}
+
+// API search type: scan_left_parallelly_n_threads : (Int, ((a, a) -> a), a, [a]) -> [a]
+// fwd bind count: 3
+// scan_left_parallelly_n_threads(2, (+), 0, [1, 2, 3]) == [0, 1, 3, 6]
+// Same as scan_left, but uses n threads in parallel.
+// The set of f, init and value_type should form a monoid.
+template <typename F, typename ContainerIn>
+auto scan_left_parallelly_n_threads(std::size_t n, F f,
+    const typename ContainerIn::value_type& init, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 1>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::n_threads_chunk_runner { n }, f, just(init), xs);
+}
+
+// API search type: scan_left_1_parallelly : (((a, a) -> a), [a]) -> [a]
+// fwd bind count: 1
+// scan_left_1_parallelly((+), [1, 2, 3]) == [1, 3, 6]
+// Same as scan_left_1, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// The set of f and value_type should form a semigroup.
+// xs must be non-empty.
+// Check out scan_left_1_parallelly_n_threads to limit the number of threads.
+template <typename F, typename ContainerIn>
+auto scan_left_1_parallelly(F f, const ContainerIn& xs)
 {
     assert(is_not_empty(xs));
-    if (size_of_cont(xs) == 1) {
-        return xs.front();
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly_n_threads(n, f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_1_parallelly_n_threads(n, f, transform_result);
-    }
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 0>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::default_chunk_runner(), f, nothing<typename ContainerIn::value_type>(), xs);
+}
+
+// API search type: scan_left_1_parallelly_n_threads : (Int, ((a, a) -> a), [a]) -> [a]
+// fwd bind count: 2
+// scan_left_1_parallelly_n_threads(2, (+), [1, 2, 3]) == [1, 3, 6]
+// Same as scan_left_1, but uses n threads in parallel.
+// The set of f and value_type should form a semigroup.
+// xs must be non-empty.
+template <typename F, typename ContainerIn>
+auto scan_left_1_parallelly_n_threads(std::size_t n, F f, const ContainerIn& xs)
+{
+    assert(is_not_empty(xs));
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 0>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::n_threads_chunk_runner { n }, f, nothing<typename ContainerIn::value_type>(), xs);
+}
+
+// API search type: any_by_parallelly : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Same as any_by, but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// The search stops on all threads as soon as one of them found a match.
+// Runs on the thread pool of transform_parallelly.
+// any_by_parallelly(is_odd, [2, 4, 6]) == false
+// Check out any_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+bool any_by_parallelly(UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::default_chunk_runner(), p, xs, true)
+        .is_just();
+}
+
+// API search type: any_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Bool
+// fwd bind count: 2
+// Same as any_by, but uses n threads in parallel.
+// any_by_parallelly_n_threads(4, is_odd, [2, 4, 6]) == false
+template <typename UnaryPredicate, typename Container>
+bool any_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::n_threads_chunk_runner { n }, p, xs, true)
+        .is_just();
+}
+
+// API search type: none_by_parallelly : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Same as none_by, but using multiple threads.
+// The search stops on all threads as soon as one of them found a match.
+// none_by_parallelly(is_even, [3, 4, 5]) == false
+// Check out none_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+bool none_by_parallelly(UnaryPredicate p, const Container& xs)
+{
+    return !any_by_parallelly(p, xs);
+}
+
+// API search type: none_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Bool
+// fwd bind count: 2
+// Same as none_by, but uses n threads in parallel.
+// none_by_parallelly_n_threads(4, is_even, [3, 4, 5]) == false
+template <typename UnaryPredicate, typename Container>
+bool none_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate p, const Container& xs)
+{
+    return !any_by_parallelly_n_threads(n, p, xs);
+}
+
+// API search type: all_by_parallelly : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Same as all_by, but using multiple threads.
+// The search stops on all threads as soon as one of them found
+// an element not fulfilling the predicate.
+// all_by_parallelly(is_even, [2, 4, 6]) == true
+// Check out all_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+bool all_by_parallelly(UnaryPredicate p, const Container& xs)
+{
+    return none_by_parallelly(logical_not(p), xs);
+}
+
+// API search type: all_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Bool
+// fwd bind count: 2
+// Same as all_by, but uses n threads in parallel.
+// all_by_parallelly_n_threads(4, is_even, [2, 4, 6]) == true
+template <typename UnaryPredicate, typename Container>
+bool all_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate p, const Container& xs)
+{
+    return none_by_parallelly_n_threads(n, logical_not(p), xs);
+}
+
+// API search type: find_first_idx_by_parallelly : ((a -> Bool), [a]) -> Maybe Int
+// fwd bind count: 1
+// Same as find_first_idx_by, but using multiple threads.
+// Still returns the lowest index of all matching elements.
+// Threads stop searching as soon as a match
+// at a lower index than their current position has been found.
+// find_first_idx_by_parallelly(is_even, [1, 3, 4, 6, 9]) == Just(2)
+// Check out find_first_idx_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+maybe<std::size_t> find_first_idx_by_parallelly(
+    UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::default_chunk_runner(), pred, xs, false);
+}
+
+// API search type: find_first_idx_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Maybe Int
+// fwd bind count: 2
+// Same as find_first_idx_by, but uses n threads in parallel.
+// find_first_idx_by_parallelly_n_threads(4, is_even, [1, 3, 4, 6, 9]) == Just(2)
+template <typename UnaryPredicate, typename Container>
+maybe<std::size_t> find_first_idx_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, false);
+}
+
+// API search type: find_first_by_parallelly : ((a -> Bool), [a]) -> Maybe a
+// fwd bind count: 1
+// Same as find_first_by, but using multiple threads.
+// find_first_by_parallelly(is_even, [1, 3, 4, 6, 9]) == Just(4)
+// Check out find_first_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container,
+    typename T = typename Container::value_type>
+maybe<T> find_first_by_parallelly(UnaryPredicate pred, const Container& xs)
+{
+    return lift_maybe([&xs](std::size_t idx) -> T {
+        return *std::next(std::begin(xs), static_cast<std::ptrdiff_t>(idx));
+    },
+        find_first_idx_by_parallelly(pred, xs));
+}
+
+// API search type: find_first_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Maybe a
+// fwd bind count: 2
+// Same as find_first_by, but uses n threads in parallel.
+// find_first_by_parallelly_n_threads(4, is_even, [1, 3, 4, 6, 9]) == Just(4)
+template <typename UnaryPredicate, typename Container,
+    typename T = typename Container::value_type>
+maybe<T> find_first_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate pred, const Container& xs)
+{
+    return lift_maybe([&xs](std::size_t idx) -> T {
+        return *std::next(std::begin(xs), static_cast<std::ptrdiff_t>(idx));
+    },
+        find_first_idx_by_parallelly_n_threads(n, pred, xs));
 }
 
 // API search type: keep_if_parallelly : ((a -> Bool), [a]) -> [a]
@@ -496,19 +1583,16 @@ typename Container::value_type reduce_1_parallelly_n_threads(
 // Same as keep_if but using multiple threads.
 // Can be useful if calling the predicate takes some time.
 // keep_if_parallelly(is_even, [1, 2, 3, 2, 4, 5]) == [2, 2, 4]
-// One thread per container element is spawned.
+// Runs on the thread pool of transform_parallelly.
+// Evaluating the predicate as well as copying the kept elements
+// into the result is done in parallel.
 // Check out keep_if_parallelly_n_threads to limit the number of threads.
 template <typename Pred, typename Container>
 Container keep_if_parallelly(Pred pred, const Container& xs)
 {
-    // Avoid a temporary std::vector<bool>.
-    const auto idxs = find_all_idxs_by(
-        is_equal_to<std::uint8_t>(1),
-        transform_parallelly([pred](const auto& x) -> std::uint8_t {
-            return pred(x) ? 1 : 0;
-        },
-            xs));
-    return elems_at_idxs(idxs, xs);
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::default_chunk_runner(), pred, xs, true, false).first;
 }
 
 // API search type: keep_if_parallelly_n_threads : (Int, (a -> Bool), [a]) -> [a]
@@ -520,15 +1604,220 @@ template <typename Pred, typename Container>
 Container keep_if_parallelly_n_threads(
     std::size_t n, Pred pred, const Container& xs)
 {
-    // Avoid a temporary std::vector<bool>.
-    const auto idxs = find_all_idxs_by(
-        is_equal_to<std::uint8_t>(1),
-        transform_parallelly_n_threads(
-            n, [pred](const auto& x) -> std::uint8_t {
-                return pred(x) ? 1 : 0;
-            },
-            xs));
-    return elems_at_idxs(idxs, xs);
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, true, false).first;
+}
+
+// API search type: drop_if_parallelly : ((a -> Bool), [a]) -> [a]
+// fwd bind count: 1
+// Same as drop_if but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// drop_if_parallelly(is_even, [1, 2, 3, 2, 4, 5]) == [1, 3, 5]
+// Runs on the thread pool of transform_parallelly.
+// Check out drop_if_parallelly_n_threads to limit the number of threads.
+template <typename Pred, typename Container>
+Container drop_if_parallelly(Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::default_chunk_runner(), pred, xs, false, true).second;
+}
+
+// API search type: drop_if_parallelly_n_threads : (Int, (a -> Bool), [a]) -> [a]
+// fwd bind count: 2
+// Same as drop_if but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// drop_if_parallelly_n_threads(3, is_even, [1, 2, 3, 2, 4, 5]) == [1, 3, 5]
+template <typename Pred, typename Container>
+Container drop_if_parallelly_n_threads(
+    std::size_t n, Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, false, true).second;
+}
+
+// API search type: partition_parallelly : ((a -> Bool), [a]) -> ([a], [a])
+// fwd bind count: 1
+// Same as partition but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// partition_parallelly(is_even, [0,1,1,3,7,2,3,4]) == ([0,2,4],[1,1,3,7,3])
+// Runs on the thread pool of transform_parallelly.
+// Check out partition_parallelly_n_threads to limit the number of threads.
+template <typename Pred, typename Container>
+std::pair<Container, Container> partition_parallelly(
+    Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::default_chunk_runner(), pred, xs, true, true);
+}
+
+// API search type: partition_parallelly_n_threads : (Int, (a -> Bool), [a]) -> ([a], [a])
+// fwd bind count: 2
+// Same as partition but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// partition_parallelly_n_threads(3, is_even, [0,1,1,3,7,2,3,4]) == ([0,2,4],[1,1,3,7,3])
+template <typename Pred, typename Container>
+std::pair<Container, Container> partition_parallelly_n_threads(
+    std::size_t n, Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, true, true);
+}
+
+// API search type: sort_by_parallelly : (((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 1
+// Same as sort_by, but using multiple threads.
+// Contiguous runs are sorted on the thread pool of transform_parallelly
+// and then merged in parallel.
+// Check out sort_by_parallelly_n_threads to limit the number of threads.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_by_parallelly(Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::pool_chunk_runner { internal::default_thread_pool() }, false, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_by_parallelly_n_threads : (Int, ((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 2
+// Same as sort_by, but uses n threads in parallel.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_by_parallelly_n_threads(
+    std::size_t n, Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::n_threads_chunk_runner { n }, false, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_on_parallelly : ((a -> b), [a]) -> [a]
+// fwd bind count: 1
+// Same as sort_on, but using multiple threads.
+// Check out sort_on_parallelly_n_threads to limit the number of threads.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_on_parallelly(F f, Container&& xs)
+{
+    return sort_by_parallelly(internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_on_parallelly_n_threads : (Int, (a -> b), [a]) -> [a]
+// fwd bind count: 2
+// Same as sort_on, but uses n threads in parallel.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_on_parallelly_n_threads(
+    std::size_t n, F f, Container&& xs)
+{
+    return sort_by_parallelly_n_threads(n, internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_parallelly : [a] -> [a]
+// fwd bind count: 0
+// Same as sort, but using multiple threads.
+// Check out sort_parallelly_n_threads to limit the number of threads.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_parallelly(Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return sort_by_parallelly(std::less<T>(), std::forward<Container>(xs));
+}
+
+// API search type: sort_parallelly_n_threads : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as sort, but uses n threads in parallel.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_parallelly_n_threads(std::size_t n, Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return sort_by_parallelly_n_threads(
+        n, std::less<T>(), std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_by_parallelly : (((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 1
+// Same as stable_sort_by, but using multiple threads.
+// Contiguous runs are sorted on the thread pool of transform_parallelly
+// and then merged in parallel.
+// Check out stable_sort_by_parallelly_n_threads to limit the number of threads.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_by_parallelly(Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::pool_chunk_runner { internal::default_thread_pool() }, true, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_by_parallelly_n_threads : (Int, ((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 2
+// Same as stable_sort_by, but uses n threads in parallel.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_by_parallelly_n_threads(
+    std::size_t n, Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::n_threads_chunk_runner { n }, true, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_on_parallelly : ((a -> b), [a]) -> [a]
+// fwd bind count: 1
+// Same as stable_sort_on, but using multiple threads.
+// Check out stable_sort_on_parallelly_n_threads to limit the number of threads.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_on_parallelly(F f, Container&& xs)
+{
+    return stable_sort_by_parallelly(internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_on_parallelly_n_threads : (Int, (a -> b), [a]) -> [a]
+// fwd bind count: 2
+// Same as stable_sort_on, but uses n threads in parallel.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_on_parallelly_n_threads(
+    std::size_t n, F f, Container&& xs)
+{
+    return stable_sort_by_parallelly_n_threads(n, internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_parallelly : [a] -> [a]
+// fwd bind count: 0
+// Same as stable_sort, but using multiple threads.
+// Check out stable_sort_parallelly_n_threads to limit the number of threads.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_parallelly(Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return stable_sort_by_parallelly(std::less<T>(), std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_parallelly_n_threads : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as stable_sort, but uses n threads in parallel.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_parallelly_n_threads(std::size_t n, Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return stable_sort_by_parallelly_n_threads(
+        n, std::less<T>(), std::forward<Container>(xs));
 }
 
 // API search type: transform_reduce : ((a -> b), ((b, b) -> b), b, [a]) -> b
@@ -561,8 +1850,10 @@ auto transform_reduce_1(UnaryF unary_f, BinaryF binary_f, const Container& xs)
 // transform_reduce_parallelly(square, add, 0, [1,2,3]) == 0+1+4+9 = 14
 // Also known as map_reduce.
 // The set of binary_f, init and unary_f::output
-// should form a commutative monoid.
-// One thread per container element is spawned.
+// should form a monoid.
+// Runs on the thread pool of transform_parallelly.
+// The transformed values are folded chunk-wise right away
+// instead of being collected in a temporary container.
 // Check out transform_reduce_parallelly_n_threads to limit the number of threads.
 template <typename UnaryF, typename BinaryF, typename Container, typename Acc>
 auto transform_reduce_parallelly(UnaryF unary_f,
@@ -570,7 +1861,14 @@ auto transform_reduce_parallelly(UnaryF unary_f,
     const Acc& init,
     const Container& xs)
 {
-    return reduce_parallelly(binary_f, init, transform_parallelly(unary_f, xs));
+    using Y = std::decay_t<internal::invoke_result_t<
+        UnaryF, typename Container::value_type>>;
+    if (is_empty(xs)) {
+        return Y(init);
+    }
+    return Y(internal::invoke(binary_f, init,
+        internal::transform_reduce_1_chunked(
+            internal::default_chunk_runner(), unary_f, binary_f, xs)));
 }
 
 // API search type: transform_reduce_parallelly_n_threads : (Int, (a -> b), ((b, b) -> b), b, [a]) -> b
@@ -578,7 +1876,7 @@ auto transform_reduce_parallelly(UnaryF unary_f,
 // transform_reduce_parallelly_n_threads(2, square, add, 0, [1,2,3]) == 0+1+4+9 = 14
 // Also known as map_reduce.
 // The set of binary_f, init and unary_f::output
-// should form a commutative monoid.
+// should form a monoid.
 template <typename UnaryF, typename BinaryF, typename Container, typename Acc>
 auto transform_reduce_parallelly_n_threads(std::size_t n,
     UnaryF unary_f,
@@ -586,8 +1884,14 @@ auto transform_reduce_parallelly_n_threads(std::size_t n,
     const Acc& init,
     const Container& xs)
 {
-    return reduce_parallelly_n_threads(
-        n, binary_f, init, transform_parallelly_n_threads(n, unary_f, xs));
+    using Y = std::decay_t<internal::invoke_result_t<
+        UnaryF, typename Container::value_type>>;
+    if (is_empty(xs)) {
+        return Y(init);
+    }
+    return Y(internal::invoke(binary_f, init,
+        internal::transform_reduce_1_chunked(
+            internal::n_threads_chunk_runner { n }, unary_f, binary_f, xs)));
 }
 
 // API search type: transform_reduce_1_parallelly : ((a -> b), ((b, b) -> b), [a]) -> b
@@ -595,15 +1899,16 @@ auto transform_reduce_parallelly_n_threads(std::size_t n,
 // transform_reduce_1_parallelly(square, add, [1,2,3]) == 0+1+4+9 = 14
 // Also Known as map_reduce.
 // The set of binary_f, and unary_f::output
-// should form a commutative semigroup.
-// One thread per container element is spawned.
+// should form a semigroup.
+// Runs on the thread pool of transform_parallelly.
 // Check out transform_reduce_1_parallelly_n_threads to limit the number of threads.
 template <typename UnaryF, typename BinaryF, typename Container>
 auto transform_reduce_1_parallelly(UnaryF unary_f,
     BinaryF binary_f,
     const Container& xs)
 {
-    return reduce_1_parallelly(binary_f, transform_parallelly(unary_f, xs));
+    return internal::transform_reduce_1_chunked(
+        internal::default_chunk_runner(), unary_f, binary_f, xs);
 }
 
 // API search type: transform_reduce_1_parallelly_n_threads : (Int, (a -> b), ((b, b) -> b), [a]) -> b
@@ -611,15 +1916,15 @@ auto transform_reduce_1_parallelly(UnaryF unary_f,
 // transform_reduce_1_parallelly_n_threads(2, square, add, [1,2,3]) == 0+1+4+9 = 14
 // Also Known as map_reduce.
 // The set of binary_f, and unary_f::output
-// should form a commutative semigroup.
+// should form a semigroup.
 template <typename UnaryF, typename BinaryF, typename Container>
 auto transform_reduce_1_parallelly_n_threads(std::size_t n,
     UnaryF unary_f,
     BinaryF binary_f,
     const Container& xs)
 {
-    return reduce_1_parallelly_n_threads(
-        n, binary_f, transform_parallelly_n_threads(n, unary_f, xs));
+    return internal::transform_reduce_1_chunked(
+        internal::n_threads_chunk_runner { n }, unary_f, binary_f, xs);
 }
 
 } // namespace fplus
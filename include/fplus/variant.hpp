@@ -9,8 +9,12 @@
 #include <fplus/container_common.hpp>
 #include <fplus/maybe.hpp>
 
-#include <memory>
+#include <cassert>
+#include <cstddef>
+#include <new>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace fplus {
 
@@ -88,11 +92,6 @@ namespace internal {
         typedef List<typename Mod<Args>::type...> type;
     };
 
-    template <typename T>
-    struct as_shared_pointer {
-        typedef std::shared_ptr<T> type;
-    };
-
     // http://stackoverflow.com/a/27588263/1866775
 
     template <typename T, typename... Ts>
@@ -178,8 +177,61 @@ namespace internal {
     template <bool... bs>
     using all_true = std::is_same<bool_pack<bs..., true>, bool_pack<true, bs...>>;
 
+    template <typename T, typename Tuple>
+    struct get_index_in_tuple;
+
+    template <typename T, typename... Ts>
+    struct get_index_in_tuple<T, std::tuple<Ts...>> : get_index<T, Ts...> {
+    };
+
+    template <std::size_t... Xs>
+    struct max_of;
+
+    template <std::size_t X>
+    struct max_of<X> : std::integral_constant<std::size_t, X> {
+    };
+
+    template <std::size_t X, std::size_t Y, std::size_t... Xs>
+    struct max_of<X, Y, Xs...>
+        : max_of<(X > Y ? X : Y), Xs...> {
+    };
+
+    // Type-erased operations on one alternative of a variant,
+    // used to fill the dispatch tables indexed by the type index.
+    template <typename T>
+    struct variant_alternative_ops {
+        static void destruct(void* p)
+        {
+            static_cast<T*>(p)->~T();
+        }
+        static void copy(void* dest, const void* src)
+        {
+            new (dest) T(*static_cast<const T*>(src));
+        }
+        static void move(void* dest, void* src)
+        {
+            new (dest) T(std::move(*static_cast<T*>(src)));
+        }
+        static bool equal(const void* a, const void* b)
+        {
+            return *static_cast<const T*>(a) == *static_cast<const T*>(b);
+        }
+    };
+
+    // Calls the function of the tuple fs, that takes a T, with the T at p.
+    template <typename Res, typename T, typename FsInputTypes, typename Fs>
+    Res call_matching_visitor(const void* p, const Fs& fs)
+    {
+        return internal::invoke(
+            std::get<get_index_in_tuple<T, FsInputTypes>::value>(fs),
+            *static_cast<const T*>(p));
+    }
+
 } // namespace internal
 
+// Holds a value of exactly one of the given types.
+// The value is stored in place, so no heap allocation is involved,
+// and visiting it dispatches through a table indexed by the type index.
 template <typename... Types>
 struct variant {
     static_assert(internal::is_unique<Types...>::value, "Types must be unique.");
@@ -187,11 +239,60 @@ struct variant {
     static_assert(internal::all_true<(!std::is_const<Types>::value)...>::value, "No const types allowed.");
     static_assert(sizeof...(Types) >= 1, "Please provide at least one type.");
 
+private:
+    static constexpr bool is_nothrow_movable = internal::all_true<std::is_nothrow_move_constructible<Types>::value...>::value;
+
+public:
+
     template <typename T>
     variant(const T& val)
-        : shared_ptrs_({})
+        : index_(internal::get_index<T, Types...>::value)
+        , storage_()
+    {
+        new (&storage_) T(val);
+    }
+
+    variant(const variant<Types...>& other)
+        : index_(other.index_)
+        , storage_()
+    {
+        copy_content(other);
+    }
+
+    variant(variant<Types...>&& other) noexcept(is_nothrow_movable)
+        : index_(other.index_)
+        , storage_()
+    {
+        move_content(std::move(other));
+    }
+
+    // The new content is built in a temporary first,
+    // so a throwing copy leaves *this unchanged.
+    variant<Types...>& operator=(const variant<Types...>& other)
+    {
+        if (this != &other) {
+            variant<Types...> tmp(other);
+            replace_content(std::move(tmp));
+        }
+        return *this;
+    }
+
+    variant<Types...>& operator=(variant<Types...>&& other) noexcept(is_nothrow_movable)
+    {
+        if (this != &other) {
+            if (is_nothrow_movable) {
+                replace_content(std::move(other));
+            } else {
+                variant<Types...> tmp(std::move(other));
+                replace_content(std::move(tmp));
+            }
+        }
+        return *this;
+    }
+
+    ~variant()
     {
-        std::get<internal::get_index<T, Types...>::value>(shared_ptrs_) = std::make_shared<T>(val);
+        destruct_content();
     }
 
     template <typename T>
@@ -200,21 +301,22 @@ struct variant {
         static_assert(
             internal::is_one_of<T, Types...>::value, "Type must match one possible variant type.");
 
-        const auto ptr = std::get<internal::get_index<T, Types...>::value>(shared_ptrs_);
-
-        return static_cast<bool>(ptr);
+        return index_ == internal::get_index<T, Types...>::value;
     }
 
+    // Equal if both hold the same type and the values are equal.
     friend bool operator==(
         const variant<Types...>& a, const variant<Types...>& b)
     {
-        return a.shared_ptrs_ == b.shared_ptrs_;
+        using op = bool (*)(const void*, const void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::equal... };
+        return a.index_ == b.index_ && ops[a.index_](&a.storage_, &b.storage_);
     }
 
     friend bool operator!=(
         const variant<Types...>& a, const variant<Types...>& b)
     {
-        return a.shared_ptrs_ != b.shared_ptrs_;
+        return !(a == b);
     }
 
     template <typename F>
@@ -233,10 +335,8 @@ struct variant {
         static_assert(!std::is_same<std::decay_t<Ret>, void>::value,
             "Function must return non-void type.");
 
-        const auto ptr = std::get<internal::get_index<T, Types...>::value>(shared_ptrs_);
-
-        if (ptr) {
-            return just(internal::invoke(f, *ptr));
+        if (is<T>()) {
+            return just(internal::invoke(f, unsafe_get<T>()));
         }
 
         return nothing<std::decay_t<Ret>>();
@@ -258,9 +358,8 @@ struct variant {
         static_assert(std::is_same<std::decay_t<Ret>, void>::value,
             "Function must return void type.");
 
-        const auto ptr = std::get<internal::get_index<T, Types...>::value>(shared_ptrs_);
-        if (ptr) {
-            internal::invoke(f, *ptr);
+        if (is<T>()) {
+            internal::invoke(f, unsafe_get<T>());
         }
     }
 
@@ -274,11 +373,11 @@ struct variant {
             Res;
 
         static_assert(
-            sizeof...(Fs) >= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) >= sizeof...(Types),
             "Too few functions provided.");
 
         static_assert(
-            sizeof...(Fs) <= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) <= sizeof...(Types),
             "Too many functions provided.");
 
         typedef typename internal::transform_parameter_pack<
@@ -306,9 +405,7 @@ struct variant {
         static_assert(!std::is_same<std::decay_t<Res>, void>::value,
             "Function must return non-void type.");
 
-        const auto results = justs(go_visit_one<Res>(fs...));
-        assert(size_of_cont(results) == 1);
-        return head(results);
+        return dispatch<Res, function_first_input_types_tuple>(fs...);
     }
 
     template <typename... Fs>
@@ -316,11 +413,11 @@ struct variant {
     {
 
         static_assert(
-            sizeof...(Fs) >= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) >= sizeof...(Types),
             "Too few functions provided.");
 
         static_assert(
-            sizeof...(Fs) <= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) <= sizeof...(Types),
             "Too many functions provided.");
 
         typedef typename internal::transform_parameter_pack<
@@ -345,18 +442,18 @@ struct variant {
             internal::type_set_eq<function_first_input_types_tuple, std::tuple<Types...>>::value,
             "Functions do not cover all possible types.");
 
-        go_effect_one(fs...);
+        dispatch<void, function_first_input_types_tuple>(fs...);
     }
 
     template <typename... Fs>
     variant<Types...> transform(Fs... fs) const
     {
         static_assert(
-            sizeof...(Fs) >= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) >= sizeof...(Types),
             "Too few functions provided.");
 
         static_assert(
-            sizeof...(Fs) <= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) <= sizeof...(Types),
             "Too many functions provided.");
 
         typedef typename internal::transform_parameter_pack<
@@ -387,36 +484,59 @@ struct variant {
     }
 
 private:
-    template <typename Res, typename F>
-    std::vector<fplus::maybe<Res>> go_visit_one(F f) const
+    template <typename T>
+    const T& unsafe_get() const
     {
-        return { visit_one(f) };
+        assert(is<T>());
+        return *reinterpret_cast<const T*>(&storage_);
     }
 
-    template <typename Res, typename F, typename... Fs>
-    std::vector<fplus::maybe<Res>> go_visit_one(F f, Fs... fs) const
+    // Calls the one function of fs taking the currently held type.
+    template <typename Res, typename FsInputTypes, typename... Fs>
+    Res dispatch(const Fs&... fs) const
     {
-        return fplus::append(go_visit_one<Res>(f), go_visit_one<Res>(fs...));
+        typedef std::tuple<const Fs&...> fs_tuple;
+        using op = Res (*)(const void*, const fs_tuple&);
+        static constexpr op ops[] = {
+            &internal::call_matching_visitor<Res, Types, FsInputTypes, fs_tuple>...
+        };
+        return ops[index_](&storage_, fs_tuple(fs...));
     }
 
-    template <typename F>
-    void go_effect_one(F f) const
+    void copy_content(const variant<Types...>& other)
+    {
+        using op = void (*)(void*, const void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::copy... };
+        ops[index_](&storage_, &other.storage_);
+    }
+
+    void move_content(variant<Types...>&& other)
+    {
+        using op = void (*)(void*, void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::move... };
+        ops[index_](&storage_, &other.storage_);
+    }
+
+    void destruct_content()
     {
-        effect_one(f);
+        using op = void (*)(void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::destruct... };
+        ops[index_](&storage_);
     }
 
-    template <typename F, typename... Fs>
-    void go_effect_one(F f, Fs... fs) const
+    // No content would be left if the move threw after the old
+    // content has been destroyed, so this terminates instead.
+    void replace_content(variant<Types...>&& other) noexcept
     {
-        go_effect_one(f);
-        go_effect_one(fs...);
+        destruct_content();
+        index_ = other.index_;
+        move_content(std::move(other));
     }
 
-    typedef typename internal::transform_parameter_pack<
-        std::tuple,
-        internal::as_shared_pointer,
-        Types...>::type shared_ptr_pack;
-    shared_ptr_pack shared_ptrs_;
+    std::size_t index_;
+    typename std::aligned_storage<
+        internal::max_of<sizeof(Types)...>::value,
+        internal::max_of<alignof(Types)...>::value>::type storage_;
 };
 
 } // namespace fplus
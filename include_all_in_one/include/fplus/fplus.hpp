@@ -102,7 +102,10 @@ the standard library.
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 
+#include <cstddef>
+#include <functional>
 #include <type_traits>
+#include <utility>
 
 namespace fplus {
 namespace internal {
@@ -283,6 +286,19 @@ namespace internal {
 
     template <std::size_t N>
     using make_reverse_index_sequence = make_reverse_integer_sequence<std::size_t, N>;
+
+    // Can T be used as the key of a std::unordered_set,
+    // i.e. is std::hash<T> usable and are values comparable with ==?
+    template <typename T, typename = void>
+    struct is_hashable : std::false_type {
+    };
+
+    template <typename T>
+    struct is_hashable<T,
+        void_t<decltype(std::hash<T>()(std::declval<const T&>())),
+            decltype(std::declval<const T&>() == std::declval<const T&>())>>
+        : std::is_convertible<decltype(std::hash<T>()(std::declval<const T&>())), std::size_t> {
+    };
 }
 }
 
@@ -3110,6 +3126,456 @@ namespace internal {
 }
 }
 
+//
+// internal/lazy_ranges.hpp
+//
+
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Read-only sequences computing their elements on access
+    // instead of storing them, returned by the *_lazy functions.
+    // They provide the interface of a const container
+    // (value_type, const_iterator, begin, end, size, empty),
+    // so functions only reading their input accept them as is.
+    // Functions returning a container of the input type
+    // need a real container, see convert_container.
+
+    // Random-access iterator over a range providing operator[].
+    // Dereferencing returns the element by value.
+    template <typename Range>
+    class lazy_idx_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename Range::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef value_type reference;
+
+        lazy_idx_iterator()
+            : range_(nullptr)
+            , idx_(0)
+        {
+        }
+        lazy_idx_iterator(const Range* range, std::size_t idx)
+            : range_(range)
+            , idx_(idx)
+        {
+        }
+        value_type operator*() const { return (*range_)[idx_]; }
+        value_type operator[](difference_type n) const
+        {
+            return (*range_)[offset(n)];
+        }
+        lazy_idx_iterator& operator++()
+        {
+            ++idx_;
+            return *this;
+        }
+        lazy_idx_iterator operator++(int)
+        {
+            lazy_idx_iterator result = *this;
+            ++idx_;
+            return result;
+        }
+        lazy_idx_iterator& operator--()
+        {
+            --idx_;
+            return *this;
+        }
+        lazy_idx_iterator operator--(int)
+        {
+            lazy_idx_iterator result = *this;
+            --idx_;
+            return result;
+        }
+        lazy_idx_iterator& operator+=(difference_type n)
+        {
+            idx_ = offset(n);
+            return *this;
+        }
+        lazy_idx_iterator& operator-=(difference_type n)
+        {
+            idx_ = offset(-n);
+            return *this;
+        }
+        friend lazy_idx_iterator operator+(lazy_idx_iterator it, difference_type n)
+        {
+            return it += n;
+        }
+        friend lazy_idx_iterator operator+(difference_type n, lazy_idx_iterator it)
+        {
+            return it += n;
+        }
+        friend lazy_idx_iterator operator-(lazy_idx_iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+        friend difference_type operator-(const lazy_idx_iterator& a, const lazy_idx_iterator& b)
+        {
+            return static_cast<difference_type>(a.idx_) - static_cast<difference_type>(b.idx_);
+        }
+        friend bool operator==(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ == b.idx_; }
+        friend bool operator!=(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ != b.idx_; }
+        friend bool operator<(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ < b.idx_; }
+        friend bool operator>(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ > b.idx_; }
+        friend bool operator<=(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ <= b.idx_; }
+        friend bool operator>=(const lazy_idx_iterator& a, const lazy_idx_iterator& b) { return a.idx_ >= b.idx_; }
+
+    private:
+        std::size_t offset(difference_type n) const
+        {
+            return static_cast<std::size_t>(static_cast<difference_type>(idx_) + n);
+        }
+        const Range* range_;
+        std::size_t idx_;
+    };
+
+    // Common interface of the ranges with index-based element access.
+    template <typename Derived, typename T>
+    class lazy_idx_range {
+    public:
+        typedef T value_type;
+        typedef lazy_idx_iterator<Derived> const_iterator;
+        typedef const_iterator iterator;
+        typedef std::size_t size_type;
+
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const_iterator begin() const { return const_iterator(derived(), 0); }
+        const_iterator end() const { return const_iterator(derived(), size_); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    protected:
+        explicit lazy_idx_range(std::size_t size)
+            : size_(size)
+        {
+        }
+
+    private:
+        const Derived* derived() const { return static_cast<const Derived*>(this); }
+        std::size_t size_;
+    };
+
+    // start, start + step, start + 2 * step, ... while < end
+    template <typename T>
+    class numbers_step_range : public lazy_idx_range<numbers_step_range<T>, T> {
+    public:
+        numbers_step_range(T start, T end, T step)
+            : lazy_idx_range<numbers_step_range<T>, T>(count(start, end, step))
+            , start_(start)
+            , step_(step)
+        {
+        }
+        T operator[](std::size_t idx) const
+        {
+            return static_cast<T>(start_ + static_cast<T>(idx) * step_);
+        }
+
+    private:
+        static std::size_t count(T start, T end, T step)
+        {
+            if (!(step > 0) || !(start < end)) {
+                return 0;
+            }
+            std::size_t n = static_cast<std::size_t>((end - start) / step);
+            // Correct rounding of the division.
+            while (n > 0 && !(start + static_cast<T>(n - 1) * step < end)) {
+                --n;
+            }
+            while (start + static_cast<T>(n) * step < end) {
+                ++n;
+            }
+            return n;
+        }
+        T start_;
+        T step_;
+    };
+
+    // f(0), f(1), ..., f(size - 1)
+    template <typename F, typename T>
+    class generate_by_idx_range : public lazy_idx_range<generate_by_idx_range<F, T>, T> {
+    public:
+        generate_by_idx_range(F f, std::size_t size)
+            : lazy_idx_range<generate_by_idx_range<F, T>, T>(size)
+            , f_(f)
+        {
+        }
+        T operator[](std::size_t idx) const
+        {
+            return internal::invoke(f_, idx);
+        }
+
+    private:
+        F f_;
+    };
+
+    // The elements of xs, n times in a row.
+    template <typename T>
+    class repeat_range : public lazy_idx_range<repeat_range<T>, T> {
+    public:
+        template <typename Container>
+        repeat_range(std::size_t n, const Container& xs)
+            : lazy_idx_range<repeat_range<T>, T>(n * xs.size())
+            , xs_(std::begin(xs), std::end(xs))
+        {
+        }
+        const T& operator[](std::size_t idx) const
+        {
+            return xs_[idx % xs_.size()];
+        }
+
+    private:
+        std::vector<T> xs_;
+    };
+
+    // x, f(x), f(f(x)), ... (size elements)
+    // Every element is computed from its predecessor,
+    // so the iterators only support forward traversal.
+    // They carry the current value, to which they return references.
+    template <typename F, typename T>
+    class iterate_range {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+
+        class const_iterator {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T* pointer;
+            typedef const T& reference;
+
+            const_iterator(const iterate_range* range, std::size_t idx)
+                : range_(range)
+                , idx_(idx)
+                , current_(range->x_)
+            {
+            }
+            const T& operator*() const { return current_; }
+            const T* operator->() const { return &current_; }
+            const_iterator& operator++()
+            {
+                ++idx_;
+                if (idx_ < range_->size_) {
+                    current_ = internal::invoke(range_->f_, current_);
+                }
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator result = *this;
+                ++*this;
+                return result;
+            }
+            friend bool operator==(const const_iterator& a, const const_iterator& b) { return a.idx_ == b.idx_; }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a.idx_ != b.idx_; }
+
+        private:
+            const iterate_range* range_;
+            std::size_t idx_;
+            T current_;
+        };
+        typedef const_iterator iterator;
+
+        iterate_range(F f, std::size_t size, const T& x)
+            : f_(f)
+            , size_(size)
+            , x_(x)
+        {
+        }
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size_); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    private:
+        F f_;
+        std::size_t size_;
+        T x_;
+    };
+
+    // Non-owning view of the elements in [first, last).
+    template <typename Iterator>
+    class iterator_range {
+    public:
+        typedef typename std::iterator_traits<Iterator>::value_type value_type;
+        typedef Iterator const_iterator;
+        typedef Iterator iterator;
+        typedef std::size_t size_type;
+
+        iterator_range(Iterator first, Iterator last, std::size_t size)
+            : first_(first)
+            , last_(last)
+            , size_(size)
+        {
+        }
+        std::size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        const_iterator begin() const { return first_; }
+        const_iterator end() const { return last_; }
+        const_iterator cbegin() const { return first_; }
+        const_iterator cend() const { return last_; }
+        decltype(auto) operator[](std::size_t idx) const
+        {
+            return *std::next(first_,
+                static_cast<typename std::iterator_traits<Iterator>::difference_type>(idx));
+        }
+
+    private:
+        Iterator first_;
+        Iterator last_;
+        std::size_t size_;
+    };
+
+    template <typename Iterator>
+    Iterator advanced_iterator(Iterator it, std::size_t n)
+    {
+        return std::next(it,
+            static_cast<typename std::iterator_traits<Iterator>::difference_type>(n));
+    }
+
+    // Windows into a container, window idx covering
+    // the elements [idx * step, idx * step + length),
+    // cut off at the end of the container.
+    // The windows are computed on access
+    // in O(1) for random-access containers.
+    template <typename Container,
+        typename Window = iterator_range<typename Container::const_iterator>>
+    class window_range : public lazy_idx_range<window_range<Container>, Window> {
+    public:
+        window_range(const Container& xs, std::size_t n_windows,
+            std::size_t length, std::size_t step)
+            : lazy_idx_range<window_range<Container>, Window>(n_windows)
+            , first_(std::begin(xs))
+            , xs_size_(static_cast<std::size_t>(
+                  std::distance(std::begin(xs), std::end(xs))))
+            , length_(length)
+            , step_(step)
+        {
+        }
+        Window operator[](std::size_t idx) const
+        {
+            const std::size_t begin_idx = std::min(idx * step_, xs_size_);
+            const std::size_t end_idx = std::min(begin_idx + length_, xs_size_);
+            const auto it = advanced_iterator(first_, begin_idx);
+            return Window(it, advanced_iterator(it, end_idx - begin_idx),
+                end_idx - begin_idx);
+        }
+
+    private:
+        typename Container::const_iterator first_;
+        std::size_t xs_size_;
+        std::size_t length_;
+        std::size_t step_;
+    };
+
+    // Every step-th element of a container, without copying them.
+    template <typename Container,
+        typename T = typename Container::value_type>
+    class stride_range : public lazy_idx_range<stride_range<Container>, T> {
+    public:
+        stride_range(const Container& xs, std::size_t step)
+            : lazy_idx_range<stride_range<Container>, T>(
+                (static_cast<std::size_t>(std::distance(std::begin(xs), std::end(xs)))
+                    + step - 1)
+                / step)
+            , first_(std::begin(xs))
+            , step_(step)
+        {
+        }
+        const T& operator[](std::size_t idx) const
+        {
+            return *advanced_iterator(first_, idx * step_);
+        }
+
+    private:
+        typename Container::const_iterator first_;
+        std::size_t step_;
+    };
+
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#endif
+
+    // Results of transformations of lazy ranges are stored in vectors.
+    template <class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<numbers_step_range<T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class F, class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<generate_by_idx_range<F, T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<repeat_range<T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class F, class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<iterate_range<F, T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class Iterator, class NewT, int SizeOffset>
+    struct same_cont_new_t<iterator_range<Iterator>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class Container, class Window, class NewT, int SizeOffset>
+    struct same_cont_new_t<window_range<Container, Window>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+    template <class Container, class T, class NewT, int SizeOffset>
+    struct same_cont_new_t<stride_range<Container, T>, NewT, SizeOffset> {
+        typedef typename std::vector<NewT> type;
+    };
+
+    template <class T>
+    struct has_order<numbers_step_range<T>> : public std::true_type {
+    };
+    template <class F, class T>
+    struct has_order<generate_by_idx_range<F, T>> : public std::true_type {
+    };
+    template <class T>
+    struct has_order<repeat_range<T>> : public std::true_type {
+    };
+    template <class F, class T>
+    struct has_order<iterate_range<F, T>> : public std::true_type {
+    };
+    template <class Iterator>
+    struct has_order<iterator_range<Iterator>> : public std::true_type {
+    };
+    template <class Container, class Window>
+    struct has_order<window_range<Container, Window>> : public std::true_type {
+    };
+    template <class Container, class T>
+    struct has_order<stride_range<Container, T>> : public std::true_type {
+    };
+
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+}
+}
+
 #include <algorithm>
 #include <cassert>
 #include <cmath>
@@ -4815,29 +5281,72 @@ Container nub_by(BinaryPredicate p, const Container& xs)
     return result;
 }
 
+namespace internal {
+
+    // Key type of the elements of a container with respect to f.
+    template <typename F, typename Container>
+    using key_of_t = std::decay_t<internal::invoke_result_t<F,
+        const typename Container::value_type&>>;
+
+    template <typename Container, typename F>
+    Container nub_on(std::true_type /* is_hashable */, F f, const Container& xs)
+    {
+        std::unordered_set<key_of_t<F, Container>> seen;
+        Container result;
+        auto itOut = internal::get_back_inserter(result);
+        for (const auto& x : xs) {
+            if (seen.insert(internal::invoke(f, x)).second) {
+                *itOut = x;
+            }
+        }
+        return result;
+    }
+
+    template <typename Container, typename F>
+    Container nub_on(std::false_type /* is_hashable */, F f, const Container& xs)
+    {
+        return nub_by(is_equal_by(f), xs);
+    }
+
+    template <typename Container>
+    Container nub(std::true_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return nub_on(std::true_type(), identity<T>, xs);
+    }
+
+    template <typename Container>
+    Container nub(std::false_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return nub_by(std::equal_to<T>(), xs);
+    }
+}
+
 // API search type: nub_on : ((a -> b), [a]) -> [a]
 // fwd bind count: 1
 // Makes the elements in a container unique
 // with respect to their function value.
 // nub_on((mod 10), [12,32,15]) == [12,15]
-// O(n^2)
+// O(n) if the function values are hashable, O(n^2) otherwise.
 template <typename Container, typename F>
 Container nub_on(F f, const Container& xs)
 {
-    return nub_by(is_equal_by(f), xs);
+    return internal::nub_on(
+        internal::is_hashable<internal::key_of_t<F, Container>>(), f, xs);
 }
 
 // API search type: nub : [a] -> [a]
 // fwd bind count: 0
 // Makes the elements in a container unique.
 // nub([1,2,2,3,2]) == [1,2,3]
-// O(n^2)
+// O(n) if the elements are hashable, O(n^2) otherwise.
 // Also known as distinct.
 template <typename Container>
 Container nub(const Container& xs)
 {
     typedef typename Container::value_type T;
-    return nub_by(std::equal_to<T>(), xs);
+    return internal::nub(internal::is_hashable<T>(), xs);
 }
 
 // API search type: all_unique_by_eq : (((a, a) -> Bool), [a]) -> Bool
@@ -4853,29 +5362,63 @@ bool all_unique_by_eq(BinaryPredicate p, const Container& xs)
     return size_of_cont(nub_by(p, xs)) == size_of_cont(xs);
 }
 
+namespace internal {
+    template <typename Container, typename F>
+    bool all_unique_on(std::true_type /* is_hashable */, F f, const Container& xs)
+    {
+        std::unordered_set<key_of_t<F, Container>> seen;
+        for (const auto& x : xs) {
+            if (!seen.insert(internal::invoke(f, x)).second) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Container, typename F>
+    bool all_unique_on(std::false_type /* is_hashable */, F f, const Container& xs)
+    {
+        return all_unique_by_eq(is_equal_by(f), xs);
+    }
+
+    template <typename Container>
+    bool all_unique(std::true_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return all_unique_on(std::true_type(), identity<T>, xs);
+    }
+
+    template <typename Container>
+    bool all_unique(std::false_type /* is_hashable */, const Container& xs)
+    {
+        typedef typename Container::value_type T;
+        return all_unique_by_eq(std::equal_to<T>(), xs);
+    }
+}
+
 // API search type: all_unique_on : ((a -> b), [a]) -> Bool
 // fwd bind count: 1
 // Checks if all elements in a container are unique
 // with respect to their function values.
 // Returns true for empty containers.
-// O(n^2)
+// O(n) if the function values are hashable, O(n^2) otherwise.
 template <typename Container, typename F>
 bool all_unique_on(F f, const Container& xs)
 {
-    return all_unique_by_eq(is_equal_by(f), xs);
+    return internal::all_unique_on(
+        internal::is_hashable<internal::key_of_t<F, Container>>(), f, xs);
 }
 
 // API search type: all_unique : [a] -> Bool
 // fwd bind count: 0
 // Checks if all elements in a container are unique.
 // Returns true for empty containers.
-// O(n^2)
+// O(n) if the elements are hashable, O(n^2) otherwise.
 template <typename Container>
 bool all_unique(const Container& xs)
 {
     typedef typename Container::value_type T;
-    auto comp = std::equal_to<T>();
-    return all_unique_by_eq(comp, xs);
+    return internal::all_unique(internal::is_hashable<T>(), xs);
 }
 
 // API search type: is_strictly_sorted_by : (((a, a) -> Bool), [a]) -> Bool
@@ -5081,10 +5624,37 @@ ContainerOut numbers(const T start, const T end)
     return numbers_step<T, ContainerOut>(start, end, 1);
 }
 
-// API search type: singleton_seq : a -> [a]
-// fwd bind count: 0
-// Construct a sequence containing a single value.
-// singleton_seq(3) == [3].
+// API search type: numbers_step_lazy : (a, a, a) -> [a]
+// fwd bind count: 2
+// Same as numbers_step, but the numbers are computed on access
+// instead of being stored, so the memory usage is constant.
+// numbers_step_lazy(2, 9, 2) == [2, 4, 6, 8]
+template <typename T>
+internal::numbers_step_range<T> numbers_step_lazy(
+    const T start, const T end, const T step)
+{
+    return internal::numbers_step_range<T>(start, end, step);
+}
+
+// API search type: numbers_lazy : (a, a) -> [a]
+// fwd bind count: 1
+// Same as numbers, but the numbers are computed on access
+// instead of being stored, so the memory usage is constant.
+// Can be passed to every function only reading its input,
+// e.g. sum(numbers_lazy(0, 15000000)) does not allocate.
+// Functions returning a container of the same type as their input
+// need a real container, e.g. convert_container<std::vector<T>>(...).
+// numbers_lazy(2, 9) == [2, 3, 4, 5, 6, 7, 8]
+template <typename T>
+internal::numbers_step_range<T> numbers_lazy(const T start, const T end)
+{
+    return numbers_step_lazy<T>(start, end, 1);
+}
+
+// API search type: singleton_seq : a -> [a]
+// fwd bind count: 0
+// Construct a sequence containing a single value.
+// singleton_seq(3) == [3].
 template <typename T, typename ContainerOut = std::vector<T>>
 ContainerOut singleton_seq(const T& x)
 {
@@ -5150,32 +5720,112 @@ typename Container::value_type last(const Container& xs)
     return xs.back();
 }
 
+// Accumulates the count, mean, variance, minimum and maximum
+// of a stream of values in a single pass and constant memory,
+// using Welford's numerically stable update.
+// Accumulators filled independently, e.g. on different threads,
+// can be combined with merge.
+template <typename Result = double>
+class running_stats {
+public:
+    running_stats()
+        : count_(0)
+        , mean_(0)
+        , m2_(0)
+        , min_(0)
+        , max_(0)
+    {
+    }
+
+    template <typename T>
+    void add(const T& value)
+    {
+        const Result x = static_cast<Result>(value);
+        ++count_;
+        const Result delta = x - mean_;
+        mean_ += delta / static_cast<Result>(count_);
+        m2_ += delta * (x - mean_);
+        if (count_ == 1) {
+            min_ = x;
+            max_ = x;
+        } else {
+            min_ = std::min(min_, x);
+            max_ = std::max(max_, x);
+        }
+    }
+
+    // Combines the statistics of both streams,
+    // see Chan et al., "Updating Formulae and a Pairwise Algorithm
+    // for Computing Sample Variances", 1979.
+    void merge(const running_stats& other)
+    {
+        if (other.count_ == 0) {
+            return;
+        }
+        if (count_ == 0) {
+            *this = other;
+            return;
+        }
+        const Result n_a = static_cast<Result>(count_);
+        const Result n_b = static_cast<Result>(other.count_);
+        const Result n = n_a + n_b;
+        const Result delta = other.mean_ - mean_;
+        mean_ += delta * (n_b / n);
+        m2_ += other.m2_ + delta * delta * (n_a * n_b / n);
+        count_ += other.count_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    std::size_t count() const { return count_; }
+
+    // The following are only meaningful if count() != 0.
+    Result mean() const { return mean_; }
+    Result minimum() const { return min_; }
+    Result maximum() const { return max_; }
+    // population variance
+    Result variance() const { return m2_ / static_cast<Result>(count_); }
+    // sample variance, count() must be at least 2
+    Result sample_variance() const { return m2_ / static_cast<Result>(count_ - 1); }
+    Result stddev() const { return std::sqrt(variance()); }
+    Result sample_stddev() const { return std::sqrt(sample_variance()); }
+
+private:
+    std::size_t count_;
+    Result mean_;
+    Result m2_;
+    Result min_;
+    Result max_;
+};
+
+// API search type: get_running_stats : [a] -> RunningStats a
+// fwd bind count: 0
+// Accumulates count, mean, variance, minimum and maximum
+// of all elements in a single pass.
+// get_running_stats([1, 3, 7, 4]).mean() == 3.75
+template <typename Result = double, typename Container>
+running_stats<Result> get_running_stats(const Container& xs)
+{
+    running_stats<Result> stats;
+    for (const auto& x : xs) {
+        stats.add(x);
+    }
+    return stats;
+}
+
 // API search type: mean_stddev : [a] -> (a, a)
 // fwd bind count: 0
 // Calculates the mean and the population standard deviation.
 // mean_stddev([4, 8]) == (6, 2)
 // mean_stddev([1, 3, 7, 4]) == (3.75, 2.5)
+// Single pass without allocations, also works with lists.
 // xs must be non-empty.
 template <typename Result, typename Container>
 std::pair<Result, Result> mean_stddev(const Container& xs)
 {
-    assert(size_of_cont(xs) != 0);
-
-    // http://stackoverflow.com/a/7616783/1866775
-    Result sum = static_cast<Result>(
-        internal::accumulate(xs.begin(), xs.end(),
-            static_cast<typename Container::value_type>(0)));
-    Result mean = sum / static_cast<Result>(xs.size());
-
-    std::vector<Result> diff(xs.size());
-    std::transform(xs.begin(), xs.end(), diff.begin(),
-        [mean](Result x) {
-            return x - mean;
-        });
-    Result sq_sum = std::inner_product(
-        diff.begin(), diff.end(), diff.begin(), static_cast<Result>(0));
-    Result stddev = std::sqrt(sq_sum / static_cast<Result>(xs.size()));
-    return std::make_pair(mean, stddev);
+    assert(!is_empty(xs));
+    const auto stats = get_running_stats<Result>(xs);
+    return std::make_pair(stats.mean(), stats.stddev());
 }
 
 // API search type: count_occurrences_by : ((a -> b), [a]) -> Map b Int
@@ -5379,8 +6029,12 @@ ContainerOut instead_of_if_empty(const ContainerAlt& alt, Container&& xs)
 
 
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace fplus {
 
@@ -5388,61 +6042,199 @@ template <typename Ok, typename Error>
 class result;
 
 template <typename Ok, typename Error>
-result<Ok, Error> ok(const Ok& val);
+result<Ok, Error> ok(Ok val);
 
 template <typename Ok, typename Error>
 result<Ok, Error> error(const Error& error);
 
+namespace internal {
+
+    struct result_ok_tag {
+    };
+    struct result_error_tag {
+    };
+
+    // Holds an Ok or an Error in place, discriminated by is_ok_.
+    template <typename Ok, typename Error>
+    class result_storage_base {
+    public:
+        bool is_ok() const { return is_ok_; }
+        const Ok& ok_value() const
+        {
+            return *reinterpret_cast<const Ok*>(&value_);
+        }
+        const Error& error_value() const
+        {
+            return *reinterpret_cast<const Error*>(&value_);
+        }
+
+    protected:
+        result_storage_base(result_ok_tag, const Ok& val)
+            : is_ok_(true)
+            , value_()
+        {
+            new (&value_) Ok(val);
+        }
+        result_storage_base(result_ok_tag, Ok&& val)
+            : is_ok_(true)
+            , value_()
+        {
+            new (&value_) Ok(std::move(val));
+        }
+        result_storage_base(result_error_tag, const Error& err)
+            : is_ok_(false)
+            , value_()
+        {
+            new (&value_) Error(err);
+        }
+        explicit result_storage_base(bool is_ok)
+            : is_ok_(is_ok)
+            , value_()
+        {
+        }
+        Ok& ok_value()
+        {
+            return *reinterpret_cast<Ok*>(&value_);
+        }
+        Error& error_value()
+        {
+            return *reinterpret_cast<Error*>(&value_);
+        }
+        void copy_content(const result_storage_base& other)
+        {
+            is_ok_ = other.is_ok_;
+            if (is_ok_)
+                new (&value_) Ok(other.ok_value());
+            else
+                new (&value_) Error(other.error_value());
+        }
+        void move_content(result_storage_base&& other)
+        {
+            is_ok_ = other.is_ok_;
+            if (is_ok_)
+                new (&value_) Ok(std::move(other.ok_value()));
+            else
+                new (&value_) Error(std::move(other.error_value()));
+        }
+        void destruct_content()
+        {
+            if (is_ok_)
+                ok_value().~Ok();
+            else
+                error_value().~Error();
+        }
+        // No content would be left if the move threw after the old
+        // content has been destroyed, so this terminates instead.
+        void replace_content(result_storage_base&& other) noexcept
+        {
+            destruct_content();
+            move_content(std::move(other));
+        }
+        bool is_ok_;
+        static constexpr std::size_t value_size = sizeof(Ok) > sizeof(Error) ? sizeof(Ok) : sizeof(Error);
+        static constexpr std::size_t value_align = alignof(Ok) > alignof(Error) ? alignof(Ok) : alignof(Error);
+        typename std::aligned_storage<value_size, value_align>::type value_;
+    };
+
+    template <typename Ok, typename Error,
+        bool IsTriviallyCopyable = std::is_trivially_copyable<Ok>::value
+            && std::is_trivially_copyable<Error>::value>
+    class result_storage;
+
+    // Trivially copyable alternatives are copied bytewise,
+    // so the whole result is trivially copyable too.
+    template <typename Ok, typename Error>
+    class result_storage<Ok, Error, true>
+        : public result_storage_base<Ok, Error> {
+    public:
+        template <typename Tag, typename T>
+        result_storage(Tag tag, T&& val)
+            : result_storage_base<Ok, Error>(tag, std::forward<T>(val))
+        {
+        }
+    };
+
+    template <typename Ok, typename Error>
+    class result_storage<Ok, Error, false>
+        : public result_storage_base<Ok, Error> {
+        static constexpr bool is_nothrow_movable = std::is_nothrow_move_constructible<Ok>::value
+            && std::is_nothrow_move_constructible<Error>::value;
+
+    public:
+        template <typename Tag, typename T>
+        result_storage(Tag tag, T&& val)
+            : result_storage_base<Ok, Error>(tag, std::forward<T>(val))
+        {
+        }
+        result_storage(const result_storage& other)
+            : result_storage_base<Ok, Error>(other.is_ok_)
+        {
+            this->copy_content(other);
+        }
+        result_storage(result_storage&& other) noexcept(is_nothrow_movable)
+            : result_storage_base<Ok, Error>(other.is_ok_)
+        {
+            this->move_content(std::move(other));
+        }
+        // The new content is built in a temporary first,
+        // so a throwing copy leaves *this unchanged.
+        result_storage& operator=(const result_storage& other)
+        {
+            if (this != &other) {
+                result_storage tmp(other);
+                this->replace_content(std::move(tmp));
+            }
+            return *this;
+        }
+        result_storage& operator=(result_storage&& other) noexcept(is_nothrow_movable)
+        {
+            if (this != &other) {
+                if (is_nothrow_movable) {
+                    this->replace_content(std::move(other));
+                } else {
+                    result_storage tmp(std::move(other));
+                    this->replace_content(std::move(tmp));
+                }
+            }
+            return *this;
+        }
+        ~result_storage()
+        {
+            this->destruct_content();
+        }
+    };
+}
+
 // Can hold a value of type Ok or an error of type Error.
+// The value is stored in place, so no heap allocation is involved,
+// and the result is trivially copyable if Ok and Error are.
 template <typename Ok, typename Error>
 class result {
 public:
-    bool is_ok() const { return static_cast<bool>(ptr_ok_); }
-    bool is_error() const { return static_cast<bool>(ptr_error_); }
+    bool is_ok() const { return storage_.is_ok(); }
+    bool is_error() const { return !is_ok(); }
     const Ok& unsafe_get_ok() const
     {
-        check_either_or_invariant();
         assert(is_ok());
-        return *ptr_ok_;
+        return storage_.ok_value();
     }
     const Error& unsafe_get_error() const
     {
-        check_either_or_invariant();
         assert(is_error());
-        return *ptr_error_;
+        return storage_.error_value();
     }
     typedef Ok ok_t;
     typedef Error error_t;
 
-    result(const result<Ok, Error>& other)
-        : ptr_ok_(other.is_ok() ? ptr_ok(new Ok(other.unsafe_get_ok())) : ptr_ok())
-        , ptr_error_(other.is_error() ? ptr_error(new Error(other.unsafe_get_error())) : ptr_error())
-    {
-        check_either_or_invariant();
-    }
-    result<Ok, Error>& operator=(const result<Ok, Error>& other)
-    {
-        ptr_ok_ = other.is_ok() ? ptr_ok(new Ok(other.unsafe_get_ok())) : ptr_ok();
-        ptr_error_ = other.is_error() ? ptr_error(new Error(other.unsafe_get_error())) : ptr_error();
-        return *this;
-    }
-
 private:
-    void check_either_or_invariant() const
-    {
-        assert(is_ok() != is_error());
-    }
-    result()
-        : ptr_ok_(ptr_ok())
-        , ptr_error_(ptr_error())
+    template <typename Tag, typename T>
+    result(Tag tag, T&& val)
+        : storage_(tag, std::forward<T>(val))
     {
     }
-    typedef std::unique_ptr<Ok> ptr_ok;
-    typedef std::unique_ptr<Error> ptr_error;
-    friend result<Ok, Error> ok<Ok, Error>(const Ok& ok);
+    friend result<Ok, Error> ok<Ok, Error>(Ok ok);
     friend result<Ok, Error> error<Ok, Error>(const Error& error);
-    ptr_ok ptr_ok_;
-    ptr_error ptr_error_;
+    internal::result_storage<Ok, Error> storage_;
 };
 
 // API search type: is_ok : Result a b -> Bool
@@ -5495,12 +6287,11 @@ Ok ok_with_default(const Ok& defaultValue, const result<Ok, Error>& result)
 // API search type: ok : a -> Result a b
 // fwd bind count: 0
 // Wrap a value in a result as a Ok.
+// The value is moved into the result.
 template <typename Ok, typename Error>
-result<Ok, Error> ok(const Ok& val)
+result<Ok, Error> ok(Ok val)
 {
-    result<Ok, Error> x;
-    x.ptr_ok_.reset(new Ok(val));
-    return x;
+    return result<Ok, Error>(internal::result_ok_tag(), std::move(val));
 }
 
 // API search type: error : b -> Result a b
@@ -5509,9 +6300,7 @@ result<Ok, Error> ok(const Ok& val)
 template <typename Ok, typename Error>
 result<Ok, Error> error(const Error& error)
 {
-    result<Ok, Error> x;
-    x.ptr_error_.reset(new Error(error));
-    return x;
+    return result<Ok, Error>(internal::result_error_tag(), error);
 }
 
 // API search type: to_maybe : Result a b -> Maybe a
@@ -6233,6 +7022,20 @@ ContainerOut generate_by_idx(F f, std::size_t amount)
     return ys;
 }
 
+// API search type: generate_by_idx_lazy : ((Int -> a), Int) -> [a]
+// fwd bind count: 1
+// Same as generate_by_idx, but f(i) is only called
+// when element i is accessed, and the result is not stored.
+// generate_by_idx_lazy(f, 3) == [f(0), f(1), f(2)]
+template <typename F,
+    typename T = std::decay_t<internal::invoke_result_t<F, std::size_t>>>
+internal::generate_by_idx_range<F, T> generate_by_idx_lazy(F f, std::size_t amount)
+{
+    internal::
+        trigger_static_asserts<internal::unary_function_tag, F, std::size_t>();
+    return internal::generate_by_idx_range<F, T>(f, amount);
+}
+
 // API search type: repeat : (Int, [a]) -> [a]
 // fwd bind count: 1
 // Create a sequence containing xs concatenated n times.
@@ -6244,6 +7047,17 @@ Container repeat(std::size_t n, const Container& xs)
     return concat(xss);
 }
 
+// API search type: repeat_lazy : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as repeat, but only one copy of xs is stored.
+// repeat_lazy(3, [1, 2]) == [1, 2, 1, 2, 1, 2]
+template <typename Container,
+    typename T = typename Container::value_type>
+internal::repeat_range<T> repeat_lazy(std::size_t n, const Container& xs)
+{
+    return internal::repeat_range<T>(n, xs);
+}
+
 // API search type: infixes : (Int, [a]) -> [[a]]
 // fwd bind count: 1
 // Return als possible infixed of xs with a given length.
@@ -6268,6 +7082,25 @@ ContainerOut infixes(std::size_t length, const ContainerIn& xs)
     return result;
 }
 
+// API search type: infixes_view : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Same as infixes, but the infixes are views into xs
+// computed on access, so memory usage does not grow with length.
+// xs has to outlive the result.
+// infixes_view(3, [1,2,3,4,5,6]) == [[1,2,3], [2,3,4], [3,4,5], [4,5,6]]
+// length must be > 0
+template <typename ContainerIn>
+internal::window_range<ContainerIn> infixes_view(std::size_t length, const ContainerIn& xs)
+{
+    assert(length > 0);
+    const std::size_t size = size_of_cont(xs);
+    const std::size_t n_windows = size < length ? 0 : size - length + 1;
+    return internal::window_range<ContainerIn>(xs, n_windows, length, 1);
+}
+
+template <typename ContainerIn>
+void infixes_view(std::size_t, const ContainerIn&&) = delete;
+
 // API search type: carthesian_product_with_where : (((a, b) -> c), ((a -> b), Bool), [a], [b]) -> [c]
 // fwd bind count: 3
 // carthesian_product_with_where(make_pair, always(true), "ABC", "XY")
@@ -6523,6 +7356,18 @@ ContainerOut iterate(F f, std::size_t size, const T& x)
     return result;
 }
 
+// API search type: iterate_lazy : ((a -> a), Int, a) -> [a]
+// fwd bind count: 2
+// Same as iterate, but the values are computed while iterating
+// instead of being stored, so the memory usage is constant.
+// Every pass over the sequence applies f again.
+// iterate_lazy((*2), 5, 3) = [3, 6, 12, 24, 48]
+template <typename F, typename T>
+internal::iterate_range<F, T> iterate_lazy(F f, std::size_t size, const T& x)
+{
+    return internal::iterate_range<F, T>(f, size, x);
+}
+
 // API search type: iterate_maybe : ((a -> Maybe a), a) -> [a]
 // fwd bind count: 1
 // Repeatedly apply a function to a value (starting with x)
@@ -8497,2858 +9342,5358 @@ T line_equation(const std::pair<T, T>& a, const std::pair<T, T>& b, T x)
 
 
 
-#include <algorithm>
 
-namespace fplus {
+//
+// internal/aho_corasick.hpp
+//
 
-// API search type: find_first_by : ((a -> Bool), [a]) -> Maybe a
-// fwd bind count: 1
-// Returns the first element fulfilling the predicate.
-// find_first_by(is_even, [1, 3, 4, 6, 9]) == Just(4)
-// find_first_by(is_even, [1, 3, 5, 7, 9]) == Nothing
-template <typename Container, typename UnaryPredicate,
-    typename T = typename Container::value_type>
-maybe<T> find_first_by(UnaryPredicate pred, const Container& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    auto it = std::find_if(std::begin(xs), std::end(xs), pred);
-    if (it == std::end(xs))
-        return nothing<T>();
-    return just<T>(*it);
-}
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
 
-// API search type: find_last_by : ((a -> Bool), [a]) -> Maybe a
-// fwd bind count: 1
-// Returns the last element fulfilling the predicate.
-// find_last_by(is_even, [1, 3, 4, 6, 9]) == Just(6)
-// find_last_by(is_even, [1, 3, 5, 7, 9]) == Nothing
-template <typename Container, typename UnaryPredicate,
-    typename T = typename Container::value_type>
-maybe<T> find_last_by(UnaryPredicate pred, const Container& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    return find_first_by(pred, reverse(xs));
-}
 
-// API search type: find_first_idx_by : ((a -> Bool), [a]) -> Maybe Int
-// fwd bind count: 1
-// Returns the index of the first element fulfilling the predicate.
-// find_first_idx_by(is_even, [1, 3, 4, 6, 9]) == Just(2)
-// find_first_idx_by(is_even, [1, 3, 5, 7, 9]) == Nothing
-template <typename Container, typename UnaryPredicate>
-maybe<std::size_t> find_first_idx_by(UnaryPredicate pred, const Container& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    auto it = std::find_if(std::begin(xs), std::end(xs), pred);
-    if (it == std::end(xs))
-        return nothing<std::size_t>();
-    return static_cast<std::size_t>(std::distance(std::begin(xs), it));
-}
 
-// API search type: find_last_idx_by : ((a -> Bool), [a]) -> Maybe Int
-// fwd bind count: 1
-// Returns the index of the last element fulfilling the predicate.
-// find_last_idx_by(is_even, [1, 3, 4, 6, 9]) == Just(3)
-// find_last_idx_by(is_even, [1, 3, 5, 7, 9]) == Nothing
-template <typename Container, typename UnaryPredicate>
-maybe<std::size_t> find_last_idx_by(UnaryPredicate pred, const Container& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    auto calcRevIdx = [&](std::size_t idx) {
-        return size_of_cont(xs) - (idx + 1);
-    };
-    return lift_maybe(calcRevIdx, find_first_idx_by(pred, reverse(xs)));
-}
+//
+// internal/token_search.hpp
+//
 
-// API search type: find_first_idx : (a, [a]) -> Maybe Int
-// fwd bind count: 1
-// Returns the index of the first element equal to x.
-// find_first_idx(4, [1, 3, 4, 4, 9]) == Just(2)
-// find_first_idx(4, [1, 3, 5, 7, 9]) == Nothing
-template <typename Container>
-maybe<std::size_t> find_first_idx(const typename Container::value_type& x, const Container& xs)
-{
-    return find_first_idx_by(is_equal_to(x), xs);
-}
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
 
-// API search type: find_last_idx : (a, [a]) -> Maybe Int
-// fwd bind count: 1
-// Returns the index of the last element equal to x.
-// find_last_idx(4, [1, 3, 4, 4, 9]) == Just(3)
-// find_last_idx(4, [1, 3, 5, 7, 9]) == Nothing
-template <typename Container>
-maybe<std::size_t> find_last_idx(const typename Container::value_type& x, const Container& xs)
-{
-    return find_last_idx_by(is_equal_to(x), xs);
-}
 
-// API search type: find_all_idxs_by : ((a -> Bool), [a]) -> [Int]
-// fwd bind count: 1
-// Returns the indices off all elements fulfilling the predicate.
-// find_all_idxs_by(is_even, [1, 3, 4, 6, 9]) == [2, 3]
-template <typename ContainerOut = std::vector<std::size_t>,
-    typename UnaryPredicate, typename Container>
-ContainerOut find_all_idxs_by(UnaryPredicate p, const Container& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    std::size_t idx = 0;
-    ContainerOut result;
-    auto itOut = internal::get_back_inserter(result);
-    for (const auto& x : xs) {
-        if (internal::invoke(p, x))
-            *itOut = idx;
-        ++idx;
-    }
-    return result;
-}
 
-// API search type: find_all_idxs_of : (a, [a]) -> [Int]
-// fwd bind count: 1
-// Returns the indices off all elements equal to x.
-// find_all_idxs_of(4, [1, 3, 4, 4, 9]) == [2, 3]
-template <typename ContainerOut = std::vector<std::size_t>,
-    typename Container,
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Containers storing their elements contiguously, e.g. std::vector,
+    // std::string and std::array, but not std::vector<bool>.
+    template <typename Container, typename = void>
+    struct has_contiguous_data : std::false_type {
+    };
+    template <typename Container>
+    struct has_contiguous_data<Container,
+        void_t<decltype(std::declval<const Container&>().data())>>
+        : std::is_same<decltype(std::declval<const Container&>().data()),
+              const typename Container::value_type*> {
+    };
+
+    // Elements that can be compared with memchr and memcmp.
+    template <typename T>
+    struct is_byte_like
+        : std::integral_constant<bool,
+              std::is_integral<T>::value && sizeof(T) == 1
+                  && !std::is_same<T, bool>::value> {
+    };
+
+    // Elements whose operator< is a strict total order consistent with ==.
+    template <typename T>
+    struct is_totally_ordered
+        : std::integral_constant<bool,
+              std::is_integral<T>::value || std::is_enum<T>::value> {
+    };
+
+    enum class token_search_strategy {
+        empty,
+        byte_scan,
+        byte_horspool,
+        two_way,
+        hashed_horspool,
+        naive
+    };
+
+    // Byte tokens from this length on use Boyer-Moore-Horspool,
+    // shorter ones are found by memchr-ing their first element.
+    constexpr std::size_t byte_horspool_min_token_size = 4;
+
+    // Finds all (possibly overlapping) occurrences of a token
+    // in contiguous sequences of elements.
+    // The algorithm is chosen once on construction:
+    //  - bytes: memchr for short tokens, Boyer-Moore-Horspool for longer ones
+    //  - other integral and enum types: Two-Way (O(n), constant space)
+    //  - other hashable types: Boyer-Moore-Horspool with a hashed shift table
+    //  - everything else: comparison at every offset (O(n*m))
+    template <typename T>
+    class token_search_engine {
+    public:
+        explicit token_search_engine(std::vector<T> token)
+            : token_(std::move(token))
+            , strategy_(select_strategy(token_.size()))
+            , byte_shifts_()
+            , hashed_shifts_()
+            , suffix_(0)
+            , period_(0)
+            , is_periodic_(false)
+        {
+            prepare(strategy_tag<T>());
+        }
+
+        const std::vector<T>& token() const { return token_; }
+        token_search_strategy strategy() const { return strategy_; }
+
+        // Calls on_match(idx) for every occurrence of the token in xs,
+        // in ascending order, as long as on_match returns true.
+        template <typename F>
+        void for_each_match(const T* xs, std::size_t n, F on_match) const
+        {
+            const std::size_t m = token_.size();
+            if (m > n) {
+                return;
+            }
+            switch (strategy_) {
+            case token_search_strategy::empty:
+                for (std::size_t j = 0; j <= n; ++j) {
+                    if (!on_match(j)) {
+                        return;
+                    }
+                }
+                return;
+            case token_search_strategy::byte_scan:
+                return byte_scan(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::byte_horspool:
+                return byte_horspool(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::two_way:
+                return two_way(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::hashed_horspool:
+                return hashed_horspool(xs, n, on_match, strategy_tag<T>());
+            case token_search_strategy::naive:
+                break;
+            }
+            for (std::size_t j = 0; j <= n - m; ++j) {
+                if (std::equal(xs + j, xs + j + m, token_.data()) && !on_match(j)) {
+                    return;
+                }
+            }
+        }
+
+    private:
+        struct byte_tag {
+        };
+        struct ordered_tag {
+        };
+        struct hashed_tag {
+        };
+        struct generic_tag {
+        };
+        template <typename U>
+        using strategy_tag = std::conditional_t<is_byte_like<U>::value, byte_tag,
+            std::conditional_t<is_totally_ordered<U>::value, ordered_tag,
+                std::conditional_t<is_hashable<U>::value, hashed_tag, generic_tag>>>;
+
+        static token_search_strategy select_strategy(std::size_t m)
+        {
+            if (m == 0) {
+                return token_search_strategy::empty;
+            }
+            if (std::is_same<strategy_tag<T>, byte_tag>::value) {
+                return m < byte_horspool_min_token_size
+                    ? token_search_strategy::byte_scan
+                    : token_search_strategy::byte_horspool;
+            }
+            if (std::is_same<strategy_tag<T>, ordered_tag>::value) {
+                return token_search_strategy::two_way;
+            }
+            if (std::is_same<strategy_tag<T>, hashed_tag>::value) {
+                return m == 1 ? token_search_strategy::naive
+                              : token_search_strategy::hashed_horspool;
+            }
+            return token_search_strategy::naive;
+        }
+
+        static unsigned char to_byte(T x)
+        {
+            return static_cast<unsigned char>(x);
+        }
+
+        void prepare(byte_tag)
+        {
+            if (strategy_ != token_search_strategy::byte_horspool) {
+                return;
+            }
+            const std::size_t m = token_.size();
+            byte_shifts_.fill(m);
+            for (std::size_t i = 0; i + 1 < m; ++i) {
+                byte_shifts_[to_byte(token_[i])] = m - 1 - i;
+            }
+        }
+
+        void prepare(ordered_tag)
+        {
+            if (strategy_ != token_search_strategy::two_way) {
+                return;
+            }
+            const std::size_t m = token_.size();
+            suffix_ = critical_factorization(period_);
+            is_periodic_ = period_ + suffix_ <= m
+                && std::equal(token_.data(), token_.data() + suffix_,
+                    token_.data() + period_);
+            if (!is_periodic_) {
+                period_ = std::max(suffix_, m - suffix_) + 1;
+            }
+        }
+
+        void prepare(hashed_tag)
+        {
+            if (strategy_ != token_search_strategy::hashed_horspool) {
+                return;
+            }
+            const std::size_t m = token_.size();
+            for (std::size_t i = 0; i + 1 < m; ++i) {
+                hashed_shifts_[token_[i]] = m - 1 - i;
+            }
+        }
+
+        void prepare(generic_tag)
+        {
+        }
+
+        template <typename F>
+        void byte_scan(const T* xs, std::size_t n, F on_match, byte_tag) const
+        {
+            const std::size_t m = token_.size();
+            const std::size_t last = n - m;
+            std::size_t j = 0;
+            while (j <= last) {
+                const void* const found = std::memchr(xs + j, to_byte(token_[0]), last - j + 1);
+                if (found == nullptr) {
+                    return;
+                }
+                j = static_cast<std::size_t>(static_cast<const T*>(found) - xs);
+                if (std::memcmp(xs + j + 1, token_.data() + 1, m - 1) == 0 && !on_match(j)) {
+                    return;
+                }
+                ++j;
+            }
+        }
+
+        template <typename F>
+        void byte_horspool(const T* xs, std::size_t n, F on_match, byte_tag) const
+        {
+            const std::size_t m = token_.size();
+            const T token_last = token_[m - 1];
+            for (std::size_t j = 0; j <= n - m;) {
+                const T x = xs[j + m - 1];
+                if (x == token_last
+                    && std::memcmp(xs + j, token_.data(), m - 1) == 0
+                    && !on_match(j)) {
+                    return;
+                }
+                j += byte_shifts_[to_byte(x)];
+            }
+        }
+
+        // Splits the token into u and v = token[suffix..] such that
+        // the local period at the split equals the period of the token.
+        // Returns the position of the split and sets period
+        // to the period of v.
+        // See Crochemore & Perrin, "Two-way string-matching", 1991.
+        std::size_t critical_factorization(std::size_t& period) const
+        {
+            const std::size_t m = token_.size();
+            const std::size_t none = std::numeric_limits<std::size_t>::max();
+            const auto max_suffix = [&](bool reversed, std::size_t& p) {
+                // Index arithmetic wraps around on purpose: ms + k == k - 1
+                // as long as no maximal suffix has been found yet.
+                std::size_t ms = none;
+                std::size_t j = 0;
+                std::size_t k = 1;
+                p = 1;
+                while (j + k < m) {
+                    const T& a = token_[j + k];
+                    const T& b = token_[ms + k];
+                    if (reversed ? b < a : a < b) {
+                        j += k;
+                        k = 1;
+                        p = j - ms;
+                    } else if (a == b) {
+                        if (k != p) {
+                            ++k;
+                        } else {
+                            j += p;
+                            k = 1;
+                        }
+                    } else {
+                        ms = j++;
+                        k = 1;
+                        p = 1;
+                    }
+                }
+                return ms + 1;
+            };
+            std::size_t p = 1;
+            std::size_t p_rev = 1;
+            const std::size_t suffix = max_suffix(false, p);
+            const std::size_t suffix_rev = max_suffix(true, p_rev);
+            if (suffix_rev < suffix) {
+                period = p;
+                return suffix;
+            }
+            period = p_rev;
+            return suffix_rev;
+        }
+
+        template <typename F>
+        void two_way(const T* xs, std::size_t n, F on_match, ordered_tag) const
+        {
+            const std::size_t m = token_.size();
+            const T* const token = token_.data();
+            // Number of token elements known to match
+            // at the start of the current window (periodic tokens only).
+            std::size_t memory = 0;
+            for (std::size_t j = 0; j <= n - m;) {
+                std::size_t i = std::max(suffix_, memory);
+                while (i < m && token[i] == xs[i + j]) {
+                    ++i;
+                }
+                if (i < m) {
+                    j += i - suffix_ + 1;
+                    memory = 0;
+                    continue;
+                }
+                i = suffix_;
+                while (i > memory && token[i - 1] == xs[i - 1 + j]) {
+                    --i;
+                }
+                if (i <= memory && !on_match(j)) {
+                    return;
+                }
+                // Two occurrences are at least one period apart.
+                j += period_;
+                memory = is_periodic_ ? m - period_ : 0;
+            }
+        }
+
+        template <typename F>
+        void hashed_horspool(const T* xs, std::size_t n, F on_match, hashed_tag) const
+        {
+            const std::size_t m = token_.size();
+            const T& token_last = token_[m - 1];
+            for (std::size_t j = 0; j <= n - m;) {
+                const T& x = xs[j + m - 1];
+                if (x == token_last
+                    && std::equal(xs + j, xs + j + m - 1, token_.data())
+                    && !on_match(j)) {
+                    return;
+                }
+                const auto it = hashed_shifts_.find(x);
+                j += it == hashed_shifts_.end() ? m : it->second;
+            }
+        }
+
+        template <typename F, typename Tag>
+        void byte_scan(const T*, std::size_t, F, Tag) const
+        {
+        }
+        template <typename F, typename Tag>
+        void byte_horspool(const T*, std::size_t, F, Tag) const
+        {
+        }
+        template <typename F, typename Tag>
+        void two_way(const T*, std::size_t, F, Tag) const
+        {
+        }
+        template <typename F, typename Tag>
+        void hashed_horspool(const T*, std::size_t, F, Tag) const
+        {
+        }
+
+        std::vector<T> token_;
+        token_search_strategy strategy_;
+        std::array<std::size_t, 256> byte_shifts_;
+        std::conditional_t<is_hashable<T>::value,
+            std::unordered_map<T, std::size_t>, generic_tag>
+            hashed_shifts_;
+        std::size_t suffix_;
+        std::size_t period_;
+        bool is_periodic_;
+    };
+}
+}
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Aho-Corasick automaton finding all occurrences
+    // of many tokens in one pass over the input.
+    // Bytes use a dense transition table (a DFA with 256 columns),
+    // other element types follow failure links
+    // over per-node lists of outgoing edges.
+    // Empty tokens are ignored. Of equal tokens,
+    // only the first one is reported.
+    template <typename T>
+    class aho_corasick_automaton {
+    public:
+        explicit aho_corasick_automaton(const std::vector<std::vector<T>>& tokens)
+            : nodes_(1)
+            , edges_(1)
+            , dense_goto_()
+            , token_sizes_()
+        {
+            token_sizes_.reserve(tokens.size());
+            for (std::size_t idx = 0; idx < tokens.size(); ++idx) {
+                token_sizes_.push_back(tokens[idx].size());
+                insert(tokens[idx], idx);
+            }
+            link(is_byte_like<T>());
+        }
+
+        std::size_t token_count() const { return token_sizes_.size(); }
+        std::size_t token_size(std::size_t token_idx) const
+        {
+            return token_sizes_[token_idx];
+        }
+
+        // Calls on_match(idx, token_idx) for every occurrence
+        // of every token in [first, last),
+        // ordered by the position of their ends.
+        template <typename Iterator, typename F>
+        void for_each_match(Iterator first, Iterator last, F on_match) const
+        {
+            std::size_t state = 0;
+            std::size_t end_idx = 1;
+            for (; first != last; ++first, ++end_idx) {
+                state = next_state(state, *first, is_byte_like<T>());
+                std::size_t out = nodes_[state].token_idx != none
+                    ? state
+                    : nodes_[state].output_link;
+                while (out != none) {
+                    const std::size_t token_idx = nodes_[out].token_idx;
+                    on_match(end_idx - token_sizes_[token_idx], token_idx);
+                    out = nodes_[out].output_link;
+                }
+            }
+        }
+
+    private:
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        static constexpr std::size_t alphabet_size = 256;
+
+        // token_idx: token ending here, none if no token ends here
+        // output_link: longest proper suffix state a token ends in
+        struct node {
+            std::size_t fail = 0;
+            std::size_t token_idx = none;
+            std::size_t output_link = none;
+        };
+
+        std::size_t find_edge(std::size_t state, const T& x) const
+        {
+            for (const auto& edge : edges_[state]) {
+                if (edge.first == x) {
+                    return edge.second;
+                }
+            }
+            return none;
+        }
+
+        void insert(const std::vector<T>& token, std::size_t token_idx)
+        {
+            if (token.empty()) {
+                return;
+            }
+            std::size_t state = 0;
+            for (const T& x : token) {
+                std::size_t child = find_edge(state, x);
+                if (child == none) {
+                    child = nodes_.size();
+                    nodes_.emplace_back();
+                    edges_.emplace_back();
+                    edges_[state].emplace_back(x, child);
+                }
+                state = child;
+            }
+            if (nodes_[state].token_idx == none) {
+                nodes_[state].token_idx = token_idx;
+            }
+        }
+
+        void set_output_link(std::size_t state)
+        {
+            const node& fail = nodes_[nodes_[state].fail];
+            nodes_[state].output_link = fail.token_idx != none
+                ? nodes_[state].fail
+                : fail.output_link;
+        }
+
+        // Breadth-first, so the failure state of a node
+        // is complete before the node itself is processed.
+        void link(std::true_type /* is_byte_like */)
+        {
+            dense_goto_.assign(nodes_.size() * alphabet_size, 0);
+            for (const auto& edge : edges_[0]) {
+                dense_goto_[to_byte(edge.first)] = edge.second;
+            }
+            std::deque<std::size_t> queue;
+            for (const auto& edge : edges_[0]) {
+                queue.push_back(edge.second);
+            }
+            while (!queue.empty()) {
+                const std::size_t state = queue.front();
+                queue.pop_front();
+                set_output_link(state);
+                const std::size_t* const fail_row = &dense_goto_[nodes_[state].fail * alphabet_size];
+                std::size_t* const row = &dense_goto_[state * alphabet_size];
+                std::copy(fail_row, fail_row + alphabet_size, row);
+                for (const auto& edge : edges_[state]) {
+                    nodes_[edge.second].fail = fail_row[to_byte(edge.first)];
+                    row[to_byte(edge.first)] = edge.second;
+                    queue.push_back(edge.second);
+                }
+            }
+            edges_.clear();
+            edges_.shrink_to_fit();
+        }
+
+        void link(std::false_type /* is_byte_like */)
+        {
+            std::deque<std::size_t> queue;
+            for (const auto& edge : edges_[0]) {
+                queue.push_back(edge.second);
+            }
+            while (!queue.empty()) {
+                const std::size_t state = queue.front();
+                queue.pop_front();
+                set_output_link(state);
+                for (const auto& edge : edges_[state]) {
+                    nodes_[edge.second].fail = next_state(
+                        nodes_[state].fail, edge.first, std::false_type());
+                    queue.push_back(edge.second);
+                }
+            }
+        }
+
+        std::size_t next_state(std::size_t state, const T& x,
+            std::true_type /* is_byte_like */) const
+        {
+            return dense_goto_[state * alphabet_size + to_byte(x)];
+        }
+
+        std::size_t next_state(std::size_t state, const T& x,
+            std::false_type /* is_byte_like */) const
+        {
+            for (;;) {
+                const std::size_t child = find_edge(state, x);
+                if (child != none) {
+                    return child;
+                }
+                if (state == 0) {
+                    return 0;
+                }
+                state = nodes_[state].fail;
+            }
+        }
+
+        static unsigned char to_byte(const T& x)
+        {
+            return static_cast<unsigned char>(x);
+        }
+
+        std::vector<node> nodes_;
+        std::vector<std::vector<std::pair<T, std::size_t>>> edges_;
+        std::vector<std::size_t> dense_goto_;
+        std::vector<std::size_t> token_sizes_;
+    };
+}
+}
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace fplus {
+
+// API search type: find_first_by : ((a -> Bool), [a]) -> Maybe a
+// fwd bind count: 1
+// Returns the first element fulfilling the predicate.
+// find_first_by(is_even, [1, 3, 4, 6, 9]) == Just(4)
+// find_first_by(is_even, [1, 3, 5, 7, 9]) == Nothing
+template <typename Container, typename UnaryPredicate,
     typename T = typename Container::value_type>
-ContainerOut find_all_idxs_of(const T& x, const Container& xs)
+maybe<T> find_first_by(UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    auto it = std::find_if(std::begin(xs), std::end(xs), pred);
+    if (it == std::end(xs))
+        return nothing<T>();
+    return just<T>(*it);
+}
+
+// API search type: find_last_by : ((a -> Bool), [a]) -> Maybe a
+// fwd bind count: 1
+// Returns the last element fulfilling the predicate.
+// find_last_by(is_even, [1, 3, 4, 6, 9]) == Just(6)
+// find_last_by(is_even, [1, 3, 5, 7, 9]) == Nothing
+template <typename Container, typename UnaryPredicate,
+    typename T = typename Container::value_type>
+maybe<T> find_last_by(UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return find_first_by(pred, reverse(xs));
+}
+
+// API search type: find_first_idx_by : ((a -> Bool), [a]) -> Maybe Int
+// fwd bind count: 1
+// Returns the index of the first element fulfilling the predicate.
+// find_first_idx_by(is_even, [1, 3, 4, 6, 9]) == Just(2)
+// find_first_idx_by(is_even, [1, 3, 5, 7, 9]) == Nothing
+template <typename Container, typename UnaryPredicate>
+maybe<std::size_t> find_first_idx_by(UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    auto it = std::find_if(std::begin(xs), std::end(xs), pred);
+    if (it == std::end(xs))
+        return nothing<std::size_t>();
+    return static_cast<std::size_t>(std::distance(std::begin(xs), it));
+}
+
+// API search type: find_last_idx_by : ((a -> Bool), [a]) -> Maybe Int
+// fwd bind count: 1
+// Returns the index of the last element fulfilling the predicate.
+// find_last_idx_by(is_even, [1, 3, 4, 6, 9]) == Just(3)
+// find_last_idx_by(is_even, [1, 3, 5, 7, 9]) == Nothing
+template <typename Container, typename UnaryPredicate>
+maybe<std::size_t> find_last_idx_by(UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    auto calcRevIdx = [&](std::size_t idx) {
+        return size_of_cont(xs) - (idx + 1);
+    };
+    return lift_maybe(calcRevIdx, find_first_idx_by(pred, reverse(xs)));
+}
+
+// API search type: find_first_idx : (a, [a]) -> Maybe Int
+// fwd bind count: 1
+// Returns the index of the first element equal to x.
+// find_first_idx(4, [1, 3, 4, 4, 9]) == Just(2)
+// find_first_idx(4, [1, 3, 5, 7, 9]) == Nothing
+template <typename Container>
+maybe<std::size_t> find_first_idx(const typename Container::value_type& x, const Container& xs)
+{
+    return find_first_idx_by(is_equal_to(x), xs);
+}
+
+// API search type: find_last_idx : (a, [a]) -> Maybe Int
+// fwd bind count: 1
+// Returns the index of the last element equal to x.
+// find_last_idx(4, [1, 3, 4, 4, 9]) == Just(3)
+// find_last_idx(4, [1, 3, 5, 7, 9]) == Nothing
+template <typename Container>
+maybe<std::size_t> find_last_idx(const typename Container::value_type& x, const Container& xs)
+{
+    return find_last_idx_by(is_equal_to(x), xs);
+}
+
+// API search type: find_all_idxs_by : ((a -> Bool), [a]) -> [Int]
+// fwd bind count: 1
+// Returns the indices off all elements fulfilling the predicate.
+// find_all_idxs_by(is_even, [1, 3, 4, 6, 9]) == [2, 3]
+template <typename ContainerOut = std::vector<std::size_t>,
+    typename UnaryPredicate, typename Container>
+ContainerOut find_all_idxs_by(UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    std::size_t idx = 0;
+    ContainerOut result;
+    auto itOut = internal::get_back_inserter(result);
+    for (const auto& x : xs) {
+        if (internal::invoke(p, x))
+            *itOut = idx;
+        ++idx;
+    }
+    return result;
+}
+
+// API search type: find_all_idxs_of : (a, [a]) -> [Int]
+// fwd bind count: 1
+// Returns the indices off all elements equal to x.
+// find_all_idxs_of(4, [1, 3, 4, 4, 9]) == [2, 3]
+template <typename ContainerOut = std::vector<std::size_t>,
+    typename Container,
+    typename T = typename Container::value_type>
+ContainerOut find_all_idxs_of(const T& x, const Container& xs)
+{
+    return find_all_idxs_by(is_equal_to(x), xs);
+}
+
+// A token prepared for being searched in containers.
+// The search algorithm and its tables are set up once on construction,
+// so the same token can be looked for in many containers cheaply.
+// Containers storing their elements contiguously
+// (std::vector, std::string, std::array, ...) are searched
+// with memchr or Boyer-Moore-Horspool for bytes,
+// Two-Way for other integral types,
+// and Boyer-Moore-Horspool with a hashed shift table for other hashable types.
+// Everything else is compared at every offset.
+template <typename Container>
+class compiled_token {
+public:
+    typedef typename Container::value_type value_type;
+
+    explicit compiled_token(const Container& token)
+        : token_(token)
+        , engine_(std::vector<value_type>(std::begin(token), std::end(token)))
+    {
+    }
+    const Container& token() const { return token_; }
+    std::size_t size() const { return engine_.token().size(); }
+
+    // Calls on_match(idx) for every (possibly overlapping) occurrence
+    // of the token in xs, in ascending order, as long as on_match returns true.
+    template <typename F>
+    void for_each_match(const Container& xs, F on_match) const
+    {
+        for_each_match(internal::has_contiguous_data<Container>(), xs, on_match);
+    }
+
+private:
+    template <typename F>
+    void for_each_match(std::true_type, const Container& xs, F on_match) const
+    {
+        engine_.for_each_match(xs.data(), size_of_cont(xs), on_match);
+    }
+
+    template <typename F>
+    void for_each_match(std::false_type, const Container& xs, F on_match) const
+    {
+        const std::size_t m = size();
+        const std::size_t n = size_of_cont(xs);
+        if (m > n)
+            return;
+        auto itInBegin = std::begin(xs);
+        auto itInEnd = itInBegin;
+        internal::advance_iterator(itInEnd, m);
+        for (std::size_t idx = 0;; ++idx) {
+            if (std::equal(itInBegin, itInEnd, std::begin(token_)) && !on_match(idx))
+                return;
+            if (idx == n - m)
+                return;
+            ++itInBegin;
+            ++itInEnd;
+        }
+    }
+
+    Container token_;
+    internal::token_search_engine<value_type> engine_;
+};
+
+// API search type: compile_token : [a] -> CompiledToken a
+// fwd bind count: 0
+// Prepares a token for being searched in many containers.
+// The result can be passed to find_all_instances_of_token,
+// find_all_instances_of_token_non_overlapping
+// and find_first_instance_of_token instead of the token itself.
+template <typename Container>
+compiled_token<Container> compile_token(const Container& token)
+{
+    return compiled_token<Container>(token);
+}
+
+// API search type: find_all_instances_of_token : ([a], [a]) -> [Int]
+// fwd bind count: 1
+// Returns the starting indices of all segments matching token.
+// find_all_instances_of_token("haha", "oh, hahaha!") == [4, 6]
+// O(n) for contiguous containers of integral types,
+// see compiled_token for details.
+template <typename ContainerOut = std::vector<std::size_t>, typename Container>
+ContainerOut find_all_instances_of_token(const Container& token,
+    const Container& xs)
+{
+    return find_all_instances_of_token<ContainerOut>(
+        compiled_token<Container>(token), xs);
+}
+
+// Overload of find_all_instances_of_token for compiled tokens.
+template <typename ContainerOut = std::vector<std::size_t>, typename Container>
+ContainerOut find_all_instances_of_token(
+    const compiled_token<Container>& token, const Container& xs)
+{
+    ContainerOut result;
+    auto outIt = internal::get_back_inserter(result);
+    token.for_each_match(xs, [&](std::size_t idx) {
+        *outIt = idx;
+        return true;
+    });
+    return result;
+}
+
+// API search type: find_all_instances_of_token_non_overlapping : ([a], [a]) -> [Int]
+// fwd bind count: 1
+// Returns the starting indices
+// of all non-overlapping segments matching token.
+// find_all_instances_of_token_non_overlapping("haha", "oh, hahaha!") == [4]
+template <typename ContainerOut = std::vector<std::size_t>, typename Container>
+ContainerOut find_all_instances_of_token_non_overlapping(const Container& token, const Container& xs)
+{
+    return find_all_instances_of_token_non_overlapping<ContainerOut>(
+        compiled_token<Container>(token), xs);
+}
+
+// Overload of find_all_instances_of_token_non_overlapping for compiled tokens.
+template <typename ContainerOut = std::vector<std::size_t>, typename Container>
+ContainerOut find_all_instances_of_token_non_overlapping(
+    const compiled_token<Container>& token, const Container& xs)
+{
+    ContainerOut result;
+    auto outIt = internal::get_back_inserter(result);
+    const std::size_t token_size = token.size();
+    bool found = false;
+    std::size_t next_possible_idx = 0;
+    token.for_each_match(xs, [&](std::size_t idx) {
+        if (!found || next_possible_idx <= idx) {
+            *outIt = idx;
+            found = true;
+            next_possible_idx = idx + token_size;
+        }
+        return true;
+    });
+    return result;
+}
+
+// API search type: find_first_instance_of_token : ([a], [a]) -> Maybe Int
+// fwd bind count: 1
+// Returns the index of the first segment matching token.
+// find_first_instance_of_token("haha", "oh, hahaha!") == just 4
+template <typename Container>
+maybe<std::size_t> find_first_instance_of_token(const Container& token, const Container& xs)
+{
+    return find_first_instance_of_token(compiled_token<Container>(token), xs);
+}
+
+// Overload of find_first_instance_of_token for compiled tokens.
+template <typename Container>
+maybe<std::size_t> find_first_instance_of_token(
+    const compiled_token<Container>& token, const Container& xs)
+{
+    maybe<std::size_t> result;
+    token.for_each_match(xs, [&](std::size_t idx) {
+        result = just(idx);
+        return false;
+    });
+    return result;
+}
+
+// Many tokens prepared for being searched in containers at once.
+// They are compiled into an Aho-Corasick automaton,
+// which finds all occurrences of all tokens
+// in a single pass over a container.
+// Empty tokens never match.
+template <typename Container>
+class compiled_tokens {
+public:
+    typedef typename Container::value_type value_type;
+
+    template <typename ContainerTokens>
+    explicit compiled_tokens(const ContainerTokens& tokens)
+        : automaton_(to_vectors(tokens))
+    {
+    }
+    std::size_t size() const { return automaton_.token_count(); }
+    std::size_t token_size(std::size_t token_idx) const
+    {
+        return automaton_.token_size(token_idx);
+    }
+
+    // Calls on_match(idx, token_idx) for every (possibly overlapping)
+    // occurrence of every token in xs, ordered by the position of their ends.
+    // Of equal tokens, only the first one is reported.
+    template <typename F>
+    void for_each_match(const Container& xs, F on_match) const
+    {
+        automaton_.for_each_match(std::begin(xs), std::end(xs), on_match);
+    }
+
+private:
+    template <typename ContainerTokens>
+    static std::vector<std::vector<value_type>> to_vectors(const ContainerTokens& tokens)
+    {
+        std::vector<std::vector<value_type>> result;
+        result.reserve(size_of_cont(tokens));
+        for (const auto& token : tokens) {
+            result.emplace_back(std::begin(token), std::end(token));
+        }
+        return result;
+    }
+
+    internal::aho_corasick_automaton<value_type> automaton_;
+};
+
+// API search type: compile_tokens : [[a]] -> CompiledTokens a
+// fwd bind count: 0
+// Prepares many tokens for being searched in containers at once.
+// The result can be passed to find_all_instances_of_tokens
+// and replace_tokens_many instead of the tokens themselves.
+template <typename ContainerTokens,
+    typename Container = typename ContainerTokens::value_type>
+compiled_tokens<Container> compile_tokens(const ContainerTokens& tokens)
+{
+    return compiled_tokens<Container>(tokens);
+}
+
+// API search type: find_all_instances_of_tokens : ([[a]], [a]) -> [(Int, Int)]
+// fwd bind count: 1
+// Returns the starting indices of all segments matching one of the tokens,
+// each paired with the index of the matching token,
+// sorted by starting index and then by token index.
+// Empty tokens are ignored, of equal tokens only the first one is reported.
+// find_all_instances_of_tokens(["haha", "ah"], "oh, hahaha!")
+// == [(4, 0), (5, 1), (6, 0), (7, 1)]
+// O(n + k * log(k)), where k is the number of matches,
+// plus the time to compile the tokens.
+template <typename ContainerTokens,
+    typename Container = typename ContainerTokens::value_type>
+std::vector<std::pair<std::size_t, std::size_t>> find_all_instances_of_tokens(
+    const ContainerTokens& tokens, const Container& xs)
+{
+    return find_all_instances_of_tokens(compiled_tokens<Container>(tokens), xs);
+}
+
+// Overload of find_all_instances_of_tokens for compiled tokens.
+template <typename Container>
+std::vector<std::pair<std::size_t, std::size_t>> find_all_instances_of_tokens(
+    const compiled_tokens<Container>& tokens, const Container& xs)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> result;
+    tokens.for_each_match(xs, [&](std::size_t idx, std::size_t token_idx) {
+        result.emplace_back(idx, token_idx);
+    });
+    std::sort(std::begin(result), std::end(result));
+    return result;
+}
+
+} // namespace fplus
+
+//
+// sets.hpp
+//
+
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+
+
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+
+namespace fplus {
+
+// API search type: set_includes : (Set a, Set a) -> Bool
+// fwd bind count: 1
+// Checks if every element of the second set is also present in the first set.
+// Also known as is_subset_of.
+template <typename SetType>
+bool set_includes(const SetType& set1, const SetType& set2)
+{
+    return std::includes(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2));
+}
+
+// API search type: unordered_set_includes : (Unordered_Set a, Unordered_Set a) -> Bool
+// fwd bind count: 1
+// Checks if every element of the second unordered_set
+// is also present in the first unordered_set.
+// Also known as is_subset_of.
+template <typename UnorderSetType>
+bool unordered_set_includes(const UnorderSetType& set1,
+    const UnorderSetType& set2)
+{
+    auto first_not_included = std::find_if(set2.begin(), set2.end(),
+        [&](const typename UnorderSetType::value_type& x)
+            -> bool { return set1.find(x) == set1.end(); });
+    return first_not_included == set2.end();
+}
+
+// API search type: set_merge : (Set a, Set a) -> Set a
+// fwd bind count: 1
+// Returns the union of two given sets.
+template <typename SetType>
+SetType set_merge(const SetType& set1, const SetType& set2)
+{
+    SetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::merge(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2),
+        itOut);
+    return result;
+}
+
+// API search type: unordered_set_merge : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// fwd bind count: 1
+// Returns the union of two given unordered sets.
+template <typename UnorderSetType>
+UnorderSetType unordered_set_merge(const UnorderSetType& set1, const UnorderSetType& set2)
+{
+    UnorderSetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::copy(std::begin(set1), std::end(set1), itOut);
+    std::copy(std::begin(set2), std::end(set2), itOut);
+    return result;
+}
+
+// API search type: set_intersection : (Set a, Set a) -> Set a
+// fwd bind count: 1
+// Returns the intersection of both sets.
+template <typename SetType>
+SetType set_intersection(const SetType& set1, const SetType& set2)
+{
+    SetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::set_intersection(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2),
+        itOut);
+    return result;
+}
+
+// API search type: unordered_set_intersection : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// fwd bind count: 1
+// Returns the intersection of both unordered_sets.
+template <typename UnorderSetType>
+UnorderSetType unordered_set_intersection(
+    const UnorderSetType& set1, const UnorderSetType& set2)
+{
+    UnorderSetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::copy_if(std::begin(set2), std::end(set2),
+        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set1.find(x) != set1.end(); });
+    return result;
+}
+
+// API search type: set_is_disjoint : (Set a, Set a) -> Bool
+// fwd bind count: 1
+// Checks if two sets are disjoint.
+template <typename SetType>
+bool set_is_disjoint(const SetType& set1, const SetType& set2)
+{
+    return set_intersection(set1, set2).empty();
+}
+
+// API search type: unordered_set_is_disjoint : (Unordered_Set a, Unordered_Set a) -> Bool
+// fwd bind count: 1
+// Checks if two unordered_sets are disjoint.
+template <typename UnorderSetType>
+bool unordered_set_is_disjoint(
+    const UnorderSetType& set1, const UnorderSetType& set2)
+{
+    return unordered_set_intersection(set1, set2).empty();
+}
+
+// API search type: set_difference : (Set a, Set a) -> Set a
+// fwd bind count: 1
+// Returns the elements in set1 that are not present in set2.
+template <typename SetType>
+SetType set_difference(const SetType& set1, const SetType& set2)
+{
+    SetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::set_difference(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2),
+        itOut);
+    return result;
+}
+
+// API search type: unordered_set_difference : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// fwd bind count: 1
+// Returns the elements in unordered_set1
+// that are not present in unordered_set2.
+template <typename UnorderSetType>
+UnorderSetType unordered_set_difference(const UnorderSetType& set1,
+    const UnorderSetType& set2)
+{
+    UnorderSetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::copy_if(std::begin(set1), std::end(set1),
+        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set2.find(x) == set2.end(); });
+    return result;
+}
+
+// API search type: set_symmetric_difference : (Set a, Set a) -> Set a
+// fwd bind count: 1
+// Returns the symmetric difference of both sets.
+template <typename SetType>
+SetType set_symmetric_difference(const SetType& set1, const SetType& set2)
+{
+    SetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::set_symmetric_difference(std::begin(set1), std::end(set1),
+        std::begin(set2), std::end(set2),
+        itOut);
+    return result;
+}
+
+// API search type: unordered_set_symmetric_difference : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// fwd bind count: 1
+// Returns the symmetric difference of both unordered_sets.
+template <typename UnorderSetType>
+UnorderSetType unordered_set_symmetric_difference(
+    const UnorderSetType& set1, const UnorderSetType& set2)
+{
+    UnorderSetType result;
+    auto itOut = internal::get_back_inserter(result);
+    std::copy_if(std::begin(set1), std::end(set1),
+        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set2.find(x) == set2.end(); });
+    std::copy_if(std::begin(set2), std::end(set2),
+        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set1.find(x) == set1.end(); });
+    return result;
+}
+
+// API search type: sets_intersection : [Set a] -> Set a
+// fwd bind count: 0
+// Returns the intersection of the given sets.
+// Also known as intersect_many.
+// For performance try to sort the inputs sets prior, ascendending by size.
+template <typename ContainerIn,
+    typename SetType = typename ContainerIn::value_type>
+SetType sets_intersection(const ContainerIn& sets)
+{
+    return fold_left_1(set_intersection<SetType>, sets);
+}
+
+// API search type: unordered_sets_intersection : [Unordered_Set a] -> Unordered_Set a
+// fwd bind count: 0
+// Returns the intersection of the given unordered_sets.
+// Also known as intersect_many.
+template <typename ContainerIn,
+    typename UnordSetType = typename ContainerIn::value_type>
+UnordSetType unordered_sets_intersection(const ContainerIn& sets)
+{
+    return fold_left_1(unordered_set_intersection<UnordSetType>, sets);
+}
+
+} // namespace fplus
+
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fplus {
+
+// API search type: any_by : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Check if all elements in a container fulfill a predicate.
+// any_by(is_odd, [2, 4, 6]) == false
+template <typename UnaryPredicate, typename Container>
+bool any_by(UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return std::any_of(std::begin(xs), std::end(xs), p);
+}
+
+// API search type: any : [Bool] -> Bool
+// fwd bind count: 0
+// Checks if all elements in a container are true.
+// any([false, true, false]) == true
+template <typename Container>
+bool any(const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return any_by(identity<T>, xs);
+}
+
+// API search type: none_by : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Check no element in a container fulfills a predicate.
+// none_by(is_even, [3, 4, 5]) == false
+template <typename UnaryPredicate, typename Container>
+bool none_by(UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return std::none_of(std::begin(xs), std::end(xs), p);
+}
+
+// API search type: none : [Bool] -> Bool
+// fwd bind count: 0
+// Checks if all elements in a container are false.
+// none([false, true, false]) == false
+template <typename Container>
+bool none(const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return none_by(identity<T>, xs);
+}
+
+// API search type: minimum_idx_by : (((a, a) -> Bool), [a]) -> Int
+// fwd bind count: 1
+// Return the index of the first minimum element using a less comparator.
+// minimum_idx_by(lessLength, ["123", "12", "1234", "123"]) -> "1"
+// Unsafe! Crashes on an empty sequence.
+template <typename Compare, typename Container>
+typename std::size_t minimum_idx_by(Compare comp,
+    const Container& xs)
+{
+    internal::check_compare_for_container<Compare, Container>();
+    assert(is_not_empty(xs));
+    return static_cast<std::size_t>(std::distance(std::begin(xs),
+        std::min_element(std::begin(xs), std::end(xs), comp)));
+}
+
+// API search type: minimum_idx_by_maybe : (((a, a) -> Bool), [a]) -> Int
+// fwd bind count: 1
+// Return the index of the first minimum element using a less comparator
+// if sequence is not empty.
+// minimum_idx_by_maybe(lessLength, ["123", "12", "1234", "123"]) -> Just "1"
+// minimum_idx_by_maybe(lessLength, []) -> Nothing
+template <typename Compare, typename Container>
+maybe<typename std::size_t> minimum_idx_by_maybe(Compare comp,
+    const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minimum_idx_by(comp, xs);
+}
+
+// API search type: maximum_idx_by : (((a, a) -> Bool), [a]) -> Int
+// fwd bind count: 1
+// Return the index of the first maximum element using a less comparator.
+// maximum_idx_by(lessLength, ["123", "12", "1234", "123"]) == "2"
+// Unsafe! Crashes on an empty sequence.
+template <typename Compare, typename Container>
+typename std::size_t maximum_idx_by(Compare comp,
+    const Container& xs)
+{
+    internal::check_compare_for_container<Compare, Container>();
+    assert(is_not_empty(xs));
+    return static_cast<std::size_t>(std::distance(std::begin(xs),
+        std::max_element(std::begin(xs), std::end(xs), comp)));
+}
+
+// API search type: maximum_idx_by_maybe : (((a, a) -> Bool), [a]) -> Maybe Int
+// fwd bind count: 1
+// Return the index of the first maximum element using a less comparator
+// if sequence is not empty.
+// maximum_idx_by_maybe(lessLength, ["123", "12", "1234", "123"]) == Just "2"
+// maximum_idx_by_maybe(lessLength, []) == Nothing
+template <typename Compare, typename Container>
+maybe<typename std::size_t> maximum_idx_by_maybe(Compare comp,
+    const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return maximum_idx_by(comp, xs);
+}
+
+// API search type: minimum_idx : [a] -> Int
+// fwd bind count: 0
+// Return the index of the first minimum element.
+// minimum_idx([3, 1, 4, 2]) == 1
+// Unsafe! Crashes on an empty sequence.
+template <typename Container>
+typename std::size_t minimum_idx(const Container& xs)
+{
+    return minimum_idx_by(is_less<typename Container::value_type>, xs);
+}
+
+// API search type: minimum_idx_maybe : [a] -> Maybe Int
+// fwd bind count: 0
+// Return the index of the first minimum element if sequence is not empty.
+// minimum_idx_maybe([3, 1, 4, 2]) == Just 1
+// minimum_idx_maybe([]) == Nothing
+template <typename Container>
+maybe<typename std::size_t> minimum_idx_maybe(const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minimum_idx(xs);
+}
+
+// API search type: maximum_idx : [a] -> Int
+// fwd bind count: 0
+// Return the index of the first maximum element.
+// maximum_idx([3, 1, 4, 2]) == 2
+// Unsafe! Crashes on an empty sequence.
+template <typename Container>
+typename std::size_t maximum_idx(const Container& xs)
+{
+    return maximum_idx_by(is_less<typename Container::value_type>, xs);
+}
+
+// API search type: maximum_idx_maybe : [a] -> Maybe Int
+// fwd bind count: 0
+// Return the index of the first maximum element if sequence is not empty.
+// maximum_idx_maybe([3, 1, 4, 2]) == Just 2
+// maximum_imaximum_idx_maybedx([]) == Nothing
+template <typename Container>
+maybe<typename std::size_t> maximum_idx_maybe(const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return maximum_idx(xs);
+}
+
+// API search type: minimum_idx_on : ((a -> b), [a]) -> Int
+// fwd bind count: 1
+// Return the index of the first minimum element using a transformer.
+// minimum_idx_on(length, ["123", "12", "1234", "123"]) -> "1"
+// Unsafe! Crashes on an empty sequence.
+template <typename F, typename Container>
+std::size_t minimum_idx_on(F f, const Container& xs)
+{
+    using Result = internal::invoke_result_t<F, typename Container::value_type>;
+    auto transformed = transform_convert<std::vector<std::decay_t<Result>>>(f, xs);
+    return minimum_idx(transformed);
+}
+
+// API search type: minimum_idx_on_maybe : ((a -> b), [a]) -> Just Int
+// fwd bind count: 1
+// Return the index of the first minimum element using a transformer
+// if sequence is not empty.
+// minimum_idx_on_maybe(length, ["123", "12", "1234", "123"]) -> Just "1"
+// minimum_idx_on_maybe(length, []) -> Nothing"
+template <typename F, typename Container>
+maybe<typename std::size_t> minimum_idx_on_maybe(F f, const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minimum_idx_on(f, xs);
+}
+
+// API search type: maximum_idx_on : ((a -> b), [a]) -> Int
+// fwd bind count: 1
+// Return the index of the first maximum element using a transformer.
+// maximum_idx_on(length, ["123", "12", "1234", "123"]) == "2"
+// Unsafe! Crashes on an empty sequence.
+template <typename F, typename Container>
+std::size_t maximum_idx_on(F f, const Container& xs)
+{
+    using Result = internal::invoke_result_t<F, typename Container::value_type>;
+    auto transformed = transform_convert<std::vector<std::decay_t<Result>>>(f, xs);
+    return maximum_idx(transformed);
+}
+
+// API search type: maximum_idx_on_maybe : ((a -> b), [a]) -> Maybe Int
+// fwd bind count: 1
+// Return the index of the first maximum element using a transformer
+// if sequence is not empty.
+// maximum_idx_on_maybe(length, ["123", "12", "1234", "123"]) == Just "2"
+// maximum_idx_on_maybe(length, []) == Nothing
+template <typename F, typename Container>
+maybe<typename std::size_t> maximum_idx_on_maybe(F f, const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return maximum_idx_on(f, xs);
+}
+
+// API search type: minimum_by : (((a, a) -> Bool), [a]) -> a
+// fwd bind count: 1
+// Return the first minimum element using a less comparator.
+// minimum_by(lessLength, ["123", "12", "1234", "123"]) -> "12"
+// Unsafe! Crashes on an empty sequence.
+template <typename Compare, typename Container>
+typename Container::value_type minimum_by(Compare comp,
+    const Container& xs)
+{
+    internal::check_compare_for_container<Compare, Container>();
+    assert(is_not_empty(xs));
+    return *std::min_element(std::begin(xs), std::end(xs), comp);
+}
+
+// API search type: minimum_by_maybe : (((a, a) -> Bool), [a]) -> a
+// fwd bind count: 1
+// Return the first minimum element using a less comparator
+// if sequence is not empty.
+// minimum_by_maybe(lessLength, ["123", "12", "1234", "123"]) -> Just "12"
+// minimum_by_maybe(lessLength, []) -> Nothing
+template <typename Compare, typename Container>
+maybe<typename Container::value_type> minimum_by_maybe(Compare comp,
+    const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minimum_by(comp, xs);
+}
+
+// API search type: maximum_by : (((a, a) -> Bool), [a]) -> a
+// fwd bind count: 1
+// Return the first maximum element using a less comparator.
+// maximum_by(lessLength, ["123", "12", "1234", "123"]) == "1234"
+// Unsafe! Crashes on an empty sequence.
+template <typename Compare, typename Container>
+typename Container::value_type maximum_by(Compare comp,
+    const Container& xs)
+{
+    internal::check_compare_for_container<Compare, Container>();
+    assert(is_not_empty(xs));
+    return *std::max_element(std::begin(xs), std::end(xs), comp);
+}
+
+// API search type: maximum_by_maybe : (((a, a) -> Bool), [a]) -> Maybe a
+// fwd bind count: 1
+// Return the first maximum element using a less comparator
+// if sequence is not empty.
+// maximum_by_maybe(lessLength, ["123", "12", "1234", "123"]) == Just "1234"
+// maximum_by_maybe(lessLength, []) == Nothing
+template <typename Compare, typename Container>
+maybe<typename Container::value_type> maximum_by_maybe(Compare comp,
+    const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return maximum_by(comp, xs);
+}
+
+// API search type: minimum : [a] -> a
+// fwd bind count: 0
+// Return the first minimum element.
+// minimum([3, 1, 4, 2]) == 1
+// Unsafe! Crashes on an empty sequence.
+template <typename Container>
+typename Container::value_type minimum(const Container& xs)
+{
+    return minimum_by(is_less<typename Container::value_type>, xs);
+}
+
+// API search type: minimum_maybe : [a] -> Maybe a
+// fwd bind count: 0
+// Return the first minimum element if sequence is not empty
+// if sequence is not empty.
+// minimum_maybe([3, 1, 4, 2]) == Just 1
+// minimum_maybe([]) == Nothing
+template <typename Container>
+maybe<typename Container::value_type> minimum_maybe(const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minimum(xs);
+}
+
+// API search type: maximum : [a] -> a
+// fwd bind count: 0
+// Return the first maximum element.
+// maximum([3, 1, 4, 2]) == 4
+// Unsafe! Crashes on an empty sequence.
+template <typename Container>
+typename Container::value_type maximum(const Container& xs)
+{
+    return maximum_by(is_less<typename Container::value_type>, xs);
+}
+
+// API search type: maximum_maybe : [a] -> Maybe a
+// fwd bind count: 0
+// Return the first maximum element if sequence is not empty
+// if sequence is not empty.
+// maximum_maybe([3, 1, 4, 2]) == Just 4
+// maximum_maybe([]) == Nothing
+template <typename Container>
+maybe<typename Container::value_type> maximum_maybe(const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return maximum(xs);
+}
+
+// API search type: minimum_on : ((a -> b), [a]) -> a
+// fwd bind count: 1
+// Return the first minimum element using a transformer.
+// minimum_on(length, ["123", "12", "1234", "123"]) -> "12"
+// Unsafe! Crashes on an empty sequence.
+template <typename F, typename Container>
+typename Container::value_type minimum_on(F f, const Container& xs)
+{
+    internal::trigger_static_asserts<internal::unary_function_tag, F, typename Container::value_type>();
+    return elem_at_idx(minimum_idx_on(f, xs), xs);
+}
+
+// API search type: minimum_on_maybe : ((a -> b), [a]) -> Maybe a
+// fwd bind count: 1
+// Return the first minimum element using a transformer
+// if sequence is not empty.
+// minimum_on_maybe(length, ["123", "12", "1234", "123"]) -> Just "12"
+// minimum_on_maybe(length, []) -> Nothing
+template <typename F, typename Container>
+maybe<typename Container::value_type> minimum_on_maybe(
+    F f, const Container& xs)
+{
+    if (is_empty(xs))
+        return {};
+    else
+        return minimum_on(f, xs);
+}
+
+// API search type: maximum_on : ((a -> b), [a]) -> a
+// fwd bind count: 1
+// Return the first maximum element using a transformer.
+// maximum_on(length, ["123", "12", "1234", "123"]) == "1234"
+// Unsafe! Crashes on an empty sequence.
+template <typename F, typename Container>
+typename Container::value_type maximum_on(F f, const Container& xs)
+{
+    internal::trigger_static_asserts<internal::unary_function_tag, F, typename Container::value_type>();
+    return elem_at_idx(maximum_idx_on(f, xs), xs);
+}
+
+// API search type: maximum_on_maybe : ((a -> b), [a]) -> Maybe a
+// fwd bind count: 1
+// Return the first maximum element using a transformer
+// if sequence is not empty.
+// maximum_on_maybe(length, ["123", "12", "1234", "123"]) == Just "1234"
+// maximum_on_maybe(length, ["123", "12", "1234", "123"]) == Nothing
+template <typename F, typename Container>
+maybe<typename Container::value_type> maximum_on_maybe(
+    F f, const Container& xs)
 {
-    return find_all_idxs_by(is_equal_to(x), xs);
+    if (is_empty(xs))
+        return {};
+    else
+        return maximum_on(f, xs);
 }
 
-// API search type: find_all_instances_of_token : ([a], [a]) -> [Int]
-// fwd bind count: 1
-// Returns the starting indices of all segments matching token.
-// find_all_instances_of_token("haha", "oh, hahaha!") == [4, 6]
-template <typename ContainerOut = std::vector<std::size_t>, typename Container>
-ContainerOut find_all_instances_of_token(const Container& token,
-    const Container& xs)
+// API search type: mean : [a] -> a
+// fwd bind count: 0
+// mean([1, 4, 4]) == 3
+// Also known as average.
+// xs must have at least one element.
+// Use mean_using_doubles if overflow errors for sum(xs) can occur.
+// Unsafe! Crashes on an empty sequence.
+template <typename Result, typename Container>
+Result mean(const Container& xs)
 {
-    if (size_of_cont(token) > size_of_cont(xs))
-        return ContainerOut();
+    assert(size_of_cont(xs) != 0);
+    typedef typename Container::value_type T;
+    return static_cast<Result>(sum(xs) / static_cast<T>(size_of_cont(xs)));
+}
 
-    auto itInBegin = std::begin(xs);
-    auto itInEnd = itInBegin;
-    internal::advance_iterator(itInEnd, size_of_cont(token));
-    std::size_t idx = 0;
-    ContainerOut result;
-    auto outIt = internal::get_back_inserter(result);
-    std::size_t last_possible_idx = size_of_cont(xs) - size_of_cont(token);
-    auto check_and_push = [&]() {
-        if (std::equal(itInBegin, itInEnd, std::begin(token))) {
-            *outIt = idx;
-        }
-    };
-    while (idx != last_possible_idx) {
-        check_and_push();
-        ++itInBegin;
-        ++itInEnd;
-        ++idx;
-    }
-    check_and_push();
-    return result;
+// API search type: mean_obj_div_size_t : [a] -> a
+// fwd bind count: 0
+// mean_obj_div_size_t([B 1, B 4, B 4]) == B 3
+// The provided objects must support division by a std::size_t.
+// Unsafe! Crashes on an empty sequence.
+// Also Make sure sum(xs) does not overflow.
+template <typename Container,
+    typename T = typename Container::value_type>
+T mean_obj_div_size_t(const Container& xs)
+{
+    assert(size_of_cont(xs) != 0);
+    return sum(xs) / size_of_cont(xs);
 }
 
-// API search type: find_all_instances_of_token_non_overlapping : ([a], [a]) -> [Int]
-// fwd bind count: 1
-// Returns the starting indices
-// of all non-overlapping segments matching token.
-// find_all_instances_of_token_non_overlapping("haha", "oh, hahaha!") == [4]
-template <typename ContainerOut = std::vector<std::size_t>, typename Container>
-ContainerOut find_all_instances_of_token_non_overlapping(const Container& token, const Container& xs)
+// API search type: mean_obj_div_double : [a] -> a
+// fwd bind count: 0
+// mean_obj_div_double([B 1, B 4, B 4]) == B 3
+// The provided objects must support division by a double.
+// Unsafe! Crashes on an empty sequence.
+// Also Make sure sum(xs) does not overflow.
+template <typename Container,
+    typename T = typename Container::value_type>
+T mean_obj_div_double(const Container& xs)
 {
-    auto overlapping_instances = find_all_instances_of_token<ContainerOut>(
-        token, xs);
-    ContainerOut result;
-    auto outIt = internal::get_back_inserter(result);
-    std::size_t token_size = size_of_cont(token);
-    for (const auto idx : overlapping_instances) {
-        if (result.empty() || result.back() + token_size <= idx) {
-            *outIt = idx;
-        }
-    }
-    return result;
+    assert(size_of_cont(xs) != 0);
+    return sum(xs) / static_cast<double>(size_of_cont(xs));
 }
 
-// API search type: find_first_instance_of_token : ([a], [a]) -> Maybe Int
-// fwd bind count: 1
-// Returns the index of the first segment matching token.
-// find_first_instance_of_token("haha", "oh, hahaha!") == just 4
-template <typename Container>
-maybe<std::size_t> find_first_instance_of_token(const Container& token, const Container& xs)
+// API search type: mean_using_doubles : [a] -> a
+// fwd bind count: 0
+// mean_using_doubles([1, 4, 4]) == 3
+// Converts elements to double before calculating the sum
+// to prevent overflows.
+// Unsafe! Crashes on an empty sequence.
+template <typename Result, typename Container>
+Result mean_using_doubles(const Container& xs)
 {
-    if (size_of_cont(token) > size_of_cont(xs))
-        return nothing<std::size_t>();
+    assert(size_of_cont(xs) != 0);
+    auto xs_as_doubles = convert_elems<double>(xs);
+    auto result_as_double = mean<double>(xs_as_doubles);
+    if (!std::is_integral<Result>::value)
+        return static_cast<Result>(result_as_double);
+    else
+        return round<double, Result>(result_as_double);
+}
 
-    auto itInBegin = std::begin(xs);
-    auto itInEnd = itInBegin;
-    internal::advance_iterator(itInEnd, size_of_cont(token));
-    std::size_t idx = 0;
-    std::size_t last_possible_idx = size_of_cont(xs) - size_of_cont(token);
-    while (idx != last_possible_idx) {
-        if (std::equal(itInBegin, itInEnd, std::begin(token))) {
-            return just(idx);
+namespace internal {
+
+    // Partially sorts ys[lo, hi) such that every ys[idx]
+    // for idx in [first, last) is the element a full sort would put there.
+    // The indices must be sorted, unique and within [lo, hi).
+    // Every std::nth_element call halves the remaining indices,
+    // so this costs O(n * log(number of indices)).
+    template <typename T>
+    void nth_elements(std::vector<T>& ys, std::size_t lo, std::size_t hi,
+        const std::size_t* first, const std::size_t* last)
+    {
+        while (first != last) {
+            const std::size_t* mid = first + (last - first) / 2;
+            const auto it_begin = std::begin(ys);
+            std::nth_element(
+                add_to_iterator(it_begin, lo),
+                add_to_iterator(it_begin, *mid),
+                add_to_iterator(it_begin, hi));
+            nth_elements(ys, lo, *mid, first, mid);
+            lo = *mid + 1;
+            first = mid + 1;
         }
-        ++itInBegin;
-        ++itInEnd;
-        ++idx;
-    }
-    if (std::equal(itInBegin, itInEnd, std::begin(token))) {
-        return just(idx);
     }
-    return nothing<std::size_t>();
-}
 
-} // namespace fplus
+    template <typename T>
+    void nth_elements(std::vector<T>& ys, std::vector<std::size_t> idxs)
+    {
+        std::sort(std::begin(idxs), std::end(idxs));
+        idxs.erase(std::unique(std::begin(idxs), std::end(idxs)), std::end(idxs));
+        nth_elements(ys, 0, ys.size(), idxs.data(), idxs.data() + idxs.size());
+    }
 
-//
-// sets.hpp
-//
+    template <typename Container>
+    std::vector<typename Container::value_type> as_vector(const Container& xs)
+    {
+        return std::vector<typename Container::value_type>(std::begin(xs), std::end(xs));
+    }
 
-// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
-// https://github.com/Dobiasd/FunctionalPlus
-// Distributed under the Boost Software License, Version 1.0.
-// (See accompanying file LICENSE_1_0.txt or copy at
-//  http://www.boost.org/LICENSE_1_0.txt)
+    template <typename Result>
+    Result from_double(std::true_type /* is_integral */, double x)
+    {
+        return round<double, Result>(x);
+    }
 
+    template <typename Result>
+    Result from_double(std::false_type /* is_integral */, double x)
+    {
+        return static_cast<Result>(x);
+    }
+}
 
+// API search type: median : [a] -> a
+// fwd bind count: 0
+// median([5, 6, 4, 3, 2, 6, 7, 9, 3]) == 5
+// O(n), using selection instead of sorting.
+// Unsafe! Crashes on an empty sequence.
+template <typename Container,
+    typename Result = typename Container::value_type>
+Result median(const Container& xs)
+{
+    assert(is_not_empty(xs));
 
-#include <algorithm>
-#include <set>
-#include <unordered_set>
+    if (size_of_cont(xs) == 1)
+        return static_cast<Result>(*std::begin(xs));
 
-namespace fplus {
+    auto ys = internal::as_vector(xs);
+    const auto mid = internal::add_to_iterator(std::begin(ys), ys.size() / 2);
+    std::nth_element(std::begin(ys), mid, std::end(ys));
+    if (is_odd(ys.size())) {
+        return static_cast<Result>(*mid);
+    } else {
+        const auto lower = std::max_element(std::begin(ys), mid);
+        return static_cast<Result>(*lower + *mid) / static_cast<Result>(2);
+    }
+}
 
-// API search type: set_includes : (Set a, Set a) -> Bool
+// API search type: quantiles : ([Float], [a]) -> [a]
 // fwd bind count: 1
-// Checks if every element of the second set is also present in the first set.
-// Also known as is_subset_of.
-template <typename SetType>
-bool set_includes(const SetType& set1, const SetType& set2)
+// Returns the values below which the given fractions of the elements lie.
+// Interpolates linearly between the two closest ranks,
+// rounding the result for integral types.
+// Fractions outside of [0, 1] are clamped.
+// quantiles([0, 0.5, 0.9, 1], [1.0, 3.0, 2.0, 4.0, 5.0]) == [1.0, 3.0, 4.6, 5.0]
+// quantiles([0, 0.5, 0.9, 1], [1, 3, 2, 4, 5]) == [1, 3, 5, 5]
+// O(n * log(number of fractions)), all fractions share one selection.
+// Unsafe! Crashes on an empty sequence.
+template <typename ContainerPs, typename Container,
+    typename Result = typename Container::value_type>
+std::vector<Result> quantiles(const ContainerPs& ps, const Container& xs)
 {
-    return std::includes(std::begin(set1), std::end(set1),
-        std::begin(set2), std::end(set2));
+    assert(is_not_empty(xs));
+    auto ys = internal::as_vector(xs);
+    const std::size_t last_idx = ys.size() - 1;
+    std::vector<double> positions;
+    std::vector<std::size_t> idxs;
+    for (const auto& p : ps) {
+        const double clamped = std::min(std::max(static_cast<double>(p), 0.0), 1.0);
+        const double position = clamped * static_cast<double>(last_idx);
+        const std::size_t lower = floor<double, std::size_t>(position);
+        positions.push_back(position);
+        idxs.push_back(lower);
+        idxs.push_back(std::min(lower + 1, last_idx));
+    }
+    internal::nth_elements(ys, idxs);
+
+    std::vector<Result> result;
+    result.reserve(positions.size());
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        const double lower = static_cast<double>(ys[idxs[2 * i]]);
+        const double upper = static_cast<double>(ys[idxs[2 * i + 1]]);
+        const double fraction = positions[i] - static_cast<double>(idxs[2 * i]);
+        const double value = lower + fraction * (upper - lower);
+        result.push_back(internal::from_double<Result>(std::is_integral<Result>(), value));
+    }
+    return result;
 }
 
-// API search type: unordered_set_includes : (Unordered_Set a, Unordered_Set a) -> Bool
+// API search type: all_unique_by_less : (((a, a) -> Bool), [a]) -> Bool
 // fwd bind count: 1
-// Checks if every element of the second unordered_set
-// is also present in the first unordered_set.
-// Also known as is_subset_of.
-template <typename UnorderSetType>
-bool unordered_set_includes(const UnorderSetType& set1,
-    const UnorderSetType& set2)
+// Returns true for empty containers.
+// O(n*log(n))
+template <typename Container, typename Compare>
+bool all_unique_by_less(Compare comp, const Container& xs)
 {
-    auto first_not_included = std::find_if(set2.begin(), set2.end(),
-        [&](const typename UnorderSetType::value_type& x)
-            -> bool { return set1.find(x) == set1.end(); });
-    return first_not_included == set2.end();
+    internal::check_compare_for_container<Compare, Container>();
+    if (size_of_cont(xs) < 2)
+        return true;
+    return size_of_cont(unique(sort_by(comp, xs))) == size_of_cont(xs);
 }
 
-// API search type: set_merge : (Set a, Set a) -> Set a
-// fwd bind count: 1
-// Returns the union of two given sets.
-template <typename SetType>
-SetType set_merge(const SetType& set1, const SetType& set2)
+// API search type: all_unique_less : [a] -> Bool
+// fwd bind count: 0
+// Returns true for empty containers.
+// O(n*log(n))
+template <typename Container>
+bool all_unique_less(const Container& xs)
 {
-    SetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::merge(std::begin(set1), std::end(set1),
-        std::begin(set2), std::end(set2),
-        itOut);
-    return result;
+    typedef typename Container::value_type T;
+    auto comp = std::less<T>();
+    return all_unique_by_less(comp, xs);
 }
 
-// API search type: unordered_set_merge : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// API search type: is_infix_of : ([a], [a]) -> Bool
 // fwd bind count: 1
-// Returns the union of two given unordered sets.
-template <typename UnorderSetType>
-UnorderSetType unordered_set_merge(const UnorderSetType& set1, const UnorderSetType& set2)
+// is_infix_of("ion", "FunctionalPlus") == true
+template <typename Container>
+bool is_infix_of(const Container& token, const Container& xs)
 {
-    UnorderSetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::copy(std::begin(set1), std::end(set1), itOut);
-    std::copy(std::begin(set2), std::end(set2), itOut);
-    return result;
+    return is_just(find_first_instance_of_token(token, xs));
 }
 
-// API search type: set_intersection : (Set a, Set a) -> Set a
+// API search type: is_subsequence_of : ([a], [a]) -> Bool
 // fwd bind count: 1
-// Returns the intersection of both sets.
-template <typename SetType>
-SetType set_intersection(const SetType& set1, const SetType& set2)
+// is_subsequence_of("Final", "FunctionalPlus") == true
+template <typename Container>
+bool is_subsequence_of(const Container& seq, const Container& xs)
 {
-    SetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::set_intersection(std::begin(set1), std::end(set1),
-        std::begin(set2), std::end(set2),
-        itOut);
-    return result;
+    if (is_empty(seq))
+        return true;
+    if (size_of_cont(seq) > size_of_cont(xs))
+        return false;
+    typedef typename Container::value_type T;
+    auto remaining = convert_container_and_elems<std::list<T>>(seq);
+    for (const auto& x : xs) {
+        if (x == remaining.front()) {
+            remaining.pop_front();
+            if (is_empty(remaining))
+                return true;
+        }
+    }
+    return false;
 }
 
-// API search type: unordered_set_intersection : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// API search type: count_if : ((a -> Bool), [a]) -> Int
 // fwd bind count: 1
-// Returns the intersection of both unordered_sets.
-template <typename UnorderSetType>
-UnorderSetType unordered_set_intersection(
-    const UnorderSetType& set1, const UnorderSetType& set2)
+// count_if(is_even, [1, 2, 3, 5, 7, 8]) == 2
+template <typename UnaryPredicate, typename Container>
+std::size_t count_if(UnaryPredicate p, const Container& xs)
 {
-    UnorderSetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::copy_if(std::begin(set2), std::end(set2),
-        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set1.find(x) != set1.end(); });
-    return result;
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return size_of_cont(find_all_idxs_by(p, xs));
 }
 
-// API search type: set_is_disjoint : (Set a, Set a) -> Bool
+// API search type: count : (a, [a]) -> Int
 // fwd bind count: 1
-// Checks if two sets are disjoint.
-template <typename SetType>
-bool set_is_disjoint(const SetType& set1, const SetType& set2)
+// count(2, [1, 2, 3, 5, 7, 2, 2]) == 3
+template <typename Container>
+std::size_t count(const typename Container::value_type& x, const Container& xs)
 {
-    return set_intersection(set1, set2).empty();
+    return size_of_cont(find_all_idxs_of(x, xs));
 }
 
-// API search type: unordered_set_is_disjoint : (Unordered_Set a, Unordered_Set a) -> Bool
+// API search type: is_unique_in_by : ((a -> bool), [a]) -> Bool
 // fwd bind count: 1
-// Checks if two unordered_sets are disjoint.
-template <typename UnorderSetType>
-bool unordered_set_is_disjoint(
-    const UnorderSetType& set1, const UnorderSetType& set2)
+// is_unique_in_by((==2), [1, 2, 3, 5, 7, 2, 2]) == false
+// is_unique_in_by((==5), [1, 2, 3, 5, 7, 2, 2]) == true
+template <typename UnaryPredicate, typename Container>
+bool is_unique_in_by(UnaryPredicate pred, const Container& xs)
 {
-    return unordered_set_intersection(set1, set2).empty();
+    std::size_t count = 0;
+    for (const auto& x : xs) {
+        if (internal::invoke(pred, x)) {
+            ++count;
+            if (count > 1) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
-// API search type: set_difference : (Set a, Set a) -> Set a
+// API search type: is_unique_in : (a, [a]) -> Bool
 // fwd bind count: 1
-// Returns the elements in set1 that are not present in set2.
-template <typename SetType>
-SetType set_difference(const SetType& set1, const SetType& set2)
+// is_unique_in(2, [1, 2, 3, 5, 7, 2, 2]) == false
+// is_unique_in(5, [1, 2, 3, 5, 7, 2, 2]) == true
+template <typename Container>
+bool is_unique_in(const typename Container::value_type& x, const Container& xs)
 {
-    SetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::set_difference(std::begin(set1), std::end(set1),
-        std::begin(set2), std::end(set2),
-        itOut);
-    return result;
+    return is_unique_in_by(is_equal_to(x), xs);
 }
 
-// API search type: unordered_set_difference : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// API search type: is_permutation_of : ([a], [a]) -> Bool
 // fwd bind count: 1
-// Returns the elements in unordered_set1
-// that are not present in unordered_set2.
-template <typename UnorderSetType>
-UnorderSetType unordered_set_difference(const UnorderSetType& set1,
-    const UnorderSetType& set2)
+// Checks if one container is a permuation of the other one.
+// is_permutation_of([2,3,1], [1,2,3]) == true
+// O(log(n))
+template <typename Container>
+bool is_permutation_of(const Container& xs, const Container& ys)
 {
-    UnorderSetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::copy_if(std::begin(set1), std::end(set1),
-        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set2.find(x) == set2.end(); });
-    return result;
+    return size_of_cont(xs) == size_of_cont(ys) && sort(xs) == sort(ys);
 }
 
-// API search type: set_symmetric_difference : (Set a, Set a) -> Set a
+// API search type: fill_pigeonholes_to : (Int, [Int]) -> [Int]
 // fwd bind count: 1
-// Returns the symmetric difference of both sets.
-template <typename SetType>
-SetType set_symmetric_difference(const SetType& set1, const SetType& set2)
+// Returns a list containing the count for every element in xs
+// with the value corresponding to the index in the result list.
+// fill_pigeonholes_to(5, [0,1,3,1]) == [1,2,0,1,0]
+// fill_pigeonholes_to(3, [0,1,3,1]) == [1,2,0]
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<std::size_t>,
+    typename T = typename ContainerIn::value_type>
+ContainerOut fill_pigeonholes_to(std::size_t idx_end, const ContainerIn& xs)
 {
-    SetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::set_symmetric_difference(std::begin(set1), std::end(set1),
-        std::begin(set2), std::end(set2),
-        itOut);
+    static_assert(std::is_integral<T>::value,
+        "Type must be integral.");
+
+    if (is_empty(xs))
+        return {};
+
+    ContainerOut result(idx_end, 0);
+    for (const auto& x : xs) {
+        if (x >= 0) {
+            const auto idx = static_cast<std::size_t>(x);
+            if (idx < result.size()) {
+                ++result[idx];
+            }
+        }
+    }
     return result;
 }
 
-// API search type: unordered_set_symmetric_difference : (Unordered_Set a, Unordered_Set a) -> Unordered_Set a
+// API search type: fill_pigeonholes : [Int] -> [Int]
+// fwd bind count: 0
+// Returns a list containing the count for every element in xs
+// with the value corresponding to the index in the result list.
+// fill_pigeonholes([0,1,3,1]) == [1,2,0,1]
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<std::size_t>,
+    typename T = typename ContainerIn::value_type>
+ContainerOut fill_pigeonholes(const ContainerIn& xs)
+{
+    static_assert(std::is_integral<T>::value,
+        "Type must be integral.");
+
+    if (is_empty(xs))
+        return {};
+
+    return (fill_pigeonholes_to<ContainerIn, ContainerOut>(
+        maximum(xs) + 1, xs));
+}
+
+// API search type: fill_pigeonholes_bool_to : (Int, [Int]) -> [Int]
 // fwd bind count: 1
-// Returns the symmetric difference of both unordered_sets.
-template <typename UnorderSetType>
-UnorderSetType unordered_set_symmetric_difference(
-    const UnorderSetType& set1, const UnorderSetType& set2)
+// Returns a list telling if the element corresponding to the index
+// is present in xs.
+// fill_pigeonholes_bool_to(5, [0,1,3,1]) == [1,1,0,1,0]
+// fill_pigeonholes_bool_to(3, [0,1,3,1]) == [1,1,0]
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<std::uint8_t>,
+    typename T = typename ContainerIn::value_type>
+ContainerOut fill_pigeonholes_bool_to(std::size_t idx_end, const ContainerIn& xs)
 {
-    UnorderSetType result;
-    auto itOut = internal::get_back_inserter(result);
-    std::copy_if(std::begin(set1), std::end(set1),
-        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set2.find(x) == set2.end(); });
-    std::copy_if(std::begin(set2), std::end(set2),
-        itOut, [&](const typename UnorderSetType::value_type& x) -> bool { return set1.find(x) == set1.end(); });
+    static_assert(std::is_integral<T>::value,
+        "Type must be integral.");
+
+    if (is_empty(xs))
+        return {};
+
+    ContainerOut result(idx_end, 0);
+    for (const auto& x : xs) {
+        if (x >= 0) {
+            const auto idx = static_cast<std::size_t>(x);
+            if (idx < result.size()) {
+                result[idx] = 1;
+            }
+        }
+    }
     return result;
 }
 
-// API search type: sets_intersection : [Set a] -> Set a
+// API search type: fill_pigeonholes_bool : [Int] -> [Int]
 // fwd bind count: 0
-// Returns the intersection of the given sets.
-// Also known as intersect_many.
-// For performance try to sort the inputs sets prior, ascendending by size.
+// Returns a list telling if the element corresponding to the index
+// is present in xs.
+// fill_pigeonholes_bool([0,1,3,1]) == [1,2,0,1]
 template <typename ContainerIn,
-    typename SetType = typename ContainerIn::value_type>
-SetType sets_intersection(const ContainerIn& sets)
+    typename ContainerOut = std::vector<std::uint8_t>,
+    typename T = typename ContainerIn::value_type>
+ContainerOut fill_pigeonholes_bool(const ContainerIn& xs)
 {
-    return fold_left_1(set_intersection<SetType>, sets);
+    static_assert(std::is_integral<T>::value,
+        "Type must be integral.");
+
+    if (is_empty(xs))
+        return {};
+
+    return (fill_pigeonholes_bool_to<ContainerIn, ContainerOut>(
+        maximum(xs) + 1, xs));
 }
 
-// API search type: unordered_sets_intersection : [Unordered_Set a] -> Unordered_Set a
+// API search type: present_in_all : [[a]] -> [a]
 // fwd bind count: 0
-// Returns the intersection of the given unordered_sets.
-// Also known as intersect_many.
+// Returns a list containing only the elements present in all sublists of xs.
+// Also known as gemstones.
+// present_in_all([[4,1,2], [5,2,1], [2,4,1]]) == [1,2]
 template <typename ContainerIn,
-    typename UnordSetType = typename ContainerIn::value_type>
-UnordSetType unordered_sets_intersection(const ContainerIn& sets)
+    typename SubContainerIn = typename ContainerIn::value_type,
+    typename T = typename SubContainerIn::value_type,
+    typename ContainerOut = std::vector<T>>
+ContainerOut present_in_all(const ContainerIn& xs)
 {
-    return fold_left_1(unordered_set_intersection<UnordSetType>, sets);
+    return convert_container<ContainerOut>(
+        fplus::sets_intersection(
+            transform(
+                convert_container<std::set<T>, SubContainerIn>,
+                xs)));
 }
 
 } // namespace fplus
 
 
-#include <algorithm>
-#include <cstdint>
-#include <numeric>
-#include <type_traits>
+#include <map>
+#include <unordered_map>
 
 namespace fplus {
 
-// API search type: any_by : ((a -> Bool), [a]) -> Bool
-// fwd bind count: 1
-// Check if all elements in a container fulfill a predicate.
-// any_by(is_odd, [2, 4, 6]) == false
-template <typename UnaryPredicate, typename Container>
-bool any_by(UnaryPredicate p, const Container& xs)
+// API search type: pairs_to_map : [(key, val)] -> Map key val
+// fwd bind count: 0
+// Converts a Container of pairs (key, value) into a dictionary.
+template <typename MapOut, typename ContainerIn>
+MapOut pairs_to_map(const ContainerIn& pairs)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    return std::any_of(std::begin(xs), std::end(xs), p);
+    return convert_container_and_elems<MapOut>(pairs);
 }
 
-// API search type: any : [Bool] -> Bool
+// API search type: pairs_to_map_grouped : [(key, val)] -> Map key [val]
 // fwd bind count: 0
-// Checks if all elements in a container are true.
-// any([false, true, false]) == true
-template <typename Container>
-bool any(const Container& xs)
+// Convert a list of key-value pairs to a dictionary
+// while pushing values having the same key into a vector.
+// pairs_to_map_grouped([("a", 1), ("a", 2), ("b", 6), ("a", 4)])
+//     -> {"a": [1, 2, 4], "b": [6]}
+template <typename ContainerIn,
+    typename Key = typename ContainerIn::value_type::first_type,
+    typename SingleValue = typename ContainerIn::value_type::second_type,
+    typename MapOut = std::map<Key, std::vector<SingleValue>>>
+MapOut pairs_to_map_grouped(const ContainerIn& pairs)
 {
-    typedef typename Container::value_type T;
-    return any_by(identity<T>, xs);
+    MapOut result;
+    for (const auto& p : pairs) {
+        result[p.first].push_back(p.second);
+    }
+    return result;
 }
 
-// API search type: none_by : ((a -> Bool), [a]) -> Bool
-// fwd bind count: 1
-// Check no element in a container fulfills a predicate.
-// none_by(is_even, [3, 4, 5]) == false
-template <typename UnaryPredicate, typename Container>
-bool none_by(UnaryPredicate p, const Container& xs)
+// API search type: pairs_to_unordered_map_grouped : [(key, val)] -> Map key [val]
+// fwd bind count: 0
+// Convert a list of key-value pairs to a dictionary
+// while pushing values having the same key into a vector.
+// pairs_to_unordered_map_grouped([("a", 1), ("a", 2), ("b", 6), ("a", 4)])
+//     -> {"a": [1, 2, 4], "b": [6]}
+template <typename ContainerIn,
+    typename Key = typename ContainerIn::value_type::first_type,
+    typename SingleValue = typename ContainerIn::value_type::second_type,
+    typename MapOut = std::unordered_map<Key, std::vector<SingleValue>>>
+MapOut pairs_to_unordered_map_grouped(const ContainerIn& pairs)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    return std::none_of(std::begin(xs), std::end(xs), p);
+    MapOut result;
+    for (const auto& p : pairs) {
+        result[p.first].push_back(p.second);
+    }
+    return result;
 }
 
-// API search type: none : [Bool] -> Bool
+// API search type: map_to_pairs : Map key val -> [(key, val)]
 // fwd bind count: 0
-// Checks if all elements in a container are false.
-// none([false, true, false]) == false
-template <typename Container>
-bool none(const Container& xs)
+// Converts a dictionary into a Container of pairs (key, value).
+template <typename MapType,
+    typename MapPair = typename MapType::value_type,
+    typename Key = typename std::remove_const<typename MapPair::first_type>::type,
+    typename Val = typename std::remove_const<typename MapPair::second_type>::type,
+    typename OutPair = std::pair<Key, Val>,
+    typename ContainerOut = std::vector<OutPair>>
+ContainerOut map_to_pairs(const MapType& dict)
 {
-    typedef typename Container::value_type T;
-    return none_by(identity<T>, xs);
+    return convert_container_and_elems<ContainerOut>(dict);
 }
 
-// API search type: minimum_idx_by : (((a, a) -> Bool), [a]) -> Int
+// API search type: transform_map_values : ((old_val -> new_val), Map key old_val) -> Map key new_val
 // fwd bind count: 1
-// Return the index of the first minimum element using a less comparator.
-// minimum_idx_by(lessLength, ["123", "12", "1234", "123"]) -> "1"
-// Unsafe! Crashes on an empty sequence.
-template <typename Compare, typename Container>
-typename std::size_t minimum_idx_by(Compare comp,
-    const Container& xs)
+// Manipulate the values in a dictionary, keeping the key-value relationship.
+// transform_map_values((*2), {0: 2, 1: 3}) == {0: 4, 1: 6}
+template <typename F, typename MapIn>
+auto transform_map_values(F f, const MapIn& map)
 {
-    internal::check_compare_for_container<Compare, Container>();
-    assert(is_not_empty(xs));
-    return static_cast<std::size_t>(std::distance(std::begin(xs),
-        std::min_element(std::begin(xs), std::end(xs), comp)));
-}
+    using MapInPair = typename MapIn::value_type;
+    using Key = std::remove_const_t<typename MapInPair::first_type>;
+    using InVal = std::remove_const_t<typename MapInPair::second_type>;
+    using OutVal = std::decay_t<internal::invoke_result_t<F, InVal>>;
+    using MapOut = typename internal::SameMapTypeNewTypes<MapIn, Key, OutVal>::type;
 
-// API search type: minimum_idx_by_maybe : (((a, a) -> Bool), [a]) -> Int
-// fwd bind count: 1
-// Return the index of the first minimum element using a less comparator
-// if sequence is not empty.
-// minimum_idx_by_maybe(lessLength, ["123", "12", "1234", "123"]) -> Just "1"
-// minimum_idx_by_maybe(lessLength, []) -> Nothing
-template <typename Compare, typename Container>
-maybe<typename std::size_t> minimum_idx_by_maybe(Compare comp,
-    const Container& xs)
-{
-    if (is_empty(xs))
-        return {};
-    else
-        return minimum_idx_by(comp, xs);
+    return pairs_to_map<MapOut>(
+        transform(
+            bind_1st_of_2(transform_snd<Key, InVal, F>, f),
+            map_to_pairs(map)));
 }
 
-// API search type: maximum_idx_by : (((a, a) -> Bool), [a]) -> Int
-// fwd bind count: 1
-// Return the index of the first maximum element using a less comparator.
-// maximum_idx_by(lessLength, ["123", "12", "1234", "123"]) == "2"
-// Unsafe! Crashes on an empty sequence.
-template <typename Compare, typename Container>
-typename std::size_t maximum_idx_by(Compare comp,
-    const Container& xs)
+// API search type: map_union_with : (((val, val) -> val), Map key val, Map key val) -> Map key val
+// fwd bind count: 2
+// Combine two dictionaries using a binary function for the values.
+// map_union_with((++), {0: a, 1: b}, {0: c, 2: d}) == {0: ac, 1: b, 2: d}
+template <typename F, typename MapIn>
+auto map_union_with(F f, const MapIn& dict1, const MapIn& dict2)
 {
-    internal::check_compare_for_container<Compare, Container>();
-    assert(is_not_empty(xs));
-    return static_cast<std::size_t>(std::distance(std::begin(xs),
-        std::max_element(std::begin(xs), std::end(xs), comp)));
+    const auto both = append(map_to_pairs(dict1), map_to_pairs(dict2));
+    using Key = typename decltype(both)::value_type::first_type;
+    using SingleValue = typename decltype(both)::value_type::second_type;
+    auto full_map = pairs_to_map_grouped<decltype(both), Key, SingleValue,
+        typename internal::SameMapTypeNewTypes<MapIn, Key, std::vector<SingleValue>>::type>(both);
+    const auto group_f = [f](const auto& vals) {
+        return fold_left_1(f, vals);
+    };
+    return transform_map_values(group_f, full_map);
 }
 
-// API search type: maximum_idx_by_maybe : (((a, a) -> Bool), [a]) -> Maybe Int
+// API search type: map_union : (Map key val, Map key val) -> Map key val
 // fwd bind count: 1
-// Return the index of the first maximum element using a less comparator
-// if sequence is not empty.
-// maximum_idx_by_maybe(lessLength, ["123", "12", "1234", "123"]) == Just "2"
-// maximum_idx_by_maybe(lessLength, []) == Nothing
-template <typename Compare, typename Container>
-maybe<typename std::size_t> maximum_idx_by_maybe(Compare comp,
-    const Container& xs)
+// Combine two dictionaries keeping the value of the first map
+// in case of key collisions.
+// map_union({0: a, 1: b}, {0: c, 2: d}) == {0: a, 1: b, 2: d}
+template <typename MapType>
+MapType map_union(const MapType& dict1, const MapType& dict2)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return maximum_idx_by(comp, xs);
-}
+    using Value = typename MapType::value_type::second_type;
 
-// API search type: minimum_idx : [a] -> Int
-// fwd bind count: 0
-// Return the index of the first minimum element.
-// minimum_idx([3, 1, 4, 2]) == 1
-// Unsafe! Crashes on an empty sequence.
-template <typename Container>
-typename std::size_t minimum_idx(const Container& xs)
-{
-    return minimum_idx_by(is_less<typename Container::value_type>, xs);
+    const auto get_first = [](const Value& a, const Value&) -> Value {
+        return a;
+    };
+    return map_union_with(get_first, dict1, dict2);
 }
 
-// API search type: minimum_idx_maybe : [a] -> Maybe Int
+// API search type: map_grouped_to_pairs : Map key [val] -> [(key, val)]
 // fwd bind count: 0
-// Return the index of the first minimum element if sequence is not empty.
-// minimum_idx_maybe([3, 1, 4, 2]) == Just 1
-// minimum_idx_maybe([]) == Nothing
-template <typename Container>
-maybe<typename std::size_t> minimum_idx_maybe(const Container& xs)
+// Convert a dictionary with sequence values to a list of key-value pairs.
+// Inverse operation of pairs_to_map_grouped.
+// map_grouped_to_pairs({"a": [1, 2, 4], "b": [6]})
+//     -> [("a", 1), ("a", 2), ("a", 4), ("b", 6)]
+template <typename MapType>
+auto map_grouped_to_pairs(const MapType& dict)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return minimum_idx(xs);
+    using Key = typename MapType::key_type;
+    using Group = typename MapType::mapped_type;
+
+    auto fn = [](const auto& pair) {
+        const auto f = zip_repeat<std::vector<Key>, Group>;
+        return apply_to_pair(f, transform_fst(singleton_seq<Key>, pair));
+    };
+    return concat(transform(fn, map_to_pairs(dict)));
 }
 
-// API search type: maximum_idx : [a] -> Int
+// API search type: get_map_keys : Map key val -> [key]
 // fwd bind count: 0
-// Return the index of the first maximum element.
-// maximum_idx([3, 1, 4, 2]) == 2
-// Unsafe! Crashes on an empty sequence.
-template <typename Container>
-typename std::size_t maximum_idx(const Container& xs)
+// Returns all keys used in a map.
+template <typename MapType,
+    typename ContainerOut = std::vector<typename std::remove_const<typename MapType::key_type>::type>>
+ContainerOut get_map_keys(const MapType& dict)
 {
-    return maximum_idx_by(is_less<typename Container::value_type>, xs);
+    auto pairs = map_to_pairs(dict);
+    typedef typename decltype(pairs)::value_type::first_type FirstType;
+    typedef typename decltype(pairs)::value_type::second_type SecondType;
+    return transform_convert<ContainerOut>(
+        fst<FirstType, SecondType>, map_to_pairs(dict));
 }
 
-// API search type: maximum_idx_maybe : [a] -> Maybe Int
+// API search type: get_map_values : Map key val -> [val]
 // fwd bind count: 0
-// Return the index of the first maximum element if sequence is not empty.
-// maximum_idx_maybe([3, 1, 4, 2]) == Just 2
-// maximum_imaximum_idx_maybedx([]) == Nothing
-template <typename Container>
-maybe<typename std::size_t> maximum_idx_maybe(const Container& xs)
+// Returns all values present in a map.
+template <typename MapType,
+    typename ContainerOut = std::vector<typename std::remove_const<typename MapType::mapped_type>::type>>
+ContainerOut get_map_values(const MapType& dict)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return maximum_idx(xs);
+    auto pairs = map_to_pairs(dict);
+    typedef typename decltype(pairs)::value_type::first_type FirstType;
+    typedef typename decltype(pairs)::value_type::second_type SecondType;
+    return transform_convert<ContainerOut>(
+        snd<FirstType, SecondType>, map_to_pairs(dict));
 }
 
-// API search type: minimum_idx_on : ((a -> b), [a]) -> Int
-// fwd bind count: 1
-// Return the index of the first minimum element using a transformer.
-// minimum_idx_on(length, ["123", "12", "1234", "123"]) -> "1"
-// Unsafe! Crashes on an empty sequence.
-template <typename F, typename Container>
-std::size_t minimum_idx_on(F f, const Container& xs)
+// API search type: swap_keys_and_values : Map a b -> Map b a
+// fwd bind count: 0
+// Swaps keys and Values of a dict:
+// swap_keys_and_values({1: "a", 2: "b"}) == {"a": 1, "b": 2}
+template <typename MapIn,
+    typename MapInPair = typename MapIn::value_type,
+    typename InKey = typename MapInPair::first_type,
+    typename InVal = typename MapInPair::second_type,
+    typename OutKey = InVal,
+    typename OutVal = typename std::remove_const<InKey>::type,
+    typename MapOut = typename internal::SameMapTypeNewTypes<MapIn, OutKey, OutVal>::type>
+MapOut swap_keys_and_values(const MapIn& dict)
 {
-    using Result = internal::invoke_result_t<F, typename Container::value_type>;
-    auto transformed = transform_convert<std::vector<std::decay_t<Result>>>(f, xs);
-    return minimum_idx(transformed);
+    auto inAsPairs = map_to_pairs(dict);
+    auto outAsPairs = transform(swap_pair_elems<InKey, InVal>, inAsPairs);
+    return pairs_to_map<MapOut>(outAsPairs);
 }
 
-// API search type: minimum_idx_on_maybe : ((a -> b), [a]) -> Just Int
+// API search type: create_map : ([key], [val]) -> Map key val
 // fwd bind count: 1
-// Return the index of the first minimum element using a transformer
-// if sequence is not empty.
-// minimum_idx_on_maybe(length, ["123", "12", "1234", "123"]) -> Just "1"
-// minimum_idx_on_maybe(length, []) -> Nothing"
-template <typename F, typename Container>
-maybe<typename std::size_t> minimum_idx_on_maybe(F f, const Container& xs)
+// Zip a sequence of keys with a sequence of values to obtain a dictionary.
+// create_map([1,2,3], ["one", "two"]) == {1: "one", 2: "two"}
+template <typename ContainerIn1, typename ContainerIn2,
+    typename Key = typename std::remove_const<typename ContainerIn1::value_type>::type,
+    typename Val = typename std::remove_const<typename ContainerIn2::value_type>::type,
+    typename MapOut = std::map<Key, Val>>
+MapOut create_map(const ContainerIn1& keys, const ContainerIn2& values)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return minimum_idx_on(f, xs);
+    auto pairs = zip(keys, values);
+    return pairs_to_map<MapOut>(pairs);
 }
 
-// API search type: maximum_idx_on : ((a -> b), [a]) -> Int
+// API search type: create_map_with : ((key -> val), [key]) -> Map key val
 // fwd bind count: 1
-// Return the index of the first maximum element using a transformer.
-// maximum_idx_on(length, ["123", "12", "1234", "123"]) == "2"
-// Unsafe! Crashes on an empty sequence.
-template <typename F, typename Container>
-std::size_t maximum_idx_on(F f, const Container& xs)
+// Take a list of keys and create a dictionary
+// generating the values by applying f to each key.
+// create_map_with(show, [1,2]) == {1: "1", 2: "2"}
+template <typename ContainerIn, typename F>
+auto create_map_with(F f, const ContainerIn& keys)
 {
-    using Result = internal::invoke_result_t<F, typename Container::value_type>;
-    auto transformed = transform_convert<std::vector<std::decay_t<Result>>>(f, xs);
-    return maximum_idx(transformed);
+    return create_map(keys, transform(f, keys));
 }
 
-// API search type: maximum_idx_on_maybe : ((a -> b), [a]) -> Maybe Int
+// API search type: create_map_grouped : ((val -> key), [val]) -> Map key val
 // fwd bind count: 1
-// Return the index of the first maximum element using a transformer
-// if sequence is not empty.
-// maximum_idx_on_maybe(length, ["123", "12", "1234", "123"]) == Just "2"
-// maximum_idx_on_maybe(length, []) == Nothing
-template <typename F, typename Container>
-maybe<typename std::size_t> maximum_idx_on_maybe(F f, const Container& xs)
+// Take a list of values and create a grouped dictionary
+// generating the keys by applying f to each key.
+// create_map_grouped(length, ["one", "three", "two"]) == {3: ["one", "two"], 5: ["three"]}
+// Also known as group_by
+template <typename ContainerIn, typename F>
+auto create_map_grouped(F f, const ContainerIn& values)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return maximum_idx_on(f, xs);
+    return pairs_to_map_grouped(zip(transform(f, values), values));
 }
 
-// API search type: minimum_by : (((a, a) -> Bool), [a]) -> a
+// API search type: create_unordered_map : ([key], [val]) -> Map key val
 // fwd bind count: 1
-// Return the first minimum element using a less comparator.
-// minimum_by(lessLength, ["123", "12", "1234", "123"]) -> "12"
-// Unsafe! Crashes on an empty sequence.
-template <typename Compare, typename Container>
-typename Container::value_type minimum_by(Compare comp,
-    const Container& xs)
+// Zip a sequence of keys with a sequence of values to obtain a dictionary.
+// create_unordered_map([1,2,3], ["one", "two"]) == {1: "one", 2: "two"}
+template <typename ContainerIn1, typename ContainerIn2,
+    typename Key = typename std::remove_const<typename ContainerIn1::value_type>::type,
+    typename Val = typename std::remove_const<typename ContainerIn2::value_type>::type,
+    typename MapOut = std::unordered_map<Key, Val>>
+MapOut create_unordered_map(
+    const ContainerIn1& keys,
+    const ContainerIn2& values)
 {
-    internal::check_compare_for_container<Compare, Container>();
-    assert(is_not_empty(xs));
-    return *std::min_element(std::begin(xs), std::end(xs), comp);
+    auto pairs = zip(keys, values);
+    return pairs_to_map<MapOut>(pairs);
 }
 
-// API search type: minimum_by_maybe : (((a, a) -> Bool), [a]) -> a
+// API search type: create_unordered_map_with : ((key -> val), [key]) -> Map key val
 // fwd bind count: 1
-// Return the first minimum element using a less comparator
-// if sequence is not empty.
-// minimum_by_maybe(lessLength, ["123", "12", "1234", "123"]) -> Just "12"
-// minimum_by_maybe(lessLength, []) -> Nothing
-template <typename Compare, typename Container>
-maybe<typename Container::value_type> minimum_by_maybe(Compare comp,
-    const Container& xs)
+// Take a list of keys and create a dictionary
+// generating the values by applying f to each key.
+// create_unordered_map_with(show, [1,2]) == {1: "1", 2: "2"}
+template <typename ContainerIn, typename F>
+auto create_unordered_map_with(F f, const ContainerIn& keys)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return minimum_by(comp, xs);
+    return create_unordered_map(keys, transform(f, keys));
 }
 
-// API search type: maximum_by : (((a, a) -> Bool), [a]) -> a
+// API search type: create_unordered_map_grouped : ((val -> key), [val]) -> Map key val
 // fwd bind count: 1
-// Return the first maximum element using a less comparator.
-// maximum_by(lessLength, ["123", "12", "1234", "123"]) == "1234"
-// Unsafe! Crashes on an empty sequence.
-template <typename Compare, typename Container>
-typename Container::value_type maximum_by(Compare comp,
-    const Container& xs)
+// Take a list of values and create a grouped dictionary
+// generating the keys by applying f to each key.
+// create_unordered_map_grouped(length, ["one", "three", "two"]) == {3: ["one", "two"], 5: ["three"]}
+// Also known as group_by
+template <typename ContainerIn, typename F>
+auto create_unordered_map_grouped(F f, const ContainerIn& values)
 {
-    internal::check_compare_for_container<Compare, Container>();
-    assert(is_not_empty(xs));
-    return *std::max_element(std::begin(xs), std::end(xs), comp);
+    return pairs_to_unordered_map_grouped(zip(transform(f, values), values));
 }
 
-// API search type: maximum_by_maybe : (((a, a) -> Bool), [a]) -> Maybe a
+// API search type: get_from_map : (Map key val, key) -> Maybe val
 // fwd bind count: 1
-// Return the first maximum element using a less comparator
-// if sequence is not empty.
-// maximum_by_maybe(lessLength, ["123", "12", "1234", "123"]) == Just "1234"
-// maximum_by_maybe(lessLength, []) == Nothing
-template <typename Compare, typename Container>
-maybe<typename Container::value_type> maximum_by_maybe(Compare comp,
-    const Container& xs)
+// Returns just the value of a key if key is present.
+// Otherwise returns nothing.
+template <typename MapType,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+maybe<Val> get_from_map(const MapType& map, const Key& key)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return maximum_by(comp, xs);
+    auto it = map.find(key);
+    if (it == std::end(map))
+        return nothing<Val>();
+    return just(it->second);
 }
 
-// API search type: minimum : [a] -> a
-// fwd bind count: 0
-// Return the first minimum element.
-// minimum([3, 1, 4, 2]) == 1
-// Unsafe! Crashes on an empty sequence.
-template <typename Container>
-typename Container::value_type minimum(const Container& xs)
+// API search type: get_from_map_unsafe : (Map key val, key) -> val
+// fwd bind count: 1
+// Returns the value of a key if key is present.
+// Crashes otherwise.
+template <typename MapType,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+Val get_from_map_unsafe(const MapType& map, const Key& key)
 {
-    return minimum_by(is_less<typename Container::value_type>, xs);
+    return unsafe_get_just(get_from_map(map, key));
 }
 
-// API search type: minimum_maybe : [a] -> Maybe a
-// fwd bind count: 0
-// Return the first minimum element if sequence is not empty
-// if sequence is not empty.
-// minimum_maybe([3, 1, 4, 2]) == Just 1
-// minimum_maybe([]) == Nothing
-template <typename Container>
-maybe<typename Container::value_type> minimum_maybe(const Container& xs)
+// API search type: get_from_map_with_def : (Map key val, val, key) -> val
+// fwd bind count: 2
+// Returns the value of a key if key is present.
+// Otherwise returns the provided default.
+// Also known as prop_or.
+template <typename MapType,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+Val get_from_map_with_def(const MapType& map, const Val& defVal,
+    const Key& key)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return minimum(xs);
+    return just_with_default(defVal, get_from_map(map, key));
 }
 
-// API search type: maximum : [a] -> a
-// fwd bind count: 0
-// Return the first maximum element.
-// maximum([3, 1, 4, 2]) == 4
-// Unsafe! Crashes on an empty sequence.
-template <typename Container>
-typename Container::value_type maximum(const Container& xs)
+// API search type: get_first_from_map : (Map key val, [key]) -> Maybe val
+// fwd bind count: 1
+// Returns just the value of the first key present.
+// Otherwise returns nothing.
+template <typename MapType,
+    typename KeysContainer,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+maybe<Val> get_first_from_map(const MapType& map, const KeysContainer& keys)
 {
-    return maximum_by(is_less<typename Container::value_type>, xs);
+    static_assert(std::is_same<typename KeysContainer::value_type, Key>::value,
+        "Key type does not match.");
+    for (const auto& key : keys) {
+        auto it = map.find(key);
+        if (it != std::end(map))
+            return just(it->second);
+    }
+    return nothing<Val>();
 }
 
-// API search type: maximum_maybe : [a] -> Maybe a
-// fwd bind count: 0
-// Return the first maximum element if sequence is not empty
-// if sequence is not empty.
-// maximum_maybe([3, 1, 4, 2]) == Just 4
-// maximum_maybe([]) == Nothing
-template <typename Container>
-maybe<typename Container::value_type> maximum_maybe(const Container& xs)
+// API search type: get_first_from_map_unsafe : (Map key val, [key]) -> val
+// fwd bind count: 1
+// Returns the value of the first key present.
+// Crashes otherwise.
+template <typename MapType,
+    typename KeysContainer,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+Val get_first_from_map_unsafe(const MapType& map, const KeysContainer& keys)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return maximum(xs);
+    return unsafe_get_just(get_first_from_map(map, keys));
 }
 
-// API search type: minimum_on : ((a -> b), [a]) -> a
-// fwd bind count: 1
-// Return the first minimum element using a transformer.
-// minimum_on(length, ["123", "12", "1234", "123"]) -> "12"
-// Unsafe! Crashes on an empty sequence.
-template <typename F, typename Container>
-typename Container::value_type minimum_on(F f, const Container& xs)
+// API search type: get_first_from_map_with_def : (Map key val, val, [key]) -> val
+// fwd bind count: 2
+// Returns the value of the first key present.
+// Otherwise returns the provided default.
+template <typename MapType,
+    typename KeysContainer,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+Val get_first_from_map_with_def(const MapType& map, const Val& defVal,
+    const KeysContainer& keys)
 {
-    internal::trigger_static_asserts<internal::unary_function_tag, F, typename Container::value_type>();
-    return elem_at_idx(minimum_idx_on(f, xs), xs);
+    return just_with_default(defVal, get_first_from_map(map, keys));
 }
 
-// API search type: minimum_on_maybe : ((a -> b), [a]) -> Maybe a
+// API search type: map_contains : (Map key val, key) -> Bool
 // fwd bind count: 1
-// Return the first minimum element using a transformer
-// if sequence is not empty.
-// minimum_on_maybe(length, ["123", "12", "1234", "123"]) -> Just "12"
-// minimum_on_maybe(length, []) -> Nothing
-template <typename F, typename Container>
-maybe<typename Container::value_type> minimum_on_maybe(
-    F f, const Container& xs)
+// Checks if a map contains a key.
+template <typename MapType, typename Key = typename MapType::key_type>
+bool map_contains(const MapType& map, const Key& key)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return minimum_on(f, xs);
+    auto it = map.find(key);
+    return it != std::end(map);
 }
 
-// API search type: maximum_on : ((a -> b), [a]) -> a
+// API search type: map_keep_if : ((key -> Bool), Map key val) -> Map key val
 // fwd bind count: 1
-// Return the first maximum element using a transformer.
-// maximum_on(length, ["123", "12", "1234", "123"]) == "1234"
-// Unsafe! Crashes on an empty sequence.
-template <typename F, typename Container>
-typename Container::value_type maximum_on(F f, const Container& xs)
+// Filters the map by keys.
+// map_keep_if(is_upper_case, {a: 1, b: 2, A: 3, C: 4}) == {A: 3, C: 4}
+// Also known as pick_by.
+template <typename MapType, typename Pred>
+MapType map_keep_if(Pred pred, const MapType& map)
 {
-    internal::trigger_static_asserts<internal::unary_function_tag, F, typename Container::value_type>();
-    return elem_at_idx(maximum_idx_on(f, xs), xs);
+    MapType result;
+    for (const auto& key_and_value : map) {
+        if (internal::invoke(pred, key_and_value.first)) {
+            result.insert(key_and_value);
+        }
+    }
+    return result;
 }
 
-// API search type: maximum_on_maybe : ((a -> b), [a]) -> Maybe a
+// API search type: map_drop_if : ((key -> Bool), Map key val) -> Map key val
 // fwd bind count: 1
-// Return the first maximum element using a transformer
-// if sequence is not empty.
-// maximum_on_maybe(length, ["123", "12", "1234", "123"]) == Just "1234"
-// maximum_on_maybe(length, ["123", "12", "1234", "123"]) == Nothing
-template <typename F, typename Container>
-maybe<typename Container::value_type> maximum_on_maybe(
-    F f, const Container& xs)
+// Filters the map by keys.
+// map_drop_if(is_lower_case, {a: 1, b: 2, A: 3, C: 4}) == {A: 3, C: 4}
+// Inverse of map_keep_if.
+template <typename MapType, typename Pred>
+MapType map_drop_if(Pred pred, const MapType& map)
 {
-    if (is_empty(xs))
-        return {};
-    else
-        return maximum_on(f, xs);
+    return map_keep_if(logical_not(pred), map);
 }
 
-// API search type: mean : [a] -> a
-// fwd bind count: 0
-// mean([1, 4, 4]) == 3
-// Also known as average.
-// xs must have at least one element.
-// Use mean_using_doubles if overflow errors for sum(xs) can occur.
-// Unsafe! Crashes on an empty sequence.
-template <typename Result, typename Container>
-Result mean(const Container& xs)
+// API search type: map_keep : ([key], Map key val) -> Map key val
+// fwd bind count: 1
+// Keeps only the pairs of the map found in the key list.
+// map_keep([a, d], {a: 1, b: 2, c: 3, d: 4}) == {a: 1, d: 4}
+// map_keep([a, e, f], {a: 1, b: 2, c: 3, d: 4}) == {a: 1}
+// Also known as pick.
+template <typename MapType, typename KeyContainer>
+MapType map_keep(const KeyContainer& keys, const MapType& map)
 {
-    assert(size_of_cont(xs) != 0);
-    typedef typename Container::value_type T;
-    return static_cast<Result>(sum(xs) / static_cast<T>(size_of_cont(xs)));
+    static_assert(std::is_same<
+                      typename KeyContainer::value_type,
+                      typename MapType::key_type>::value,
+        "Key types do not match.");
+    return map_keep_if(bind_2nd_of_2(is_elem_of<KeyContainer>, keys), map);
 }
 
-// API search type: mean_obj_div_size_t : [a] -> a
-// fwd bind count: 0
-// mean_obj_div_size_t([B 1, B 4, B 4]) == B 3
-// The provided objects must support division by a std::size_t.
-// Unsafe! Crashes on an empty sequence.
-// Also Make sure sum(xs) does not overflow.
-template <typename Container,
-    typename T = typename Container::value_type>
-T mean_obj_div_size_t(const Container& xs)
+// API search type: map_drop : ([key], Map key val) -> Map key val
+// fwd bind count: 1
+// Keeps only the pairs of the map not found in the key list.
+// Inverse of map_keep.
+// map_drop([b, c], {a: 1, b: 2, c: 3, d: 4}); == {a: 1, d: 4}
+template <typename MapType, typename KeyContainer>
+MapType map_drop(const KeyContainer& keys, const MapType& map)
 {
-    assert(size_of_cont(xs) != 0);
-    return sum(xs) / size_of_cont(xs);
+    static_assert(std::is_same<
+                      typename KeyContainer::value_type,
+                      typename MapType::key_type>::value,
+        "Key types do not match.");
+    return map_drop_if(bind_2nd_of_2(is_elem_of<KeyContainer>, keys), map);
 }
 
-// API search type: mean_obj_div_double : [a] -> a
-// fwd bind count: 0
-// mean_obj_div_double([B 1, B 4, B 4]) == B 3
-// The provided objects must support division by a double.
-// Unsafe! Crashes on an empty sequence.
-// Also Make sure sum(xs) does not overflow.
-template <typename Container,
-    typename T = typename Container::value_type>
-T mean_obj_div_double(const Container& xs)
+// API search type: map_keep_if_value : ((val -> Bool), Map key val) -> Map key val
+// fwd bind count: 1
+// Filters the map by values.
+// map_keep_if_value(is_upper_case, {1: a, 2: b, 3: A, 4: C}) == {3: A, 4: C}
+// Also known as filter_values.
+template <typename MapType, typename Pred>
+MapType map_keep_if_value(Pred pred, const MapType& map)
 {
-    assert(size_of_cont(xs) != 0);
-    return sum(xs) / static_cast<double>(size_of_cont(xs));
+    MapType result;
+    for (const auto& key_and_value : map) {
+        if (internal::invoke(pred, key_and_value.second)) {
+            result.insert(key_and_value);
+        }
+    }
+    return result;
 }
 
-// API search type: mean_using_doubles : [a] -> a
-// fwd bind count: 0
-// mean_using_doubles([1, 4, 4]) == 3
-// Converts elements to double before calculating the sum
-// to prevent overflows.
-// Unsafe! Crashes on an empty sequence.
-template <typename Result, typename Container>
-Result mean_using_doubles(const Container& xs)
+// API search type: map_drop_if_value : ((value -> Bool), Map key val) -> Map key val
+// fwd bind count: 1
+// Filters the map by values.
+// map_drop_if_value(is_lower_case, {1: a, 2: b, 3: A, 4: C}) == {3: A, 4: C}
+// Inverse of map_keep_if_value.
+template <typename MapType, typename Pred>
+MapType map_drop_if_value(Pred pred, const MapType& map)
 {
-    assert(size_of_cont(xs) != 0);
-    auto xs_as_doubles = convert_elems<double>(xs);
-    auto result_as_double = mean<double>(xs_as_doubles);
-    if (!std::is_integral<Result>::value)
-        return static_cast<Result>(result_as_double);
-    else
-        return round<double, Result>(result_as_double);
+    return map_keep_if_value(logical_not(pred), map);
 }
 
-// API search type: median : [a] -> a
-// fwd bind count: 0
-// median([5, 6, 4, 3, 2, 6, 7, 9, 3]) == 5
-// Unsafe! Crashes on an empty sequence.
-template <typename Container,
-    typename Result = typename Container::value_type>
-Result median(const Container& xs)
+// API search type: map_keep_values : ([value], Map key val) -> Map key val
+// fwd bind count: 1
+// Keeps only the pairs of the map found in the value list.
+// map_keep_values([1, 4], {a: 1, b: 2, c: 3, d: 4}) == {a: 1, d: 4}
+// map_keep_values([1, 5, 6], {a: 1, b: 2, c: 3, d: 4}) == {a: 1}
+template <typename MapType, typename ValueContainer>
+MapType map_keep_values(const ValueContainer& values, const MapType& map)
 {
-    assert(is_not_empty(xs));
-
-    if (size_of_cont(xs) == 1)
-        return static_cast<Result>(xs.front());
-
-    // std::nth_element (instead of sorting)
-    // would be faster for random-access containers
-    // but not work at all on other containers like std::list.
-    auto xsSorted = sort(xs);
-    if (is_odd(size_of_cont(xsSorted))) {
-        auto it = std::begin(xsSorted);
-        internal::advance_iterator(it, size_of_cont(xsSorted) / 2);
-        return static_cast<Result>(*it);
-    } else {
-        auto it1 = std::begin(xsSorted);
-        internal::advance_iterator(it1, size_of_cont(xsSorted) / 2 - 1);
-        auto it2 = it1;
-        ++it2;
-        return static_cast<Result>(*it1 + *it2) / static_cast<Result>(2);
-    }
+    static_assert(std::is_same<
+                      typename ValueContainer::value_type,
+                      typename MapType::mapped_type>::value,
+        "Value types do not match.");
+    return map_keep_if_value(
+        bind_2nd_of_2(is_elem_of<ValueContainer>, values), map);
 }
 
-// API search type: all_unique_by_less : (((a, a) -> Bool), [a]) -> Bool
+// API search type: map_drop_values : ([value], Map key val) -> Map key val
 // fwd bind count: 1
-// Returns true for empty containers.
-// O(n*log(n))
-template <typename Container, typename Compare>
-bool all_unique_by_less(Compare comp, const Container& xs)
+// Keeps only the pairs of the map not found in the value list.
+// Inverse of map_keep_values.
+// map_drop_values([2, 3], {a: 1, b: 2, c: 3, d: 4}) == {a: 1, d: 4}
+template <typename MapType, typename ValueContainer>
+MapType map_drop_values(const ValueContainer& values, const MapType& map)
 {
-    internal::check_compare_for_container<Compare, Container>();
-    if (size_of_cont(xs) < 2)
-        return true;
-    return size_of_cont(unique(sort_by(comp, xs))) == size_of_cont(xs);
+    static_assert(std::is_same<
+                      typename ValueContainer::value_type,
+                      typename MapType::mapped_type>::value,
+        "Value types do not match.");
+    return map_drop_if_value(
+        bind_2nd_of_2(is_elem_of<ValueContainer>, values), map);
 }
 
-// API search type: all_unique_less : [a] -> Bool
-// fwd bind count: 0
-// Returns true for empty containers.
-// O(n*log(n))
-template <typename Container>
-bool all_unique_less(const Container& xs)
+// API search type: map_pluck : (key, [Map key val]) -> [val]
+// fwd bind count: 1
+// Extracts values to a specific key from a list of maps.
+// map_pluck('a', [{a: 1, b: 2}, {a: 3}, {c: 4}]) == [Just 1, Just 3, Nothing]
+template <typename MapContainer,
+    typename ContainerOut = std::vector<maybe<typename MapContainer::value_type::mapped_type>>,
+    typename MapType = typename MapContainer::value_type,
+    typename Key = typename MapType::key_type,
+    typename Val = typename MapType::mapped_type>
+ContainerOut map_pluck(const Key& key, const MapContainer& maps)
 {
-    typedef typename Container::value_type T;
-    auto comp = std::less<T>();
-    return all_unique_by_less(comp, xs);
+    return transform_convert<ContainerOut>(
+        bind_2nd_of_2(get_from_map<MapType>, key), maps);
 }
 
-// API search type: is_infix_of : ([a], [a]) -> Bool
+// API search type: choose : ([(a, b)], a) -> Maybe b
 // fwd bind count: 1
-// is_infix_of("ion", "FunctionalPlus") == true
-template <typename Container>
-bool is_infix_of(const Container& token, const Container& xs)
+// Selects a value assigned to a key iff the key exists exactly once.
+// choose([(1,a), (2,b)], 2) == Just b;
+// choose([(1,a), (1,b)], 2) == Nothing;
+// choose([(1,a), (2,b)], 3) == Nothing;
+template <typename Key, typename Val>
+maybe<Val> choose(const std::vector<std::pair<Key, Val>>& pairs, const Key& x)
 {
-    return is_just(find_first_instance_of_token(token, xs));
+    if (count(x, transform(fst<Key, Val>, pairs)) != 1)
+        return {};
+    return get_from_map(pairs_to_map<std::unordered_map<Key, Val>>(pairs), x);
 }
 
-// API search type: is_subsequence_of : ([a], [a]) -> Bool
-// fwd bind count: 1
-// is_subsequence_of("Final", "FunctionalPlus") == true
-template <typename Container>
-bool is_subsequence_of(const Container& seq, const Container& xs)
+// API search type: choose_by : ([((a -> Bool), b)], a) -> Maybe b
+// fwd bind count: 2
+// Iff exactly one predicate is fulfilled
+// the value assigned to this predicate is selected.
+// choose_by([(is_even,a), (is_bigger_than_3,b)], 2) == Just a;
+// choose_by([(is_even,a), (is_bigger_than_3,b)], 5) == Just b;
+// choose_by([(is_even,a), (is_bigger_than_3,b)], 1) == Nothing;
+// choose_by([(is_even,a), (is_bigger_than_3,b)], 4) == Nothing;
+template <typename Key, typename Val>
+maybe<Val> choose_by(
+    const std::vector<std::pair<std::function<bool(const Key&)>, Val>>& pairs,
+    const Key& x)
 {
-    if (is_empty(seq))
-        return true;
-    if (size_of_cont(seq) > size_of_cont(xs))
-        return false;
-    typedef typename Container::value_type T;
-    auto remaining = convert_container_and_elems<std::list<T>>(seq);
-    for (const auto& x : xs) {
-        if (x == remaining.front()) {
-            remaining.pop_front();
-            if (is_empty(remaining))
-                return true;
+    maybe<Val> result;
+    for (const auto& p : pairs) {
+        if (internal::invoke(p.first, x)) {
+            if (is_just(result)) {
+                return nothing<Val>();
+            }
+            result = p.second;
         }
     }
-    return false;
+    return result;
 }
 
-// API search type: count_if : ((a -> Bool), [a]) -> Int
+// API search type: choose_lazy : ([(a, (() -> b))], a) -> Maybe b
 // fwd bind count: 1
-// count_if(is_even, [1, 2, 3, 5, 7, 8]) == 2
-template <typename UnaryPredicate, typename Container>
-std::size_t count_if(UnaryPredicate p, const Container& xs)
+// Evaluates a lazy value assigned to a key iff the key exists exactly once.
+// choose_lazy([(1,a), (2,b)], 2) == Just b();
+// choose_lazy([(1,a), (1,b)], 2) == Nothing;
+// choose_lazy([(1,a), (2,b)], 3) == Nothing;
+template <typename Key, typename ValStub>
+auto choose_lazy(const std::vector<std::pair<Key, ValStub>>& pairs,
+    const Key& x)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    return size_of_cont(find_all_idxs_by(p, xs));
+    using Ret = maybe<std::decay_t<internal::invoke_result_t<ValStub>>>;
+    const auto res = choose(pairs, x);
+    if (res.is_nothing())
+        return Ret {};
+    else
+        return Ret { res.unsafe_get_just()() };
 }
 
-// API search type: count : (a, [a]) -> Int
-// fwd bind count: 1
-// count(2, [1, 2, 3, 5, 7, 2, 2]) == 3
-template <typename Container>
-std::size_t count(const typename Container::value_type& x, const Container& xs)
+// API search type: choose_by_lazy : ([((a -> Bool), (() -> b))], a) -> Maybe b
+// fwd bind count: 2
+// Iff exactly one predicate is fulfilled
+// the lazy value assigned to this predicate is evaluated.
+// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 2) == Just a();
+// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 5) == Just b();
+// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 1) == Nothing;
+// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 4) == Nothing;
+template <typename Key, typename ValStub>
+auto choose_by_lazy(
+    const std::vector<std::pair<std::function<bool(const Key&)>, ValStub>>& pairs,
+    const Key& x)
 {
-    return size_of_cont(find_all_idxs_of(x, xs));
+    using Ret = maybe<std::decay_t<internal::invoke_result_t<ValStub>>>;
+
+    const auto res = choose_by(pairs, x);
+    if (res.is_nothing())
+        return Ret {};
+    else
+        return Ret { res.unsafe_get_just()() };
 }
 
-// API search type: is_unique_in_by : ((a -> bool), [a]) -> Bool
+// API search type: choose_def : (b, [(a, b)], a) -> b
 // fwd bind count: 1
-// is_unique_in_by((==2), [1, 2, 3, 5, 7, 2, 2]) == false
-// is_unique_in_by((==5), [1, 2, 3, 5, 7, 2, 2]) == true
-template <typename UnaryPredicate, typename Container>
-bool is_unique_in_by(UnaryPredicate pred, const Container& xs)
+// Selects a value assigned to a key iff the key exists exactly once,
+// otherwise returns the given default value.
+// choose_def(c, [(1,a), (2,b)], 2) == b;
+// choose_def(c, [(1,a), (1,b)], 2) == c;
+// choose_def(c, [(1,a), (2,b)], 3) == c;
+template <typename Key, typename Val>
+Val choose_def(const Val& def,
+    const std::vector<std::pair<Key, Val>>& pairs, const Key& x)
 {
-    std::size_t count = 0;
-    for (const auto& x : xs) {
-        if (internal::invoke(pred, x)) {
-            ++count;
-            if (count > 1) {
-                return false;
-            }
-        }
-    }
-    return true;
+    if (count(x, transform(fst<Key, Val>, pairs)) != 1)
+        return def;
+    return get_from_map_with_def(
+        pairs_to_map<std::unordered_map<Key, Val>>(pairs), def, x);
 }
 
-// API search type: is_unique_in : (a, [a]) -> Bool
-// fwd bind count: 1
-// is_unique_in(2, [1, 2, 3, 5, 7, 2, 2]) == false
-// is_unique_in(5, [1, 2, 3, 5, 7, 2, 2]) == true
-template <typename Container>
-bool is_unique_in(const typename Container::value_type& x, const Container& xs)
+// API search type: choose_by_def : (b, [((a -> Bool), b)], a) -> b
+// fwd bind count: 2
+// Iff exactly one predicate is fulfilled
+// the value assigned to this predicate is selected.
+// Otherwise the given default value is returned.
+// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 2) == Just a;
+// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 5) == Just b;
+// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 1) == c;
+// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 4) == c;
+template <typename Key, typename Val>
+Val choose_by_def(const Val& def,
+    const std::vector<std::pair<std::function<bool(const Key&)>, Val>>& pairs,
+    const Key& x)
 {
-    return is_unique_in_by(is_equal_to(x), xs);
+    return just_with_default(def, choose_by(pairs, x));
 }
 
-// API search type: is_permutation_of : ([a], [a]) -> Bool
+// API search type: choose_def_lazy : ((() -> b), [(a, (() -> b))], a) -> b
 // fwd bind count: 1
-// Checks if one container is a permuation of the other one.
-// is_permutation_of([2,3,1], [1,2,3]) == true
-// O(log(n))
-template <typename Container>
-bool is_permutation_of(const Container& xs, const Container& ys)
+// Evaluates a lazy value assigned to a key iff the key exists exactly once,
+// otherwise evaluates the given default lazy value.
+// choose_def_lazy(c, [(1,a), (2,b)], 2) == b();
+// choose_def_lazy(c, [(1,a), (1,b)], 2) == c();
+// choose_def_lazy(c, [(1,a), (2,b)], 3) == c();
+template <typename Key, typename ValStub>
+auto choose_def_lazy(const ValStub& def,
+    const std::vector<std::pair<Key, ValStub>>& pairs,
+    const Key& x)
 {
-    return size_of_cont(xs) == size_of_cont(ys) && sort(xs) == sort(ys);
+    return choose_def(def, pairs, x)();
 }
 
-// API search type: fill_pigeonholes_to : (Int, [Int]) -> [Int]
-// fwd bind count: 1
-// Returns a list containing the count for every element in xs
-// with the value corresponding to the index in the result list.
-// fill_pigeonholes_to(5, [0,1,3,1]) == [1,2,0,1,0]
-// fill_pigeonholes_to(3, [0,1,3,1]) == [1,2,0]
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<std::size_t>,
-    typename T = typename ContainerIn::value_type>
-ContainerOut fill_pigeonholes_to(std::size_t idx_end, const ContainerIn& xs)
+// API search type: choose_by_def_lazy : ((() -> b), [((a -> Bool), (() -> b))], a) -> b
+// fwd bind count: 2
+// Iff exactly one predicate is fulfilled
+// the value assigned to this predicate is evaluated.
+// Otherwise the given default value is evaluated and returned.
+// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 2) == Just a();
+// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 5) == Just b();
+// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 1) == c();
+// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 4) == c();
+template <typename Key, typename ValStub>
+auto choose_by_def_lazy(
+    const ValStub& def,
+    const std::vector<std::pair<std::function<bool(const Key&)>, ValStub>>& pairs,
+    const Key& x)
 {
-    static_assert(std::is_integral<T>::value,
-        "Type must be integral.");
-
-    if (is_empty(xs))
-        return {};
-
-    ContainerOut result(idx_end, 0);
-    for (const auto& x : xs) {
-        if (x >= 0) {
-            const auto idx = static_cast<std::size_t>(x);
-            if (idx < result.size()) {
-                ++result[idx];
-            }
-        }
-    }
-    return result;
+    return choose_by_def(def, pairs, x)();
 }
 
-// API search type: fill_pigeonholes : [Int] -> [Int]
-// fwd bind count: 0
-// Returns a list containing the count for every element in xs
-// with the value corresponding to the index in the result list.
-// fill_pigeonholes([0,1,3,1]) == [1,2,0,1]
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<std::size_t>,
-    typename T = typename ContainerIn::value_type>
-ContainerOut fill_pigeonholes(const ContainerIn& xs)
-{
-    static_assert(std::is_integral<T>::value,
-        "Type must be integral.");
+} // namespace fplus
 
-    if (is_empty(xs))
-        return {};
+//
+// split.hpp
+//
 
-    return (fill_pigeonholes_to<ContainerIn, ContainerOut>(
-        maximum(xs) + 1, xs));
-}
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
 
-// API search type: fill_pigeonholes_bool_to : (Int, [Int]) -> [Int]
-// fwd bind count: 1
-// Returns a list telling if the element corresponding to the index
-// is present in xs.
-// fill_pigeonholes_bool_to(5, [0,1,3,1]) == [1,1,0,1,0]
-// fill_pigeonholes_bool_to(3, [0,1,3,1]) == [1,1,0]
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<std::uint8_t>,
-    typename T = typename ContainerIn::value_type>
-ContainerOut fill_pigeonholes_bool_to(std::size_t idx_end, const ContainerIn& xs)
-{
-    static_assert(std::is_integral<T>::value,
-        "Type must be integral.");
 
-    if (is_empty(xs))
-        return {};
 
-    ContainerOut result(idx_end, 0);
-    for (const auto& x : xs) {
-        if (x >= 0) {
-            const auto idx = static_cast<std::size_t>(x);
-            if (idx < result.size()) {
-                result[idx] = 1;
-            }
-        }
-    }
-    return result;
-}
 
-// API search type: fill_pigeonholes_bool : [Int] -> [Int]
-// fwd bind count: 0
-// Returns a list telling if the element corresponding to the index
-// is present in xs.
-// fill_pigeonholes_bool([0,1,3,1]) == [1,2,0,1]
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<std::uint8_t>,
-    typename T = typename ContainerIn::value_type>
-ContainerOut fill_pigeonholes_bool(const ContainerIn& xs)
-{
-    static_assert(std::is_integral<T>::value,
-        "Type must be integral.");
+//
+// internal/split.hpp
+//
 
-    if (is_empty(xs))
-        return {};
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
 
-    return (fill_pigeonholes_bool_to<ContainerIn, ContainerOut>(
-        maximum(xs) + 1, xs));
-}
 
-// API search type: present_in_all : [[a]] -> [a]
-// fwd bind count: 0
-// Returns a list containing only the elements present in all sublists of xs.
-// Also known as gemstones.
-// present_in_all([[4,1,2], [5,2,1], [2,4,1]]) == [1,2]
-template <typename ContainerIn,
-    typename SubContainerIn = typename ContainerIn::value_type,
-    typename T = typename SubContainerIn::value_type,
-    typename ContainerOut = std::vector<T>>
-ContainerOut present_in_all(const ContainerIn& xs)
-{
-    return convert_container<ContainerOut>(
-        fplus::sets_intersection(
-            transform(
-                convert_container<std::set<T>, SubContainerIn>,
-                xs)));
-}
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-} // namespace fplus
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 
-#include <map>
-#include <unordered_map>
 
 namespace fplus {
+namespace internal {
+    template <typename GroupByCallable, typename F, typename ContainerIn>
+    auto group_on_labeled_impl(GroupByCallable group, F f, const ContainerIn& xs)
+    {
+        const auto grouped = group(is_equal_by(f), xs);
+        const auto attach_label = [f](const auto& g) {
+            using std::begin;
+            return std::make_pair(internal::invoke(f, *begin(g)), g);
+        };
+        return fplus::transform(attach_label, grouped);
+    }
 
-// API search type: pairs_to_map : [(key, val)] -> Map key val
-// fwd bind count: 0
-// Converts a Container of pairs (key, value) into a dictionary.
-template <typename MapOut, typename ContainerIn>
-MapOut pairs_to_map(const ContainerIn& pairs)
-{
-    return convert_container_and_elems<MapOut>(pairs);
-}
+#if __cplusplus >= 201703L
+    template <typename T>
+    struct is_string_view : std::false_type {
+    };
+    template <typename CharT, typename Traits>
+    struct is_string_view<std::basic_string_view<CharT, Traits>> : std::true_type {
+    };
 
-// API search type: pairs_to_map_grouped : [(key, val)] -> Map key [val]
-// fwd bind count: 0
-// Convert a list of key-value pairs to a dictionary
-// while pushing values having the same key into a vector.
-// pairs_to_map_grouped([("a", 1), ("a", 2), ("b", 6), ("a", 4)])
-//     -> {"a": [1, 2, 4], "b": [6]}
-template <typename ContainerIn,
-    typename Key = typename ContainerIn::value_type::first_type,
-    typename SingleValue = typename ContainerIn::value_type::second_type,
-    typename MapOut = std::map<Key, std::vector<SingleValue>>>
-MapOut pairs_to_map_grouped(const ContainerIn& pairs)
-{
-    MapOut result;
-    for (const auto& p : pairs) {
-        result[p.first].push_back(p.second);
+    // The *_view splitting functions return views into their input,
+    // so it must outlive the result. Temporary strings are rejected.
+    // String is the deduced type of a forwarding reference.
+    template <typename String>
+    auto as_string_view(const std::remove_reference_t<String>& str)
+    {
+        static_assert(std::is_lvalue_reference<String>::value
+                || is_string_view<std::decay_t<String>>::value,
+            "The result would refer to a temporary string.");
+        typedef std::decay_t<String> Str;
+        return std::basic_string_view<typename Str::value_type,
+            typename Str::traits_type>(str.data(), str.size());
+    }
+
+    // Splits str into the segments between separators,
+    // with the same handling of empty segments as split_by.
+    // find_sep(str, pos) returns the begin and the end
+    // of the first separator at or after pos,
+    // or npos as begin if there is none.
+    template <typename CharT, typename Traits, typename FindSep>
+    std::vector<std::basic_string_view<CharT, Traits>> split_string_view(
+        FindSep find_sep, bool allow_empty,
+        std::basic_string_view<CharT, Traits> str)
+    {
+        typedef std::basic_string_view<CharT, Traits> View;
+        std::vector<View> result;
+        std::size_t start = 0;
+        for (;;) {
+            const std::pair<std::size_t, std::size_t> sep = find_sep(str, start);
+            const std::size_t stop = sep.first == View::npos ? str.size() : sep.first;
+            if (start != stop || allow_empty) {
+                result.push_back(str.substr(start, stop - start));
+            }
+            if (sep.first == View::npos) {
+                return result;
+            }
+            start = sep.second;
+        }
     }
-    return result;
+#endif
 }
-
-// API search type: pairs_to_unordered_map_grouped : [(key, val)] -> Map key [val]
-// fwd bind count: 0
-// Convert a list of key-value pairs to a dictionary
-// while pushing values having the same key into a vector.
-// pairs_to_unordered_map_grouped([("a", 1), ("a", 2), ("b", 6), ("a", 4)])
-//     -> {"a": [1, 2, 4], "b": [6]}
-template <typename ContainerIn,
-    typename Key = typename ContainerIn::value_type::first_type,
-    typename SingleValue = typename ContainerIn::value_type::second_type,
-    typename MapOut = std::unordered_map<Key, std::vector<SingleValue>>>
-MapOut pairs_to_unordered_map_grouped(const ContainerIn& pairs)
-{
-    MapOut result;
-    for (const auto& p : pairs) {
-        result[p.first].push_back(p.second);
-    }
-    return result;
 }
 
-// API search type: map_to_pairs : Map key val -> [(key, val)]
-// fwd bind count: 0
-// Converts a dictionary into a Container of pairs (key, value).
-template <typename MapType,
-    typename MapPair = typename MapType::value_type,
-    typename Key = typename std::remove_const<typename MapPair::first_type>::type,
-    typename Val = typename std::remove_const<typename MapPair::second_type>::type,
-    typename OutPair = std::pair<Key, Val>,
-    typename ContainerOut = std::vector<OutPair>>
-ContainerOut map_to_pairs(const MapType& dict)
-{
-    return convert_container_and_elems<ContainerOut>(dict);
-}
+namespace fplus {
 
-// API search type: transform_map_values : ((old_val -> new_val), Map key old_val) -> Map key new_val
+// API search type: group_by : (((a, a) -> Bool), [a]) -> [[a]]
 // fwd bind count: 1
-// Manipulate the values in a dictionary, keeping the key-value relationship.
-// transform_map_values((*2), {0: 2, 1: 3}) == {0: 4, 1: 6}
-template <typename F, typename MapIn>
-auto transform_map_values(F f, const MapIn& map)
+// Arrange the elements into groups using a given predicate.
+// Only groups of consecutive elements are formed.
+// For a version scanning the whole container see group_globally_by.
+// group_by((==), [1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2],[3],[2,2],[4],[5,5]]
+// BinaryPredicate p is a (not neccessarily transitive) connectivity check.
+// O(n)
+template <typename BinaryPredicate, typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut group_by(BinaryPredicate p, const ContainerIn& xs)
 {
-    using MapInPair = typename MapIn::value_type;
-    using Key = std::remove_const_t<typename MapInPair::first_type>;
-    using InVal = std::remove_const_t<typename MapInPair::second_type>;
-    using OutVal = std::decay_t<internal::invoke_result_t<F, InVal>>;
-    using MapOut = typename internal::SameMapTypeNewTypes<MapIn, Key, OutVal>::type;
-
-    return pairs_to_map<MapOut>(
-        transform(
-            bind_1st_of_2(transform_snd<Key, InVal, F>, f),
-            map_to_pairs(map)));
+    // ContainerOut is not deduced to
+    // SameContNewType(ContainerIn, ContainerIn)
+    // here, since ContainerIn could be a std::string.
+    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    ContainerOut result;
+    if (is_empty(xs))
+        return result;
+    typedef typename ContainerOut::value_type InnerContainerOut;
+    *internal::get_back_inserter(result) = InnerContainerOut(1, xs.front());
+    for (auto it = ++std::begin(xs); it != std::end(xs); ++it) {
+        if (internal::invoke(p, result.back().back(), *it))
+            *internal::get_back_inserter(result.back()) = *it;
+        else
+            *internal::get_back_inserter(result) = InnerContainerOut(1, *it);
+    }
+    return result;
 }
 
-// API search type: map_union_with : (((val, val) -> val), Map key val, Map key val) -> Map key val
-// fwd bind count: 2
-// Combine two dictionaries using a binary function for the values.
-// map_union_with((++), {0: a, 1: b}, {0: c, 2: d}) == {0: ac, 1: b, 2: d}
-template <typename F, typename MapIn>
-auto map_union_with(F f, const MapIn& dict1, const MapIn& dict2)
+// API search type: group_on : ((a -> b), [a]) -> [[a]]
+// fwd bind count: 1
+// Arrange elements equal after applying a transformer into groups.
+// Only groups of consecutive elements are formed.
+// For a version scanning the whole container see group_globally_on.
+// group_on((mod 10), [12,22,34]) == [[12,22],[34]]
+// O(n)
+template <typename F, typename ContainerIn>
+auto group_on(F f, const ContainerIn& xs)
 {
-    const auto both = append(map_to_pairs(dict1), map_to_pairs(dict2));
-    using Key = typename decltype(both)::value_type::first_type;
-    using SingleValue = typename decltype(both)::value_type::second_type;
-    auto full_map = pairs_to_map_grouped<decltype(both), Key, SingleValue,
-        typename internal::SameMapTypeNewTypes<MapIn, Key, std::vector<SingleValue>>::type>(both);
-    const auto group_f = [f](const auto& vals) {
-        return fold_left_1(f, vals);
-    };
-    return transform_map_values(group_f, full_map);
+    return group_by(is_equal_by(f), xs);
 }
 
-// API search type: map_union : (Map key val, Map key val) -> Map key val
+// API search type: group_on_labeled : ((a -> b), [a]) -> [(b, [a])]
 // fwd bind count: 1
-// Combine two dictionaries keeping the value of the first map
-// in case of key collisions.
-// map_union({0: a, 1: b}, {0: c, 2: d}) == {0: a, 1: b, 2: d}
-template <typename MapType>
-MapType map_union(const MapType& dict1, const MapType& dict2)
+// Arrange elements equal after applying a transformer into groups,
+// adding the transformation result as a label to the group.
+// Only groups of consecutive elements are formed.
+// For a version scanning the whole container see group_globally_on_labeled.
+// group_on_labeled((mod 10), [12,22,34]) == [(2,[12,22]), (4,[34])]
+// O(n)
+template <typename F, typename ContainerIn>
+auto group_on_labeled(F f, const ContainerIn& xs)
 {
-    using Value = typename MapType::value_type::second_type;
-
-    const auto get_first = [](const Value& a, const Value&) -> Value {
-        return a;
+    const auto group = [](auto f1, const auto& xs1) {
+        return group_by(f1, xs1);
     };
-    return map_union_with(get_first, dict1, dict2);
-}
-
-// API search type: map_grouped_to_pairs : Map key [val] -> [(key, val)]
-// fwd bind count: 0
-// Convert a dictionary with sequence values to a list of key-value pairs.
-// Inverse operation of pairs_to_map_grouped.
-// map_grouped_to_pairs({"a": [1, 2, 4], "b": [6]})
-//     -> [("a", 1), ("a", 2), ("a", 4), ("b", 6)]
-template <typename MapType>
-auto map_grouped_to_pairs(const MapType& dict)
-{
-    using Key = typename MapType::key_type;
-    using Group = typename MapType::mapped_type;
 
-    auto fn = [](const auto& pair) {
-        const auto f = zip_repeat<std::vector<Key>, Group>;
-        return apply_to_pair(f, transform_fst(singleton_seq<Key>, pair));
-    };
-    return concat(transform(fn, map_to_pairs(dict)));
+    return internal::group_on_labeled_impl(group, f, xs);
 }
 
-// API search type: get_map_keys : Map key val -> [key]
+// API search type: group : [a] -> [[a]]
 // fwd bind count: 0
-// Returns all keys used in a map.
-template <typename MapType,
-    typename ContainerOut = std::vector<typename std::remove_const<typename MapType::key_type>::type>>
-ContainerOut get_map_keys(const MapType& dict)
+// Arrange equal elements into groups.
+// Only groups of consecutive elements are formed.
+// For a version scanning the whole container see group_globally.
+// group([1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2],[3],[2,2],[4],[5,5]]
+// O(n)
+template <typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut group(const ContainerIn& xs)
 {
-    auto pairs = map_to_pairs(dict);
-    typedef typename decltype(pairs)::value_type::first_type FirstType;
-    typedef typename decltype(pairs)::value_type::second_type SecondType;
-    return transform_convert<ContainerOut>(
-        fst<FirstType, SecondType>, map_to_pairs(dict));
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    typedef typename ContainerIn::value_type T;
+    auto pred = [](const T& x, const T& y) { return x == y; };
+    return group_by<decltype(pred), ContainerIn, ContainerOut>(pred, xs);
 }
 
-// API search type: get_map_values : Map key val -> [val]
-// fwd bind count: 0
-// Returns all values present in a map.
-template <typename MapType,
-    typename ContainerOut = std::vector<typename std::remove_const<typename MapType::mapped_type>::type>>
-ContainerOut get_map_values(const MapType& dict)
+// API search type: group_globally_by : (((a, a) -> Bool), [a]) -> [[a]]
+// fwd bind count: 1
+// Arrange equal elements into groups.
+// group_globally_by((==), [1,2,2,2,3,2,2,4,5,5])
+// == [[1],[2,2,2,2,2],[3],[4],[5,5]]
+// BinaryPredicate p is a
+// transitive (whenever p(x,y) and p(y,z), then also p(x,z)) equality check.
+// O(n^2)
+// If you need O(n*log(n)), sort and then use group_by
+template <typename BinaryPredicate, typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut group_globally_by(BinaryPredicate p, const ContainerIn& xs)
 {
-    auto pairs = map_to_pairs(dict);
-    typedef typename decltype(pairs)::value_type::first_type FirstType;
-    typedef typename decltype(pairs)::value_type::second_type SecondType;
-    return transform_convert<ContainerOut>(
-        snd<FirstType, SecondType>, map_to_pairs(dict));
+    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    typedef typename ContainerOut::value_type InnerContainerOut;
+    ContainerOut result;
+    for (const auto& x : xs) {
+        bool found = false;
+        for (auto& ys : result) {
+            if (internal::invoke(p, x, ys.back())) {
+                *internal::get_back_inserter(ys) = x;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            *internal::get_back_inserter(result) = InnerContainerOut(1, x);
+        }
+    }
+    return result;
 }
 
-// API search type: swap_keys_and_values : Map a b -> Map b a
-// fwd bind count: 0
-// Swaps keys and Values of a dict:
-// swap_keys_and_values({1: "a", 2: "b"}) == {"a": 1, "b": 2}
-template <typename MapIn,
-    typename MapInPair = typename MapIn::value_type,
-    typename InKey = typename MapInPair::first_type,
-    typename InVal = typename MapInPair::second_type,
-    typename OutKey = InVal,
-    typename OutVal = typename std::remove_const<InKey>::type,
-    typename MapOut = typename internal::SameMapTypeNewTypes<MapIn, OutKey, OutVal>::type>
-MapOut swap_keys_and_values(const MapIn& dict)
-{
-    auto inAsPairs = map_to_pairs(dict);
-    auto outAsPairs = transform(swap_pair_elems<InKey, InVal>, inAsPairs);
-    return pairs_to_map<MapOut>(outAsPairs);
-}
+namespace internal {
 
-// API search type: create_map : ([key], [val]) -> Map key val
-// fwd bind count: 1
-// Zip a sequence of keys with a sequence of values to obtain a dictionary.
-// create_map([1,2,3], ["one", "two"]) == {1: "one", 2: "two"}
-template <typename ContainerIn1, typename ContainerIn2,
-    typename Key = typename std::remove_const<typename ContainerIn1::value_type>::type,
-    typename Val = typename std::remove_const<typename ContainerIn2::value_type>::type,
-    typename MapOut = std::map<Key, Val>>
-MapOut create_map(const ContainerIn1& keys, const ContainerIn2& values)
-{
-    auto pairs = zip(keys, values);
-    return pairs_to_map<MapOut>(pairs);
-}
+    // Groups by hashing the keys, keeping the order of first occurrence.
+    // Returns the keys of the groups alongside the groups.
+    template <typename ContainerOut, typename F, typename ContainerIn>
+    auto group_globally_on_hashed(F f, const ContainerIn& xs)
+    {
+        typedef typename ContainerOut::value_type InnerContainerOut;
+        typedef key_of_t<F, ContainerIn> Key;
+        std::unordered_map<Key, std::size_t> group_idxs;
+        std::vector<Key> keys;
+        ContainerOut result;
+        for (const auto& x : xs) {
+            auto key = internal::invoke(f, x);
+            const auto it = group_idxs.find(key);
+            if (it == group_idxs.end()) {
+                group_idxs.emplace(key, result.size());
+                keys.push_back(std::move(key));
+                *internal::get_back_inserter(result) = InnerContainerOut(1, x);
+            } else {
+                *internal::get_back_inserter(result[it->second]) = x;
+            }
+        }
+        return std::make_pair(std::move(keys), std::move(result));
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on(std::true_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        return group_globally_on_hashed<std::vector<ContainerIn>>(f, xs).second;
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on(std::false_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        return group_globally_by(is_equal_by(f), xs);
+    }
 
-// API search type: create_map_with : ((key -> val), [key]) -> Map key val
-// fwd bind count: 1
-// Take a list of keys and create a dictionary
-// generating the values by applying f to each key.
-// create_map_with(show, [1,2]) == {1: "1", 2: "2"}
-template <typename ContainerIn, typename F>
-auto create_map_with(F f, const ContainerIn& keys)
-{
-    return create_map(keys, transform(f, keys));
-}
+    template <typename ContainerIn>
+    auto group_globally(std::true_type /* is_hashable */, const ContainerIn& xs)
+    {
+        typedef typename ContainerIn::value_type T;
+        return group_globally_on(std::true_type(), identity<T>, xs);
+    }
 
-// API search type: create_map_grouped : ((val -> key), [val]) -> Map key val
-// fwd bind count: 1
-// Take a list of values and create a grouped dictionary
-// generating the keys by applying f to each key.
-// create_map_grouped(length, ["one", "three", "two"]) == {3: ["one", "two"], 5: ["three"]}
-// Also known as group_by
-template <typename ContainerIn, typename F>
-auto create_map_grouped(F f, const ContainerIn& values)
-{
-    return pairs_to_map_grouped(zip(transform(f, values), values));
-}
+    template <typename ContainerIn>
+    auto group_globally(std::false_type /* is_hashable */, const ContainerIn& xs)
+    {
+        typedef typename ContainerIn::value_type T;
+        auto pred = [](const T& x, const T& y) { return x == y; };
+        return group_globally_by(pred, xs);
+    }
 
-// API search type: create_unordered_map : ([key], [val]) -> Map key val
-// fwd bind count: 1
-// Zip a sequence of keys with a sequence of values to obtain a dictionary.
-// create_unordered_map([1,2,3], ["one", "two"]) == {1: "one", 2: "two"}
-template <typename ContainerIn1, typename ContainerIn2,
-    typename Key = typename std::remove_const<typename ContainerIn1::value_type>::type,
-    typename Val = typename std::remove_const<typename ContainerIn2::value_type>::type,
-    typename MapOut = std::unordered_map<Key, Val>>
-MapOut create_unordered_map(
-    const ContainerIn1& keys,
-    const ContainerIn2& values)
-{
-    auto pairs = zip(keys, values);
-    return pairs_to_map<MapOut>(pairs);
+    template <typename F, typename ContainerIn>
+    auto group_globally_on_labeled(std::true_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        auto keys_and_groups = group_globally_on_hashed<std::vector<ContainerIn>>(f, xs);
+        std::vector<std::pair<key_of_t<F, ContainerIn>, ContainerIn>> result;
+        result.reserve(keys_and_groups.first.size());
+        for (std::size_t i = 0; i < keys_and_groups.first.size(); ++i) {
+            result.emplace_back(std::move(keys_and_groups.first[i]),
+                std::move(keys_and_groups.second[i]));
+        }
+        return result;
+    }
+
+    template <typename F, typename ContainerIn>
+    auto group_globally_on_labeled(std::false_type /* is_hashable */, F f, const ContainerIn& xs)
+    {
+        const auto group = [](auto f1, const auto& xs1) {
+            return group_globally_by(f1, xs1);
+        };
+        return internal::group_on_labeled_impl(group, f, xs);
+    }
 }
 
-// API search type: create_unordered_map_with : ((key -> val), [key]) -> Map key val
+// API search type: group_globally_on : ((a -> b), [a]) -> [[a]]
 // fwd bind count: 1
-// Take a list of keys and create a dictionary
-// generating the values by applying f to each key.
-// create_unordered_map_with(show, [1,2]) == {1: "1", 2: "2"}
-template <typename ContainerIn, typename F>
-auto create_unordered_map_with(F f, const ContainerIn& keys)
+// Arrange elements equal after applying a transformer into groups.
+// group_globally_on((mod 10), [12,34,22]) == [[12,22],[34]]
+// O(n) if the transformation results are hashable, O(n^2) otherwise.
+// If you need O(n*log(n)) for non-hashable ones, sort and then use group_on
+template <typename F, typename ContainerIn>
+auto group_globally_on(F f, const ContainerIn& xs)
 {
-    return create_unordered_map(keys, transform(f, keys));
+    return internal::group_globally_on(
+        internal::is_hashable<internal::key_of_t<F, ContainerIn>>(), f, xs);
 }
 
-// API search type: create_unordered_map_grouped : ((val -> key), [val]) -> Map key val
+// API search type: group_globally_on_labeled : ((a -> b), [a]) -> [(b, [a])]
 // fwd bind count: 1
-// Take a list of values and create a grouped dictionary
-// generating the keys by applying f to each key.
-// create_unordered_map_grouped(length, ["one", "three", "two"]) == {3: ["one", "two"], 5: ["three"]}
-// Also known as group_by
-template <typename ContainerIn, typename F>
-auto create_unordered_map_grouped(F f, const ContainerIn& values)
+// Arrange elements equal after applying a transformer into groups,
+// adding the transformation result as a label to the group.
+// group_globally_on_labeled((mod 10), [12,34,22]) == [(2,[12,22]),(4, [34])]
+// O(n) if the transformation results are hashable, O(n^2) otherwise.
+// If you need O(n*log(n)) for non-hashable ones, sort and then use group_on_labeled
+template <typename F, typename ContainerIn>
+auto group_globally_on_labeled(F f, const ContainerIn& xs)
 {
-    return pairs_to_unordered_map_grouped(zip(transform(f, values), values));
+    return internal::group_globally_on_labeled(
+        internal::is_hashable<internal::key_of_t<F, ContainerIn>>(), f, xs);
 }
 
-// API search type: get_from_map : (Map key val, key) -> Maybe val
-// fwd bind count: 1
-// Returns just the value of a key if key is present.
-// Otherwise returns nothing.
-template <typename MapType,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-maybe<Val> get_from_map(const MapType& map, const Key& key)
+// API search type: group_globally : [a] -> [[a]]
+// fwd bind count: 0
+// Arrange equal elements into groups.
+// group_globally([1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2,2,2],[3],[4],[5,5]]
+// O(n) if the elements are hashable, O(n^2) otherwise.
+// If you need O(n*log(n)) for non-hashable ones, sort and then use group
+template <typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut group_globally(const ContainerIn& xs)
 {
-    auto it = map.find(key);
-    if (it == std::end(map))
-        return nothing<Val>();
-    return just(it->second);
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    typedef typename ContainerIn::value_type T;
+    return internal::group_globally(internal::is_hashable<T>(), xs);
 }
 
-// API search type: get_from_map_unsafe : (Map key val, key) -> val
+// API search type: cluster_by : (((a, a) -> Bool), [a]) -> [[a]]
 // fwd bind count: 1
-// Returns the value of a key if key is present.
-// Crashes otherwise.
-template <typename MapType,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-Val get_from_map_unsafe(const MapType& map, const Key& key)
+// Groups connected components, stable regarding initial order.
+// cluster_by(\x y -> abs (y - x) <= 3), [2,3,6,4,12,11,20,23,8,4])
+// == [[2,3,6,4,12,11,8,4],[20,23]]
+// BinaryPredicate p is a connectivity check, being
+//  a) commutative (p(x,y) = p(y,x))
+//  b) reflexive (p(x,x) = true)
+//  c) not neccessarily transitive, but can be
+// O(n^2), memory complexity also O(n^2)
+template <typename BinaryPredicate, typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut cluster_by(BinaryPredicate p, const ContainerIn& xs)
 {
-    return unsafe_get_just(get_from_map(map, key));
-}
+    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
 
-// API search type: get_from_map_with_def : (Map key val, val, key) -> val
-// fwd bind count: 2
-// Returns the value of a key if key is present.
-// Otherwise returns the provided default.
-// Also known as prop_or.
-template <typename MapType,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-Val get_from_map_with_def(const MapType& map, const Val& defVal,
-    const Key& key)
-{
-    return just_with_default(defVal, get_from_map(map, key));
-}
+    typedef std::vector<unsigned char> bools;
+    bools zero_filled_row(size_of_cont(xs), 0);
 
-// API search type: get_first_from_map : (Map key val, [key]) -> Maybe val
-// fwd bind count: 1
-// Returns just the value of the first key present.
-// Otherwise returns nothing.
-template <typename MapType,
-    typename KeysContainer,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-maybe<Val> get_first_from_map(const MapType& map, const KeysContainer& keys)
-{
-    static_assert(std::is_same<typename KeysContainer::value_type, Key>::value,
-        "Key type does not match.");
-    for (const auto& key : keys) {
-        auto it = map.find(key);
-        if (it != std::end(map))
-            return just(it->second);
+    // adjecency matrix
+    typedef std::vector<bools> boolss;
+    boolss adj_mat(size_of_cont(xs), zero_filled_row);
+
+    for (const auto& idx_and_val_y : enumerate(xs)) {
+        auto idx_y = idx_and_val_y.first;
+        auto val_y = idx_and_val_y.second;
+        for (const auto& idx_and_val_x : enumerate(xs)) {
+            auto idx_x = idx_and_val_x.first;
+            auto val_x = idx_and_val_x.second;
+            if (internal::invoke(p, val_y, val_x)) {
+                adj_mat[idx_y][idx_x] = 1;
+            }
+        }
     }
-    return nothing<Val>();
-}
 
-// API search type: get_first_from_map_unsafe : (Map key val, [key]) -> val
-// fwd bind count: 1
-// Returns the value of the first key present.
-// Crashes otherwise.
-template <typename MapType,
-    typename KeysContainer,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-Val get_first_from_map_unsafe(const MapType& map, const KeysContainer& keys)
-{
-    return unsafe_get_just(get_first_from_map(map, keys));
-}
+    bools already_used = zero_filled_row;
+    auto is_already_used = [&](std::size_t i) -> bool {
+        return already_used[i] != 0;
+    };
 
-// API search type: get_first_from_map_with_def : (Map key val, val, [key]) -> val
-// fwd bind count: 2
-// Returns the value of the first key present.
-// Otherwise returns the provided default.
-template <typename MapType,
-    typename KeysContainer,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-Val get_first_from_map_with_def(const MapType& map, const Val& defVal,
-    const KeysContainer& keys)
-{
-    return just_with_default(defVal, get_first_from_map(map, keys));
-}
+    typedef std::vector<std::size_t> idxs;
+    typedef std::vector<idxs> idxss;
 
-// API search type: map_contains : (Map key val, key) -> Bool
-// fwd bind count: 1
-// Checks if a map contains a key.
-template <typename MapType, typename Key = typename MapType::key_type>
-bool map_contains(const MapType& map, const Key& key)
-{
-    auto it = map.find(key);
-    return it != std::end(map);
-}
+    auto bools_to_idxs = [](const bools& activations) -> idxs {
+        auto unsigned_char_to_bool = [](unsigned char x) {
+            return x != 0;
+        };
+        return find_all_idxs_by(unsigned_char_to_bool, activations);
+    };
 
-// API search type: map_keep_if : ((key -> Bool), Map key val) -> Map key val
-// fwd bind count: 1
-// Filters the map by keys.
-// map_keep_if(is_upper_case, {a: 1, b: 2, A: 3, C: 4}) == {A: 3, C: 4}
-// Also known as pick_by.
-template <typename MapType, typename Pred>
-MapType map_keep_if(Pred pred, const MapType& map)
-{
-    MapType result;
-    for (const auto& key_and_value : map) {
-        if (internal::invoke(pred, key_and_value.first)) {
-            result.insert(key_and_value);
+    idxss idx_clusters;
+    std::function<void(std::size_t)> process_idx = [&](std::size_t idx) -> void {
+        auto connected_idxs = bools_to_idxs(adj_mat[idx]);
+        auto new_connected_idxs = drop_if(is_already_used, connected_idxs);
+        if (is_empty(new_connected_idxs)) {
+            return;
+        }
+        idx_clusters.back() = append(idx_clusters.back(), new_connected_idxs);
+        for (const auto& new_idx : new_connected_idxs) {
+            already_used[new_idx] = 1;
+        }
+        for (const auto& new_idx : new_connected_idxs) {
+            process_idx(new_idx);
         }
+    };
+
+    typedef typename ContainerOut::value_type InnerContainerOut;
+
+    for (const auto& idx : all_idxs(xs)) {
+        if (is_already_used(idx)) {
+            continue;
+        }
+        *internal::get_back_inserter(idx_clusters) = idxs();
+        *internal::get_back_inserter(idx_clusters.back()) = idx;
+        already_used[idx] = 1;
+        process_idx(idx);
     }
-    return result;
-}
 
-// API search type: map_drop_if : ((key -> Bool), Map key val) -> Map key val
-// fwd bind count: 1
-// Filters the map by keys.
-// map_drop_if(is_lower_case, {a: 1, b: 2, A: 3, C: 4}) == {A: 3, C: 4}
-// Inverse of map_keep_if.
-template <typename MapType, typename Pred>
-MapType map_drop_if(Pred pred, const MapType& map)
-{
-    return map_keep_if(logical_not(pred), map);
-}
+    typedef typename ContainerIn::value_type T;
+
+    auto idx_to_val = [&](std::size_t idx) -> T {
+        return elem_at_idx(idx, xs);
+    };
 
-// API search type: map_keep : ([key], Map key val) -> Map key val
-// fwd bind count: 1
-// Keeps only the pairs of the map found in the key list.
-// map_keep([a, d], {a: 1, b: 2, c: 3, d: 4}) == {a: 1, d: 4}
-// map_keep([a, e, f], {a: 1, b: 2, c: 3, d: 4}) == {a: 1}
-// Also known as pick.
-template <typename MapType, typename KeyContainer>
-MapType map_keep(const KeyContainer& keys, const MapType& map)
-{
-    static_assert(std::is_same<
-                      typename KeyContainer::value_type,
-                      typename MapType::key_type>::value,
-        "Key types do not match.");
-    return map_keep_if(bind_2nd_of_2(is_elem_of<KeyContainer>, keys), map);
-}
+    auto idxs_to_vals = [&](const idxs& val_idxs) -> InnerContainerOut {
+        return transform_convert<InnerContainerOut>(idx_to_val, sort(val_idxs));
+    };
 
-// API search type: map_drop : ([key], Map key val) -> Map key val
-// fwd bind count: 1
-// Keeps only the pairs of the map not found in the key list.
-// Inverse of map_keep.
-// map_drop([b, c], {a: 1, b: 2, c: 3, d: 4}); == {a: 1, d: 4}
-template <typename MapType, typename KeyContainer>
-MapType map_drop(const KeyContainer& keys, const MapType& map)
-{
-    static_assert(std::is_same<
-                      typename KeyContainer::value_type,
-                      typename MapType::key_type>::value,
-        "Key types do not match.");
-    return map_drop_if(bind_2nd_of_2(is_elem_of<KeyContainer>, keys), map);
+    return transform_convert<ContainerOut>(idxs_to_vals, idx_clusters);
 }
 
-// API search type: map_keep_if_value : ((val -> Bool), Map key val) -> Map key val
-// fwd bind count: 1
-// Filters the map by values.
-// map_keep_if_value(is_upper_case, {1: a, 2: b, 3: A, 4: C}) == {3: A, 4: C}
-// Also known as filter_values.
-template <typename MapType, typename Pred>
-MapType map_keep_if_value(Pred pred, const MapType& map)
+// API search type: split_by : ((a -> Bool), Bool, [a]) -> [[a]]
+// fwd bind count: 2
+// Split a sequence at every element fulfilling a predicate.
+// The splitting elements are discarded.
+// split_by(is_even, true, [1,3,2,2,5,5,3,6,7,9]) == [[1,3],[],[5,5,3],[7,9]]
+// also known as split_when
+// O(n)
+template <typename UnaryPredicate, typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut split_by(UnaryPredicate pred, bool allow_empty, const ContainerIn& xs)
 {
-    MapType result;
-    for (const auto& key_and_value : map) {
-        if (internal::invoke(pred, key_and_value.second)) {
-            result.insert(key_and_value);
+    internal::check_unary_predicate_for_container<UnaryPredicate, ContainerIn>();
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+
+    if (allow_empty && is_empty(xs)) {
+        return { {} };
+    }
+
+    ContainerOut result;
+    auto itOut = internal::get_back_inserter(result);
+    auto start = std::begin(xs);
+
+    while (start != std::end(xs)) {
+        const auto stop = std::find_if(start, std::end(xs), pred);
+        if (start != stop || allow_empty) {
+            *itOut = { start, stop };
+        }
+        if (stop == std::end(xs)) {
+            break;
+        }
+        start = internal::add_to_iterator(stop);
+        if (allow_empty && start == std::end(xs)) {
+            *itOut = typename ContainerOut::value_type();
         }
     }
     return result;
 }
 
-// API search type: map_drop_if_value : ((value -> Bool), Map key val) -> Map key val
+// API search type: split_by_keep_separators : ((a -> Bool), [a]) -> [[a]]
 // fwd bind count: 1
-// Filters the map by values.
-// map_drop_if_value(is_lower_case, {1: a, 2: b, 3: A, 4: C}) == {3: A, 4: C}
-// Inverse of map_keep_if_value.
-template <typename MapType, typename Pred>
-MapType map_drop_if_value(Pred pred, const MapType& map)
+// Split a sequence at every element fulfilling a predicate.
+// The splitting elements are kept.
+// split_by_keep_separators(is_even, true, [1,3,2,2,5,5,3,6,7,9])
+// == [[1,3],[2],[2,5,5,3],[6,7,9]]
+// O(n)
+template <typename UnaryPredicate, typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut split_by_keep_separators(UnaryPredicate pred, const ContainerIn& xs)
 {
-    return map_keep_if_value(logical_not(pred), map);
+    internal::check_unary_predicate_for_container<UnaryPredicate, ContainerIn>();
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    ContainerOut result;
+    if (is_empty(xs))
+        return result;
+    auto itOut = internal::get_back_inserter(result);
+    auto start = std::begin(xs);
+    while (start != std::end(xs)) {
+        const auto stop = std::find_if(
+            internal::add_to_iterator(start), std::end(xs), pred);
+        *itOut = { start, stop };
+        if (stop == std::end(xs)) {
+            break;
+        }
+        start = stop;
+    }
+    return result;
 }
 
-// API search type: map_keep_values : ([value], Map key val) -> Map key val
-// fwd bind count: 1
-// Keeps only the pairs of the map found in the value list.
-// map_keep_values([1, 4], {a: 1, b: 2, c: 3, d: 4}) == {a: 1, d: 4}
-// map_keep_values([1, 5, 6], {a: 1, b: 2, c: 3, d: 4}) == {a: 1}
-template <typename MapType, typename ValueContainer>
-MapType map_keep_values(const ValueContainer& values, const MapType& map)
+// API search type: split : (a, Bool, [a]) -> [[a]]
+// fwd bind count: 2
+// Split a sequence at every element equal to x.
+// The splitting elements are discarded.
+// split(0, true, [1,3,2,0,0,6,0,7,5]) == [[1,3,2],[],[6],[7,5]]
+// O(n)
+template <typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+auto split(const T& x, bool allow_empty, const ContainerIn& xs)
 {
-    static_assert(std::is_same<
-                      typename ValueContainer::value_type,
-                      typename MapType::mapped_type>::value,
-        "Value types do not match.");
-    return map_keep_if_value(
-        bind_2nd_of_2(is_elem_of<ValueContainer>, values), map);
+    return split_by(is_equal_to(x), allow_empty, xs);
 }
 
-// API search type: map_drop_values : ([value], Map key val) -> Map key val
-// fwd bind count: 1
-// Keeps only the pairs of the map not found in the value list.
-// Inverse of map_keep_values.
-// map_drop_values([2, 3], {a: 1, b: 2, c: 3, d: 4}) == {a: 1, d: 4}
-template <typename MapType, typename ValueContainer>
-MapType map_drop_values(const ValueContainer& values, const MapType& map)
+// API search type: split_one_of : ([a], Bool, [a]) -> [[a]]
+// fwd bind count: 2
+// Split a sequence at every element present in delimiters.
+// The splitting elements are discarded.
+// Also known as split_words_by_many.
+// split_one_of([0,3], true [1,3,2,0,0,6,0,7,5]) == [[1],[2],[],[6],[7,5]]
+// split_one_of(" o", false, "How are u?") == ["H","w","are","u?"]
+// O(n)
+template <typename ContainerIn,
+    typename ContainerDelims>
+auto split_one_of(
+    const ContainerDelims delimiters, bool allow_empty, const ContainerIn& xs)
 {
-    static_assert(std::is_same<
-                      typename ValueContainer::value_type,
-                      typename MapType::mapped_type>::value,
-        "Value types do not match.");
-    return map_drop_if_value(
-        bind_2nd_of_2(is_elem_of<ValueContainer>, values), map);
+    const auto pred = [&](const typename ContainerIn::value_type& x) -> bool {
+        return is_elem_of(x, delimiters);
+    };
+    return split_by(pred, allow_empty, xs);
 }
 
-// API search type: map_pluck : (key, [Map key val]) -> [val]
+// API search type: split_keep_separators : ((a -> Bool), [a]) -> [[a]]
 // fwd bind count: 1
-// Extracts values to a specific key from a list of maps.
-// map_pluck('a', [{a: 1, b: 2}, {a: 3}, {c: 4}]) == [Just 1, Just 3, Nothing]
-template <typename MapContainer,
-    typename ContainerOut = std::vector<maybe<typename MapContainer::value_type::mapped_type>>,
-    typename MapType = typename MapContainer::value_type,
-    typename Key = typename MapType::key_type,
-    typename Val = typename MapType::mapped_type>
-ContainerOut map_pluck(const Key& key, const MapContainer& maps)
+// Split a sequence at every element equal to x.
+// The splitting elements are kept.
+// split_keep_separators(2, true, [1,3,2,2,5,5,3,2,7,9])
+// == [[1,3],[2],[2,5,5,3],[6,7,9]]
+// O(n)
+template <typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+auto split_keep_separators(const T& x, const ContainerIn& xs)
 {
-    return transform_convert<ContainerOut>(
-        bind_2nd_of_2(get_from_map<MapType>, key), maps);
+    return split_by_keep_separators(is_equal_to(x), xs);
 }
 
-// API search type: choose : ([(a, b)], a) -> Maybe b
+// API search type: split_at_idx : (Int, [a]) -> ([a], [a])
 // fwd bind count: 1
-// Selects a value assigned to a key iff the key exists exactly once.
-// choose([(1,a), (2,b)], 2) == Just b;
-// choose([(1,a), (1,b)], 2) == Nothing;
-// choose([(1,a), (2,b)], 3) == Nothing;
-template <typename Key, typename Val>
-maybe<Val> choose(const std::vector<std::pair<Key, Val>>& pairs, const Key& x)
+// Split a sequence at a specific position.
+// split_at_idx(2, [0,1,2,3,4]) == ([0,1],[2,3,4])
+template <typename Container>
+std::pair<Container, Container> split_at_idx(std::size_t idx, const Container& xs)
 {
-    if (count(x, transform(fst<Key, Val>, pairs)) != 1)
-        return {};
-    return get_from_map(pairs_to_map<std::unordered_map<Key, Val>>(pairs), x);
+    assert(idx <= size_of_cont(xs));
+    return make_pair(get_segment(0, idx, xs),
+        get_segment(idx, size_of_cont(xs), xs));
 }
 
-// API search type: choose_by : ([((a -> Bool), b)], a) -> Maybe b
+// API search type: insert_at_idx : (Int, a, [a]) -> [a]
 // fwd bind count: 2
-// Iff exactly one predicate is fulfilled
-// the value assigned to this predicate is selected.
-// choose_by([(is_even,a), (is_bigger_than_3,b)], 2) == Just a;
-// choose_by([(is_even,a), (is_bigger_than_3,b)], 5) == Just b;
-// choose_by([(is_even,a), (is_bigger_than_3,b)], 1) == Nothing;
-// choose_by([(is_even,a), (is_bigger_than_3,b)], 4) == Nothing;
-template <typename Key, typename Val>
-maybe<Val> choose_by(
-    const std::vector<std::pair<std::function<bool(const Key&)>, Val>>& pairs,
-    const Key& x)
+// Insert an element into a sequence at a specific position.
+// insert_at_idx(2, 0, [1,2,3,4]) == [1,2,0,3,4].
+template <typename Container,
+    typename T = typename Container::value_type>
+Container insert_at_idx(std::size_t idx, const T& x, const Container& xs)
 {
-    maybe<Val> result;
-    for (const auto& p : pairs) {
-        if (internal::invoke(p.first, x)) {
-            if (is_just(result)) {
-                return nothing<Val>();
-            }
-            result = p.second;
-        }
+    const auto splitted = split_at_idx(idx, xs);
+    return concat(std::vector<Container>(
+        { splitted.first,
+            singleton_seq<T, Container>(x),
+            splitted.second }));
+}
+
+// API search type: partition : ((a -> Bool), [a]) -> ([a], [a])
+// fwd bind count: 1
+// Split a sequence into two groups.
+// The first group contains all elements fulfilling the predicate.
+// The second group contains the remaining elements.
+// partition(is_even, [0,1,1,3,7,2,3,4]) == ([0,2,4],[1,1,3,7,3])
+template <typename UnaryPredicate, typename Container>
+std::pair<Container, Container> partition(UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    Container matching;
+    Container notMatching;
+    auto itOutMatching = internal::get_back_inserter(matching);
+    auto itOutNotMatching = internal::get_back_inserter(notMatching);
+    for (const auto& x : xs) {
+        if (internal::invoke(pred, x))
+            *itOutMatching = x;
+        else
+            *itOutNotMatching = x;
     }
-    return result;
+    return make_pair(matching, notMatching);
 }
 
-// API search type: choose_lazy : ([(a, (() -> b))], a) -> Maybe b
+// API search type: split_at_idxs : ([Int], [a]) -> [[a]]
 // fwd bind count: 1
-// Evaluates a lazy value assigned to a key iff the key exists exactly once.
-// choose_lazy([(1,a), (2,b)], 2) == Just b();
-// choose_lazy([(1,a), (1,b)], 2) == Nothing;
-// choose_lazy([(1,a), (2,b)], 3) == Nothing;
-template <typename Key, typename ValStub>
-auto choose_lazy(const std::vector<std::pair<Key, ValStub>>& pairs,
-    const Key& x)
+// Split a sequence at specific indices.
+// split_at_idxs([2,5], [0,1,2,3,4,5,6,7]) == [[0,1],[2,3,4],[5,6,7]]
+// split_at_idxs([2,5,5], [0,1,2,3,4,5,6,7]) == [[0,1],[2,3,4],[],[5,6,7]]
+template <typename ContainerIdxs, typename ContainerIn,
+    typename ContainerOut = std::vector<ContainerIn>>
+ContainerOut split_at_idxs(const ContainerIdxs& idxsIn, const ContainerIn& xs)
 {
-    using Ret = maybe<std::decay_t<internal::invoke_result_t<ValStub>>>;
-    const auto res = choose(pairs, x);
-    if (res.is_nothing())
-        return Ret {};
-    else
-        return Ret { res.unsafe_get_just()() };
+    static_assert(std::is_same<typename ContainerIdxs::value_type, std::size_t>::value,
+        "Indices must be std::size_t");
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    ContainerIdxs idxStartC = { 0 };
+    ContainerIdxs idxEndC = { size_of_cont(xs) };
+    std::vector<ContainerIdxs> containerIdxss = { idxStartC, idxsIn, idxEndC };
+    auto idxs = concat(containerIdxss);
+    auto idxsClean = sort(idxs);
+    ContainerOut result;
+    internal::prepare_container(result, size_of_cont(idxsClean) - 1);
+    auto itOut = internal::get_back_inserter(result);
+    auto idxPairs = overlapping_pairs(idxsClean);
+    for (const auto& idxPair : idxPairs) {
+        *itOut = get_segment(idxPair.first, idxPair.second, xs);
+    }
+    return result;
 }
 
-// API search type: choose_by_lazy : ([((a -> Bool), (() -> b))], a) -> Maybe b
-// fwd bind count: 2
-// Iff exactly one predicate is fulfilled
-// the lazy value assigned to this predicate is evaluated.
-// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 2) == Just a();
-// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 5) == Just b();
-// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 1) == Nothing;
-// choose_by_lazy([(is_even,a), (is_bigger_than_3,b)], 4) == Nothing;
-template <typename Key, typename ValStub>
-auto choose_by_lazy(
-    const std::vector<std::pair<std::function<bool(const Key&)>, ValStub>>& pairs,
-    const Key& x)
+// API search type: split_every : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Split a sequence every n elements.
+// split_every(3, [0,1,2,3,4,5,6,7]) == [[0,1,2],[3,4,5],[6,7]]
+// Also known as chunk or chunks.
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<ContainerIn>>
+ContainerOut split_every(std::size_t n, const ContainerIn& xs)
 {
-    using Ret = maybe<std::decay_t<internal::invoke_result_t<ValStub>>>;
-
-    const auto res = choose_by(pairs, x);
-    if (res.is_nothing())
-        return Ret {};
-    else
-        return Ret { res.unsafe_get_just()() };
+    return split_at_idxs<
+        std::vector<std::size_t>,
+        ContainerIn,
+        ContainerOut>(
+        numbers_step<std::size_t>(
+            n, size_of_cont(xs), n),
+        xs);
 }
 
-// API search type: choose_def : (b, [(a, b)], a) -> b
+// API search type: split_every_view : (Int, [a]) -> [[a]]
 // fwd bind count: 1
-// Selects a value assigned to a key iff the key exists exactly once,
-// otherwise returns the given default value.
-// choose_def(c, [(1,a), (2,b)], 2) == b;
-// choose_def(c, [(1,a), (1,b)], 2) == c;
-// choose_def(c, [(1,a), (2,b)], 3) == c;
-template <typename Key, typename Val>
-Val choose_def(const Val& def,
-    const std::vector<std::pair<Key, Val>>& pairs, const Key& x)
+// Same as split_every, but the chunks are views into xs
+// computed on access, so no element is copied.
+// xs has to outlive the result.
+// split_every_view(3, [0,1,2,3,4,5,6,7]) == [[0,1,2],[3,4,5],[6,7]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> split_every_view(std::size_t n, const ContainerIn& xs)
 {
-    if (count(x, transform(fst<Key, Val>, pairs)) != 1)
-        return def;
-    return get_from_map_with_def(
-        pairs_to_map<std::unordered_map<Key, Val>>(pairs), def, x);
+    assert(n > 0);
+    const std::size_t n_chunks = std::max<std::size_t>(1,
+        div_pos_int_ceil(size_of_cont(xs), n));
+    return internal::window_range<ContainerIn>(xs, n_chunks, n, n);
 }
 
-// API search type: choose_by_def : (b, [((a -> Bool), b)], a) -> b
-// fwd bind count: 2
-// Iff exactly one predicate is fulfilled
-// the value assigned to this predicate is selected.
-// Otherwise the given default value is returned.
-// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 2) == Just a;
-// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 5) == Just b;
-// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 1) == c;
-// choose_by_def(c, [(is_even,a), (is_bigger_than_3,b)], 4) == c;
-template <typename Key, typename Val>
-Val choose_by_def(const Val& def,
-    const std::vector<std::pair<std::function<bool(const Key&)>, Val>>& pairs,
-    const Key& x)
+template <typename ContainerIn>
+void split_every_view(std::size_t, const ContainerIn&&) = delete;
+
+// API search type: split_evenly : (Int, [a]) -> [[a]]
+// fwd bind count: 1
+// Split a sequence into n similarly-sized chunks.
+// split_evenly(2, [0,1,2,3,4]) == [[0,1,2],[3,4]]
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<ContainerIn>>
+ContainerOut split_evenly(std::size_t n, const ContainerIn& xs)
 {
-    return just_with_default(def, choose_by(pairs, x));
+    const std::size_t every_n = div_pos_int_ceil(size_of_cont(xs), n);
+    return split_at_idxs<
+        std::vector<std::size_t>,
+        ContainerIn,
+        ContainerOut>(
+        numbers_step<std::size_t>(
+            every_n, size_of_cont(xs), every_n),
+        xs);
 }
 
-// API search type: choose_def_lazy : ((() -> b), [(a, (() -> b))], a) -> b
+// API search type: split_evenly_view : (Int, [a]) -> [[a]]
 // fwd bind count: 1
-// Evaluates a lazy value assigned to a key iff the key exists exactly once,
-// otherwise evaluates the given default lazy value.
-// choose_def_lazy(c, [(1,a), (2,b)], 2) == b();
-// choose_def_lazy(c, [(1,a), (1,b)], 2) == c();
-// choose_def_lazy(c, [(1,a), (2,b)], 3) == c();
-template <typename Key, typename ValStub>
-auto choose_def_lazy(const ValStub& def,
-    const std::vector<std::pair<Key, ValStub>>& pairs,
-    const Key& x)
+// Same as split_evenly, but the chunks are views into xs
+// computed on access, so no element is copied.
+// xs has to outlive the result.
+// split_evenly_view(2, [0,1,2,3,4]) == [[0,1,2],[3,4]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> split_evenly_view(std::size_t n, const ContainerIn& xs)
 {
-    return choose_def(def, pairs, x)();
+    const std::size_t every_n = std::max<std::size_t>(1,
+        div_pos_int_ceil(size_of_cont(xs), n));
+    return split_every_view(every_n, xs);
 }
 
-// API search type: choose_by_def_lazy : ((() -> b), [((a -> Bool), (() -> b))], a) -> b
+template <typename ContainerIn>
+void split_evenly_view(std::size_t, const ContainerIn&&) = delete;
+
+// API search type: split_by_token : ([a], Bool, [a]) -> [[a]]
 // fwd bind count: 2
-// Iff exactly one predicate is fulfilled
-// the value assigned to this predicate is evaluated.
-// Otherwise the given default value is evaluated and returned.
-// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 2) == Just a();
-// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 5) == Just b();
-// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 1) == c();
-// choose_by_def_lazy(c, [(is_even,a), (is_bigger_than_3,b)], 4) == c();
-template <typename Key, typename ValStub>
-auto choose_by_def_lazy(
-    const ValStub& def,
-    const std::vector<std::pair<std::function<bool(const Key&)>, ValStub>>& pairs,
-    const Key& x)
+// Split a sequence at every segment matching a token.
+// split_by_token(", ", true, "foo, bar, baz") == ["foo", "bar", "baz"]
+template <typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut split_by_token(const ContainerIn& token,
+    bool allow_empty, const ContainerIn& xs)
 {
-    return choose_by_def(def, pairs, x)();
-}
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
+    const auto token_begins = find_all_instances_of_token_non_overlapping(token, xs);
+    const auto token_ends = transform(add_to<std::size_t>(size_of_cont(token)), token_begins);
+    assert(is_sorted(interweave(token_begins, token_ends)));
 
-} // namespace fplus
+    typedef std::vector<std::size_t> idx_vec;
+    const auto segments = zip(
+        fplus::append(idx_vec(1, 0), token_ends),
+        fplus::append(token_begins, idx_vec(1, size_of_cont(xs))));
 
-//
-// split.hpp
-//
+    ContainerOut result;
+    auto itOut = internal::get_back_inserter(result);
+    for (const auto& segment : segments) {
+        if (segment.first != segment.second || allow_empty)
+            *itOut = get_segment(segment.first, segment.second, xs);
+    }
+    return result;
+}
 
-// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
-// https://github.com/Dobiasd/FunctionalPlus
-// Distributed under the Boost Software License, Version 1.0.
-// (See accompanying file LICENSE_1_0.txt or copy at
-//  http://www.boost.org/LICENSE_1_0.txt)
+#if __cplusplus >= 201703L
 
+// The following *_view versions of the splitting functions
+// return std::basic_string_view segments pointing into the input
+// instead of copying every segment into a new string.
+// The input has to outlive the result, so temporaries are not accepted.
+// They have no fwd instances, since they need C++17.
+
+// API search type: split_by_view : ((Char -> Bool), Bool, String) -> [StringView]
+// Split a string at every character fulfilling a predicate.
+// split_by_view(is_whitespace, false, "a b  c") == ["a", "b", "c"]
+// O(n)
+template <typename UnaryPredicate, typename String>
+auto split_by_view(UnaryPredicate pred, bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    return internal::split_string_view([&pred](View s, std::size_t pos) {
+        const auto it = std::find_if(std::begin(s) + static_cast<std::ptrdiff_t>(pos), std::end(s), pred);
+        const std::size_t idx = it == std::end(s)
+            ? View::npos
+            : static_cast<std::size_t>(std::distance(std::begin(s), it));
+        return std::make_pair(idx, idx + 1);
+    },
+        allow_empty, view);
+}
 
+// API search type: split_view : (Char, Bool, String) -> [StringView]
+// Split a string at every occurrence of a character.
+// split_view(',', true, "a,,b") == ["a", "", "b"]
+// O(n)
+template <typename String, typename Char>
+auto split_view(Char x, bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    return internal::split_string_view([x](View s, std::size_t pos) {
+        const std::size_t idx = s.find(x, pos);
+        return std::make_pair(idx, idx + 1);
+    },
+        allow_empty, view);
+}
+
+// API search type: split_one_of_view : (String, Bool, String) -> [StringView]
+// Split a string at every character present in delimiters.
+// split_one_of_view(" o", false, "How are u?") == ["H","w","are","u?"]
+// O(n * m), m being the number of delimiters
+template <typename Delimiters, typename String>
+auto split_one_of_view(const Delimiters& delimiters,
+    bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    const View delims(delimiters.data(), delimiters.size());
+    return internal::split_string_view([delims](View s, std::size_t pos) {
+        const std::size_t idx = s.find_first_of(delims, pos);
+        return std::make_pair(idx, idx + 1);
+    },
+        allow_empty, view);
+}
+
+// API search type: split_by_token_view : (String, Bool, String) -> [StringView]
+// Split a string at every non-overlapping occurrence of a token.
+// split_by_token_view(", ", true, "foo, bar, baz") == ["foo", "bar", "baz"]
+// An empty token does not split the string.
+template <typename Token, typename String>
+auto split_by_token_view(const Token& token, bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    const View tok(token.data(), token.size());
+    return internal::split_string_view([tok](View s, std::size_t pos) {
+        const std::size_t idx = tok.empty() ? View::npos : s.find(tok, pos);
+        return std::make_pair(idx, idx + tok.size());
+    },
+        allow_empty, view);
+}
 
+#endif
 
-//
-// internal/split.hpp
-//
+// API search type: run_length_encode_by : (((a, a) -> Bool), [a]) -> [(Int, a)]
+// fwd bind count: 1
+// RLE using a specific binary predicate as equality check.
+// run_length_encode_by((==),[1,2,2,2,2,3,3,2)) == [(1,1),(4,2),(2,3),(1,2)]
+template <typename BinaryPredicate,
+    typename ContainerIn,
+    typename T = typename ContainerIn::value_type,
+    typename ContainerOut =
+        typename std::vector<std::pair<std::size_t, T>>>
+ContainerOut run_length_encode_by(BinaryPredicate pred, const ContainerIn& xs)
+{
+    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
+    ContainerOut result;
+    auto groups = group_by(pred, xs);
+    auto group_to_pair = [](const ContainerIn& group) -> std::pair<std::size_t, T> {
+        return std::make_pair(size_of_cont(group), group.front());
+    };
+    return transform(group_to_pair, groups);
+}
 
-// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
-// https://github.com/Dobiasd/FunctionalPlus
-// Distributed under the Boost Software License, Version 1.0.
-// (See accompanying file LICENSE_1_0.txt or copy at
-//  http://www.boost.org/LICENSE_1_0.txt)
+// API search type: run_length_encode : [a] -> [(Int, a)]
+// fwd bind count: 0
+// RLE.
+// run_length_encode([1,2,2,2,2,3,3,2)) == [(1,1),(4,2),(2,3),(1,2)]
+template <typename ContainerIn,
+    typename T = typename ContainerIn::value_type>
+auto run_length_encode(const ContainerIn& xs)
+{
+    return run_length_encode_by(is_equal<T>, xs);
+}
 
+// API search type: run_length_decode : [(Int, a)] -> [a]
+// fwd bind count: 0
+// Inverse operation to run_length_encode.
+// run_length_decode([(1,1),(4,2),(2,3),(1,2)]) == [1,2,2,2,2,3,3,2)
+template <typename ContainerIn,
+    typename Pair = typename ContainerIn::value_type,
+    typename Cnt = typename Pair::first_type>
+auto run_length_decode(const ContainerIn& pairs)
+{
+    static_assert(std::is_convertible<Cnt, std::size_t>::value,
+        "Count type must be convertible to std::size_t.");
+    const auto pair_to_vec =
+        [](const Pair& p) {
+            return replicate(p.first, p.second);
+        };
+    return concat(transform(pair_to_vec, pairs));
+}
 
-#include <iterator>
-#include <utility>
+// API search type: span : ((a -> Bool), [a]) -> ([a], [a])
+// fwd bind count: 1
+// span, applied to a predicate p and a list xs,
+// returns a tuple where first element is longest prefix (possibly empty)
+// of xs of elements that satisfy p
+// and second element is the remainder of the list.
+// span(is_even, [0,2,4,5,6,7,8]) == ([0,2,4], [5,6,7,8])
+template <typename Container, typename UnaryPredicate>
+std::pair<Container, Container> span(UnaryPredicate pred, const Container& xs)
+{
+    auto maybeIdx = find_first_idx_by(logical_not(pred), xs);
+    return {
+        take(just_with_default<std::size_t>(size_of_cont(xs), maybeIdx), xs),
+        drop(just_with_default<std::size_t>(size_of_cont(xs), maybeIdx), xs)
+    };
+}
 
+// API search type: divvy : (Int, Int, [a]) -> [[a]]
+// fwd bind count: 2
+// Generates subsequences overlapping with a specific step.
+// divvy(5, 2, [0,1,2,3,4,5,6,7,8,9]) == [[0,1,2,3,4],[2,3,4,5,6],[4,5,6,7,8]]
+// divvy(length, 1, xs) is also known as aperture
+// divvy(1, step, xs) is also known as stride
+//     (but withouts the nested lists in the result)
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<ContainerIn>>
+ContainerOut divvy(std::size_t length, std::size_t step, const ContainerIn& xs)
+{
+    assert(length > 0);
+    assert(step > 0);
+    const auto start_idxs = numbers_step<std::size_t>(
+        0, size_of_cont(xs) - (length - 1), step);
 
+    ContainerOut result;
+    internal::prepare_container(result, size_of_cont(start_idxs));
+    auto itOut = internal::get_back_inserter(result);
 
-namespace fplus {
-namespace internal {
-    template <typename GroupByCallable, typename F, typename ContainerIn>
-    auto group_on_labeled_impl(GroupByCallable group, F f, const ContainerIn& xs)
-    {
-        const auto grouped = group(is_equal_by(f), xs);
-        const auto attach_label = [f](const auto& g) {
-            using std::begin;
-            return std::make_pair(internal::invoke(f, *begin(g)), g);
-        };
-        return fplus::transform(attach_label, grouped);
+    for (const auto start_idx : start_idxs) {
+        *itOut = get_segment(start_idx, start_idx + length, xs);
     }
+    return result;
 }
+
+// API search type: divvy_view : (Int, Int, [a]) -> [[a]]
+// fwd bind count: 2
+// Same as divvy, but the subsequences are views into xs
+// computed on access, so memory usage does not grow with length.
+// xs has to outlive the result.
+// divvy_view(5, 2, [0,1,2,3,4,5,6,7,8,9]) == [[0,1,2,3,4],[2,3,4,5,6],[4,5,6,7,8]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> divvy_view(
+    std::size_t length, std::size_t step, const ContainerIn& xs)
+{
+    assert(length > 0);
+    assert(step > 0);
+    const std::size_t size = size_of_cont(xs);
+    const std::size_t n_windows = size < length ? 0 : (size - length) / step + 1;
+    return internal::window_range<ContainerIn>(xs, n_windows, length, step);
 }
 
-namespace fplus {
+template <typename ContainerIn>
+void divvy_view(std::size_t, std::size_t, const ContainerIn&&) = delete;
 
-// API search type: group_by : (((a, a) -> Bool), [a]) -> [[a]]
+// API search type: aperture : (Int, [a]) -> [[a]]
 // fwd bind count: 1
-// Arrange the elements into groups using a given predicate.
-// Only groups of consecutive elements are formed.
-// For a version scanning the whole container see group_globally_by.
-// group_by((==), [1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2],[3],[2,2],[4],[5,5]]
-// BinaryPredicate p is a (not neccessarily transitive) connectivity check.
-// O(n)
-template <typename BinaryPredicate, typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut group_by(BinaryPredicate p, const ContainerIn& xs)
+// Generates overlapping subsequences.
+// aperture(5, [0,1,2,3,4,5,6]) == [[0,1,2,3,4],[1,2,3,4,5],[2,3,4,5,6]]
+template <typename ContainerIn,
+    typename ContainerOut = std::vector<ContainerIn>>
+ContainerOut aperture(std::size_t length, const ContainerIn& xs)
 {
-    // ContainerOut is not deduced to
-    // SameContNewType(ContainerIn, ContainerIn)
-    // here, since ContainerIn could be a std::string.
-    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
+    assert(length > 0);
+    const auto start_idxs = numbers<std::size_t>(
+        0, size_of_cont(xs) - (length - 1));
+
     ContainerOut result;
-    if (is_empty(xs))
-        return result;
-    typedef typename ContainerOut::value_type InnerContainerOut;
-    *internal::get_back_inserter(result) = InnerContainerOut(1, xs.front());
-    for (auto it = ++std::begin(xs); it != std::end(xs); ++it) {
-        if (internal::invoke(p, result.back().back(), *it))
-            *internal::get_back_inserter(result.back()) = *it;
-        else
-            *internal::get_back_inserter(result) = InnerContainerOut(1, *it);
+    internal::prepare_container(result, size_of_cont(start_idxs));
+    auto itOut = internal::get_back_inserter(result);
+
+    for (const auto start_idx : start_idxs) {
+        *itOut = get_segment(start_idx, start_idx + length, xs);
     }
     return result;
 }
 
-// API search type: group_on : ((a -> b), [a]) -> [[a]]
+// API search type: aperture_view : (Int, [a]) -> [[a]]
 // fwd bind count: 1
-// Arrange elements equal after applying a transformer into groups.
-// Only groups of consecutive elements are formed.
-// For a version scanning the whole container see group_globally_on.
-// group_on((mod 10), [12,22,34]) == [[12,22],[34]]
-// O(n)
-template <typename F, typename ContainerIn>
-auto group_on(F f, const ContainerIn& xs)
+// Same as aperture, but the subsequences are views into xs
+// computed on access, so memory usage does not grow with length.
+// xs has to outlive the result.
+// aperture_view(5, [0,1,2,3,4,5,6]) == [[0,1,2,3,4],[1,2,3,4,5],[2,3,4,5,6]]
+template <typename ContainerIn>
+internal::window_range<ContainerIn> aperture_view(std::size_t length, const ContainerIn& xs)
 {
-    return group_by(is_equal_by(f), xs);
+    return divvy_view(length, 1, xs);
 }
 
-// API search type: group_on_labeled : ((a -> b), [a]) -> [(b, [a])]
+template <typename ContainerIn>
+void aperture_view(std::size_t, const ContainerIn&&) = delete;
+
+// API search type: stride : (Int, [a]) -> [a]
 // fwd bind count: 1
-// Arrange elements equal after applying a transformer into groups,
-// adding the transformation result as a label to the group.
-// Only groups of consecutive elements are formed.
-// For a version scanning the whole container see group_globally_on_labeled.
-// group_on_labeled((mod 10), [12,22,34]) == [(2,[12,22]), (4,[34])]
-// O(n)
-template <typename F, typename ContainerIn>
-auto group_on_labeled(F f, const ContainerIn& xs)
+// Keeps every nth element.
+// stride(3, [0,1,2,3,4,5,6,7]) == [0,3,6]
+template <typename Container>
+Container stride(std::size_t step, const Container& xs)
 {
-    const auto group = [](auto f1, const auto& xs1) {
-        return group_by(f1, xs1);
-    };
-
-    return internal::group_on_labeled_impl(group, f, xs);
+    assert(step > 0);
+    Container ys;
+    auto it = internal::get_back_inserter<Container>(ys);
+    auto it_in = std::begin(xs);
+    std::size_t i = 0;
+    const auto xs_size = size_of_cont(xs);
+    while (it_in != std::end(xs)) {
+        *it = *it_in;
+        std::size_t increment = std::min(step, xs_size - i);
+        internal::advance_iterator(it_in, increment);
+        i += increment;
+    }
+    return ys;
 }
 
-// API search type: group : [a] -> [[a]]
-// fwd bind count: 0
-// Arrange equal elements into groups.
-// Only groups of consecutive elements are formed.
-// For a version scanning the whole container see group_globally.
-// group([1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2],[3],[2,2],[4],[5,5]]
-// O(n)
-template <typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut group(const ContainerIn& xs)
+// API search type: stride_view : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as stride, but the elements are not copied.
+// xs has to outlive the result.
+// stride_view(3, [0,1,2,3,4,5,6,7]) == [0,3,6]
+template <typename Container>
+internal::stride_range<Container> stride_view(std::size_t step, const Container& xs)
 {
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
-    typedef typename ContainerIn::value_type T;
-    auto pred = [](const T& x, const T& y) { return x == y; };
-    return group_by<decltype(pred), ContainerIn, ContainerOut>(pred, xs);
+    assert(step > 0);
+    return internal::stride_range<Container>(xs, step);
 }
 
-// API search type: group_globally_by : (((a, a) -> Bool), [a]) -> [[a]]
-// fwd bind count: 1
-// Arrange equal elements into groups.
-// group_globally_by((==), [1,2,2,2,3,2,2,4,5,5])
-// == [[1],[2,2,2,2,2],[3],[4],[5,5]]
-// BinaryPredicate p is a
-// transitive (whenever p(x,y) and p(y,z), then also p(x,z)) equality check.
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group_by
-template <typename BinaryPredicate, typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut group_globally_by(BinaryPredicate p, const ContainerIn& xs)
-{
-    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
-    typedef typename ContainerOut::value_type InnerContainerOut;
-    ContainerOut result;
-    for (const auto& x : xs) {
-        bool found = false;
-        for (auto& ys : result) {
-            if (internal::invoke(p, x, ys.back())) {
-                *internal::get_back_inserter(ys) = x;
-                found = true;
-                break;
-            }
+template <typename Container>
+void stride_view(std::size_t, const Container&&) = delete;
+
+namespace internal {
+
+    template <typename Container>
+    Container winsorize(internal::reuse_container_t,
+        double trim_ratio, Container&& xs)
+    {
+        const std::size_t n = size_of_cont(xs);
+        if (n == 1 || n == 0) {
+            return std::forward<Container>(xs);
         }
-        if (!found) {
-            *internal::get_back_inserter(result) = InnerContainerOut(1, x);
+        trim_ratio = std::max(trim_ratio, 0.0);
+        std::size_t amount = floor<double, std::size_t>(
+            trim_ratio * static_cast<double>(n));
+        amount = std::min(n / 2, amount);
+        if (amount == 0) {
+            return std::forward<Container>(xs);
+        }
+        typedef typename Container::value_type T;
+        if (2 * amount == n) {
+            const T m = median(xs);
+            std::fill(std::begin(xs), std::end(xs), m);
+            return std::forward<Container>(xs);
         }
+        auto ys = internal::as_vector(xs);
+        internal::nth_elements(ys, { amount, n - 1 - amount });
+        const T lower = ys[amount];
+        const T upper = ys[n - 1 - amount];
+        for (auto& x : xs) {
+            if (x < lower) {
+                x = lower;
+            } else if (upper < x) {
+                x = upper;
+            }
+        }
+        return std::forward<Container>(xs);
     }
-    return result;
-}
 
-// API search type: group_globally_on : ((a -> b), [a]) -> [[a]]
+    template <typename Container>
+    Container winsorize(internal::create_new_container_t,
+        double trim_ratio, const Container& xs)
+    {
+        auto ys = xs;
+        return winsorize(internal::reuse_container_t(), trim_ratio, std::move(ys));
+    }
+
+} // namespace internal
+
+// API search type: winsorize : (Float, [Float]) -> [Float]
 // fwd bind count: 1
-// Arrange elements equal after applying a transformer into groups.
-// group_globally_on((mod 10), [12,34,22]) == [[12,22],[34]]
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group_on
-template <typename F, typename ContainerIn>
-auto group_globally_on(F f, const ContainerIn& xs)
+// Winsorizing: Clamps the given ratio of the smallest elements
+// to the smallest remaining one and the same ratio of the largest
+// elements to the largest remaining one, keeping the order of the elements.
+// winsorize(0.1, [1,3,4,4,4,4,4,4,6,8]) == [3,3,4,4,4,4,4,4,6,6]
+// winsorize(0.1, [4,4,4,3,8,4,6,4,1,4]) == [4,4,4,3,6,4,6,4,3,4]
+// O(n), using selection instead of sorting.
+// Clamps in place when given an rvalue.
+template <typename Container>
+auto winsorize(double trim_ratio, Container&& xs)
 {
-    return group_globally_by(is_equal_by(f), xs);
+    return internal::winsorize(internal::can_reuse_v<Container> {},
+        trim_ratio, std::forward<Container>(xs));
 }
 
-// API search type: group_globally_on_labeled : ((a -> b), [a]) -> [(b, [a])]
+// API search type: separate_on : ((a -> b), [a]) -> [[a]]
 // fwd bind count: 1
-// Arrange elements equal after applying a transformer into groups,
-// adding the transformation result as a label to the group.
-// group_globally_on_labeled((mod 10), [12,34,22]) == [(2,[12,22]),(4, [34])]
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group_on_labeled
-template <typename F, typename ContainerIn>
-auto group_globally_on_labeled(F f, const ContainerIn& xs)
+// Separate elements equal after applying a transformer into groups.
+// separate_on((mod 10), [12,22,34]) == [[12,34],[22]]
+template <typename F, typename ContainerIn,
+    typename ContainerOut = typename std::vector<ContainerIn>>
+ContainerOut separate_on(F f, const ContainerIn& xs)
 {
-    const auto group = [](auto f1, const auto& xs1) {
-        return group_globally_by(f1, xs1);
-    };
+    static_assert(std::is_same<ContainerIn,
+                      typename ContainerOut::value_type>::value,
+        "Containers do not match.");
 
-    return internal::group_on_labeled_impl(group, f, xs);
+    ContainerOut result;
+    if (is_empty(xs)) {
+        return result;
+    }
+
+    const auto groups = group_globally_on(f, xs);
+    bool found = true;
+    auto itOut = internal::get_back_inserter(result);
+    std::size_t index = 0;
+    while (found) {
+        typename ContainerOut::value_type sub_result;
+        found = false;
+        auto itOutInner = internal::get_back_inserter(sub_result);
+        for (auto& group : groups) {
+            if (size_of_cont(group) > index) {
+                *itOutInner = group[index];
+                found = true;
+            }
+        }
+        if (found) {
+            *itOut = sub_result;
+            ++index;
+        }
+    }
+    return result;
 }
 
-// API search type: group_globally : [a] -> [[a]]
+// API search type: separate : [a] -> [[a]]
 // fwd bind count: 0
-// Arrange equal elements into groups.
-// group_globally([1,2,2,2,3,2,2,4,5,5]) == [[1],[2,2,2,2,2],[3],[4],[5,5]]
-// O(n^2)
-// If you need O(n*log(n)), sort and then use group
+// Separate equal elements into groups.
+// separate([1, 2, 2, 3, 3, 4, 4, 4]) == [[1, 2, 3, 4], [2, 3, 4], [4]]
 template <typename ContainerIn,
     typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut group_globally(const ContainerIn& xs)
+ContainerOut separate(const ContainerIn& xs)
 {
     static_assert(std::is_same<ContainerIn,
                       typename ContainerOut::value_type>::value,
         "Containers do not match.");
     typedef typename ContainerIn::value_type T;
-    auto pred = [](const T& x, const T& y) { return x == y; };
-    return group_globally_by(pred, xs);
+    return separate_on(identity<T>, xs);
 }
 
-// API search type: cluster_by : (((a, a) -> Bool), [a]) -> [[a]]
-// fwd bind count: 1
-// Groups connected components, stable regarding initial order.
-// cluster_by(\x y -> abs (y - x) <= 3), [2,3,6,4,12,11,20,23,8,4])
-// == [[2,3,6,4,12,11,8,4],[20,23]]
-// BinaryPredicate p is a connectivity check, being
-//  a) commutative (p(x,y) = p(y,x))
-//  b) reflexive (p(x,x) = true)
-//  c) not neccessarily transitive, but can be
-// O(n^2), memory complexity also O(n^2)
-template <typename BinaryPredicate, typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut cluster_by(BinaryPredicate p, const ContainerIn& xs)
-{
-    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
+} // namespace fplus
 
-    typedef std::vector<unsigned char> bools;
-    bools zero_filled_row(size_of_cont(xs), 0);
 
-    // adjecency matrix
-    typedef std::vector<bools> boolss;
-    boolss adj_mat(size_of_cont(xs), zero_filled_row);
+//
+// internal/cpu_affinity.hpp
+//
 
-    for (const auto& idx_and_val_y : enumerate(xs)) {
-        auto idx_y = idx_and_val_y.first;
-        auto val_y = idx_and_val_y.second;
-        for (const auto& idx_and_val_x : enumerate(xs)) {
-            auto idx_x = idx_and_val_x.first;
-            auto val_x = idx_and_val_x.second;
-            if (internal::invoke(p, val_y, val_x)) {
-                adj_mat[idx_y][idx_x] = 1;
-            }
-        }
-    }
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
 
-    bools already_used = zero_filled_row;
-    auto is_already_used = [&](std::size_t i) -> bool {
-        return already_used[i] != 0;
-    };
 
-    typedef std::vector<std::size_t> idxs;
-    typedef std::vector<idxs> idxss;
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
-    auto bools_to_idxs = [](const bools& activations) -> idxs {
-        auto unsigned_char_to_bool = [](unsigned char x) {
-            return x != 0;
-        };
-        return find_all_idxs_by(unsigned_char_to_bool, activations);
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace fplus {
+namespace internal {
+
+    // Where a logical CPU sits in the machine.
+    struct cpu_location {
+        std::size_t cpu;
+        std::size_t package;
+        std::size_t core;
     };
 
-    idxss idx_clusters;
-    std::function<void(std::size_t)> process_idx = [&](std::size_t idx) -> void {
-        auto connected_idxs = bools_to_idxs(adj_mat[idx]);
-        auto new_connected_idxs = drop_if(is_already_used, connected_idxs);
-        if (is_empty(new_connected_idxs)) {
-            return;
+    // Reads one number from the sysfs topology of a CPU,
+    // returning fallback if it is not available.
+    inline std::size_t read_cpu_topology_value(std::size_t cpu,
+        const std::string& name, std::size_t fallback)
+    {
+        std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + name);
+        std::size_t value = fallback;
+        if (!(file >> value)) {
+            return fallback;
         }
-        idx_clusters.back() = append(idx_clusters.back(), new_connected_idxs);
-        for (const auto& new_idx : new_connected_idxs) {
-            already_used[new_idx] = 1;
+        return value;
+    }
+
+    // The CPUs the process is allowed to run on.
+    // Without OS support, all CPUs are assumed to be on one package.
+    inline std::vector<cpu_location> allowed_cpu_locations()
+    {
+        std::vector<cpu_location> result;
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (std::size_t id = 0; id < static_cast<std::size_t>(CPU_SETSIZE); ++id) {
+                if (CPU_ISSET(id, &set)) {
+                    result.push_back({ id,
+                        read_cpu_topology_value(id, "physical_package_id", 0),
+                        read_cpu_topology_value(id, "core_id", id) });
+                }
+            }
         }
-        for (const auto& new_idx : new_connected_idxs) {
-            process_idx(new_idx);
+#endif
+        if (result.empty()) {
+            const std::size_t n = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+            for (std::size_t cpu = 0; cpu < n; ++cpu) {
+                result.push_back({ cpu, 0, cpu });
+            }
         }
-    };
+        return result;
+    }
 
-    typedef typename ContainerOut::value_type InnerContainerOut;
+    // Orders the CPUs such that neighboring threads share
+    // as much as possible: hyper-threads of one core are adjacent,
+    // and a package is filled before the next one is used.
+    inline std::vector<cpu_location> compact_cpu_order(
+        std::vector<cpu_location> cpus)
+    {
+        std::sort(std::begin(cpus), std::end(cpus),
+            [](const cpu_location& a, const cpu_location& b) {
+                return std::tie(a.package, a.core, a.cpu)
+                    < std::tie(b.package, b.core, b.cpu);
+            });
+        return cpus;
+    }
+
+    // Orders the CPUs such that neighboring threads share
+    // as little as possible: the packages are used round-robin,
+    // and every physical core gets one thread
+    // before hyper-threads are used.
+    inline std::vector<cpu_location> scatter_cpu_order(
+        const std::vector<cpu_location>& cpus)
+    {
+        // sibling_rank: 0 for the first hyper-thread of a core, 1 for the second, ...
+        // package_rank: position within the package after ordering by sibling_rank
+        struct ranked_cpu {
+            cpu_location location;
+            std::size_t sibling_rank;
+            std::size_t package_rank;
+        };
+        std::vector<ranked_cpu> ranked;
+        const auto compact = compact_cpu_order(cpus);
+        for (std::size_t i = 0; i < compact.size(); ++i) {
+            const bool is_sibling = i > 0
+                && compact[i].package == compact[i - 1].package
+                && compact[i].core == compact[i - 1].core;
+            ranked.push_back({ compact[i],
+                is_sibling ? ranked.back().sibling_rank + 1 : 0, 0 });
+        }
+        std::stable_sort(std::begin(ranked), std::end(ranked),
+            [](const ranked_cpu& a, const ranked_cpu& b) {
+                return std::tie(a.location.package, a.sibling_rank)
+                    < std::tie(b.location.package, b.sibling_rank);
+            });
+        for (std::size_t i = 1; i < ranked.size(); ++i) {
+            if (ranked[i].location.package == ranked[i - 1].location.package) {
+                ranked[i].package_rank = ranked[i - 1].package_rank + 1;
+            }
+        }
+        std::stable_sort(std::begin(ranked), std::end(ranked),
+            [](const ranked_cpu& a, const ranked_cpu& b) {
+                return std::tie(a.package_rank, a.location.package)
+                    < std::tie(b.package_rank, b.location.package);
+            });
+        std::vector<cpu_location> result;
+        result.reserve(ranked.size());
+        for (const auto& r : ranked) {
+            result.push_back(r.location);
+        }
+        return result;
+    }
 
-    for (const auto& idx : all_idxs(xs)) {
-        if (is_already_used(idx)) {
-            continue;
+    // Restricts the calling thread to one CPU.
+    // Returns false if this is not supported or not allowed.
+    inline bool pin_current_thread_to_cpu(std::size_t cpu)
+    {
+#if defined(__linux__)
+        if (cpu >= static_cast<std::size_t>(CPU_SETSIZE)) {
+            return false;
         }
-        *internal::get_back_inserter(idx_clusters) = idxs();
-        *internal::get_back_inserter(idx_clusters.back()) = idx;
-        already_used[idx] = 1;
-        process_idx(idx);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
     }
+}
+}
 
-    typedef typename ContainerIn::value_type T;
+//
+// internal/thread_pool.hpp
+//
 
-    auto idx_to_val = [&](std::size_t idx) -> T {
-        return elem_at_idx(idx, xs);
-    };
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
 
-    auto idxs_to_vals = [&](const idxs& val_idxs) -> InnerContainerOut {
-        return transform_convert<InnerContainerOut>(idx_to_val, sort(val_idxs));
-    };
 
-    return transform_convert<ContainerOut>(idxs_to_vals, idx_clusters);
-}
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-// API search type: split_by : ((a -> Bool), Bool, [a]) -> [[a]]
-// fwd bind count: 2
-// Split a sequence at every element fulfilling a predicate.
-// The splitting elements are discarded.
-// split_by(is_even, true, [1,3,2,2,5,5,3,6,7,9]) == [[1,3],[],[5,5,3],[7,9]]
-// also known as split_when
-// O(n)
-template <typename UnaryPredicate, typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut split_by(UnaryPredicate pred, bool allow_empty, const ContainerIn& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
+namespace fplus {
+namespace internal {
 
-    if (allow_empty && is_empty(xs)) {
-        return { {} };
+    // Number of chunks a parallel job over n items is split into,
+    // so that idle workers can pick up the remaining work
+    // when the chunks turn out to be unevenly expensive.
+    inline std::size_t parallel_chunk_count(
+        std::size_t n_items, std::size_t n_workers)
+    {
+        return std::min(n_items, std::max<std::size_t>(1, 4 * n_workers));
     }
 
-    ContainerOut result;
-    auto itOut = internal::get_back_inserter(result);
-    auto start = std::begin(xs);
+    // First index of chunk idx when splitting n items into n_chunks chunks.
+    // The chunk sizes differ by at most one.
+    inline std::size_t parallel_chunk_begin(
+        std::size_t n_items, std::size_t n_chunks, std::size_t idx)
+    {
+        const std::size_t base = n_items / n_chunks;
+        const std::size_t rest = n_items % n_chunks;
+        return idx * base + std::min(idx, rest);
+    }
 
-    while (start != std::end(xs)) {
-        const auto stop = std::find_if(start, std::end(xs), pred);
-        if (start != stop || allow_empty) {
-            *itOut = { start, stop };
+    // A fixed set of worker threads, each owning a task queue.
+    // Workers take tasks from the back of their own queue
+    // and steal from the front of the other queues when running dry.
+    // The threads are created once and live as long as the pool.
+    class thread_pool {
+    public:
+        typedef std::function<void()> task;
+
+        explicit thread_pool(std::size_t n_threads)
+            : queues_()
+            , threads_()
+            , wake_mutex_()
+            , wake_cv_()
+            , pending_(0)
+            , next_queue_(0)
+            , stop_(false)
+        {
+            n_threads = std::max<std::size_t>(1, n_threads);
+            for (std::size_t i = 0; i < n_threads; ++i) {
+                queues_.push_back(std::make_unique<task_queue>());
+            }
+            for (std::size_t i = 0; i < n_threads; ++i) {
+                threads_.emplace_back([this, i]() { worker_loop(i); });
+            }
         }
-        if (stop == std::end(xs)) {
-            break;
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stop_ = true;
+            }
+            wake_cv_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
         }
-        start = internal::add_to_iterator(stop);
-        if (allow_empty && start == std::end(xs)) {
-            *itOut = typename ContainerOut::value_type();
+
+        std::size_t size() const
+        {
+            return threads_.size();
         }
-    }
-    return result;
-}
 
-// API search type: split_by_keep_separators : ((a -> Bool), [a]) -> [[a]]
-// fwd bind count: 1
-// Split a sequence at every element fulfilling a predicate.
-// The splitting elements are kept.
-// split_by_keep_separators(is_even, true, [1,3,2,2,5,5,3,6,7,9])
-// == [[1,3],[2],[2,5,5,3],[6,7,9]]
-// O(n)
-template <typename UnaryPredicate, typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut split_by_keep_separators(UnaryPredicate pred, const ContainerIn& xs)
-{
-    internal::check_unary_predicate_for_container<UnaryPredicate, ContainerIn>();
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
-    ContainerOut result;
-    if (is_empty(xs))
-        return result;
-    auto itOut = internal::get_back_inserter(result);
-    auto start = std::begin(xs);
-    while (start != std::end(xs)) {
-        const auto stop = std::find_if(
-            internal::add_to_iterator(start), std::end(xs), pred);
-        *itOut = { start, stop };
-        if (stop == std::end(xs)) {
-            break;
+        void submit(task t)
+        {
+            const std::size_t idx = next_queue_.fetch_add(1) % queues_.size();
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                ++pending_;
+            }
+            {
+                std::lock_guard<std::mutex> lock(queues_[idx]->mutex);
+                queues_[idx]->tasks.push_back(std::move(t));
+            }
+            wake_cv_.notify_one();
+        }
+
+        // Calls f(i) for every i in [0, n_chunks) and blocks until all
+        // calls are finished. The calling thread works on the chunks too,
+        // so nested use from inside a task can not dead-lock the pool.
+        // The first exception thrown by f is rethrown to the caller.
+        // At most max_helpers pool threads join the calling thread.
+        template <typename F>
+        void run_chunks(std::size_t n_chunks, F f,
+            std::size_t max_helpers = static_cast<std::size_t>(-1))
+        {
+            if (n_chunks == 0) {
+                return;
+            }
+            if (n_chunks == 1) {
+                f(std::size_t(0));
+                return;
+            }
+            const auto job = std::make_shared<chunk_job>(n_chunks);
+            F* f_ptr = &f;
+            const std::size_t n_helpers = std::min(
+                std::min(size(), max_helpers), n_chunks - 1);
+            for (std::size_t i = 0; i < n_helpers; ++i) {
+                submit([job, f_ptr]() { job->work(f_ptr); });
+            }
+            job->work(&f);
+            job->wait();
+            if (job->error) {
+                std::rethrow_exception(job->error);
+            }
+        }
+
+    private:
+        struct task_queue {
+            task_queue()
+                : mutex()
+                , tasks()
+            {
+            }
+            std::mutex mutex;
+            std::deque<task> tasks;
+        };
+
+        // Shared state of one run_chunks call.
+        // Helpers that start after all chunks have been claimed
+        // only touch this object, never the (possibly dead) function.
+        struct chunk_job {
+            explicit chunk_job(std::size_t n)
+                : n_chunks(n)
+                , next(0)
+                , done(0)
+                , mutex()
+                , cv()
+                , error()
+            {
+            }
+            template <typename F>
+            void work(F* f)
+            {
+                for (;;) {
+                    const std::size_t idx = next.fetch_add(1);
+                    if (idx >= n_chunks) {
+                        return;
+                    }
+                    try {
+                        (*f)(idx);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    if (done.fetch_add(1) + 1 == n_chunks) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        cv.notify_all();
+                    }
+                }
+            }
+            void wait()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]() { return done.load() == n_chunks; });
+            }
+            const std::size_t n_chunks;
+            std::atomic<std::size_t> next;
+            std::atomic<std::size_t> done;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::exception_ptr error;
+        };
+
+        bool pop_or_steal(std::size_t idx, task& t)
+        {
+            {
+                task_queue& own = *queues_[idx];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    t = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t i = 1; i < queues_.size(); ++i) {
+                task_queue& other = *queues_[(idx + i) % queues_.size()];
+                std::lock_guard<std::mutex> lock(other.mutex);
+                if (!other.tasks.empty()) {
+                    t = std::move(other.tasks.front());
+                    other.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
         }
-        start = stop;
-    }
-    return result;
-}
 
-// API search type: split : (a, Bool, [a]) -> [[a]]
-// fwd bind count: 2
-// Split a sequence at every element equal to x.
-// The splitting elements are discarded.
-// split(0, true, [1,3,2,0,0,6,0,7,5]) == [[1,3,2],[],[6],[7,5]]
-// O(n)
-template <typename ContainerIn,
-    typename T = typename ContainerIn::value_type>
-auto split(const T& x, bool allow_empty, const ContainerIn& xs)
-{
-    return split_by(is_equal_to(x), allow_empty, xs);
-}
+        void worker_loop(std::size_t idx)
+        {
+            for (;;) {
+                task t;
+                if (pop_or_steal(idx, t)) {
+                    --pending_;
+                    t();
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_cv_.wait(lock, [this]() {
+                    return stop_ || pending_.load() > 0;
+                });
+                if (stop_ && pending_.load() == 0) {
+                    return;
+                }
+            }
+        }
 
-// API search type: split_one_of : ([a], Bool, [a]) -> [[a]]
-// fwd bind count: 2
-// Split a sequence at every element present in delimiters.
-// The splitting elements are discarded.
-// Also known as split_words_by_many.
-// split_one_of([0,3], true [1,3,2,0,0,6,0,7,5]) == [[1],[2],[],[6],[7,5]]
-// split_one_of(" o", false, "How are u?") == ["H","w","are","u?"]
-// O(n)
-template <typename ContainerIn,
-    typename ContainerDelims>
-auto split_one_of(
-    const ContainerDelims delimiters, bool allow_empty, const ContainerIn& xs)
-{
-    const auto pred = [&](const typename ContainerIn::value_type& x) -> bool {
-        return is_elem_of(x, delimiters);
+        std::vector<std::unique_ptr<task_queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex wake_mutex_;
+        std::condition_variable wake_cv_;
+        std::atomic<std::size_t> pending_;
+        std::atomic<std::size_t> next_queue_;
+        bool stop_;
     };
-    return split_by(pred, allow_empty, xs);
-}
 
-// API search type: split_keep_separators : ((a -> Bool), [a]) -> [[a]]
-// fwd bind count: 1
-// Split a sequence at every element equal to x.
-// The splitting elements are kept.
-// split_keep_separators(2, true, [1,3,2,2,5,5,3,2,7,9])
-// == [[1,3],[2],[2,5,5,3],[6,7,9]]
-// O(n)
-template <typename ContainerIn,
-    typename T = typename ContainerIn::value_type>
-auto split_keep_separators(const T& x, const ContainerIn& xs)
-{
-    return split_by_keep_separators(is_equal_to(x), xs);
+    // The process-wide pool used by the *_parallelly functions.
+    // Its threads are started on first use and joined at program exit.
+    inline thread_pool& default_thread_pool()
+    {
+        static thread_pool pool(std::thread::hardware_concurrency());
+        return pool;
+    }
 }
-
-// API search type: split_at_idx : (Int, [a]) -> ([a], [a])
-// fwd bind count: 1
-// Split a sequence at a specific position.
-// split_at_idx(2, [0,1,2,3,4]) == ([0,1],[2,3,4])
-template <typename Container>
-std::pair<Container, Container> split_at_idx(std::size_t idx, const Container& xs)
-{
-    assert(idx <= size_of_cont(xs));
-    return make_pair(get_segment(0, idx, xs),
-        get_segment(idx, size_of_cont(xs), xs));
 }
 
-// API search type: insert_at_idx : (Int, a, [a]) -> [a]
-// fwd bind count: 2
-// Insert an element into a sequence at a specific position.
-// insert_at_idx(2, 0, [1,2,3,4]) == [1,2,0,3,4].
-template <typename Container,
-    typename T = typename Container::value_type>
-Container insert_at_idx(std::size_t idx, const T& x, const Container& xs)
-{
-    const auto splitted = split_at_idx(idx, xs);
-    return concat(std::vector<Container>(
-        { splitted.first,
-            singleton_seq<T, Container>(x),
-            splitted.second }));
-}
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
-// API search type: partition : ((a -> Bool), [a]) -> ([a], [a])
+namespace fplus {
+
+// API search type: transform_with_idx : (((Int, a) -> b), [a]) -> [b]
 // fwd bind count: 1
-// Split a sequence into two groups.
-// The first group contains all elements fulfilling the predicate.
-// The second group contains the remaining elements.
-// partition(is_even, [0,1,1,3,7,2,3,4]) == ([0,2,4],[1,1,3,7,3])
-template <typename UnaryPredicate, typename Container>
-std::pair<Container, Container> partition(UnaryPredicate pred, const Container& xs)
+// Apply a function to every index and corresponding element of a sequence.
+// transform_with_idx(f, [6, 4, 7]) == [f(0, 6), f(1, 4), f(2, 7)]
+template <typename F, typename ContainerIn,
+    typename ContainerOut = typename internal::same_cont_new_t_from_binary_f<
+        ContainerIn, F, std::size_t, typename ContainerIn::value_type, 0>::type>
+ContainerOut transform_with_idx(F f, const ContainerIn& xs)
 {
-    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
-    Container matching;
-    Container notMatching;
-    auto itOutMatching = internal::get_back_inserter(matching);
-    auto itOutNotMatching = internal::get_back_inserter(notMatching);
+    internal::trigger_static_asserts<internal::binary_function_tag, F>();
+    ContainerOut ys;
+    internal::prepare_container(ys, size_of_cont(xs));
+    auto it = internal::get_back_inserter<ContainerOut>(ys);
+    std::size_t idx = 0;
     for (const auto& x : xs) {
-        if (internal::invoke(pred, x))
-            *itOutMatching = x;
-        else
-            *itOutNotMatching = x;
+        *it = internal::invoke(f, idx++, x);
     }
-    return make_pair(matching, notMatching);
+    return ys;
 }
 
-// API search type: split_at_idxs : ([Int], [a]) -> [[a]]
+// API search type: transform_and_keep_justs : ((a -> Maybe b), [a]) -> [b]
 // fwd bind count: 1
-// Split a sequence at specific indices.
-// split_at_idxs([2,5], [0,1,2,3,4,5,6,7]) == [[0,1],[2,3,4],[5,6,7]]
-// split_at_idxs([2,5,5], [0,1,2,3,4,5,6,7]) == [[0,1],[2,3,4],[],[5,6,7]]
-template <typename ContainerIdxs, typename ContainerIn,
-    typename ContainerOut = std::vector<ContainerIn>>
-ContainerOut split_at_idxs(const ContainerIdxs& idxsIn, const ContainerIn& xs)
+// Map function over values and drop resulting nothings.
+// Also known as filter_map.
+template <typename F, typename ContainerIn>
+auto transform_and_keep_justs(F f, const ContainerIn& xs)
 {
-    static_assert(std::is_same<typename ContainerIdxs::value_type, std::size_t>::value,
-        "Indices must be std::size_t");
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
-    ContainerIdxs idxStartC = { 0 };
-    ContainerIdxs idxEndC = { size_of_cont(xs) };
-    std::vector<ContainerIdxs> containerIdxss = { idxStartC, idxsIn, idxEndC };
-    auto idxs = concat(containerIdxss);
-    auto idxsClean = sort(idxs);
-    ContainerOut result;
-    internal::prepare_container(result, size_of_cont(idxsClean) - 1);
-    auto itOut = internal::get_back_inserter(result);
-    auto idxPairs = overlapping_pairs(idxsClean);
-    for (const auto& idxPair : idxPairs) {
-        *itOut = get_segment(idxPair.first, idxPair.second, xs);
-    }
-    return result;
-}
+    using X = typename ContainerIn::value_type;
+    internal::
+        trigger_static_asserts<internal::unary_function_tag, F, X>();
 
-// API search type: split_every : (Int, [a]) -> [[a]]
-// fwd bind count: 1
-// Split a sequence every n elements.
-// split_every(3, [0,1,2,3,4,5,6,7]) == [[0,1,2],[3,4,5],[6,7]]
-// Also known as chunk or chunks.
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<ContainerIn>>
-ContainerOut split_every(std::size_t n, const ContainerIn& xs)
-{
-    return split_at_idxs<
-        std::vector<std::size_t>,
+    using ContainerOut = typename internal::same_cont_new_t<
         ContainerIn,
-        ContainerOut>(
-        numbers_step<std::size_t>(
-            n, size_of_cont(xs), n),
-        xs);
-}
+        typename std::decay_t<internal::invoke_result_t<F, X>>::type>::type;
 
-// API search type: split_evenly : (Int, [a]) -> [[a]]
-// fwd bind count: 1
-// Split a sequence into n similarly-sized chunks.
-// split_evenly(2, [0,1,2,3,4]) == [[0,1,2],[3,4]]
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<ContainerIn>>
-ContainerOut split_evenly(std::size_t n, const ContainerIn& xs)
-{
-    const std::size_t every_n = div_pos_int_ceil(size_of_cont(xs), n);
-    return split_at_idxs<
-        std::vector<std::size_t>,
-        ContainerIn,
-        ContainerOut>(
-        numbers_step<std::size_t>(
-            every_n, size_of_cont(xs), every_n),
-        xs);
+    auto transformed = transform(f, xs);
+    return justs<decltype(transformed), ContainerOut>(transformed);
 }
 
-// API search type: split_by_token : ([a], Bool, [a]) -> [[a]]
-// fwd bind count: 2
-// Split a sequence at every segment matching a token.
-// split_by_token(", ", true, "foo, bar, baz") == ["foo", "bar", "baz"]
-template <typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut split_by_token(const ContainerIn& token,
-    bool allow_empty, const ContainerIn& xs)
+// API search type: transform_and_keep_oks : ((a -> Result b), [a]) -> [b]
+// fwd bind count: 1
+// Map function over values and drop resulting errors.
+template <typename F, typename ContainerIn>
+auto transform_and_keep_oks(F f, const ContainerIn& xs)
 {
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
-    const auto token_begins = find_all_instances_of_token_non_overlapping(token, xs);
-    const auto token_ends = transform(add_to<std::size_t>(size_of_cont(token)), token_begins);
-    assert(is_sorted(interweave(token_begins, token_ends)));
-
-    typedef std::vector<std::size_t> idx_vec;
-    const auto segments = zip(
-        fplus::append(idx_vec(1, 0), token_ends),
-        fplus::append(token_begins, idx_vec(1, size_of_cont(xs))));
+    using X = typename ContainerIn::value_type;
+    internal::
+        trigger_static_asserts<internal::unary_function_tag, F, X>();
 
-    ContainerOut result;
-    auto itOut = internal::get_back_inserter(result);
-    for (const auto& segment : segments) {
-        if (segment.first != segment.second || allow_empty)
-            *itOut = get_segment(segment.first, segment.second, xs);
-    }
-    return result;
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn,
+        typename std::decay_t<internal::invoke_result_t<F, X>>::ok_t>::type;
+    auto transformed = transform(f, xs);
+    return oks<decltype(transformed), ContainerOut>(transformed);
 }
 
-// API search type: run_length_encode_by : (((a, a) -> Bool), [a]) -> [(Int, a)]
+// API search type: transform_and_concat : ((a -> [b]), [a]) -> [b]
 // fwd bind count: 1
-// RLE using a specific binary predicate as equality check.
-// run_length_encode_by((==),[1,2,2,2,2,3,3,2)) == [(1,1),(4,2),(2,3),(1,2)]
-template <typename BinaryPredicate,
-    typename ContainerIn,
-    typename T = typename ContainerIn::value_type,
-    typename ContainerOut =
-        typename std::vector<std::pair<std::size_t, T>>>
-ContainerOut run_length_encode_by(BinaryPredicate pred, const ContainerIn& xs)
+// Map function over values and concat results.
+// Also known as flat_map or concat_map.
+template <typename F, typename ContainerIn>
+auto transform_and_concat(F f, const ContainerIn& xs)
 {
-    internal::check_binary_predicate_for_container<BinaryPredicate, ContainerIn>();
-    ContainerOut result;
-    auto groups = group_by(pred, xs);
-    auto group_to_pair = [](const ContainerIn& group) -> std::pair<std::size_t, T> {
-        return std::make_pair(size_of_cont(group), group.front());
-    };
-    return transform(group_to_pair, groups);
+    internal::trigger_static_asserts<internal::unary_function_tag, F, typename ContainerIn::value_type>();
+    return concat(transform(f, xs));
 }
 
-// API search type: run_length_encode : [a] -> [(Int, a)]
+// API search type: replicate_elems : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Replicate every element n times, concatenate the result.
+// replicate_elems(3, [1,2]) == [1, 1, 1, 2, 2, 2]
+template <typename Container>
+Container replicate_elems(std::size_t n, const Container& xs)
+{
+    typedef typename Container::value_type T;
+    return transform_and_concat(bind_1st_of_2(replicate<T, Container>, n), xs);
+}
+
+// API search type: interleave : [[a]] -> [a]
 // fwd bind count: 0
-// RLE.
-// run_length_encode([1,2,2,2,2,3,3,2)) == [(1,1),(4,2),(2,3),(1,2)]
+// Return a sequence that contains elements from the provided sequences
+// in alternating order. If one list runs out of items,
+// appends the items from the remaining list.
+// interleave([[1,2,3],[4,5],[6,7,8]]) == [1,4,6,2,5,7,3,8]
 template <typename ContainerIn,
-    typename T = typename ContainerIn::value_type>
-auto run_length_encode(const ContainerIn& xs)
+    typename ContainerOut = typename ContainerIn::value_type>
+ContainerOut interleave(const ContainerIn& xss)
 {
-    return run_length_encode_by(is_equal<T>, xs);
+    typedef typename ContainerIn::value_type inner_t;
+    typedef std::vector<typename inner_t::const_iterator> its_t;
+    const auto inner_cbegin = [](const inner_t& xs) { return xs.cbegin(); };
+    const auto inner_cend = [](const inner_t& xs) { return xs.cend(); };
+    auto it_pairs = zip(
+        transform_convert<its_t>(inner_cbegin, xss),
+        transform_convert<its_t>(inner_cend, xss));
+
+    ContainerOut result;
+    const std::size_t length = sum(transform(size_of_cont<inner_t>, xss));
+    internal::prepare_container(result, length);
+    auto it_out = internal::get_back_inserter<ContainerOut>(result);
+    bool still_appending = true;
+    while (still_appending) {
+        still_appending = false;
+        for (auto& it_pair : it_pairs) {
+            if (it_pair.first != it_pair.second) {
+                *it_out = *it_pair.first;
+                still_appending = true;
+                ++it_pair.first;
+            }
+        }
+    }
+    return result;
 }
 
-// API search type: run_length_decode : [(Int, a)] -> [a]
+// API search type: transpose : [[a]] -> [[a]]
 // fwd bind count: 0
-// Inverse operation to run_length_encode.
-// run_length_decode([(1,1),(4,2),(2,3),(1,2)]) == [1,2,2,2,2,3,3,2)
-template <typename ContainerIn,
-    typename Pair = typename ContainerIn::value_type,
-    typename Cnt = typename Pair::first_type>
-auto run_length_decode(const ContainerIn& pairs)
+// Transpose a nested sequence aka. table aka. two-dimensional matrix.
+// transpose([[1,2,3],[4,5,6],[7,8,9]]) == [[1,4,7],[2,5,8],[3,6,9]]
+// transpose([[1,2,3],[4,5],[7,8,9]]) == [[1,4,7],[2,5,8],[3,9]]
+template <typename Container>
+Container transpose(const Container& rows)
 {
-    static_assert(std::is_convertible<Cnt, std::size_t>::value,
-        "Count type must be convertible to std::size_t.");
-    const auto pair_to_vec =
-        [](const Pair& p) {
-            return replicate(p.first, p.second);
-        };
-    return concat(transform(pair_to_vec, pairs));
+    if (is_empty(rows)) {
+        return {};
+    }
+    return split_every<typename Container::value_type, Container>(
+        size_of_cont(rows), interleave(rows));
 }
 
-// API search type: span : ((a -> Bool), [a]) -> ([a], [a])
+namespace internal {
+
+    template <typename Container>
+    Container shuffle(internal::reuse_container_t,
+        std::uint_fast32_t seed, Container&& xs)
+    {
+        std::mt19937 g(seed);
+        std::shuffle(std::begin(xs), std::end(xs), g);
+        return std::forward<Container>(xs);
+    }
+
+    template <typename Container>
+    Container shuffle(internal::create_new_container_t,
+        std::uint_fast32_t seed, const Container& xs)
+    {
+        Container ys = xs;
+        return internal::shuffle(internal::reuse_container_t(), seed, std::move(ys));
+    }
+
+} // namespace internal
+
+// API search type: shuffle : (Int, [a]) -> [a]
 // fwd bind count: 1
-// span, applied to a predicate p and a list xs,
-// returns a tuple where first element is longest prefix (possibly empty)
-// of xs of elements that satisfy p
-// and second element is the remainder of the list.
-// span(is_even, [0,2,4,5,6,7,8]) == ([0,2,4], [5,6,7,8])
-template <typename Container, typename UnaryPredicate>
-std::pair<Container, Container> span(UnaryPredicate pred, const Container& xs)
+// Returns a randomly shuffled version of xs.
+// Example call: shuffle(std::mt19937::default_seed, xs);
+// Example call: shuffle(std::random_device()(), xs);
+template <typename Container>
+auto shuffle(std::uint_fast32_t seed, Container&& xs)
 {
-    auto maybeIdx = find_first_idx_by(logical_not(pred), xs);
-    return {
-        take(just_with_default<std::size_t>(size_of_cont(xs), maybeIdx), xs),
-        drop(just_with_default<std::size_t>(size_of_cont(xs), maybeIdx), xs)
-    };
+    return (internal::shuffle(internal::can_reuse_v<Container> {},
+        seed, std::forward<Container>(xs)));
 }
 
-// API search type: divvy : (Int, Int, [a]) -> [[a]]
+// API search type: sample : (Int, Int, [a]) -> [a]
 // fwd bind count: 2
-// Generates subsequences overlapping with a specific step.
-// divvy(5, 2, [0,1,2,3,4,5,6,7,8,9]) == [[0,1,2,3,4],[2,3,4,5,6],[4,5,6,7,8]]
-// divvy(length, 1, xs) is also known as aperture
-// divvy(1, step, xs) is also known as stride
-//     (but withouts the nested lists in the result)
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<ContainerIn>>
-ContainerOut divvy(std::size_t length, std::size_t step, const ContainerIn& xs)
+// Returns n random elements from xs without replacement.
+// n has to be smaller than or equal to the number of elements in xs.
+// Also known as rnd_select.
+// Example call: sample(std::mt19937::default_seed, 3, xs);
+// Example call: sample(std::random_device()(), 3, xs);
+template <typename Container>
+Container sample(std::uint_fast32_t seed, std::size_t n, const Container& xs)
 {
-    assert(length > 0);
-    assert(step > 0);
-    const auto start_idxs = numbers_step<std::size_t>(
-        0, size_of_cont(xs) - (length - 1), step);
-
-    ContainerOut result;
-    internal::prepare_container(result, size_of_cont(start_idxs));
-    auto itOut = internal::get_back_inserter(result);
-
-    for (const auto start_idx : start_idxs) {
-        *itOut = get_segment(start_idx, start_idx + length, xs);
-    }
-    return result;
+    assert(n <= size_of_cont(xs));
+    return get_segment(0, n, shuffle(seed, xs));
 }
 
-// API search type: aperture : (Int, [a]) -> [[a]]
+// API search type: random_element : (Int, [a]) -> a
 // fwd bind count: 1
-// Generates overlapping subsequences.
-// aperture(5, [0,1,2,3,4,5,6]) == [[0,1,2,3,4],[1,2,3,4,5],[2,3,4,5,6]]
-template <typename ContainerIn,
-    typename ContainerOut = std::vector<ContainerIn>>
-ContainerOut aperture(std::size_t length, const ContainerIn& xs)
+// Returns one random element from xs.
+// xs must be non-empty.
+// Example call: random_element(std::mt19937::default_seed, xs)
+// Example call: random_element(std::random_device()(), xs)
+// Also known as choice.
+template <typename Container>
+typename Container::value_type random_element(
+    std::uint_fast32_t seed, const Container& xs)
 {
-    assert(length > 0);
-    const auto start_idxs = numbers<std::size_t>(
-        0, size_of_cont(xs) - (length - 1));
-
-    ContainerOut result;
-    internal::prepare_container(result, size_of_cont(start_idxs));
-    auto itOut = internal::get_back_inserter(result);
+    assert(is_not_empty(xs));
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> dis(0, size_of_cont(xs) - 1);
+    return elem_at_idx(dis(gen), xs);
+}
 
-    for (const auto start_idx : start_idxs) {
-        *itOut = get_segment(start_idx, start_idx + length, xs);
-    }
-    return result;
+// API search type: random_elements : (Int, Int, [a]) -> a
+// fwd bind count: 2
+// Returns random elements from xs with replacement.
+// xs must be non-empty.
+// Example call: random_elements(std::mt19937::default_seed, 10, xs)
+// Example call: random_elements(std::random_device()(), 10, xs)
+template <typename Container>
+Container random_elements(
+    std::uint_fast32_t seed, std::size_t n, const Container& xs)
+{
+    assert(is_not_empty(xs));
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<std::size_t> dis(0, size_of_cont(xs) - 1);
+    const auto draw = [&]() -> typename Container::value_type {
+        return elem_at_idx(dis(gen), xs);
+    };
+    return generate<Container>(draw, n);
 }
 
-// API search type: stride : (Int, [a]) -> [a]
+// API search type: apply_functions : ([(a -> b)], a) -> [b]
 // fwd bind count: 1
-// Keeps every nth element.
-// stride(3, [0,1,2,3,4,5,6,7]) == [0,3,6]
-template <typename Container>
-Container stride(std::size_t step, const Container& xs)
+// Applies a list of functions to a value.
+template <typename FunctionContainer,
+    typename F = typename FunctionContainer::value_type,
+    typename FIn>
+auto apply_functions(const FunctionContainer& functions, const FIn& x)
 {
-    assert(step > 0);
-    Container ys;
-    auto it = internal::get_back_inserter<Container>(ys);
-    auto it_in = std::begin(xs);
-    std::size_t i = 0;
-    const auto xs_size = size_of_cont(xs);
-    while (it_in != std::end(xs)) {
-        *it = *it_in;
-        std::size_t increment = std::min(step, xs_size - i);
-        internal::advance_iterator(it_in, increment);
-        i += increment;
+    internal::trigger_static_asserts<internal::unary_function_tag, F, FIn>();
+
+    using FOut = std::decay_t<internal::invoke_result_t<F, FIn>>;
+    using ContainerOut =
+        typename internal::same_cont_new_t<FunctionContainer, FOut, 0>::type;
+
+    ContainerOut ys;
+    internal::prepare_container(ys, size_of_cont(functions));
+    auto it = internal::get_back_inserter<ContainerOut>(ys);
+    for (const auto& f : functions) {
+        *it = internal::invoke(f, x);
     }
     return ys;
 }
 
-// API search type: winsorize : (Float, [Float]) -> [Float]
-// fwd bind count: 1
-// Winsorizing
-// winsorize(0.1, [1,3,4,4,4,4,4,4,6,8]) == [3,3,4,4,4,4,4,4,6,6]
-template <typename Container>
-Container winsorize(double trim_ratio, const Container& xs)
+// API search type: apply_function_n_times : ((a -> a), Int, a) -> a
+// fwd bind count: 2
+// Applies a functional n times in a row.
+template <typename F, typename FIn>
+auto apply_function_n_times(F f, std::size_t n, const FIn& x)
 {
-    if (size_of_cont(xs) == 1 || size_of_cont(xs) == 0) {
-        return xs;
-    }
-    trim_ratio = std::max(trim_ratio, 0.0);
-    const auto xs_sorted = sort(xs);
-    std::size_t amount = floor<double, std::size_t>(
-        trim_ratio * static_cast<double>(size_of_cont(xs_sorted)));
-    amount = std::min(size_of_cont(xs_sorted) / 2, amount);
-    const auto parts = split_at_idxs(
-        std::vector<std::size_t>({ amount, size_of_cont(xs_sorted) - amount }),
-        xs_sorted);
-    assert(size_of_cont(parts) == 3);
-    typedef typename Container::value_type T;
-    if (is_empty(parts[1])) {
-        return Container(size_of_cont(xs_sorted), median(xs_sorted));
-    } else {
-        const T lower = parts[1].front();
-        const T upper = parts[1].back();
-        const auto result = concat(std::vector<Container>({ Container(amount, lower),
-            parts[1],
-            Container(amount, upper) }));
-        assert(size_of_cont(result) == size_of_cont(xs_sorted));
-        return result;
+    internal::trigger_static_asserts<internal::unary_function_tag, F, FIn>();
+    using FOut = std::decay_t<internal::invoke_result_t<F, FIn>>;
+    static_assert(std::is_same<FOut, FIn>::value,
+        "Input and output of F must be the same type.");
+    if (n == 0) {
+        return x;
+    }
+    FOut y = internal::invoke(f, x);
+    for (std::size_t i = 1; i < n; ++i) {
+        y = internal::invoke(f, y);
     }
+    return y;
 }
 
-// API search type: separate_on : ((a -> b), [a]) -> [[a]]
-// fwd bind count: 1
-// Separate elements equal after applying a transformer into groups.
-// separate_on((mod 10), [12,22,34]) == [[12,34],[22]]
-template <typename F, typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut separate_on(F f, const ContainerIn& xs)
-{
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
+// How the adaptive scheduler distributed the chunks of one parallel run
+// of a *_parallelly function (not the *_n_threads ones) on the thread pool.
+// n_sampled_chunks chunks are processed by one thread
+// to measure their cost, while the other threads already process chunks.
+// The ones left after that are handed out
+// to n_threads threads in tasks of chunks_per_task chunks.
+// n_threads == 1 means the rest was processed serially,
+// because parallelization would not have paid off.
+// Jobs with no more chunks than threads are not sampled,
+// every chunk gets its own thread.
+struct parallel_schedule {
+    std::size_t n_chunks;
+    std::size_t n_sampled_chunks;
+    double sampled_seconds;
+    double estimated_remaining_seconds;
+    std::size_t n_threads;
+    std::size_t chunks_per_task;
+};
 
-    ContainerOut result;
-    if (is_empty(xs)) {
-        return result;
-    }
+namespace internal {
 
-    const auto groups = group_globally_on(f, xs);
-    bool found = true;
-    auto itOut = internal::get_back_inserter(result);
-    std::size_t index = 0;
-    while (found) {
-        typename ContainerOut::value_type sub_result;
-        found = false;
-        auto itOutInner = internal::get_back_inserter(sub_result);
-        for (auto& group : groups) {
-            if (size_of_cont(group) > index) {
-                *itOutInner = group[index];
-                found = true;
-            }
+    class parallel_schedule_observer_slot {
+    public:
+        typedef std::function<void(const parallel_schedule&)> observer;
+        parallel_schedule_observer_slot()
+            : mutex_()
+            , observer_()
+            , is_set_(false)
+        {
         }
-        if (found) {
-            *itOut = sub_result;
-            ++index;
+        observer exchange(observer new_observer)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            is_set_ = static_cast<bool>(new_observer);
+            std::swap(observer_, new_observer);
+            return new_observer;
+        }
+        void notify(const parallel_schedule& schedule)
+        {
+            if (!is_set_.load()) {
+                return;
+            }
+            observer current;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                current = observer_;
+            }
+            if (current) {
+                current(schedule);
+            }
         }
+
+    private:
+        std::mutex mutex_;
+        observer observer_;
+        std::atomic<bool> is_set_;
+    };
+
+    inline parallel_schedule_observer_slot& parallel_schedule_observer()
+    {
+        static parallel_schedule_observer_slot slot;
+        return slot;
     }
-    return result;
 }
 
-// API search type: separate : [a] -> [[a]]
-// fwd bind count: 0
-// Separate equal elements into groups.
-// separate([1, 2, 2, 3, 3, 4, 4, 4]) == [[1, 2, 3, 4], [2, 3, 4], [4]]
-template <typename ContainerIn,
-    typename ContainerOut = typename std::vector<ContainerIn>>
-ContainerOut separate(const ContainerIn& xs)
+// Installs a function that is called with the parallel_schedule
+// chosen for every parallel run of a *_parallelly function,
+// e.g. to log it when tuning an application.
+// It is called from the thread invoking the *_parallelly function.
+// Returns the previously installed observer.
+// Pass an empty std::function to uninstall it.
+inline std::function<void(const parallel_schedule&)>
+set_parallel_schedule_observer(
+    std::function<void(const parallel_schedule&)> observer)
 {
-    static_assert(std::is_same<ContainerIn,
-                      typename ContainerOut::value_type>::value,
-        "Containers do not match.");
-    typedef typename ContainerIn::value_type T;
-    return separate_on(identity<T>, xs);
+    return internal::parallel_schedule_observer().exchange(std::move(observer));
 }
 
-} // namespace fplus
-
+// Describes on which logical CPUs the threads
+// of a *_parallelly_placed function run, one thread per entry.
+// The same CPU may occur multiple times.
+// On systems without support for thread affinity (currently everything
+// but Linux) or if pinning a thread fails, the thread runs unpinned.
+struct thread_placement {
+    std::vector<std::size_t> cpus;
+};
 
-#include <algorithm>
-#include <cstdint>
-#include <future>
-#include <iterator>
-#include <mutex>
-#include <random>
+// API search type: thread_placement_on_cpus : [Int] -> ThreadPlacement
+// One thread for each of the given CPU ids.
+inline thread_placement thread_placement_on_cpus(
+    const std::vector<std::size_t>& cpus)
+{
+    return { cpus };
+}
 
-namespace fplus {
+namespace internal {
+    inline thread_placement thread_placement_from_order(
+        const std::vector<cpu_location>& order, std::size_t n_threads)
+    {
+        std::vector<std::size_t> cpus;
+        cpus.reserve(n_threads);
+        for (std::size_t i = 0; i < n_threads; ++i) {
+            cpus.push_back(order[i % order.size()].cpu);
+        }
+        return { cpus };
+    }
+}
 
-// API search type: transform_with_idx : (((Int, a) -> b), [a]) -> [b]
-// fwd bind count: 1
-// Apply a function to every index and corresponding element of a sequence.
-// transform_with_idx(f, [6, 4, 7]) == [f(0, 6), f(1, 4), f(2, 7)]
-template <typename F, typename ContainerIn,
-    typename ContainerOut = typename internal::same_cont_new_t_from_binary_f<
-        ContainerIn, F, std::size_t, typename ContainerIn::value_type, 0>::type>
-ContainerOut transform_with_idx(F f, const ContainerIn& xs)
+// API search type: compact_thread_placement : Int -> ThreadPlacement
+// n threads packed as densely as possible onto the CPUs
+// the process may use, i.e. hyper-threads of one core first,
+// and one package (socket / NUMA node) before the next one.
+// Good for threads that share a lot of data.
+// Wraps around if there are more threads than CPUs.
+inline thread_placement compact_thread_placement(std::size_t n_threads)
 {
-    internal::trigger_static_asserts<internal::binary_function_tag, F>();
-    ContainerOut ys;
-    internal::prepare_container(ys, size_of_cont(xs));
-    auto it = internal::get_back_inserter<ContainerOut>(ys);
-    std::size_t idx = 0;
-    for (const auto& x : xs) {
-        *it = internal::invoke(f, idx++, x);
-    }
-    return ys;
+    return internal::thread_placement_from_order(
+        internal::compact_cpu_order(internal::allowed_cpu_locations()),
+        n_threads);
 }
 
-// API search type: transform_and_keep_justs : ((a -> Maybe b), [a]) -> [b]
-// fwd bind count: 1
-// Map function over values and drop resulting nothings.
-// Also known as filter_map.
-template <typename F, typename ContainerIn>
-auto transform_and_keep_justs(F f, const ContainerIn& xs)
+// API search type: scatter_thread_placement : Int -> ThreadPlacement
+// n threads spread as widely as possible over the CPUs
+// the process may use, i.e. alternating between the packages,
+// and using hyper-threads only after every physical core got a thread.
+// Good for threads that need much memory bandwidth.
+// Wraps around if there are more threads than CPUs.
+inline thread_placement scatter_thread_placement(std::size_t n_threads)
 {
-    using X = typename ContainerIn::value_type;
-    internal::
-        trigger_static_asserts<internal::unary_function_tag, F, X>();
+    return internal::thread_placement_from_order(
+        internal::scatter_cpu_order(internal::allowed_cpu_locations()),
+        n_threads);
+}
 
-    using ContainerOut = typename internal::same_cont_new_t<
-        ContainerIn,
-        typename std::decay_t<internal::invoke_result_t<F, X>>::type>::type;
+namespace internal {
 
-    auto transformed = transform(f, xs);
-    return justs<decltype(transformed), ContainerOut>(transformed);
-}
+    // Index-based read access to the elements of a container.
+    // Non-random-access containers get a temporary table of iterators.
+    template <typename Container,
+        bool IsRandomAccess = std::is_base_of<std::random_access_iterator_tag,
+            typename std::iterator_traits<
+                typename Container::const_iterator>::iterator_category>::value>
+    class indexed_elems {
+    public:
+        explicit indexed_elems(const Container& xs)
+            : its_()
+        {
+            its_.reserve(size_of_cont(xs));
+            for (auto it = std::cbegin(xs); it != std::cend(xs); ++it) {
+                its_.push_back(it);
+            }
+        }
+        decltype(auto) operator[](std::size_t idx) const
+        {
+            return *its_[idx];
+        }
 
-// API search type: transform_and_keep_oks : ((a -> Result b), [a]) -> [b]
-// fwd bind count: 1
-// Map function over values and drop resulting errors.
-template <typename F, typename ContainerIn>
-auto transform_and_keep_oks(F f, const ContainerIn& xs)
-{
-    using X = typename ContainerIn::value_type;
-    internal::
-        trigger_static_asserts<internal::unary_function_tag, F, X>();
+    private:
+        std::vector<typename Container::const_iterator> its_;
+    };
 
-    using ContainerOut = typename internal::same_cont_new_t<
-        ContainerIn,
-        typename std::decay_t<internal::invoke_result_t<F, X>>::ok_t>::type;
-    auto transformed = transform(f, xs);
-    return oks<decltype(transformed), ContainerOut>(transformed);
-}
+    template <typename Container>
+    class indexed_elems<Container, true> {
+    public:
+        explicit indexed_elems(const Container& xs)
+            : begin_(std::cbegin(xs))
+        {
+        }
+        decltype(auto) operator[](std::size_t idx) const
+        {
+            return begin_[static_cast<std::ptrdiff_t>(idx)];
+        }
 
-// API search type: transform_and_concat : ((a -> [b]), [a]) -> [b]
-// fwd bind count: 1
-// Map function over values and concat results.
-// Also known as flat_map or concat_map.
-template <typename F, typename ContainerIn>
-auto transform_and_concat(F f, const ContainerIn& xs)
-{
-    internal::trigger_static_asserts<internal::unary_function_tag, F, typename ContainerIn::value_type>();
-    return concat(transform(f, xs));
-}
+    private:
+        typename Container::const_iterator begin_;
+    };
+
+    // Pre-sized output of a parallel transformation.
+    // Every slot is written exactly once, by whichever thread
+    // processes the corresponding input element.
+    // Types without a default constructor or move assignment, and bool
+    // (std::vector<bool> packs neighboring slots into one byte),
+    // are stored as maybes.
+    template <typename Y,
+        bool Direct = std::is_default_constructible<Y>::value
+            && std::is_move_assignable<Y>::value
+            && !std::is_same<Y, bool>::value>
+    class parallel_output_slots {
+    public:
+        explicit parallel_output_slots(std::size_t n)
+            : ys_(n)
+        {
+        }
+        void set(std::size_t idx, Y&& y)
+        {
+            ys_[idx] = std::move(y);
+        }
+        template <typename ContainerOut>
+        ContainerOut get(std::true_type)
+        {
+            return std::move(ys_);
+        }
+        template <typename ContainerOut>
+        ContainerOut get(std::false_type)
+        {
+            return convert_container<ContainerOut>(ys_);
+        }
+        template <typename ContainerOut>
+        ContainerOut get()
+        {
+            return get<ContainerOut>(
+                std::is_same<ContainerOut, std::vector<Y>> {});
+        }
 
-// API search type: replicate_elems : (Int, [a]) -> [a]
-// fwd bind count: 1
-// Replicate every element n times, concatenate the result.
-// replicate_elems(3, [1,2]) == [1, 1, 1, 2, 2, 2]
-template <typename Container>
-Container replicate_elems(std::size_t n, const Container& xs)
-{
-    typedef typename Container::value_type T;
-    return transform_and_concat(bind_1st_of_2(replicate<T, Container>, n), xs);
-}
+    private:
+        std::vector<Y> ys_;
+    };
 
-// API search type: interleave : [[a]] -> [a]
-// fwd bind count: 0
-// Return a sequence that contains elements from the provided sequences
-// in alternating order. If one list runs out of items,
-// appends the items from the remaining list.
-// interleave([[1,2,3],[4,5],[6,7,8]]) == [1,4,6,2,5,7,3,8]
-template <typename ContainerIn,
-    typename ContainerOut = typename ContainerIn::value_type>
-ContainerOut interleave(const ContainerIn& xss)
-{
-    typedef typename ContainerIn::value_type inner_t;
-    typedef std::vector<typename inner_t::const_iterator> its_t;
-    const auto inner_cbegin = [](const inner_t& xs) { return xs.cbegin(); };
-    const auto inner_cend = [](const inner_t& xs) { return xs.cend(); };
-    auto it_pairs = zip(
-        transform_convert<its_t>(inner_cbegin, xss),
-        transform_convert<its_t>(inner_cend, xss));
+    template <typename Y>
+    class parallel_output_slots<Y, false> {
+    public:
+        explicit parallel_output_slots(std::size_t n)
+            : ys_(n)
+        {
+        }
+        void set(std::size_t idx, Y&& y)
+        {
+            ys_[idx] = std::move(y);
+        }
+        template <typename ContainerOut>
+        ContainerOut get()
+        {
+            ContainerOut result;
+            internal::prepare_container(result, ys_.size());
+            auto it = internal::get_back_inserter<ContainerOut>(result);
+            for (auto& y : ys_) {
+                *it = std::move(y.unsafe_get_just());
+            }
+            return result;
+        }
 
-    ContainerOut result;
-    const std::size_t length = sum(transform(size_of_cont<inner_t>, xss));
-    internal::prepare_container(result, length);
-    auto it_out = internal::get_back_inserter<ContainerOut>(result);
-    bool still_appending = true;
-    while (still_appending) {
-        still_appending = false;
-        for (auto& it_pair : it_pairs) {
-            if (it_pair.first != it_pair.second) {
-                *it_out = *it_pair.first;
-                still_appending = true;
-                ++it_pair.first;
+    private:
+        std::vector<maybe<Y>> ys_;
+    };
+
+    // Calls worker() on n threads, the calling thread being one of them,
+    // and rethrows the first exception thrown by any of them.
+    template <typename F>
+    void run_on_n_threads(std::size_t n, F worker)
+    {
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        const auto guarded_worker = [&]() {
+            try {
+                worker();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(n);
+        for (std::size_t i = 1; i < n; ++i) {
+            threads.emplace_back(guarded_worker);
+        }
+        guarded_worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Chunk runners process n_chunks chunks by calling f(chunk_idx),
+    // know how many workers they have at their disposal
+    // and into how many chunks a job over n items should be split.
+
+    // Runs the chunks on a thread pool.
+    struct pool_chunk_runner {
+        thread_pool& pool;
+        std::size_t n_workers() const
+        {
+            return pool.size();
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return parallel_chunk_count(n_items, n_workers());
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            pool.run_chunks(n_chunks, f);
+        }
+    };
+
+    // Tuning constants of adaptive_chunk_runner.
+    // Time spent sampling chunks before deciding.
+    const double adaptive_sample_seconds = 50e-6;
+    // Minimum work an additional thread has to get to be worth using it.
+    const double adaptive_min_seconds_per_thread = 100e-6;
+    // Desired duration of one task, to keep the queue overhead low.
+    const double adaptive_task_seconds = 50e-6;
+
+    // Chooses how the n_rest chunks left after sampling are distributed,
+    // given that n_sampled chunks took sampled_seconds on one thread.
+    inline parallel_schedule adaptive_schedule(std::size_t n_chunks,
+        std::size_t n_sampled, double sampled_seconds,
+        std::size_t n_rest, std::size_t n_workers)
+    {
+        const double seconds_per_chunk = sampled_seconds
+            / static_cast<double>(std::max<std::size_t>(1, n_sampled));
+        const double rest_seconds = seconds_per_chunk * static_cast<double>(n_rest);
+        const double max_threads = std::min(
+            static_cast<double>(std::min(n_workers + 1, n_rest)),
+            rest_seconds / adaptive_min_seconds_per_thread);
+        const std::size_t n_threads = std::max<std::size_t>(1,
+            static_cast<std::size_t>(max_threads));
+        std::size_t chunks_per_task = std::max<std::size_t>(1, n_rest);
+        if (n_threads > 1) {
+            // Leave some slack to balance unevenly expensive chunks.
+            const std::size_t max_chunks_per_task = std::max<std::size_t>(1,
+                n_rest / (4 * n_threads));
+            chunks_per_task = static_cast<std::size_t>(std::max(1.0,
+                std::ceil(std::min(static_cast<double>(max_chunks_per_task),
+                    adaptive_task_seconds / seconds_per_chunk))));
+        }
+        return { n_chunks, n_sampled, sampled_seconds, rest_seconds,
+            n_threads, chunks_per_task };
+    }
+
+    // Runs many small chunks on a thread pool,
+    // choosing the number of threads and the grain size at run time:
+    // Jobs with no more chunks than threads are handed to the pool directly.
+    // Otherwise all threads start claiming chunks one by one,
+    // while the first of them measures the cost of its chunks.
+    // From that, the remaining work is estimated.
+    // If it does not justify more threads, the surplus ones stop,
+    // down to the sampling thread processing the rest on its own.
+    // The others continue in tasks of as many chunks
+    // as are needed to make the claiming overhead negligible.
+    // The chosen schedule is reported to the parallel_schedule_observer.
+    struct adaptive_chunk_runner {
+        thread_pool& pool;
+        std::size_t n_workers() const
+        {
+            return pool.size();
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return std::min(n_items, 64 * (n_workers() + 1));
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            if (n_chunks == 0) {
+                return;
             }
+            const std::size_t max_threads = n_workers() + 1;
+            if (n_chunks <= max_threads) {
+                parallel_schedule_observer().notify({ n_chunks, 0, 0, 0, n_chunks, 1 });
+                pool.run_chunks(n_chunks, f);
+                return;
+            }
+
+            typedef std::chrono::steady_clock clock;
+            // Chunks are claimed from next_chunk, chunks_per_task at a time.
+            // Threads ranked at or above n_threads stop claiming.
+            // The sampling thread has rank 0.
+            std::atomic<std::size_t> next_chunk(0);
+            std::atomic<std::size_t> chunks_per_task(1);
+            std::atomic<std::size_t> n_threads(max_threads);
+            std::atomic<std::size_t> next_rank(0);
+            parallel_schedule schedule = { n_chunks, 0, 0, 0, max_threads, 1 };
+            const auto sample = [&]() {
+                const std::size_t max_sampled = std::max<std::size_t>(1, n_chunks / 8);
+                const auto sample_start = clock::now();
+                std::size_t n_sampled = 0;
+                double sampled_seconds = 0;
+                while (n_sampled < max_sampled
+                    && sampled_seconds < adaptive_sample_seconds) {
+                    const std::size_t chunk_idx = next_chunk.fetch_add(1);
+                    if (chunk_idx >= n_chunks) {
+                        break;
+                    }
+                    f(chunk_idx);
+                    ++n_sampled;
+                    sampled_seconds = std::chrono::duration<double>(
+                        clock::now() - sample_start)
+                                          .count();
+                }
+                const std::size_t n_claimed = std::min(n_chunks, next_chunk.load());
+                schedule = adaptive_schedule(n_chunks, n_sampled, sampled_seconds,
+                    n_chunks - n_claimed, n_workers());
+                chunks_per_task.store(schedule.chunks_per_task);
+                n_threads.store(schedule.n_threads);
+            };
+            pool.run_chunks(
+                max_threads, [&](std::size_t) {
+                    const std::size_t rank = next_rank.fetch_add(1);
+                    if (rank == 0) {
+                        sample();
+                    }
+                    while (rank < n_threads.load()) {
+                        const std::size_t n = chunks_per_task.load();
+                        const std::size_t begin = next_chunk.fetch_add(n);
+                        if (begin >= n_chunks) {
+                            return;
+                        }
+                        const std::size_t end = std::min(n_chunks, begin + n);
+                        for (std::size_t chunk_idx = begin; chunk_idx < end; ++chunk_idx) {
+                            f(chunk_idx);
+                        }
+                    }
+                },
+                n_workers());
+            parallel_schedule_observer().notify(schedule);
         }
-    }
-    return result;
-}
+    };
 
-// API search type: transpose : [[a]] -> [[a]]
-// fwd bind count: 0
-// Transpose a nested sequence aka. table aka. two-dimensional matrix.
-// transpose([[1,2,3],[4,5,6],[7,8,9]]) == [[1,4,7],[2,5,8],[3,6,9]]
-// transpose([[1,2,3],[4,5],[7,8,9]]) == [[1,4,7],[2,5,8],[3,9]]
-template <typename Container>
-Container transpose(const Container& rows)
-{
-    if (is_empty(rows)) {
-        return {};
+    inline adaptive_chunk_runner default_chunk_runner()
+    {
+        return { default_thread_pool() };
     }
-    return split_every<typename Container::value_type, Container>(
-        size_of_cont(rows), interleave(rows));
-}
 
-namespace internal {
+    // Runs the chunks on n new threads,
+    // which claim the next free chunk from a shared counter.
+    struct n_threads_chunk_runner {
+        std::size_t n;
+        std::size_t n_workers() const
+        {
+            return n;
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return parallel_chunk_count(n_items, n_workers());
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            std::atomic<std::size_t> next_chunk(0);
+            run_on_n_threads(
+                std::max<std::size_t>(1, std::min(n, n_chunks)), [&]() {
+                    for (;;) {
+                        const std::size_t chunk_idx = next_chunk.fetch_add(1);
+                        if (chunk_idx >= n_chunks) {
+                            return;
+                        }
+                        f(chunk_idx);
+                    }
+                });
+        }
+    };
+
+    // Runs the chunks on one new thread per entry of a thread_placement,
+    // every thread pinned to its CPU.
+    // There is one contiguous chunk per thread and the assignment is static,
+    // so a thread always works on the same slice of the data.
+    struct placed_chunk_runner {
+        const thread_placement& placement;
+        std::size_t n_workers() const
+        {
+            return placement.cpus.size();
+        }
+        std::size_t chunk_count(std::size_t n_items) const
+        {
+            return std::min(n_items, n_workers());
+        }
+        template <typename F>
+        void operator()(std::size_t n_chunks, F f) const
+        {
+            const std::size_t n_threads = std::min(n_chunks, n_workers());
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            const auto worker = [&](std::size_t thread_idx) {
+                pin_current_thread_to_cpu(placement.cpus[thread_idx]);
+                try {
+                    for (std::size_t chunk_idx = thread_idx; chunk_idx < n_chunks;
+                         chunk_idx += n_threads) {
+                        f(chunk_idx);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(n_threads);
+            for (std::size_t i = 0; i < n_threads; ++i) {
+                threads.emplace_back(worker, i);
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    };
 
+    // Iterators to the first element of every chunk
+    // plus the end iterator of the container.
     template <typename Container>
-    Container shuffle(internal::reuse_container_t,
-        std::uint_fast32_t seed, Container&& xs)
+    std::vector<typename Container::const_iterator> chunk_begin_iterators(
+        const Container& xs, std::size_t n_chunks)
     {
-        std::mt19937 g(seed);
-        std::shuffle(std::begin(xs), std::end(xs), g);
-        return std::forward<Container>(xs);
+        const std::size_t n = size_of_cont(xs);
+        std::vector<typename Container::const_iterator> result;
+        result.reserve(n_chunks + 1);
+        result.push_back(std::cbegin(xs));
+        for (std::size_t i = 0; i < n_chunks; ++i) {
+            const auto chunk_size = parallel_chunk_begin(n, n_chunks, i + 1)
+                - parallel_chunk_begin(n, n_chunks, i);
+            result.push_back(std::next(
+                result.back(), static_cast<std::ptrdiff_t>(chunk_size)));
+        }
+        return result;
     }
 
-    template <typename Container>
-    Container shuffle(internal::create_new_container_t,
-        std::uint_fast32_t seed, const Container& xs)
+    // Every chunk is folded sequentially into one partial result,
+    // then the partial results are joined from left to right.
+    // So binary_f only needs to be associative,
+    // and the memory overhead is one value per chunk.
+    template <typename ChunkRunner, typename UnaryF, typename BinaryF,
+        typename Container>
+    auto transform_reduce_1_chunked(const ChunkRunner& run_chunks,
+        UnaryF unary_f,
+        BinaryF binary_f,
+        const Container& xs)
     {
-        Container ys = xs;
-        return internal::shuffle(internal::reuse_container_t(), seed, std::move(ys));
+        assert(is_not_empty(xs));
+        using X = typename Container::value_type;
+        using T = std::decay_t<internal::invoke_result_t<UnaryF, X>>;
+        const std::size_t n_chunks = run_chunks.chunk_count(size_of_cont(xs));
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+        std::vector<maybe<T>> partials(n_chunks);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            auto it = chunk_begins[chunk_idx];
+            const auto end = chunk_begins[chunk_idx + 1];
+            T acc = internal::invoke(unary_f, *it);
+            for (++it; it != end; ++it) {
+                acc = internal::invoke(binary_f, std::move(acc),
+                    internal::invoke(unary_f, *it));
+            }
+            partials[chunk_idx] = std::move(acc);
+        });
+        T result = std::move(partials.front().unsafe_get_just());
+        for (std::size_t i = 1; i < n_chunks; ++i) {
+            result = internal::invoke(binary_f, std::move(result),
+                std::move(partials[i].unsafe_get_just()));
+        }
+        return result;
     }
 
-} // namespace internal
+    // Identity function handing out references to the elements,
+    // so a plain reduction does not copy them.
+    struct pass_elem_through {
+        template <typename T>
+        const T& operator()(const T& x) const
+        {
+            return x;
+        }
+    };
 
-// API search type: shuffle : (Int, [a]) -> [a]
-// fwd bind count: 1
-// Returns a randomly shuffled version of xs.
-// Example call: shuffle(std::mt19937::default_seed, xs);
-// Example call: shuffle(std::random_device()(), xs);
-template <typename Container>
-auto shuffle(std::uint_fast32_t seed, Container&& xs)
-{
-    return (internal::shuffle(internal::can_reuse_v<Container> {},
-        seed, std::forward<Container>(xs)));
-}
+    // Parallel stream compaction:
+    // 1. Every chunk evaluates the predicate and counts its matches.
+    // 2. An exclusive prefix sum over the (few) chunk counts
+    //    yields the output offset of every chunk.
+    // 3. Every chunk copies its elements into the pre-sized outputs.
+    // Only the requested sides of the partition are filled.
+    template <typename ChunkRunner, typename Pred, typename Container>
+    std::pair<Container, Container> partition_chunked(
+        const ChunkRunner& run_chunks,
+        Pred pred,
+        const Container& xs,
+        bool fill_matching,
+        bool fill_not_matching)
+    {
+        using T = typename Container::value_type;
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+
+        // Avoid a temporary std::vector<bool>.
+        std::vector<std::uint8_t> flags(n, 0);
+        std::vector<std::size_t> matching_offsets(n_chunks + 1, 0);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx);
+            std::size_t count = 0;
+            for (auto it = chunk_begins[chunk_idx];
+                 it != chunk_begins[chunk_idx + 1]; ++it, ++idx) {
+                if (internal::invoke(pred, *it)) {
+                    flags[idx] = 1;
+                    ++count;
+                }
+            }
+            matching_offsets[chunk_idx + 1] = count;
+        });
+        for (std::size_t i = 1; i <= n_chunks; ++i) {
+            matching_offsets[i] += matching_offsets[i - 1];
+        }
+        const std::size_t n_matching = matching_offsets.back();
+
+        parallel_output_slots<T> matching(fill_matching ? n_matching : 0);
+        parallel_output_slots<T> not_matching(
+            fill_not_matching ? n - n_matching : 0);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            const std::size_t chunk_begin = parallel_chunk_begin(n, n_chunks, chunk_idx);
+            std::size_t idx = chunk_begin;
+            std::size_t idx_matching = matching_offsets[chunk_idx];
+            std::size_t idx_not_matching = chunk_begin - idx_matching;
+            for (auto it = chunk_begins[chunk_idx];
+                 it != chunk_begins[chunk_idx + 1]; ++it, ++idx) {
+                if (flags[idx]) {
+                    if (fill_matching) {
+                        matching.set(idx_matching, T(*it));
+                    }
+                    ++idx_matching;
+                } else {
+                    if (fill_not_matching) {
+                        not_matching.set(idx_not_matching, T(*it));
+                    }
+                    ++idx_not_matching;
+                }
+            }
+        });
+        return { matching.template get<Container>(),
+            not_matching.template get<Container>() };
+    }
+
+    // Searches the chunks in parallel for an element fulfilling pred.
+    // Found indices are published through a shared atomic minimum,
+    // and every chunk stops as soon as it can not improve on it anymore,
+    // i.e. all remaining work is cancelled cooperatively.
+    // Returns the lowest matching index,
+    // or any matching index if any_match_suffices is set.
+    template <typename ChunkRunner, typename Pred, typename Container>
+    maybe<std::size_t> find_first_idx_by_chunked(
+        const ChunkRunner& run_chunks, Pred pred, const Container& xs,
+        bool any_match_suffices)
+    {
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+        std::atomic<std::size_t> found_idx(n);
+        const auto is_done = [&](std::size_t idx) {
+            const std::size_t found = found_idx.load(std::memory_order_relaxed);
+            return any_match_suffices ? found != n : idx >= found;
+        };
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx);
+            for (auto it = chunk_begins[chunk_idx];
+                 it != chunk_begins[chunk_idx + 1] && !is_done(idx); ++it, ++idx) {
+                if (internal::invoke(pred, *it)) {
+                    std::size_t found = found_idx.load();
+                    while (idx < found
+                        && !found_idx.compare_exchange_weak(found, idx)) {
+                    }
+                    return;
+                }
+            }
+        });
+        if (found_idx.load() == n) {
+            return nothing<std::size_t>();
+        }
+        return just(found_idx.load());
+    }
+
+    // Two-pass parallel prefix scan:
+    // 1. Every chunk (but the last) is folded into one partial result.
+    // 2. An exclusive scan over the (few) partial results
+    //    yields the carry-in value of every chunk.
+    // 3. Every chunk scans its elements starting with its carry-in,
+    //    writing directly into the pre-sized output.
+    // If init is a just, it is the first element of the output
+    // and the carry-in of the first chunk.
+    template <typename ContainerOut, typename ChunkRunner, typename F,
+        typename Container>
+    ContainerOut scan_left_chunked(const ChunkRunner& run_chunks, F f,
+        const maybe<typename Container::value_type>& init, const Container& xs)
+    {
+        using T = typename Container::value_type;
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const auto chunk_begins = chunk_begin_iterators(xs, n_chunks);
+        const std::size_t out_offset = init.is_just() ? 1 : 0;
+        parallel_output_slots<T> ys(n + out_offset);
+        if (init.is_just()) {
+            ys.set(0, T(init.unsafe_get_just()));
+        }
 
-// API search type: sample : (Int, Int, [a]) -> [a]
-// fwd bind count: 2
-// Returns n random elements from xs without replacement.
-// n has to be smaller than or equal to the number of elements in xs.
-// Also known as rnd_select.
-// Example call: sample(std::mt19937::default_seed, 3, xs);
-// Example call: sample(std::random_device()(), 3, xs);
-template <typename Container>
-Container sample(std::uint_fast32_t seed, std::size_t n, const Container& xs)
-{
-    assert(n <= size_of_cont(xs));
-    return get_segment(0, n, shuffle(seed, xs));
-}
+        std::vector<maybe<T>> partials(n_chunks);
+        if (n_chunks > 1) {
+            run_chunks(n_chunks - 1, [&](std::size_t chunk_idx) {
+                auto it = chunk_begins[chunk_idx];
+                T acc = *it;
+                for (++it; it != chunk_begins[chunk_idx + 1]; ++it) {
+                    acc = internal::invoke(f, std::move(acc), *it);
+                }
+                partials[chunk_idx] = std::move(acc);
+            });
+        }
 
-// API search type: random_element : (Int, [a]) -> a
-// fwd bind count: 1
-// Returns one random element from xs.
-// xs must be non-empty.
-// Example call: random_element(std::mt19937::default_seed, xs)
-// Example call: random_element(std::random_device()(), xs)
-// Also known as choice.
-template <typename Container>
-typename Container::value_type random_element(
-    std::uint_fast32_t seed, const Container& xs)
-{
-    assert(is_not_empty(xs));
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<std::size_t> dis(0, size_of_cont(xs) - 1);
-    return elem_at_idx(dis(gen), xs);
-}
+        std::vector<maybe<T>> carries(n_chunks);
+        if (n_chunks > 0) {
+            carries[0] = init;
+        }
+        for (std::size_t i = 1; i < n_chunks; ++i) {
+            if (carries[i - 1].is_just()) {
+                carries[i] = internal::invoke(f,
+                    carries[i - 1].unsafe_get_just(),
+                    partials[i - 1].unsafe_get_just());
+            } else {
+                carries[i] = partials[i - 1];
+            }
+        }
 
-// API search type: random_elements : (Int, Int, [a]) -> a
-// fwd bind count: 2
-// Returns random elements from xs with replacement.
-// xs must be non-empty.
-// Example call: random_elements(std::mt19937::default_seed, 10, xs)
-// Example call: random_elements(std::random_device()(), 10, xs)
-template <typename Container>
-Container random_elements(
-    std::uint_fast32_t seed, std::size_t n, const Container& xs)
-{
-    assert(is_not_empty(xs));
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<std::size_t> dis(0, size_of_cont(xs) - 1);
-    const auto draw = [&]() -> typename Container::value_type {
-        return elem_at_idx(dis(gen), xs);
-    };
-    return generate<Container>(draw, n);
-}
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx) + out_offset;
+            auto it = chunk_begins[chunk_idx];
+            T acc = carries[chunk_idx].is_just()
+                ? internal::invoke(f, carries[chunk_idx].unsafe_get_just(), *it)
+                : T(*it);
+            ys.set(idx++, T(acc));
+            for (++it; it != chunk_begins[chunk_idx + 1]; ++it) {
+                acc = internal::invoke(f, std::move(acc), *it);
+                ys.set(idx++, T(acc));
+            }
+        });
+        return ys.template get<ContainerOut>();
+    }
 
-// API search type: apply_functions : ([(a -> b)], a) -> [b]
-// fwd bind count: 1
-// Applies a list of functions to a value.
-template <typename FunctionContainer,
-    typename F = typename FunctionContainer::value_type,
-    typename FIn>
-auto apply_functions(const FunctionContainer& functions, const FIn& x)
-{
-    internal::trigger_static_asserts<internal::unary_function_tag, F, FIn>();
+    // Moves the stable merge of [a, a_end) and [b, b_end) to out.
+    // On equivalence the element of the first range goes first.
+    template <typename Compare, typename InIt, typename OutIt>
+    void move_merge(Compare comp,
+        InIt a, InIt a_end, InIt b, InIt b_end, OutIt out)
+    {
+        while (a != a_end && b != b_end) {
+            if (internal::invoke(comp, *b, *a)) {
+                *out = std::move(*b);
+                ++b;
+            } else {
+                *out = std::move(*a);
+                ++a;
+            }
+            ++out;
+        }
+        out = std::move(a, a_end, out);
+        std::move(b, b_end, out);
+    }
 
-    using FOut = std::decay_t<internal::invoke_result_t<F, FIn>>;
-    using ContainerOut =
-        typename internal::same_cont_new_t<FunctionContainer, FOut, 0>::type;
+    // Number of elements taken from [a, a + size_a)
+    // when the first k elements of the stable merge of
+    // [a, a + size_a) and [b, b + size_b) are taken (merge path).
+    template <typename Compare, typename It>
+    std::size_t merge_path_split(Compare comp,
+        It a, std::size_t size_a, It b, std::size_t size_b, std::size_t k)
+    {
+        std::size_t lo = k > size_b ? k - size_b : 0;
+        std::size_t hi = std::min(k, size_a);
+        while (lo < hi) {
+            const std::size_t i = lo + (hi - lo) / 2;
+            const std::size_t j = k - i;
+            if (!internal::invoke(comp,
+                    b[static_cast<std::ptrdiff_t>(j - 1)],
+                    a[static_cast<std::ptrdiff_t>(i)])) {
+                lo = i + 1;
+            } else {
+                hi = i;
+            }
+        }
+        return lo;
+    }
+
+    // Parallel merge sort of a random-access range.
+    // Every worker sorts one contiguous run,
+    // then neighboring runs are merged pairwise in rounds,
+    // ping-ponging between the range and one buffer.
+    // Every merge is split along its merge path into pieces,
+    // so all workers are busy even in the last rounds.
+    // The merges are stable, so the result is stable
+    // if the runs are sorted stably.
+    // The runs are coarse by design, so this expects a pool_chunk_runner
+    // and not the sampling adaptive_chunk_runner.
+    template <typename ChunkRunner, typename Compare, typename It>
+    void merge_sort_parallelly(const ChunkRunner& run_chunks,
+        bool stable, Compare comp, It first, It last)
+    {
+        using T = typename std::iterator_traits<It>::value_type;
+        const std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+        const std::size_t n_workers = std::max<std::size_t>(1, run_chunks.n_workers());
+        const std::size_t n_runs = std::min(n_workers, n / 2);
+        const auto sort_range = [&](It begin, It end) {
+            if (stable) {
+                std::stable_sort(begin, end, comp);
+            } else {
+                std::sort(begin, end, comp);
+            }
+        };
+        // Neighboring elements of a std::vector<bool> share their bytes.
+        if (n_runs < 2 || std::is_same<T, bool>::value) {
+            sort_range(first, last);
+            return;
+        }
 
-    ContainerOut ys;
-    internal::prepare_container(ys, size_of_cont(functions));
-    auto it = internal::get_back_inserter<ContainerOut>(ys);
-    for (const auto& f : functions) {
-        *it = internal::invoke(f, x);
+        std::vector<std::size_t> bounds;
+        for (std::size_t i = 0; i <= n_runs; ++i) {
+            bounds.push_back(parallel_chunk_begin(n, n_runs, i));
+        }
+        const auto at = [](auto it, std::size_t idx) {
+            return std::next(it, static_cast<std::ptrdiff_t>(idx));
+        };
+        run_chunks(n_runs, [&](std::size_t run_idx) {
+            sort_range(at(first, bounds[run_idx]), at(first, bounds[run_idx + 1]));
+        });
+
+        std::vector<T> buffer(
+            std::make_move_iterator(first), std::make_move_iterator(last));
+        bool in_buffer = true;
+        while (bounds.size() > 2) {
+            const auto merge_round = [&](auto src, auto dst) {
+                const std::size_t n_pairs = (bounds.size() - 1) / 2;
+                // Every pair is split into pieces of about n / n_workers elements.
+                std::vector<std::size_t> pieces_begin = { 0 };
+                for (std::size_t p = 0; p < n_pairs; ++p) {
+                    const std::size_t pair_size = bounds[2 * p + 2] - bounds[2 * p];
+                    pieces_begin.push_back(pieces_begin.back()
+                        + std::max<std::size_t>(1, n_workers * pair_size / n));
+                }
+                const std::size_t n_pieces = pieces_begin.back();
+                const bool has_lonely_run = (bounds.size() - 1) % 2 == 1;
+                run_chunks(n_pieces + (has_lonely_run ? 1 : 0), [&](std::size_t piece_idx) {
+                    if (piece_idx == n_pieces) {
+                        const std::size_t begin = bounds[bounds.size() - 2];
+                        std::move(at(src, begin), at(src, n), at(dst, begin));
+                        return;
+                    }
+                    const std::size_t p = static_cast<std::size_t>(std::distance(
+                        pieces_begin.begin(),
+                        std::upper_bound(pieces_begin.begin(), pieces_begin.end(), piece_idx)) - 1);
+                    const std::size_t begin_a = bounds[2 * p];
+                    const std::size_t begin_b = bounds[2 * p + 1];
+                    const std::size_t size_a = begin_b - begin_a;
+                    const std::size_t size_b = bounds[2 * p + 2] - begin_b;
+                    const std::size_t n_pair_pieces = pieces_begin[p + 1] - pieces_begin[p];
+                    const std::size_t piece = piece_idx - pieces_begin[p];
+                    const std::size_t k_begin = parallel_chunk_begin(size_a + size_b, n_pair_pieces, piece);
+                    const std::size_t k_end = parallel_chunk_begin(size_a + size_b, n_pair_pieces, piece + 1);
+                    const auto a = at(src, begin_a);
+                    const auto b = at(src, begin_b);
+                    const std::size_t i_begin = merge_path_split(comp, a, size_a, b, size_b, k_begin);
+                    const std::size_t i_end = merge_path_split(comp, a, size_a, b, size_b, k_end);
+                    move_merge(comp,
+                        at(a, i_begin), at(a, i_end),
+                        at(b, k_begin - i_begin), at(b, k_end - i_end),
+                        at(dst, begin_a + k_begin));
+                });
+            };
+            if (in_buffer) {
+                merge_round(buffer.begin(), first);
+            } else {
+                merge_round(first, buffer.begin());
+            }
+            in_buffer = !in_buffer;
+            std::vector<std::size_t> merged_bounds;
+            for (std::size_t i = 0; i < bounds.size(); i += 2) {
+                merged_bounds.push_back(bounds[i]);
+            }
+            if (merged_bounds.back() != n) {
+                merged_bounds.push_back(n);
+            }
+            bounds = merged_bounds;
+        }
+        if (in_buffer) {
+            run_chunks(n_workers, [&](std::size_t chunk_idx) {
+                const std::size_t begin = parallel_chunk_begin(n, n_workers, chunk_idx);
+                const std::size_t end = parallel_chunk_begin(n, n_workers, chunk_idx + 1);
+                std::move(at(buffer.begin(), begin), at(buffer.begin(), end), at(first, begin));
+            });
+        }
     }
-    return ys;
-}
 
-// API search type: apply_function_n_times : ((a -> a), Int, a) -> a
-// fwd bind count: 2
-// Applies a functional n times in a row.
-template <typename F, typename FIn>
-auto apply_function_n_times(F f, std::size_t n, const FIn& x)
-{
-    internal::trigger_static_asserts<internal::unary_function_tag, F, FIn>();
-    using FOut = std::decay_t<internal::invoke_result_t<F, FIn>>;
-    static_assert(std::is_same<FOut, FIn>::value,
-        "Input and output of F must be the same type.");
-    if (n == 0) {
-        return x;
+    template <typename ChunkRunner, typename Compare, typename T>
+    std::list<T> sort_by_parallelly(internal::reuse_container_t,
+        const ChunkRunner&, bool stable, Compare comp, std::list<T>&& xs)
+    {
+        // std::list<T>::sort is stable, and lists can not be split cheaply.
+        (void)stable;
+        xs.sort(comp);
+        return std::forward<std::list<T>>(xs);
     }
-    FOut y = internal::invoke(f, x);
-    for (std::size_t i = 1; i < n; ++i) {
-        y = internal::invoke(f, y);
+
+    template <typename ChunkRunner, typename Compare, typename Container>
+    Container sort_by_parallelly(internal::reuse_container_t,
+        const ChunkRunner& run_chunks, bool stable, Compare comp,
+        Container&& xs)
+    {
+        merge_sort_parallelly(run_chunks, stable, comp,
+            std::begin(xs), std::end(xs));
+        return std::forward<Container>(xs);
+    }
+
+    template <typename ChunkRunner, typename Compare, typename Container>
+    Container sort_by_parallelly(internal::create_new_container_t,
+        const ChunkRunner& run_chunks, bool stable, Compare comp,
+        const Container& xs)
+    {
+        auto result = xs;
+        return sort_by_parallelly(internal::reuse_container_t(),
+            run_chunks, stable, comp, std::move(result));
     }
-    return y;
-}
+
+    // Applies f to contiguous chunks of xs,
+    // writing every result directly into its output slot.
+    template <typename ContainerOut, typename ChunkRunner, typename F,
+        typename ContainerIn>
+    ContainerOut transform_parallelly_chunked(
+        const ChunkRunner& run_chunks, F f, const ContainerIn& xs)
+    {
+        using X = typename ContainerIn::value_type;
+        using Y = std::decay_t<internal::invoke_result_t<F, X>>;
+        const std::size_t n = size_of_cont(xs);
+        const std::size_t n_chunks = run_chunks.chunk_count(n);
+        const indexed_elems<ContainerIn> elems(xs);
+        parallel_output_slots<Y> ys(n);
+        run_chunks(n_chunks, [&](std::size_t chunk_idx) {
+            const std::size_t end = parallel_chunk_begin(n, n_chunks, chunk_idx + 1);
+            for (std::size_t idx = parallel_chunk_begin(n, n_chunks, chunk_idx);
+                 idx < end; ++idx) {
+                ys.set(idx, internal::invoke(f, elems[idx]));
+            }
+        });
+        return ys.template get<ContainerOut>();
+    }
+
+} // namespace internal
 
 // API search type: transform_parallelly : ((a -> b), [a]) -> [b]
 // fwd bind count: 1
 // transform_parallelly((*2), [1, 3, 4]) == [2, 6, 8]
-// Same as transform, but can utilize multiple CPUs by using std::launch::async.
-// Only makes sense if one run of the provided function
-// takes enough time to justify the synchronization overhead.
-// One thread per container element is spawned.
-// Check out transform_parallelly_n_threads to limit the number of threads.
-template <typename F, typename ContainerIn>
-auto transform_parallelly(F f, const ContainerIn& xs)
-{
-    using ContainerOut = typename internal::
-        same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
-    using X = typename ContainerIn::value_type;
-    internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
-    auto handles = transform([&f](const X& x) {
-        return std::async(std::launch::async, [&x, &f]() {
-            return internal::invoke(f, x);
-        });
-    },
-        xs);
-
-    ContainerOut ys;
-    internal::prepare_container(ys, size_of_cont(xs));
-    auto it = internal::get_back_inserter<ContainerOut>(ys);
-    for (auto& handle : handles) {
-        *it = handle.get();
-    }
-    return ys;
+// Same as transform, but can utilize multiple CPUs.
+// The elements are processed in contiguous chunks
+// by a process-wide pool of worker threads,
+// which is created once and then reused by all *_parallelly functions.
+// The cost of f is measured on the first elements,
+// and the remaining ones are only distributed to other threads
+// if this is estimated to pay off, otherwise they are processed serially.
+// set_parallel_schedule_observer allows to inspect these decisions.
+// Check out transform_parallelly_n_threads to limit the number of threads.
+template <typename F, typename ContainerIn>
+auto transform_parallelly(F f, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::
+        same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
+    using X = typename ContainerIn::value_type;
+    internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
+    return internal::transform_parallelly_chunked<ContainerOut>(
+        internal::default_chunk_runner(), f, xs);
 }
 
 // API search type: transform_parallelly_n_threads : (Int, (a -> b), [a]) -> [b]
 // fwd bind count: 2
 // transform_parallelly_n_threads(4, (*2), [1, 3, 4]) == [2, 6, 8]
 // Same as transform, but uses n threads in parallel.
-// Only makes sense if one run of the provided function
-// takes enough time to justify the synchronization overhead.
+// The threads claim contiguous ranges of elements from a shared counter
+// and write the results directly into the pre-sized output,
+// so no locking is involved.
 // Can be used for applying the MapReduce pattern.
 template <typename F, typename ContainerIn>
 auto transform_parallelly_n_threads(std::size_t n, F f, const ContainerIn& xs)
@@ -11356,64 +14701,41 @@ auto transform_parallelly_n_threads(std::size_t n, F f, const ContainerIn& xs)
     using ContainerOut = typename internal::
         same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
     using X = typename ContainerIn::value_type;
-    using Y = internal::invoke_result_t<F, X>;
-    using x_ptr_t = const X*;
-    auto queue = transform_convert<std::vector<x_ptr_t>>(
-        [](const X& x) -> x_ptr_t {
-            return &x;
-        },
-        xs);
-
-    std::mutex queue_mutex;
-    std::mutex thread_results_mutex;
-    std::map<std::size_t, std::decay_t<Y>> thread_results;
-    std::size_t queue_idx = 0;
-
-    const auto worker_func = [&]() {
-        for (;;) {
-            std::size_t idx = std::numeric_limits<std::size_t>::max();
-            x_ptr_t x_ptr = nullptr;
-            {
-                std::lock_guard<std::mutex> queue_lock(queue_mutex);
-                if (queue_idx == queue.size()) {
-                    return;
-                }
-                idx = queue_idx;
-                x_ptr = queue[idx];
-                ++queue_idx;
-            }
-
-            const auto y = internal::invoke(f, *x_ptr);
-
-            {
-                std::lock_guard<std::mutex> thread_results_lock(
-                    thread_results_mutex);
-                thread_results.insert(std::make_pair(idx, y));
-            }
-        }
-    };
-
-    const auto create_thread = [&]() -> std::thread {
-        return std::thread(worker_func);
-    };
-    auto threads = generate<std::vector<std::thread>>(create_thread, n);
-
-    for (auto& thread : threads) {
-        thread.join();
-    }
+    internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
+    return internal::transform_parallelly_chunked<ContainerOut>(
+        internal::n_threads_chunk_runner { n }, f, xs);
+}
 
-    return get_map_values<decltype(thread_results), ContainerOut>(
-        thread_results);
+// API search type: transform_parallelly_placed : (ThreadPlacement, (a -> b), [a]) -> [b]
+// fwd bind count: 2
+// transform_parallelly_placed(compact_thread_placement(4), (*2), [1, 3, 4]) == [2, 6, 8]
+// Same as transform, but uses one thread per entry of the placement,
+// each one pinned to its CPU and working on one contiguous slice of xs.
+// Useful on multi-socket machines to keep threads from migrating
+// and reading their data across the interconnect.
+// The output is allocated and initialized by the calling thread,
+// so its memory stays on the NUMA node of the caller.
+template <typename F, typename ContainerIn>
+auto transform_parallelly_placed(
+    const thread_placement& placement, F f, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::
+        same_cont_new_t_from_unary_f<ContainerIn, F, 0>::type;
+    using X = typename ContainerIn::value_type;
+    internal::trigger_static_asserts<internal::unary_function_tag, F, X>();
+    assert(!placement.cpus.empty());
+    return internal::transform_parallelly_chunked<ContainerOut>(
+        internal::placed_chunk_runner { placement }, f, xs);
 }
 
 // API search type: reduce_parallelly : (((a, a) -> a), a, [a]) -> a
 // fwd bind count: 2
 // reduce_parallelly((+), 0, [1, 2, 3]) == (0+1+2+3) == 6
-// Same as reduce, but can utilize multiple CPUs by using std::launch::async.
-// Combines the initial value and all elements of the sequence
-// using the given function in unspecified order.
-// The set of f, init and value_type should form a commutative monoid.
-// One thread per container element is spawned.
+// Same as reduce, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f, init and value_type should form a monoid.
 // Check out reduce_parallelly_n_threads to limit the number of threads.
 template <typename F, typename Container>
 typename Container::value_type reduce_parallelly(
@@ -11421,28 +14743,19 @@ typename Container::value_type reduce_parallelly(
 {
     if (is_empty(xs)) {
         return init;
-    } else if (size_of_cont(xs) == 1) {
-        return internal::invoke(f, init, xs.front());
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly(f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_parallelly(f, init, transform_result);
     }
+    return internal::invoke(f, init,
+        internal::transform_reduce_1_chunked(internal::default_chunk_runner(),
+            internal::pass_elem_through(), f, xs));
 }
 
 // API search type: reduce_parallelly_n_threads : (Int, ((a, a) -> a), a, [a]) -> a
 // fwd bind count: 3
 // reduce_parallelly_n_threads(2, (+), 0, [1, 2, 3]) == (0+1+2+3) == 6
-// Same as reduce, but can utilize multiple CPUs by using std::launch::async.
-// Combines the initial value and all elements of the sequence
-// using the given function in unspecified order.
-// The set of f, init and value_type should form a commutative monoid.
+// Same as reduce, but uses n threads in parallel.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f, init and value_type should form a monoid.
 template <typename F, typename Container>
 typename Container::value_type reduce_parallelly_n_threads(
     std::size_t n,
@@ -11450,74 +14763,249 @@ typename Container::value_type reduce_parallelly_n_threads(
 {
     if (is_empty(xs)) {
         return init;
-    } else if (size_of_cont(xs) == 1) {
-        return internal::invoke(f, init, xs.front());
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly_n_threads(n, f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_parallelly_n_threads(n, f, init, transform_result);
     }
+    return internal::invoke(f, init,
+        internal::transform_reduce_1_chunked(
+            internal::n_threads_chunk_runner { n }, internal::pass_elem_through(), f, xs));
 }
 
 // API search type: reduce_1_parallelly : (((a, a) -> a), [a]) -> a
 // fwd bind count: 1
 // reduce_1_parallelly((+), [1, 2, 3]) == (1+2+3) == 6
-// Same as reduce_1, but can utilize multiple CPUs by using std::launch::async.
-// Joins all elements of the sequence using the given function
-// in unspecified order.
-// The set of f and value_type should form a commutative semigroup.
-// One thread per container element is spawned.
+// Same as reduce_1, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f and value_type should form a semigroup.
 // Check out reduce_1_parallelly_n_threads to limit the number of threads.
 template <typename F, typename Container>
 typename Container::value_type reduce_1_parallelly(F f, const Container& xs)
 {
-    assert(is_not_empty(xs));
-    if (size_of_cont(xs) == 1) {
-        return xs.front();
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly(f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_1_parallelly(f, transform_result);
-    }
+    return internal::transform_reduce_1_chunked(
+        internal::default_chunk_runner(), internal::pass_elem_through(), f, xs);
 }
 
 // API search type: reduce_1_parallelly_n_threads : (Int, ((a, a) -> a), [a]) -> a
 // fwd bind count: 2
 // reduce_1_parallelly_n_threads(2, (+), [1, 2, 3]) == (1+2+3) == 6
-// Same as reduce_1, but can utilize multiple CPUs by using std::launch::async.
-// Joins all elements of the sequence using the given function
-// in unspecified order.
-// The set of f and value_type should form a commutative semigroup.
+// Same as reduce_1, but uses n threads in parallel.
+// Every thread folds a contiguous chunk of the sequence,
+// then the partial results are combined in order.
+// The set of f and value_type should form a semigroup.
 template <typename F, typename Container>
 typename Container::value_type reduce_1_parallelly_n_threads(
     std::size_t n, F f, const Container& xs)
+{
+    return internal::transform_reduce_1_chunked(
+        internal::n_threads_chunk_runner { n }, internal::pass_elem_through(), f, xs);
+}
+
+// API search type: scan_left_parallelly : (((a, a) -> a), a, [a]) -> [a]
+// fwd bind count: 2
+// scan_left_parallelly((+), 0, [1, 2, 3]) == [0, 1, 3, 6]
+// Same as scan_left, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// Every chunk of the sequence is folded in parallel,
+// then every chunk is scanned in parallel,
+// starting with the combined result of the chunks before it.
+// So f is called about twice as often as by scan_left.
+// The set of f, init and value_type should form a monoid.
+// Check out scan_left_parallelly_n_threads to limit the number of threads.
+template <typename F, typename ContainerIn>
+auto scan_left_parallelly(F f,
+    const typename ContainerIn::value_type& init, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 1>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::default_chunk_runner(), f, just(init), xs);
+}
+
+// API search type: scan_left_parallelly_n_threads : (Int, ((a, a) -> a), a, [a]) -> [a]
+// fwd bind count: 3
+// scan_left_parallelly_n_threads(2, (+), 0, [1, 2, 3]) == [0, 1, 3, 6]
+// Same as scan_left, but uses n threads in parallel.
+// The set of f, init and value_type should form a monoid.
+template <typename F, typename ContainerIn>
+auto scan_left_parallelly_n_threads(std::size_t n, F f,
+    const typename ContainerIn::value_type& init, const ContainerIn& xs)
+{
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 1>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::n_threads_chunk_runner { n }, f, just(init), xs);
+}
+
+// API search type: scan_left_1_parallelly : (((a, a) -> a), [a]) -> [a]
+// fwd bind count: 1
+// scan_left_1_parallelly((+), [1, 2, 3]) == [1, 3, 6]
+// Same as scan_left_1, but can utilize multiple CPUs
+// by running on the thread pool of transform_parallelly.
+// The set of f and value_type should form a semigroup.
+// xs must be non-empty.
+// Check out scan_left_1_parallelly_n_threads to limit the number of threads.
+template <typename F, typename ContainerIn>
+auto scan_left_1_parallelly(F f, const ContainerIn& xs)
 {
     assert(is_not_empty(xs));
-    if (size_of_cont(xs) == 1) {
-        return xs.front();
-    } else {
-        typedef typename Container::value_type T;
-        const auto f_on_pair = [f](const std::pair<T, T>& p) -> T {
-            return internal::invoke(f, p.first, p.second);
-        };
-        auto transform_result = transform_parallelly_n_threads(n, f_on_pair, adjacent_pairs(xs));
-        if (is_odd(size_of_cont(xs))) {
-            transform_result.push_back(last(xs));
-        }
-        return reduce_1_parallelly_n_threads(n, f, transform_result);
-    }
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 0>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::default_chunk_runner(), f, nothing<typename ContainerIn::value_type>(), xs);
+}
+
+// API search type: scan_left_1_parallelly_n_threads : (Int, ((a, a) -> a), [a]) -> [a]
+// fwd bind count: 2
+// scan_left_1_parallelly_n_threads(2, (+), [1, 2, 3]) == [1, 3, 6]
+// Same as scan_left_1, but uses n threads in parallel.
+// The set of f and value_type should form a semigroup.
+// xs must be non-empty.
+template <typename F, typename ContainerIn>
+auto scan_left_1_parallelly_n_threads(std::size_t n, F f, const ContainerIn& xs)
+{
+    assert(is_not_empty(xs));
+    using ContainerOut = typename internal::same_cont_new_t<
+        ContainerIn, typename ContainerIn::value_type, 0>::type;
+    return internal::scan_left_chunked<ContainerOut>(
+        internal::n_threads_chunk_runner { n }, f, nothing<typename ContainerIn::value_type>(), xs);
+}
+
+// API search type: any_by_parallelly : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Same as any_by, but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// The search stops on all threads as soon as one of them found a match.
+// Runs on the thread pool of transform_parallelly.
+// any_by_parallelly(is_odd, [2, 4, 6]) == false
+// Check out any_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+bool any_by_parallelly(UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::default_chunk_runner(), p, xs, true)
+        .is_just();
+}
+
+// API search type: any_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Bool
+// fwd bind count: 2
+// Same as any_by, but uses n threads in parallel.
+// any_by_parallelly_n_threads(4, is_odd, [2, 4, 6]) == false
+template <typename UnaryPredicate, typename Container>
+bool any_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate p, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::n_threads_chunk_runner { n }, p, xs, true)
+        .is_just();
+}
+
+// API search type: none_by_parallelly : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Same as none_by, but using multiple threads.
+// The search stops on all threads as soon as one of them found a match.
+// none_by_parallelly(is_even, [3, 4, 5]) == false
+// Check out none_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+bool none_by_parallelly(UnaryPredicate p, const Container& xs)
+{
+    return !any_by_parallelly(p, xs);
+}
+
+// API search type: none_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Bool
+// fwd bind count: 2
+// Same as none_by, but uses n threads in parallel.
+// none_by_parallelly_n_threads(4, is_even, [3, 4, 5]) == false
+template <typename UnaryPredicate, typename Container>
+bool none_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate p, const Container& xs)
+{
+    return !any_by_parallelly_n_threads(n, p, xs);
+}
+
+// API search type: all_by_parallelly : ((a -> Bool), [a]) -> Bool
+// fwd bind count: 1
+// Same as all_by, but using multiple threads.
+// The search stops on all threads as soon as one of them found
+// an element not fulfilling the predicate.
+// all_by_parallelly(is_even, [2, 4, 6]) == true
+// Check out all_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+bool all_by_parallelly(UnaryPredicate p, const Container& xs)
+{
+    return none_by_parallelly(logical_not(p), xs);
+}
+
+// API search type: all_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Bool
+// fwd bind count: 2
+// Same as all_by, but uses n threads in parallel.
+// all_by_parallelly_n_threads(4, is_even, [2, 4, 6]) == true
+template <typename UnaryPredicate, typename Container>
+bool all_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate p, const Container& xs)
+{
+    return none_by_parallelly_n_threads(n, logical_not(p), xs);
+}
+
+// API search type: find_first_idx_by_parallelly : ((a -> Bool), [a]) -> Maybe Int
+// fwd bind count: 1
+// Same as find_first_idx_by, but using multiple threads.
+// Still returns the lowest index of all matching elements.
+// Threads stop searching as soon as a match
+// at a lower index than their current position has been found.
+// find_first_idx_by_parallelly(is_even, [1, 3, 4, 6, 9]) == Just(2)
+// Check out find_first_idx_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container>
+maybe<std::size_t> find_first_idx_by_parallelly(
+    UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::default_chunk_runner(), pred, xs, false);
+}
+
+// API search type: find_first_idx_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Maybe Int
+// fwd bind count: 2
+// Same as find_first_idx_by, but uses n threads in parallel.
+// find_first_idx_by_parallelly_n_threads(4, is_even, [1, 3, 4, 6, 9]) == Just(2)
+template <typename UnaryPredicate, typename Container>
+maybe<std::size_t> find_first_idx_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<UnaryPredicate, Container>();
+    return internal::find_first_idx_by_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, false);
+}
+
+// API search type: find_first_by_parallelly : ((a -> Bool), [a]) -> Maybe a
+// fwd bind count: 1
+// Same as find_first_by, but using multiple threads.
+// find_first_by_parallelly(is_even, [1, 3, 4, 6, 9]) == Just(4)
+// Check out find_first_by_parallelly_n_threads to limit the number of threads.
+template <typename UnaryPredicate, typename Container,
+    typename T = typename Container::value_type>
+maybe<T> find_first_by_parallelly(UnaryPredicate pred, const Container& xs)
+{
+    return lift_maybe([&xs](std::size_t idx) -> T {
+        return *std::next(std::begin(xs), static_cast<std::ptrdiff_t>(idx));
+    },
+        find_first_idx_by_parallelly(pred, xs));
+}
+
+// API search type: find_first_by_parallelly_n_threads : (Int, (a -> Bool), [a]) -> Maybe a
+// fwd bind count: 2
+// Same as find_first_by, but uses n threads in parallel.
+// find_first_by_parallelly_n_threads(4, is_even, [1, 3, 4, 6, 9]) == Just(4)
+template <typename UnaryPredicate, typename Container,
+    typename T = typename Container::value_type>
+maybe<T> find_first_by_parallelly_n_threads(
+    std::size_t n, UnaryPredicate pred, const Container& xs)
+{
+    return lift_maybe([&xs](std::size_t idx) -> T {
+        return *std::next(std::begin(xs), static_cast<std::ptrdiff_t>(idx));
+    },
+        find_first_idx_by_parallelly_n_threads(n, pred, xs));
 }
 
 // API search type: keep_if_parallelly : ((a -> Bool), [a]) -> [a]
@@ -11525,19 +15013,16 @@ typename Container::value_type reduce_1_parallelly_n_threads(
 // Same as keep_if but using multiple threads.
 // Can be useful if calling the predicate takes some time.
 // keep_if_parallelly(is_even, [1, 2, 3, 2, 4, 5]) == [2, 2, 4]
-// One thread per container element is spawned.
+// Runs on the thread pool of transform_parallelly.
+// Evaluating the predicate as well as copying the kept elements
+// into the result is done in parallel.
 // Check out keep_if_parallelly_n_threads to limit the number of threads.
 template <typename Pred, typename Container>
 Container keep_if_parallelly(Pred pred, const Container& xs)
 {
-    // Avoid a temporary std::vector<bool>.
-    const auto idxs = find_all_idxs_by(
-        is_equal_to<std::uint8_t>(1),
-        transform_parallelly([pred](const auto& x) -> std::uint8_t {
-            return pred(x) ? 1 : 0;
-        },
-            xs));
-    return elems_at_idxs(idxs, xs);
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::default_chunk_runner(), pred, xs, true, false).first;
 }
 
 // API search type: keep_if_parallelly_n_threads : (Int, (a -> Bool), [a]) -> [a]
@@ -11549,15 +15034,220 @@ template <typename Pred, typename Container>
 Container keep_if_parallelly_n_threads(
     std::size_t n, Pred pred, const Container& xs)
 {
-    // Avoid a temporary std::vector<bool>.
-    const auto idxs = find_all_idxs_by(
-        is_equal_to<std::uint8_t>(1),
-        transform_parallelly_n_threads(
-            n, [pred](const auto& x) -> std::uint8_t {
-                return pred(x) ? 1 : 0;
-            },
-            xs));
-    return elems_at_idxs(idxs, xs);
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, true, false).first;
+}
+
+// API search type: drop_if_parallelly : ((a -> Bool), [a]) -> [a]
+// fwd bind count: 1
+// Same as drop_if but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// drop_if_parallelly(is_even, [1, 2, 3, 2, 4, 5]) == [1, 3, 5]
+// Runs on the thread pool of transform_parallelly.
+// Check out drop_if_parallelly_n_threads to limit the number of threads.
+template <typename Pred, typename Container>
+Container drop_if_parallelly(Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::default_chunk_runner(), pred, xs, false, true).second;
+}
+
+// API search type: drop_if_parallelly_n_threads : (Int, (a -> Bool), [a]) -> [a]
+// fwd bind count: 2
+// Same as drop_if but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// drop_if_parallelly_n_threads(3, is_even, [1, 2, 3, 2, 4, 5]) == [1, 3, 5]
+template <typename Pred, typename Container>
+Container drop_if_parallelly_n_threads(
+    std::size_t n, Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, false, true).second;
+}
+
+// API search type: partition_parallelly : ((a -> Bool), [a]) -> ([a], [a])
+// fwd bind count: 1
+// Same as partition but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// partition_parallelly(is_even, [0,1,1,3,7,2,3,4]) == ([0,2,4],[1,1,3,7,3])
+// Runs on the thread pool of transform_parallelly.
+// Check out partition_parallelly_n_threads to limit the number of threads.
+template <typename Pred, typename Container>
+std::pair<Container, Container> partition_parallelly(
+    Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::default_chunk_runner(), pred, xs, true, true);
+}
+
+// API search type: partition_parallelly_n_threads : (Int, (a -> Bool), [a]) -> ([a], [a])
+// fwd bind count: 2
+// Same as partition but using multiple threads.
+// Can be useful if calling the predicate takes some time.
+// partition_parallelly_n_threads(3, is_even, [0,1,1,3,7,2,3,4]) == ([0,2,4],[1,1,3,7,3])
+template <typename Pred, typename Container>
+std::pair<Container, Container> partition_parallelly_n_threads(
+    std::size_t n, Pred pred, const Container& xs)
+{
+    internal::check_unary_predicate_for_container<Pred, Container>();
+    return internal::partition_chunked(
+        internal::n_threads_chunk_runner { n }, pred, xs, true, true);
+}
+
+// API search type: sort_by_parallelly : (((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 1
+// Same as sort_by, but using multiple threads.
+// Contiguous runs are sorted on the thread pool of transform_parallelly
+// and then merged in parallel.
+// Check out sort_by_parallelly_n_threads to limit the number of threads.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_by_parallelly(Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::pool_chunk_runner { internal::default_thread_pool() }, false, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_by_parallelly_n_threads : (Int, ((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 2
+// Same as sort_by, but uses n threads in parallel.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_by_parallelly_n_threads(
+    std::size_t n, Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::n_threads_chunk_runner { n }, false, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_on_parallelly : ((a -> b), [a]) -> [a]
+// fwd bind count: 1
+// Same as sort_on, but using multiple threads.
+// Check out sort_on_parallelly_n_threads to limit the number of threads.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_on_parallelly(F f, Container&& xs)
+{
+    return sort_by_parallelly(internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_on_parallelly_n_threads : (Int, (a -> b), [a]) -> [a]
+// fwd bind count: 2
+// Same as sort_on, but uses n threads in parallel.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_on_parallelly_n_threads(
+    std::size_t n, F f, Container&& xs)
+{
+    return sort_by_parallelly_n_threads(n, internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: sort_parallelly : [a] -> [a]
+// fwd bind count: 0
+// Same as sort, but using multiple threads.
+// Check out sort_parallelly_n_threads to limit the number of threads.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_parallelly(Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return sort_by_parallelly(std::less<T>(), std::forward<Container>(xs));
+}
+
+// API search type: sort_parallelly_n_threads : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as sort, but uses n threads in parallel.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut sort_parallelly_n_threads(std::size_t n, Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return sort_by_parallelly_n_threads(
+        n, std::less<T>(), std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_by_parallelly : (((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 1
+// Same as stable_sort_by, but using multiple threads.
+// Contiguous runs are sorted on the thread pool of transform_parallelly
+// and then merged in parallel.
+// Check out stable_sort_by_parallelly_n_threads to limit the number of threads.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_by_parallelly(Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::pool_chunk_runner { internal::default_thread_pool() }, true, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_by_parallelly_n_threads : (Int, ((a, a) -> Bool), [a]) -> [a]
+// fwd bind count: 2
+// Same as stable_sort_by, but uses n threads in parallel.
+template <typename Compare, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_by_parallelly_n_threads(
+    std::size_t n, Compare comp, Container&& xs)
+{
+    return internal::sort_by_parallelly(internal::can_reuse_v<Container> {},
+        internal::n_threads_chunk_runner { n }, true, comp,
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_on_parallelly : ((a -> b), [a]) -> [a]
+// fwd bind count: 1
+// Same as stable_sort_on, but using multiple threads.
+// Check out stable_sort_on_parallelly_n_threads to limit the number of threads.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_on_parallelly(F f, Container&& xs)
+{
+    return stable_sort_by_parallelly(internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_on_parallelly_n_threads : (Int, (a -> b), [a]) -> [a]
+// fwd bind count: 2
+// Same as stable_sort_on, but uses n threads in parallel.
+template <typename F, typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_on_parallelly_n_threads(
+    std::size_t n, F f, Container&& xs)
+{
+    return stable_sort_by_parallelly_n_threads(n, internal::is_less_by_struct<F>(f),
+        std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_parallelly : [a] -> [a]
+// fwd bind count: 0
+// Same as stable_sort, but using multiple threads.
+// Check out stable_sort_parallelly_n_threads to limit the number of threads.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_parallelly(Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return stable_sort_by_parallelly(std::less<T>(), std::forward<Container>(xs));
+}
+
+// API search type: stable_sort_parallelly_n_threads : (Int, [a]) -> [a]
+// fwd bind count: 1
+// Same as stable_sort, but uses n threads in parallel.
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>>
+ContainerOut stable_sort_parallelly_n_threads(std::size_t n, Container&& xs)
+{
+    typedef typename std::remove_reference<Container>::type::value_type T;
+    return stable_sort_by_parallelly_n_threads(
+        n, std::less<T>(), std::forward<Container>(xs));
 }
 
 // API search type: transform_reduce : ((a -> b), ((b, b) -> b), b, [a]) -> b
@@ -11590,8 +15280,10 @@ auto transform_reduce_1(UnaryF unary_f, BinaryF binary_f, const Container& xs)
 // transform_reduce_parallelly(square, add, 0, [1,2,3]) == 0+1+4+9 = 14
 // Also known as map_reduce.
 // The set of binary_f, init and unary_f::output
-// should form a commutative monoid.
-// One thread per container element is spawned.
+// should form a monoid.
+// Runs on the thread pool of transform_parallelly.
+// The transformed values are folded chunk-wise right away
+// instead of being collected in a temporary container.
 // Check out transform_reduce_parallelly_n_threads to limit the number of threads.
 template <typename UnaryF, typename BinaryF, typename Container, typename Acc>
 auto transform_reduce_parallelly(UnaryF unary_f,
@@ -11599,7 +15291,14 @@ auto transform_reduce_parallelly(UnaryF unary_f,
     const Acc& init,
     const Container& xs)
 {
-    return reduce_parallelly(binary_f, init, transform_parallelly(unary_f, xs));
+    using Y = std::decay_t<internal::invoke_result_t<
+        UnaryF, typename Container::value_type>>;
+    if (is_empty(xs)) {
+        return Y(init);
+    }
+    return Y(internal::invoke(binary_f, init,
+        internal::transform_reduce_1_chunked(
+            internal::default_chunk_runner(), unary_f, binary_f, xs)));
 }
 
 // API search type: transform_reduce_parallelly_n_threads : (Int, (a -> b), ((b, b) -> b), b, [a]) -> b
@@ -11607,7 +15306,7 @@ auto transform_reduce_parallelly(UnaryF unary_f,
 // transform_reduce_parallelly_n_threads(2, square, add, 0, [1,2,3]) == 0+1+4+9 = 14
 // Also known as map_reduce.
 // The set of binary_f, init and unary_f::output
-// should form a commutative monoid.
+// should form a monoid.
 template <typename UnaryF, typename BinaryF, typename Container, typename Acc>
 auto transform_reduce_parallelly_n_threads(std::size_t n,
     UnaryF unary_f,
@@ -11615,8 +15314,14 @@ auto transform_reduce_parallelly_n_threads(std::size_t n,
     const Acc& init,
     const Container& xs)
 {
-    return reduce_parallelly_n_threads(
-        n, binary_f, init, transform_parallelly_n_threads(n, unary_f, xs));
+    using Y = std::decay_t<internal::invoke_result_t<
+        UnaryF, typename Container::value_type>>;
+    if (is_empty(xs)) {
+        return Y(init);
+    }
+    return Y(internal::invoke(binary_f, init,
+        internal::transform_reduce_1_chunked(
+            internal::n_threads_chunk_runner { n }, unary_f, binary_f, xs)));
 }
 
 // API search type: transform_reduce_1_parallelly : ((a -> b), ((b, b) -> b), [a]) -> b
@@ -11624,15 +15329,16 @@ auto transform_reduce_parallelly_n_threads(std::size_t n,
 // transform_reduce_1_parallelly(square, add, [1,2,3]) == 0+1+4+9 = 14
 // Also Known as map_reduce.
 // The set of binary_f, and unary_f::output
-// should form a commutative semigroup.
-// One thread per container element is spawned.
+// should form a semigroup.
+// Runs on the thread pool of transform_parallelly.
 // Check out transform_reduce_1_parallelly_n_threads to limit the number of threads.
 template <typename UnaryF, typename BinaryF, typename Container>
 auto transform_reduce_1_parallelly(UnaryF unary_f,
     BinaryF binary_f,
     const Container& xs)
 {
-    return reduce_1_parallelly(binary_f, transform_parallelly(unary_f, xs));
+    return internal::transform_reduce_1_chunked(
+        internal::default_chunk_runner(), unary_f, binary_f, xs);
 }
 
 // API search type: transform_reduce_1_parallelly_n_threads : (Int, (a -> b), ((b, b) -> b), [a]) -> b
@@ -11640,28 +15346,126 @@ auto transform_reduce_1_parallelly(UnaryF unary_f,
 // transform_reduce_1_parallelly_n_threads(2, square, add, [1,2,3]) == 0+1+4+9 = 14
 // Also Known as map_reduce.
 // The set of binary_f, and unary_f::output
-// should form a commutative semigroup.
+// should form a semigroup.
 template <typename UnaryF, typename BinaryF, typename Container>
 auto transform_reduce_1_parallelly_n_threads(std::size_t n,
     UnaryF unary_f,
     BinaryF binary_f,
     const Container& xs)
 {
-    return reduce_1_parallelly_n_threads(
-        n, binary_f, transform_parallelly_n_threads(n, unary_f, xs));
+    return internal::transform_reduce_1_chunked(
+        internal::n_threads_chunk_runner { n }, unary_f, binary_f, xs);
 }
 
 } // namespace fplus
 
 #include <iomanip>
 #include <ios>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <ostream>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
 
 namespace fplus {
 
+namespace internal {
+    // Numbers that show formats without a std::ostringstream,
+    // producing the same characters the stream would.
+    // Character types and bool are not among them,
+    // because the stream does not show them as numbers.
+    // Floating-point numbers need std::to_chars.
+    template <typename T>
+    struct is_fast_showable
+        : std::integral_constant<bool,
+              (std::is_integral<T>::value
+#if defined(__cpp_lib_to_chars)
+                  || std::is_floating_point<T>::value
+#endif
+                  )
+                  && !std::is_same<T, bool>::value
+                  && !std::is_same<T, char>::value
+                  && !std::is_same<T, signed char>::value
+                  && !std::is_same<T, unsigned char>::value
+                  && !std::is_same<T, wchar_t>::value
+                  && !std::is_same<T, char16_t>::value
+                  && !std::is_same<T, char32_t>::value> {
+    };
+
+    template <typename T>
+    bool is_negative_number(T x, std::true_type /* is_signed */)
+    {
+        return x < 0;
+    }
+
+    template <typename T>
+    bool is_negative_number(T, std::false_type /* is_signed */)
+    {
+        return false;
+    }
+
+    template <typename T>
+    void show_number_append(std::string& out, T x, std::true_type /* is_integral */)
+    {
+        char buffer[std::numeric_limits<T>::digits10 + 3];
+#if __cplusplus >= 201703L
+        const auto converted = std::to_chars(std::begin(buffer), std::end(buffer), x);
+        out.append(buffer, converted.ptr);
+#else
+        typedef std::make_unsigned_t<T> U;
+        const bool negative = is_negative_number(x, std::is_signed<T>());
+        U value = negative
+            ? static_cast<U>(U(0) - static_cast<U>(x))
+            : static_cast<U>(x);
+        char* const last = std::end(buffer);
+        char* first = last;
+        do {
+            *--first = static_cast<char>('0' + value % 10);
+            value = static_cast<U>(value / 10);
+        } while (value != 0);
+        if (negative) {
+            *--first = '-';
+        }
+        out.append(first, last);
+#endif
+    }
+
+#if defined(__cpp_lib_to_chars)
+    // Same as the default format of a stream, i.e. "%.6g".
+    template <typename T>
+    void show_number_append(std::string& out, T x, std::false_type /* is_integral */)
+    {
+        char buffer[64];
+        const auto converted = std::to_chars(std::begin(buffer), std::end(buffer),
+            x, std::chars_format::general, 6);
+        out.append(buffer, converted.ptr);
+    }
+#endif
+
+    template <typename T>
+    std::string show_value(const T& x, std::true_type /* is_fast_showable */)
+    {
+        std::string result;
+        show_number_append(result, x, std::is_integral<T>());
+        return result;
+    }
+
+    template <typename T>
+    std::string show_value(const T& x, std::false_type /* is_fast_showable */)
+    {
+        std::ostringstream ss;
+        ss << x;
+        return ss.str();
+    }
+}
+
 // API search type: show : a -> String
 // fwd bind count: 0
 // 42 -> "42"
@@ -11672,12 +15476,12 @@ namespace fplus {
 // Pair to String
 // std::vector<std::list<T>> to String
 // std::vector<T> to String
+// Integers (and floating-point numbers if std::to_chars supports them)
+// are converted without the overhead of a std::ostringstream.
 template <typename T>
 std::string show(const T& x)
 {
-    std::ostringstream ss;
-    ss << x;
-    return ss.str();
+    return internal::show_value(x, internal::is_fast_showable<T>());
 }
 
 // string identity
@@ -11727,6 +15531,62 @@ std::string show(const std::deque<T, A>& xs)
     return show_cont(xs);
 }
 
+namespace internal {
+    template <typename T>
+    void show_append(std::string& out, const T& x, std::true_type /* is_fast_showable */)
+    {
+        show_number_append(out, x, std::is_integral<T>());
+    }
+
+    template <typename T>
+    void show_append(std::string& out, const T& x, std::false_type /* is_fast_showable */)
+    {
+        out += show(x);
+    }
+
+    template <typename T>
+    void show_append(std::string& out, const T& x)
+    {
+        show_append(out, x, is_fast_showable<T>());
+    }
+
+    inline void show_append(std::string& out, const std::string& x)
+    {
+        out += x;
+    }
+
+    // Shows all elements of xs into one buffer.
+    // Whenever the buffer holds at least flush_size chars,
+    // it is passed to flush and cleared afterwards.
+    template <typename Container, typename Flush>
+    void show_cont_into(std::string& buffer,
+        Flush flush, std::size_t flush_size,
+        const std::string& separator,
+        const std::string& prefix, const std::string& suffix,
+        const Container& xs,
+        std::size_t new_line_every_nth_elem)
+    {
+        const std::string newline = std::string("\n") + std::string(prefix.size(), ' ');
+        buffer += prefix;
+        std::size_t i = 0;
+        for (const auto& x : xs) {
+            if (i != 0) {
+                buffer += separator;
+                if (new_line_every_nth_elem != 0 && i % new_line_every_nth_elem == 0) {
+                    buffer += newline;
+                }
+            }
+            show_append(buffer, x);
+            if (buffer.size() >= flush_size) {
+                flush(buffer);
+                buffer.clear();
+            }
+            ++i;
+        }
+        buffer += suffix;
+    }
+}
+
 // API search type: show_cont_with_frame_and_newlines : (String, String, String, [a], Int) -> String
 // fwd bind count: 3
 // show_cont_with_frame_and_newlines (",", "(", ")", [1, 2, 3, 4, 5], 2)
@@ -11740,24 +15600,13 @@ std::string show_cont_with_frame_and_newlines(
     const Container& xs,
     std::size_t new_line_every_nth_elem)
 {
-    std::vector<std::string> elemStrs;
-    elemStrs.reserve(xs.size());
-    if (new_line_every_nth_elem == 0) {
-        for (const auto& x : xs) {
-            elemStrs.push_back(show(x));
-        }
-    } else {
-        std::size_t i = 0;
-        std::string newline = std::string("\n") + std::string(prefix.size(), ' ');
-        for (const auto& x : xs) {
-            if (i && i % new_line_every_nth_elem == 0)
-                elemStrs.push_back(newline + show(x));
-            else
-                elemStrs.push_back(show(x));
-            ++i;
-        }
-    }
-    return prefix + join(separator, elemStrs) + suffix;
+    std::string result;
+    result.reserve(prefix.size() + suffix.size()
+        + size_of_cont(xs) * (separator.size() + 1));
+    internal::show_cont_into(result, [](const std::string&) {},
+        std::numeric_limits<std::size_t>::max(),
+        separator, prefix, suffix, xs, new_line_every_nth_elem);
+    return result;
 }
 
 // API search type: show_cont_with_frame : (String, String, String, [a]) -> String
@@ -11791,6 +15640,48 @@ std::string show_cont(const Container& xs)
     return show_cont_with(", ", xs);
 }
 
+// API search type: show_cont_with_frame_to : (OStream, String, String, String, [a]) -> Io ()
+// Writes the same as show_cont_with_frame into a stream.
+// The text is passed on in pieces of about 64 KiB,
+// so no string holding the whole output is built.
+template <typename Container>
+void show_cont_with_frame_to(std::ostream& os,
+    const std::string& separator,
+    const std::string& prefix, const std::string& suffix,
+    const Container& xs)
+{
+    const std::size_t flush_size = 1 << 16;
+    const auto write = [&os](const std::string& buffer) {
+        os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    };
+    std::string buffer;
+    buffer.reserve(flush_size + 64);
+    internal::show_cont_into(buffer, write, flush_size,
+        separator, prefix, suffix, xs, 0);
+    write(buffer);
+}
+
+// API search type: show_cont_to : (OStream, [a]) -> Io ()
+// Writes the same as show_cont into a stream,
+// without building a string holding the whole output.
+// show_cont_to(std::cout, [1, 2, 3]) prints "[1, 2, 3]"
+template <typename Container>
+void show_cont_to(std::ostream& os, const Container& xs)
+{
+    show_cont_with_frame_to(os, ", ", "[", "]", xs);
+}
+
+// API search type: show_to_buffer : (String, a) -> Io ()
+// Appends show(x) to buffer.
+// Numbers are formatted directly into the buffer,
+// so filling a reused buffer does not allocate.
+// show_to_buffer(buffer, 42) appends "42"
+template <typename T>
+void show_to_buffer(std::string& buffer, const T& x)
+{
+    internal::show_append(buffer, x);
+}
+
 // API search type: show_maybe : Maybe a -> String
 // fwd bind count: 0
 // show_maybe(Just 42) -> "Just 42"
@@ -12990,8 +16881,17 @@ shared_ref<raii<INIT, QUIT>> make_raii(INIT init, QUIT quit)
 
 
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
 
 namespace fplus {
 
@@ -13091,27 +16991,114 @@ namespace internal {
             result = str;
         }
     };
+
+    // The fast paths below parse [first, last) completely,
+    // without allocations, exceptions or locale lookups.
+    // They only accept the plain notation ("-42", "4.2e1"),
+    // and return false for everything else,
+    // including subnormal floating-point values,
+    // which std::from_chars accepts but std::sto* rejects.
+    // The lenient std::sto* functions then decide,
+    // so the set of accepted inputs does not change.
+
+    template <typename T>
+    bool read_value_fast(const char* first, const char* last,
+        T& result, std::true_type /* is_integral */)
+    {
+#if __cplusplus >= 201703L
+        const auto parsed = std::from_chars(first, last, result);
+        return parsed.ec == std::errc() && parsed.ptr == last;
+#else
+        typedef std::make_unsigned_t<T> U;
+        const bool negative = first != last && *first == '-';
+        if (negative) {
+            if (!std::is_signed<T>::value) {
+                return false;
+            }
+            ++first;
+        }
+        if (first == last) {
+            return false;
+        }
+        const U max_value = static_cast<U>(std::numeric_limits<T>::max());
+        const U limit = negative ? static_cast<U>(max_value + 1) : max_value;
+        U value = 0;
+        for (; first != last; ++first) {
+            const U digit = static_cast<U>(static_cast<unsigned char>(*first) - '0');
+            if (digit > 9 || value > (limit - digit) / 10) {
+                return false;
+            }
+            value = static_cast<U>(value * 10 + digit);
+        }
+        result = negative
+            ? static_cast<T>(-static_cast<T>(value - 1) - 1)
+            : static_cast<T>(value);
+        return true;
+#endif
+    }
+
+    template <typename T>
+    bool read_value_fast(const char* first, const char* last,
+        T& result, std::false_type /* is_integral */)
+    {
+#if defined(__cpp_lib_to_chars)
+        if (std::is_floating_point<T>::value) {
+            const auto parsed = std::from_chars(first, last, result);
+            return parsed.ec == std::errc() && parsed.ptr == last
+                && std::fpclassify(result) != FP_SUBNORMAL;
+        }
+#endif
+        (void)first;
+        (void)last;
+        (void)result;
+        return false;
+    }
+
+    inline bool read_value_fast(const char*, const char*,
+        std::string&, std::false_type)
+    {
+        return false;
+    }
+
+    template <typename T>
+    bool read_value_fast(const char* first, const char* last, T& result)
+    {
+        return read_value_fast(first, last, result,
+            std::integral_constant<bool,
+                std::is_integral<T>::value && !std::is_same<T, bool>::value>());
+    }
+
+    template <typename T>
+    result<T, std::string> read_value_result_slow(const std::string& str)
+    {
+        try {
+            T result;
+            std::size_t num_chars_used = 0;
+            internal::helper_read_value_struct<T>::read(str,
+                result, num_chars_used);
+            if (num_chars_used != str.size()) {
+                return error<T>(std::string("String not fully parsable."));
+            }
+            return ok<T, std::string>(result);
+        } catch (const std::invalid_argument& e) {
+            return error<T, std::string>(e.what());
+        } catch (const std::out_of_range& e) {
+            return error<T, std::string>(e.what());
+        }
+    }
 }
 
 // API search type: read_value_result : String -> Result a
 // Try to deserialize a value.
+// Plain numbers are parsed without the overhead of std::stoi etc.
 template <typename T>
 result<T, std::string> read_value_result(const std::string& str)
 {
-    try {
-        T result;
-        std::size_t num_chars_used = 0;
-        internal::helper_read_value_struct<T>::read(str,
-            result, num_chars_used);
-        if (num_chars_used != str.size()) {
-            return error<T>(std::string("String not fully parsable."));
-        }
+    T result;
+    if (internal::read_value_fast(str.data(), str.data() + str.size(), result)) {
         return ok<T, std::string>(result);
-    } catch (const std::invalid_argument& e) {
-        return error<T, std::string>(e.what());
-    } catch (const std::out_of_range& e) {
-        return error<T, std::string>(e.what());
     }
+    return internal::read_value_result_slow<T>(str);
 }
 
 // API search type: read_value : String -> Maybe a
@@ -13159,6 +17146,41 @@ T read_value_unsafe(const std::string& str)
     return unsafe_get_just(to_maybe(read_value_result<T>(str)));
 }
 
+// API search type: read_values : (Char, String) -> Result [a] String
+// Deserializes all fields of a delimited buffer, e.g. a column of numbers.
+// The fields are parsed in place, without creating a string for each one.
+// A delimiter at the very end of the buffer is ignored,
+// so newline-terminated lines can be parsed directly.
+// If a field can not be parsed, the error names its index.
+// read_values<int>(',', "1,2,3") == Ok [1,2,3]
+// read_values<int>('\n', "1\n2\n") == Ok [1,2]
+// read_values<int>(',', "1,x,3") == Error "Field 1: ..."
+template <typename T>
+result<std::vector<T>, std::string> read_values(char delimiter, const std::string& str)
+{
+    const char* first = str.data();
+    const char* const last = str.data() + str.size();
+    std::vector<T> values;
+    values.reserve(static_cast<std::size_t>(std::count(first, last, delimiter)) + 1);
+    while (first != last) {
+        const char* const field_end = std::find(first, last, delimiter);
+        T value;
+        if (internal::read_value_fast(first, field_end, value)) {
+            values.push_back(value);
+        } else {
+            const auto slow_result = internal::read_value_result_slow<T>(
+                std::string(first, field_end));
+            if (is_error(slow_result)) {
+                return error<std::vector<T>, std::string>(
+                    "Field " + std::to_string(values.size()) + ": " + unsafe_get_error(slow_result));
+            }
+            values.push_back(unsafe_get_ok(slow_result));
+        }
+        first = field_end == last ? last : field_end + 1;
+    }
+    return ok<std::vector<T>, std::string>(std::move(values));
+}
+
 } // namespace fplus
 
 //
@@ -13173,6 +17195,11 @@ T read_value_unsafe(const std::string& str)
 
 
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+
 namespace fplus {
 
 namespace internal {
@@ -13249,34 +17276,254 @@ ContainerOut replace_elem_at_idx(std::size_t idx, const T& dest,
         idx, dest, std::forward<Container>(xs));
 }
 
-// API search type: replace_elems : (a, a, [a]) -> [a]
-// fwd bind count: 2
-// Replace all elements matching source with dest.
-// replace_elems(4, 0, [1, 3, 4, 4, 7]) == [1, 3, 0, 0, 7]
-template <typename Container,
-    typename ContainerOut = internal::remove_const_and_ref_t<Container>,
-    typename T = typename ContainerOut::value_type>
-ContainerOut replace_elems(const T& source, const T& dest, Container&& xs)
-{
-    return replace_if(bind_1st_of_2(is_equal<T>, source), dest, xs);
-}
+// API search type: replace_elems : (a, a, [a]) -> [a]
+// fwd bind count: 2
+// Replace all elements matching source with dest.
+// replace_elems(4, 0, [1, 3, 4, 4, 7]) == [1, 3, 0, 0, 7]
+template <typename Container,
+    typename ContainerOut = internal::remove_const_and_ref_t<Container>,
+    typename T = typename ContainerOut::value_type>
+ContainerOut replace_elems(const T& source, const T& dest, Container&& xs)
+{
+    return replace_if(bind_1st_of_2(is_equal<T>, source), dest, xs);
+}
+
+// API search type: replace_tokens : ([a], [a], [a]) -> [a]
+// fwd bind count: 2
+// Replace all segments matching source with dest.
+// replace_tokens("haha", "hihi", "oh, hahaha!") == "oh, hihiha!"
+// replace_tokens("haha", "o", "oh, hahaha!") == "oh, oha!"
+template <typename Container>
+Container replace_tokens(const Container& source, const Container& dest, const Container& xs)
+{
+    auto splitted = split_by_token(source, true, xs);
+    return join(dest, splitted);
+}
+
+// API search type: replace_tokens_many : ([[a]], [[a]], [a]) -> [a]
+// fwd bind count: 2
+// Replace all segments matching one of the sources
+// with the dest of the same index, scanning only once.
+// Of overlapping matches, the one starting first wins,
+// and of those starting at the same position, the longest one.
+// Empty sources are ignored.
+// sources and dests must have the same size.
+// replace_tokens_many(["haha", "h"], ["hihi", "H"], "oh, hahaha!")
+// == "oH, hihiHa!"
+// O(n + k), where k is the number of matches,
+// plus the time to compile the sources.
+template <typename ContainerTokens, typename Container>
+Container replace_tokens_many(const ContainerTokens& sources,
+    const ContainerTokens& dests, const Container& xs)
+{
+    return replace_tokens_many(compiled_tokens<Container>(sources), dests, xs);
+}
+
+// Overload of replace_tokens_many for compiled sources.
+template <typename ContainerTokens, typename Container>
+Container replace_tokens_many(const compiled_tokens<Container>& sources,
+    const ContainerTokens& dests, const Container& xs)
+{
+    assert(size_of_cont(dests) == sources.size());
+    const std::size_t n = size_of_cont(xs);
+    // For every position, the index of the longest source starting there.
+    const std::size_t none = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> longest(n, none);
+    sources.for_each_match(xs, [&](std::size_t idx, std::size_t token_idx) {
+        if (longest[idx] == none
+            || sources.token_size(longest[idx]) < sources.token_size(token_idx)) {
+            longest[idx] = token_idx;
+        }
+    });
+
+    std::vector<typename ContainerTokens::const_iterator> dest_its;
+    dest_its.reserve(sources.size());
+    for (auto it = std::begin(dests); it != std::end(dests); ++it) {
+        dest_its.push_back(it);
+    }
+    std::size_t result_size = 0;
+    for (std::size_t idx = 0; idx < n;) {
+        if (longest[idx] == none) {
+            ++result_size;
+            ++idx;
+        } else {
+            result_size += size_of_cont(*dest_its[longest[idx]]);
+            idx += sources.token_size(longest[idx]);
+        }
+    }
+
+    Container result;
+    internal::prepare_container(result, result_size);
+    auto itOut = internal::get_back_inserter(result);
+    std::size_t skip = 0;
+    std::size_t idx = 0;
+    for (const auto& x : xs) {
+        if (skip > 0) {
+            --skip;
+        } else if (longest[idx] == none) {
+            *itOut = x;
+        } else {
+            const auto& dest = *dest_its[longest[idx]];
+            itOut = std::copy(std::begin(dest), std::end(dest), itOut);
+            skip = sources.token_size(longest[idx]) - 1;
+        }
+        ++idx;
+    }
+    return result;
+}
+
+} // namespace fplus
+
+//
+// side_effects.hpp
+//
+
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+
+
+//
+// internal/file_mapping.hpp
+//
+
+// Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
+// https://github.com/Dobiasd/FunctionalPlus
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FPLUS_HAS_MMAP
+#endif
+
+namespace fplus {
+namespace internal {
+
+    // How the pages of a mapped file are going to be accessed.
+    enum class file_access {
+        normal,
+        sequential,
+        random,
+        will_need
+    };
+
+    // The read-only content of a file.
+    // Regular files are mapped into memory, so pages are only loaded
+    // when they are accessed. Other files (pipes, procfs, ...)
+    // and systems without mmap fall back to reading the whole content.
+    class file_mapping {
+    public:
+        // Returns nullptr if the file can not be opened.
+        static std::unique_ptr<file_mapping> open(const std::string& filename)
+        {
+            std::unique_ptr<file_mapping> result(new file_mapping());
+#ifdef FPLUS_HAS_MMAP
+            const int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return nullptr;
+            }
+            struct stat info;
+            const bool is_regular = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
+            if (is_regular && info.st_size == 0) {
+                ::close(fd);
+                return result;
+            }
+            if (is_regular) {
+                const std::size_t size = static_cast<std::size_t>(info.st_size);
+                void* const addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (addr != MAP_FAILED) {
+                    result->data_ = static_cast<const char*>(addr);
+                    result->size_ = size;
+                    result->is_mapped_ = true;
+                    return result;
+                }
+            } else {
+                ::close(fd);
+            }
+#endif
+            std::ifstream input(filename, std::ios::binary);
+            if (!input.good()) {
+                return nullptr;
+            }
+            result->buffer_.assign(std::istreambuf_iterator<char>(input),
+                std::istreambuf_iterator<char>());
+            result->data_ = result->buffer_.data();
+            result->size_ = result->buffer_.size();
+            return result;
+        }
+        file_mapping(const file_mapping&) = delete;
+        file_mapping& operator=(const file_mapping&) = delete;
+        ~file_mapping()
+        {
+#ifdef FPLUS_HAS_MMAP
+            if (is_mapped_) {
+                ::munmap(const_cast<char*>(data_), size_);
+            }
+#endif
+        }
+        const char* data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+        // Passes the expected access pattern on to the OS.
+        // Returns false if the hint could not be applied,
+        // which is always the case for content that is not mapped.
+        bool advise(file_access access) const
+        {
+#ifdef FPLUS_HAS_MMAP
+            if (!is_mapped_) {
+                return false;
+            }
+            int advice = POSIX_MADV_NORMAL;
+            if (access == file_access::sequential) {
+                advice = POSIX_MADV_SEQUENTIAL;
+            } else if (access == file_access::random) {
+                advice = POSIX_MADV_RANDOM;
+            } else if (access == file_access::will_need) {
+                advice = POSIX_MADV_WILLNEED;
+            }
+            return ::posix_madvise(const_cast<char*>(data_), size_, advice) == 0;
+#else
+            (void)access;
+            return false;
+#endif
+        }
 
-// API search type: replace_tokens : ([a], [a], [a]) -> [a]
-// fwd bind count: 2
-// Replace all segments matching source with dest.
-// replace_tokens("haha", "hihi", "oh, hahaha!") == "oh, hihiha!"
-// replace_tokens("haha", "o", "oh, hahaha!") == "oh, oha!"
-template <typename Container>
-Container replace_tokens(const Container& source, const Container& dest, const Container& xs)
-{
-    auto splitted = split_by_token(source, true, xs);
-    return join(dest, splitted);
+    private:
+        file_mapping()
+            : data_(nullptr)
+            , size_(0)
+            , is_mapped_(false)
+            , buffer_()
+        {
+        }
+        const char* data_;
+        std::size_t size_;
+        bool is_mapped_;
+        std::string buffer_;
+    };
+}
 }
 
-} // namespace fplus
+#undef FPLUS_HAS_MMAP
 
 //
-// side_effects.hpp
+// internal/line_reader.hpp
 //
 
 // Copyright 2015, Tobias Hermann and the FunctionalPlus contributors.
@@ -13286,6 +17533,207 @@ Container replace_tokens(const Container& source, const Container& dest, const C
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fplus {
+namespace internal {
+
+    // Reads a file chunk by chunk into a reusable buffer
+    // and splits the content into lines on the fly,
+    // so memory usage does not depend on the size of the file.
+    // Lines are split like split_lines does it,
+    // i.e. "\r\n", "\r" and "\n" are line breaks,
+    // and empty lines are only returned if allow_empty is set.
+    class chunked_line_reader {
+    public:
+        // Returns nullptr if the file can not be opened.
+        static std::unique_ptr<chunked_line_reader> open(
+            const std::string& filename, bool allow_empty, std::size_t chunk_size)
+        {
+            std::unique_ptr<chunked_line_reader> result(
+                new chunked_line_reader(filename, allow_empty, chunk_size));
+            if (!result->input_.good()) {
+                return nullptr;
+            }
+            return result;
+        }
+        chunked_line_reader(const chunked_line_reader&) = delete;
+        chunked_line_reader& operator=(const chunked_line_reader&) = delete;
+
+        // Reads the next line into line, reusing its capacity.
+        // Returns false if there are no more lines.
+        bool next(std::string& line)
+        {
+            line.clear();
+            if (finished_) {
+                return false;
+            }
+            for (;;) {
+                if (pos_ == end_ && !fill()) {
+                    finished_ = true;
+                    return !line.empty() || allow_empty_;
+                }
+                if (skip_line_feed_) {
+                    skip_line_feed_ = false;
+                    if (buffer_[pos_] == '\n') {
+                        ++pos_;
+                        continue;
+                    }
+                }
+                const char* const first = buffer_.data() + pos_;
+                const char* const last = buffer_.data() + end_;
+                const char* const line_break = std::find_if(first, last,
+                    [](char c) { return c == '\n' || c == '\r'; });
+                line.append(first, line_break);
+                if (line_break == last) {
+                    pos_ = end_;
+                    continue;
+                }
+                skip_line_feed_ = *line_break == '\r';
+                pos_ += static_cast<std::size_t>(line_break - first) + 1;
+                if (!line.empty() || allow_empty_) {
+                    return true;
+                }
+            }
+        }
+
+        // Reads the next lines, about chunk_size bytes in total,
+        // reusing the strings already present in lines.
+        // Returns false if there are no more lines.
+        bool next_batch(std::vector<std::string>& lines)
+        {
+            std::size_t n = 0;
+            std::size_t n_bytes = 0;
+            while (n_bytes < chunk_size_) {
+                if (n == lines.size()) {
+                    lines.emplace_back();
+                }
+                if (!next(lines[n])) {
+                    break;
+                }
+                n_bytes += lines[n].size() + 1;
+                ++n;
+            }
+            lines.resize(n);
+            return n > 0;
+        }
+
+    private:
+        chunked_line_reader(const std::string& filename,
+            bool allow_empty, std::size_t chunk_size)
+            : input_(filename, std::ios::binary)
+            , allow_empty_(allow_empty)
+            , chunk_size_(std::max<std::size_t>(1, chunk_size))
+            , buffer_(chunk_size_)
+            , pos_(0)
+            , end_(0)
+            , skip_line_feed_(false)
+            , finished_(false)
+        {
+        }
+
+        bool fill()
+        {
+            if (!input_) {
+                return false;
+            }
+            input_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            pos_ = 0;
+            end_ = static_cast<std::size_t>(input_.gcount());
+            return end_ > 0;
+        }
+
+        std::ifstream input_;
+        bool allow_empty_;
+        std::size_t chunk_size_;
+        std::vector<char> buffer_;
+        std::size_t pos_;
+        std::size_t end_;
+        bool skip_line_feed_;
+        bool finished_;
+    };
+
+    // The lines of a text file, read on iteration.
+    // Every call to begin() opens the file anew,
+    // so the range can be traversed more than once.
+    // An unreadable file looks like an empty one.
+    class text_file_line_range {
+    public:
+        typedef std::string value_type;
+        typedef std::size_t size_type;
+
+        class const_iterator {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef std::string value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const std::string* pointer;
+            typedef const std::string& reference;
+
+            const_iterator()
+                : reader_()
+                , line_()
+            {
+            }
+            explicit const_iterator(std::shared_ptr<chunked_line_reader> reader)
+                : reader_(std::move(reader))
+                , line_()
+            {
+                ++*this;
+            }
+            const std::string& operator*() const { return line_; }
+            const std::string* operator->() const { return &line_; }
+            const_iterator& operator++()
+            {
+                if (reader_ && !reader_->next(line_)) {
+                    reader_.reset();
+                }
+                return *this;
+            }
+            friend bool operator==(const const_iterator& a, const const_iterator& b)
+            {
+                return a.reader_ == b.reader_;
+            }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b)
+            {
+                return a.reader_ != b.reader_;
+            }
+
+        private:
+            std::shared_ptr<chunked_line_reader> reader_;
+            std::string line_;
+        };
+        typedef const_iterator iterator;
+
+        text_file_line_range(const std::string& filename,
+            bool allow_empty, std::size_t chunk_size)
+            : filename_(filename)
+            , allow_empty_(allow_empty)
+            , chunk_size_(chunk_size)
+        {
+        }
+        const_iterator begin() const
+        {
+            std::shared_ptr<chunked_line_reader> reader = chunked_line_reader::open(filename_, allow_empty_, chunk_size_);
+            return reader ? const_iterator(std::move(reader)) : const_iterator();
+        }
+        const_iterator end() const { return const_iterator(); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+    private:
+        std::string filename_;
+        bool allow_empty_;
+        std::size_t chunk_size_;
+    };
+}
+}
 
 //
 // string_tools.hpp
@@ -13362,6 +17810,43 @@ ContainerOut split_lines(bool allowEmpty, const String& str)
     return split_by(is_line_break<String>, allowEmpty, clean_newlines(str));
 }
 
+#if __cplusplus >= 201703L
+
+// API search type: split_words_view : (Bool, String) -> [StringView]
+// Splits a string by non-letter and non-digit characters.
+// Returns views into str instead of copies, see split_by_view.
+// split_words_view(false, "How are you?") == ["How", "are", "you"]
+template <typename String>
+auto split_words_view(bool allow_empty, String&& str)
+{
+    typedef std::decay_t<String> Str;
+    return split_by_view(logical_not(is_letter_or_digit<Str>),
+        allow_empty, std::forward<String>(str));
+}
+
+// API search type: split_lines_view : (Bool, String) -> [StringView]
+// Splits a string by the found newlines.
+// Returns views into str instead of copies, see split_by_view.
+// Windows ("\r\n") and mac ("\r") newlines are recognized directly,
+// so unlike split_lines no cleaned copy of str is needed.
+// split_lines_view(false, "Hi,\r\nhow are you?") == ["Hi,", "how are you?"]
+template <typename String>
+auto split_lines_view(bool allow_empty, String&& str)
+{
+    const auto view = internal::as_string_view<String>(str);
+    typedef std::decay_t<decltype(view)> View;
+    return internal::split_string_view([](View s, std::size_t pos) {
+        const typename View::value_type line_breaks[] = { '\r', '\n' };
+        const std::size_t idx = s.find_first_of(line_breaks, pos, 2);
+        const bool is_crlf = idx != View::npos && s[idx] == '\r'
+            && idx + 1 < s.size() && s[idx + 1] == '\n';
+        return std::make_pair(idx, idx + (is_crlf ? 2 : 1));
+    },
+        allow_empty, view);
+}
+
+#endif
+
 // API search type: trim_whitespace_left : String -> String
 // fwd bind count: 0
 // trim_whitespace_left("    text  ") == "text  "
@@ -13478,6 +17963,7 @@ std::string to_string_fill_right(const std::string::value_type& filler,
 
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <condition_variable>
 #include <cstdint>
 #include <fstream>
@@ -13485,11 +17971,17 @@ std::string to_string_fill_right(const std::string::value_type& filler,
 #include <future>
 #include <iostream>
 #include <iterator>
+#include <memory>
+#include <mutex>
 #include <streambuf>
 #include <string>
 #include <thread>
 #include <vector>
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
 namespace fplus {
 
 // Executes a function f in a fixed interval,
@@ -13766,6 +18258,22 @@ void parallel_for_each_n_threads(size_t n_threads, F f, const Container& xs)
     fplus::transform_parallelly_n_threads(n_threads, f_dummy_return, xs);
 }
 
+// API search type: parallel_for_each_placed : (ThreadPlacement, Io a, [a]) -> Io ()
+// fwd bind count: 2
+// Runs the function `f` in parallel on all the container elements,
+// using one thread per entry of the placement, each pinned to its CPU.
+// The function will perform its side effects, and nothing is returned.
+template <typename F, typename Container>
+void parallel_for_each_placed(const thread_placement& placement, F f, const Container& xs)
+{
+    using IdxType = typename Container::value_type;
+    auto f_dummy_return = [&f](const IdxType& v) {
+        f(v);
+        return true;
+    };
+    fplus::transform_parallelly_placed(placement, f_dummy_return, xs);
+}
+
 // API search type: execute_serially_until_failure : [Io Bool] -> Io Bool
 // Returns a function that (when called) executes the given side effects
 // one after another until one of them returns false.
@@ -13788,7 +18296,8 @@ std::function<bool()> execute_serially_until_failure(const Container& effs)
 
 // API search type: execute_parallelly : [Io a] -> Io [a]
 // Returns a function that (when called) executes the given side effects
-// in parallel (one thread each) and returns the collected results.
+// in parallel (on the thread pool of transform_parallelly)
+// and returns the collected results.
 template <typename Container>
 auto execute_parallelly(const Container& effs)
 {
@@ -13817,6 +18326,23 @@ auto execute_parallelly_n_threads(std::size_t n, const Container& effs)
     };
 }
 
+// API search type: execute_parallelly_placed : (ThreadPlacement, [Io a]) -> Io [a]
+// Returns a function that (when called) executes the given side effects
+// in parallel (one thread per entry of the placement, each pinned to its CPU)
+// and returns the collected results.
+template <typename Container>
+auto execute_parallelly_placed(const thread_placement& placement, const Container& effs)
+{
+    return [placement, effs] {
+        // Bluntly re-using the transform implementation to execute side effects.
+        return transform_parallelly_placed(
+            placement, [](const auto& eff) {
+                return internal::invoke(eff);
+            },
+            effs);
+    };
+}
+
 // API search type: execute_fire_and_forget : Io a -> Io a
 // Returns a function that (when called) executes the given side effect
 // in a new thread and returns immediately.
@@ -13921,6 +18447,445 @@ inline std::function<std::vector<std::string>()> read_text_file_lines(
     };
 }
 
+// API search type: read_text_file_lines_lazy : (Bool, String) -> [String]
+// Returns the lines of a text file as a range
+// that reads the file in chunks of 1 MiB while being iterated,
+// so memory usage does not grow with the size of the file.
+// Lines spanning chunk boundaries are joined correctly.
+// Iterating yields a reference to a line buffer that is reused,
+// so the range is meant to be consumed by a range-based for loop
+// or as the source of a lazy pipeline, e.g.:
+// fwd::apply(read_text_file_lines_lazy(false, "huge.txt"),
+//     fwd::lazy::keep_if(is_relevant),
+//     fwd::lazy::transform(parse),
+//     fwd::lazy::fold_left(combine, init))
+// Every traversal reads the file anew.
+// An unreadable file results in no lines.
+inline internal::text_file_line_range read_text_file_lines_lazy(
+    bool allow_empty, const std::string& filename)
+{
+    return internal::text_file_line_range(filename, allow_empty, 1 << 20);
+}
+
+// API search type: for_each_line_parallelly : ((String -> Io ()), Bool, String) -> Io Bool
+// Calls f on every line of a text file, using the default thread pool.
+// The file is read in batches of lines of about 1 MiB each.
+// While one group of batches (one per thread) is processed,
+// the next group is read, so memory usage is bounded
+// by two groups, independently of the size of the file.
+// The order in which the lines are processed is unspecified.
+// Returns false if the file could not be opened.
+template <typename F>
+bool for_each_line_parallelly(F f, bool allow_empty, const std::string& filename)
+{
+    const auto reader = internal::chunked_line_reader::open(filename, allow_empty, 1 << 20);
+    if (!reader) {
+        return false;
+    }
+    internal::thread_pool& pool = internal::default_thread_pool();
+    typedef std::vector<std::vector<std::string>> batch_group;
+    const auto read_group = [&reader, &pool](batch_group& group) -> bool {
+        group.resize(pool.size() + 1);
+        std::size_t n = 0;
+        while (n < group.size() && reader->next_batch(group[n])) {
+            ++n;
+        }
+        group.resize(n);
+        return n > 0;
+    };
+    const auto process_group = [&f, &pool](const batch_group& group) {
+        pool.run_chunks(group.size(), [&f, &group](std::size_t idx) {
+            for (const auto& line : group[idx]) {
+                internal::invoke(f, line);
+            }
+        });
+    };
+    batch_group current;
+    batch_group next;
+    bool has_current = read_group(current);
+    while (has_current) {
+        auto processing = std::async(std::launch::async,
+            [&process_group, &current]() { process_group(current); });
+        const bool has_next = read_group(next);
+        processing.get();
+        std::swap(current, next);
+        has_current = has_next;
+    }
+    return true;
+}
+
+// Expected access pattern of a mapped_file.
+typedef internal::file_access file_access_hint;
+
+// Read-only view of the content of a file mapped into memory,
+// as returned by read_mapped_file.
+// Nothing is copied when opening it: pages are loaded on first access.
+// Copies share the mapping, which is released with the last one.
+// It behaves like a const container of chars.
+// With C++17, str() returns a std::string_view of the whole content,
+// which can be split without copying, e.g. with split_lines_view.
+class mapped_file {
+public:
+    typedef char value_type;
+    typedef const char* const_iterator;
+    typedef const_iterator iterator;
+    typedef std::size_t size_type;
+
+    mapped_file()
+        : mapping_()
+    {
+    }
+    explicit mapped_file(std::shared_ptr<const internal::file_mapping> mapping)
+        : mapping_(std::move(mapping))
+    {
+    }
+    const char* data() const { return mapping_ ? mapping_->data() : nullptr; }
+    std::size_t size() const { return mapping_ ? mapping_->size() : 0; }
+    bool empty() const { return size() == 0; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    char operator[](std::size_t idx) const { return data()[idx]; }
+    // Tells the OS how the content is going to be accessed,
+    // e.g. file_access_hint::sequential doubles the read-ahead
+    // and file_access_hint::random disables it.
+    // Returns false if the hint could not be applied.
+    bool advise(file_access_hint hint) const
+    {
+        return mapping_ && mapping_->advise(hint);
+    }
+#if __cplusplus >= 201703L
+    std::string_view str() const
+    {
+        return std::string_view(data(), size());
+    }
+#endif
+
+private:
+    std::shared_ptr<const internal::file_mapping> mapping_;
+};
+
+// API search type: read_mapped_file_maybe : (FileAccessHint, String) -> Io (Maybe MappedFile)
+// Returns a function that (when called) maps a file into memory
+// and applies the given access hint.
+// In contrast to read_text_file_maybe no content is copied.
+inline std::function<maybe<mapped_file>()> read_mapped_file_maybe(
+    file_access_hint hint, const std::string& filename)
+{
+    return [filename, hint]() -> maybe<mapped_file> {
+        std::shared_ptr<const internal::file_mapping> mapping = internal::file_mapping::open(filename);
+        if (!mapping)
+            return {};
+        mapping->advise(hint);
+        return just(mapped_file(std::move(mapping)));
+    };
+}
+
+// API search type: read_mapped_file : (FileAccessHint, String) -> Io MappedFile
+// Returns a function that (when called) maps a file into memory
+// and applies the given access hint.
+// This function then returns an empty mapped_file if the file could not be read.
+inline std::function<mapped_file()> read_mapped_file(
+    file_access_hint hint, const std::string& filename)
+{
+    return [filename, hint]() -> mapped_file {
+        return just_with_default(
+            mapped_file(),
+            read_mapped_file_maybe(hint, filename)());
+    };
+}
+
+// Writes text into a file, replacing it if it already exists.
+// The text is collected in a reusable buffer of buffer_size bytes,
+// which is written out whenever it is full,
+// so large outputs can be produced piece by piece.
+// Errors are remembered and reported by flush and close,
+// which return the total number of bytes written so far.
+// The destructor closes the file, ignoring errors.
+//
+// Example usage:
+//
+// buffered_file_writer writer("out.txt");
+// for (const auto& x : xs) {
+//     writer.write_line(show(x));
+// }
+// const auto written = writer.close();
+class buffered_file_writer {
+public:
+    explicit buffered_file_writer(const std::string& filename,
+        std::size_t buffer_size = 1 << 20)
+        : filename_(filename)
+        , output_(filename)
+        , buffer_()
+        , buffer_size_(std::max<std::size_t>(1, buffer_size))
+        , bytes_written_(0)
+        , error_()
+    {
+        buffer_.reserve(buffer_size_);
+        if (!output_.good()) {
+            error_ = "Can not open file for writing: " + filename_;
+        }
+    }
+    buffered_file_writer(const buffered_file_writer&) = delete;
+    buffered_file_writer& operator=(const buffered_file_writer&) = delete;
+    ~buffered_file_writer()
+    {
+        close();
+    }
+    void write(const std::string& str)
+    {
+        if (buffer_.size() + str.size() > buffer_size_) {
+            write_buffer();
+        }
+        if (str.size() >= buffer_size_) {
+            write_to_file(str.data(), str.size());
+        } else {
+            buffer_ += str;
+        }
+    }
+    void write(char c)
+    {
+        if (buffer_.size() == buffer_size_) {
+            write_buffer();
+        }
+        buffer_ += c;
+    }
+    void write_line(const std::string& line)
+    {
+        write(line);
+        write('\n');
+    }
+    // Writes out the buffer and flushes the file.
+    result<std::size_t, std::string> flush()
+    {
+        write_buffer();
+        if (error_.empty() && output_.is_open() && !output_.flush()) {
+            error_ = "Can not write to file: " + filename_;
+        }
+        return get_result();
+    }
+    // Flushes and closes the file. Further writes are errors.
+    result<std::size_t, std::string> close()
+    {
+        if (!output_.is_open()) {
+            write_buffer();
+            return get_result();
+        }
+        flush();
+        output_.close();
+        if (error_.empty() && output_.fail()) {
+            error_ = "Can not close file: " + filename_;
+        }
+        return get_result();
+    }
+
+private:
+    void write_buffer()
+    {
+        write_to_file(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+    void write_to_file(const char* data, std::size_t size)
+    {
+        if (size == 0 || !error_.empty()) {
+            return;
+        }
+        if (!output_.is_open() || !output_.write(data, static_cast<std::streamsize>(size))) {
+            error_ = "Can not write to file: " + filename_;
+            return;
+        }
+        bytes_written_ += size;
+    }
+    result<std::size_t, std::string> get_result() const
+    {
+        if (!error_.empty()) {
+            return error<std::size_t>(error_);
+        }
+        return ok<std::size_t, std::string>(bytes_written_);
+    }
+    std::string filename_;
+    std::ofstream output_;
+    std::string buffer_;
+    std::size_t buffer_size_;
+    std::size_t bytes_written_;
+    std::string error_;
+};
+
+// Like buffered_file_writer, but full buffers are handed over
+// to a background thread writing them into the file,
+// so the producer can continue computing in the meantime.
+// At most max_pending_buffers full buffers wait for being written.
+// If the writer thread falls behind, the producer waits,
+// which bounds the memory usage.
+// Written buffers are reused.
+// The writing functions must only be called from one thread at a time.
+class async_file_writer {
+public:
+    explicit async_file_writer(const std::string& filename,
+        std::size_t buffer_size = 1 << 20,
+        std::size_t max_pending_buffers = 4)
+        : filename_(filename)
+        , output_(filename)
+        , buffer_()
+        , buffer_size_(std::max<std::size_t>(1, buffer_size))
+        , max_pending_buffers_(std::max<std::size_t>(1, max_pending_buffers))
+        , mutex_()
+        , cv_()
+        , pending_()
+        , free_()
+        , is_writing_(false)
+        , stop_(false)
+        , bytes_written_(0)
+        , error_()
+        , thread_()
+    {
+        buffer_.reserve(buffer_size_);
+        if (!output_.good()) {
+            error_ = "Can not open file for writing: " + filename_;
+        }
+        thread_ = std::thread([this]() { writer_loop(); });
+    }
+    async_file_writer(const async_file_writer&) = delete;
+    async_file_writer& operator=(const async_file_writer&) = delete;
+    ~async_file_writer()
+    {
+        close();
+    }
+    void write(const std::string& str)
+    {
+        if (buffer_.size() + str.size() > buffer_size_) {
+            hand_over_buffer();
+        }
+        buffer_ += str;
+        if (buffer_.size() >= buffer_size_) {
+            hand_over_buffer();
+        }
+    }
+    void write(char c)
+    {
+        buffer_ += c;
+        if (buffer_.size() >= buffer_size_) {
+            hand_over_buffer();
+        }
+    }
+    void write_line(const std::string& line)
+    {
+        write(line);
+        write('\n');
+    }
+    // Waits until everything written so far is in the file.
+    result<std::size_t, std::string> flush()
+    {
+        hand_over_buffer();
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return pending_.empty() && !is_writing_; });
+        if (error_.empty() && output_.is_open() && !output_.flush()) {
+            error_ = "Can not write to file: " + filename_;
+        }
+        return get_result();
+    }
+    // Flushes, stops the writer thread and closes the file.
+    // Further writes are errors.
+    result<std::size_t, std::string> close()
+    {
+        if (!thread_.joinable()) {
+            hand_over_buffer();
+            std::lock_guard<std::mutex> lock(mutex_);
+            return get_result();
+        }
+        flush();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (output_.is_open()) {
+            output_.close();
+            if (error_.empty() && output_.fail()) {
+                error_ = "Can not close file: " + filename_;
+            }
+        }
+        return get_result();
+    }
+
+private:
+    void hand_over_buffer()
+    {
+        if (buffer_.empty()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!thread_.joinable()) {
+            if (error_.empty()) {
+                error_ = "Can not write to closed file: " + filename_;
+            }
+            buffer_.clear();
+            return;
+        }
+        cv_.wait(lock, [this]() { return pending_.size() < max_pending_buffers_; });
+        pending_.push_back(std::move(buffer_));
+        if (free_.empty()) {
+            buffer_ = std::string();
+            buffer_.reserve(buffer_size_);
+        } else {
+            buffer_ = std::move(free_.back());
+            free_.pop_back();
+        }
+        cv_.notify_all();
+    }
+    void writer_loop()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cv_.wait(lock, [this]() { return stop_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            std::string buffer = std::move(pending_.front());
+            pending_.pop_front();
+            is_writing_ = true;
+            const bool skip = !error_.empty();
+            lock.unlock();
+            const bool success = skip
+                || output_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            lock.lock();
+            is_writing_ = false;
+            if (!skip && !success) {
+                error_ = "Can not write to file: " + filename_;
+            } else if (!skip) {
+                bytes_written_ += buffer.size();
+            }
+            buffer.clear();
+            free_.push_back(std::move(buffer));
+            cv_.notify_all();
+        }
+    }
+    result<std::size_t, std::string> get_result() const
+    {
+        if (!error_.empty()) {
+            return error<std::size_t>(error_);
+        }
+        return ok<std::size_t, std::string>(bytes_written_);
+    }
+    std::string filename_;
+    std::ofstream output_;
+    std::string buffer_;
+    std::size_t buffer_size_;
+    std::size_t max_pending_buffers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::string> pending_;
+    std::vector<std::string> free_;
+    bool is_writing_;
+    bool stop_;
+    std::size_t bytes_written_;
+    std::string error_;
+    std::thread thread_;
+};
+
 // API search type: write_text_file : (String, String) -> Io Bool
 // Returns a function that (when called) writes content into a text file,
 // replacing it if it already exists.
@@ -13951,15 +18916,25 @@ inline std::function<bool()> write_binary_file(const std::string& filename,
 // API search type: write_text_file_lines : (String, [String], Bool) -> Io Bool
 // Returns a function that (when called) writes lines into a text file,
 // replacing it if it already exists.
+// The lines are streamed through a buffered_file_writer
+// instead of being joined into one string first.
 inline std::function<bool()> write_text_file_lines(bool trailing_newline,
     const std::string& filename,
-    const std::vector<std::string>& lines)
+    std::vector<std::string> lines)
 {
-    std::string content = join(std::string("\n"), lines);
-    if (trailing_newline) {
-        content += "\n";
-    }
-    return write_text_file(filename, content);
+    return [filename, trailing_newline, lines = std::move(lines)]() -> bool {
+        buffered_file_writer writer(filename);
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            if (i != 0) {
+                writer.write('\n');
+            }
+            writer.write(lines[i]);
+        }
+        if (trailing_newline) {
+            writer.write('\n');
+        }
+        return is_ok(writer.close());
+    };
 }
 
 // API search type: execute_effect : Io a -> a
@@ -14237,8 +19212,12 @@ std::vector<T> flatten_tree_breadth_first(const tree<T>& x)
 
 
 
-#include <memory>
+#include <cassert>
+#include <cstddef>
+#include <new>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace fplus {
 
@@ -14316,11 +19295,6 @@ namespace internal {
         typedef List<typename Mod<Args>::type...> type;
     };
 
-    template <typename T>
-    struct as_shared_pointer {
-        typedef std::shared_ptr<T> type;
-    };
-
     // http://stackoverflow.com/a/27588263/1866775
 
     template <typename T, typename... Ts>
@@ -14406,8 +19380,61 @@ namespace internal {
     template <bool... bs>
     using all_true = std::is_same<bool_pack<bs..., true>, bool_pack<true, bs...>>;
 
+    template <typename T, typename Tuple>
+    struct get_index_in_tuple;
+
+    template <typename T, typename... Ts>
+    struct get_index_in_tuple<T, std::tuple<Ts...>> : get_index<T, Ts...> {
+    };
+
+    template <std::size_t... Xs>
+    struct max_of;
+
+    template <std::size_t X>
+    struct max_of<X> : std::integral_constant<std::size_t, X> {
+    };
+
+    template <std::size_t X, std::size_t Y, std::size_t... Xs>
+    struct max_of<X, Y, Xs...>
+        : max_of<(X > Y ? X : Y), Xs...> {
+    };
+
+    // Type-erased operations on one alternative of a variant,
+    // used to fill the dispatch tables indexed by the type index.
+    template <typename T>
+    struct variant_alternative_ops {
+        static void destruct(void* p)
+        {
+            static_cast<T*>(p)->~T();
+        }
+        static void copy(void* dest, const void* src)
+        {
+            new (dest) T(*static_cast<const T*>(src));
+        }
+        static void move(void* dest, void* src)
+        {
+            new (dest) T(std::move(*static_cast<T*>(src)));
+        }
+        static bool equal(const void* a, const void* b)
+        {
+            return *static_cast<const T*>(a) == *static_cast<const T*>(b);
+        }
+    };
+
+    // Calls the function of the tuple fs, that takes a T, with the T at p.
+    template <typename Res, typename T, typename FsInputTypes, typename Fs>
+    Res call_matching_visitor(const void* p, const Fs& fs)
+    {
+        return internal::invoke(
+            std::get<get_index_in_tuple<T, FsInputTypes>::value>(fs),
+            *static_cast<const T*>(p));
+    }
+
 } // namespace internal
 
+// Holds a value of exactly one of the given types.
+// The value is stored in place, so no heap allocation is involved,
+// and visiting it dispatches through a table indexed by the type index.
 template <typename... Types>
 struct variant {
     static_assert(internal::is_unique<Types...>::value, "Types must be unique.");
@@ -14415,11 +19442,60 @@ struct variant {
     static_assert(internal::all_true<(!std::is_const<Types>::value)...>::value, "No const types allowed.");
     static_assert(sizeof...(Types) >= 1, "Please provide at least one type.");
 
+private:
+    static constexpr bool is_nothrow_movable = internal::all_true<std::is_nothrow_move_constructible<Types>::value...>::value;
+
+public:
+
     template <typename T>
     variant(const T& val)
-        : shared_ptrs_({})
+        : index_(internal::get_index<T, Types...>::value)
+        , storage_()
+    {
+        new (&storage_) T(val);
+    }
+
+    variant(const variant<Types...>& other)
+        : index_(other.index_)
+        , storage_()
+    {
+        copy_content(other);
+    }
+
+    variant(variant<Types...>&& other) noexcept(is_nothrow_movable)
+        : index_(other.index_)
+        , storage_()
+    {
+        move_content(std::move(other));
+    }
+
+    // The new content is built in a temporary first,
+    // so a throwing copy leaves *this unchanged.
+    variant<Types...>& operator=(const variant<Types...>& other)
+    {
+        if (this != &other) {
+            variant<Types...> tmp(other);
+            replace_content(std::move(tmp));
+        }
+        return *this;
+    }
+
+    variant<Types...>& operator=(variant<Types...>&& other) noexcept(is_nothrow_movable)
+    {
+        if (this != &other) {
+            if (is_nothrow_movable) {
+                replace_content(std::move(other));
+            } else {
+                variant<Types...> tmp(std::move(other));
+                replace_content(std::move(tmp));
+            }
+        }
+        return *this;
+    }
+
+    ~variant()
     {
-        std::get<internal::get_index<T, Types...>::value>(shared_ptrs_) = std::make_shared<T>(val);
+        destruct_content();
     }
 
     template <typename T>
@@ -14428,21 +19504,22 @@ struct variant {
         static_assert(
             internal::is_one_of<T, Types...>::value, "Type must match one possible variant type.");
 
-        const auto ptr = std::get<internal::get_index<T, Types...>::value>(shared_ptrs_);
-
-        return static_cast<bool>(ptr);
+        return index_ == internal::get_index<T, Types...>::value;
     }
 
+    // Equal if both hold the same type and the values are equal.
     friend bool operator==(
         const variant<Types...>& a, const variant<Types...>& b)
     {
-        return a.shared_ptrs_ == b.shared_ptrs_;
+        using op = bool (*)(const void*, const void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::equal... };
+        return a.index_ == b.index_ && ops[a.index_](&a.storage_, &b.storage_);
     }
 
     friend bool operator!=(
         const variant<Types...>& a, const variant<Types...>& b)
     {
-        return a.shared_ptrs_ != b.shared_ptrs_;
+        return !(a == b);
     }
 
     template <typename F>
@@ -14461,10 +19538,8 @@ struct variant {
         static_assert(!std::is_same<std::decay_t<Ret>, void>::value,
             "Function must return non-void type.");
 
-        const auto ptr = std::get<internal::get_index<T, Types...>::value>(shared_ptrs_);
-
-        if (ptr) {
-            return just(internal::invoke(f, *ptr));
+        if (is<T>()) {
+            return just(internal::invoke(f, unsafe_get<T>()));
         }
 
         return nothing<std::decay_t<Ret>>();
@@ -14486,9 +19561,8 @@ struct variant {
         static_assert(std::is_same<std::decay_t<Ret>, void>::value,
             "Function must return void type.");
 
-        const auto ptr = std::get<internal::get_index<T, Types...>::value>(shared_ptrs_);
-        if (ptr) {
-            internal::invoke(f, *ptr);
+        if (is<T>()) {
+            internal::invoke(f, unsafe_get<T>());
         }
     }
 
@@ -14502,11 +19576,11 @@ struct variant {
             Res;
 
         static_assert(
-            sizeof...(Fs) >= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) >= sizeof...(Types),
             "Too few functions provided.");
 
         static_assert(
-            sizeof...(Fs) <= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) <= sizeof...(Types),
             "Too many functions provided.");
 
         typedef typename internal::transform_parameter_pack<
@@ -14534,9 +19608,7 @@ struct variant {
         static_assert(!std::is_same<std::decay_t<Res>, void>::value,
             "Function must return non-void type.");
 
-        const auto results = justs(go_visit_one<Res>(fs...));
-        assert(size_of_cont(results) == 1);
-        return head(results);
+        return dispatch<Res, function_first_input_types_tuple>(fs...);
     }
 
     template <typename... Fs>
@@ -14544,11 +19616,11 @@ struct variant {
     {
 
         static_assert(
-            sizeof...(Fs) >= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) >= sizeof...(Types),
             "Too few functions provided.");
 
         static_assert(
-            sizeof...(Fs) <= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) <= sizeof...(Types),
             "Too many functions provided.");
 
         typedef typename internal::transform_parameter_pack<
@@ -14573,18 +19645,18 @@ struct variant {
             internal::type_set_eq<function_first_input_types_tuple, std::tuple<Types...>>::value,
             "Functions do not cover all possible types.");
 
-        go_effect_one(fs...);
+        dispatch<void, function_first_input_types_tuple>(fs...);
     }
 
     template <typename... Fs>
     variant<Types...> transform(Fs... fs) const
     {
         static_assert(
-            sizeof...(Fs) >= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) >= sizeof...(Types),
             "Too few functions provided.");
 
         static_assert(
-            sizeof...(Fs) <= std::tuple_size<shared_ptr_pack>::value,
+            sizeof...(Fs) <= sizeof...(Types),
             "Too many functions provided.");
 
         typedef typename internal::transform_parameter_pack<
@@ -14615,36 +19687,59 @@ struct variant {
     }
 
 private:
-    template <typename Res, typename F>
-    std::vector<fplus::maybe<Res>> go_visit_one(F f) const
+    template <typename T>
+    const T& unsafe_get() const
     {
-        return { visit_one(f) };
+        assert(is<T>());
+        return *reinterpret_cast<const T*>(&storage_);
     }
 
-    template <typename Res, typename F, typename... Fs>
-    std::vector<fplus::maybe<Res>> go_visit_one(F f, Fs... fs) const
+    // Calls the one function of fs taking the currently held type.
+    template <typename Res, typename FsInputTypes, typename... Fs>
+    Res dispatch(const Fs&... fs) const
     {
-        return fplus::append(go_visit_one<Res>(f), go_visit_one<Res>(fs...));
+        typedef std::tuple<const Fs&...> fs_tuple;
+        using op = Res (*)(const void*, const fs_tuple&);
+        static constexpr op ops[] = {
+            &internal::call_matching_visitor<Res, Types, FsInputTypes, fs_tuple>...
+        };
+        return ops[index_](&storage_, fs_tuple(fs...));
     }
 
-    template <typename F>
-    void go_effect_one(F f) const
+    void copy_content(const variant<Types...>& other)
+    {
+        using op = void (*)(void*, const void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::copy... };
+        ops[index_](&storage_, &other.storage_);
+    }
+
+    void move_content(variant<Types...>&& other)
+    {
+        using op = void (*)(void*, void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::move... };
+        ops[index_](&storage_, &other.storage_);
+    }
+
+    void destruct_content()
     {
-        effect_one(f);
+        using op = void (*)(void*);
+        static constexpr op ops[] = { &internal::variant_alternative_ops<Types>::destruct... };
+        ops[index_](&storage_);
     }
 
-    template <typename F, typename... Fs>
-    void go_effect_one(F f, Fs... fs) const
+    // No content would be left if the move threw after the old
+    // content has been destroyed, so this terminates instead.
+    void replace_content(variant<Types...>&& other) noexcept
     {
-        go_effect_one(f);
-        go_effect_one(fs...);
+        destruct_content();
+        index_ = other.index_;
+        move_content(std::move(other));
     }
 
-    typedef typename internal::transform_parameter_pack<
-        std::tuple,
-        internal::as_shared_pointer,
-        Types...>::type shared_ptr_pack;
-    shared_ptr_pack shared_ptrs_;
+    std::size_t index_;
+    typename std::aligned_storage<
+        internal::max_of<sizeof(Types)...>::value,
+        internal::max_of<alignof(Types)...>::value>::type storage_;
 };
 
 } // namespace fplus
@@ -14844,12 +19939,15 @@ fplus_curry_define_fn_1(all_the_same_on)
 fplus_curry_define_fn_0(all_the_same)
 fplus_curry_define_fn_2(numbers_step)
 fplus_curry_define_fn_1(numbers)
+fplus_curry_define_fn_2(numbers_step_lazy)
+fplus_curry_define_fn_1(numbers_lazy)
 fplus_curry_define_fn_0(singleton_seq)
 fplus_curry_define_fn_0(all_idxs)
 fplus_curry_define_fn_0(init)
 fplus_curry_define_fn_0(tail)
 fplus_curry_define_fn_0(head)
 fplus_curry_define_fn_0(last)
+fplus_curry_define_fn_0(get_running_stats)
 fplus_curry_define_fn_0(mean_stddev)
 fplus_curry_define_fn_1(count_occurrences_by)
 fplus_curry_define_fn_0(count_occurrences)
@@ -14900,8 +19998,11 @@ fplus_curry_define_fn_1(adjacent_drop_fst_if)
 fplus_curry_define_fn_1(adjacent_drop_snd_if)
 fplus_curry_define_fn_1(adjacent_keep_fst_if)
 fplus_curry_define_fn_1(generate_by_idx)
+fplus_curry_define_fn_1(generate_by_idx_lazy)
 fplus_curry_define_fn_1(repeat)
+fplus_curry_define_fn_1(repeat_lazy)
 fplus_curry_define_fn_1(infixes)
+fplus_curry_define_fn_1(infixes_view)
 fplus_curry_define_fn_3(carthesian_product_with_where)
 fplus_curry_define_fn_2(carthesian_product_with)
 fplus_curry_define_fn_2(carthesian_product_where)
@@ -14912,6 +20013,7 @@ fplus_curry_define_fn_1(combinations)
 fplus_curry_define_fn_1(combinations_with_replacement)
 fplus_curry_define_fn_0(power_set)
 fplus_curry_define_fn_2(iterate)
+fplus_curry_define_fn_2(iterate_lazy)
 fplus_curry_define_fn_1(iterate_maybe)
 fplus_curry_define_fn_1(adjacent_difference_by)
 fplus_curry_define_fn_0(adjacent_difference)
@@ -15000,9 +20102,12 @@ fplus_curry_define_fn_1(find_first_idx)
 fplus_curry_define_fn_1(find_last_idx)
 fplus_curry_define_fn_1(find_all_idxs_by)
 fplus_curry_define_fn_1(find_all_idxs_of)
+fplus_curry_define_fn_0(compile_token)
 fplus_curry_define_fn_1(find_all_instances_of_token)
 fplus_curry_define_fn_1(find_all_instances_of_token_non_overlapping)
 fplus_curry_define_fn_1(find_first_instance_of_token)
+fplus_curry_define_fn_0(compile_tokens)
+fplus_curry_define_fn_1(find_all_instances_of_tokens)
 fplus_curry_define_fn_1(set_includes)
 fplus_curry_define_fn_1(unordered_set_includes)
 fplus_curry_define_fn_1(set_merge)
@@ -15050,6 +20155,7 @@ fplus_curry_define_fn_0(mean_obj_div_size_t)
 fplus_curry_define_fn_0(mean_obj_div_double)
 fplus_curry_define_fn_0(mean_using_doubles)
 fplus_curry_define_fn_0(median)
+fplus_curry_define_fn_1(quantiles)
 fplus_curry_define_fn_1(all_unique_by_less)
 fplus_curry_define_fn_0(all_unique_less)
 fplus_curry_define_fn_1(is_infix_of)
@@ -15124,15 +20230,20 @@ fplus_curry_define_fn_2(insert_at_idx)
 fplus_curry_define_fn_1(partition)
 fplus_curry_define_fn_1(split_at_idxs)
 fplus_curry_define_fn_1(split_every)
+fplus_curry_define_fn_1(split_every_view)
 fplus_curry_define_fn_1(split_evenly)
+fplus_curry_define_fn_1(split_evenly_view)
 fplus_curry_define_fn_2(split_by_token)
 fplus_curry_define_fn_1(run_length_encode_by)
 fplus_curry_define_fn_0(run_length_encode)
 fplus_curry_define_fn_0(run_length_decode)
 fplus_curry_define_fn_1(span)
 fplus_curry_define_fn_2(divvy)
+fplus_curry_define_fn_2(divvy_view)
 fplus_curry_define_fn_1(aperture)
+fplus_curry_define_fn_1(aperture_view)
 fplus_curry_define_fn_1(stride)
+fplus_curry_define_fn_1(stride_view)
 fplus_curry_define_fn_1(winsorize)
 fplus_curry_define_fn_1(separate_on)
 fplus_curry_define_fn_0(separate)
@@ -15151,12 +20262,43 @@ fplus_curry_define_fn_1(apply_functions)
 fplus_curry_define_fn_2(apply_function_n_times)
 fplus_curry_define_fn_1(transform_parallelly)
 fplus_curry_define_fn_2(transform_parallelly_n_threads)
+fplus_curry_define_fn_2(transform_parallelly_placed)
 fplus_curry_define_fn_2(reduce_parallelly)
 fplus_curry_define_fn_3(reduce_parallelly_n_threads)
 fplus_curry_define_fn_1(reduce_1_parallelly)
 fplus_curry_define_fn_2(reduce_1_parallelly_n_threads)
+fplus_curry_define_fn_2(scan_left_parallelly)
+fplus_curry_define_fn_3(scan_left_parallelly_n_threads)
+fplus_curry_define_fn_1(scan_left_1_parallelly)
+fplus_curry_define_fn_2(scan_left_1_parallelly_n_threads)
+fplus_curry_define_fn_1(any_by_parallelly)
+fplus_curry_define_fn_2(any_by_parallelly_n_threads)
+fplus_curry_define_fn_1(none_by_parallelly)
+fplus_curry_define_fn_2(none_by_parallelly_n_threads)
+fplus_curry_define_fn_1(all_by_parallelly)
+fplus_curry_define_fn_2(all_by_parallelly_n_threads)
+fplus_curry_define_fn_1(find_first_idx_by_parallelly)
+fplus_curry_define_fn_2(find_first_idx_by_parallelly_n_threads)
+fplus_curry_define_fn_1(find_first_by_parallelly)
+fplus_curry_define_fn_2(find_first_by_parallelly_n_threads)
 fplus_curry_define_fn_1(keep_if_parallelly)
 fplus_curry_define_fn_2(keep_if_parallelly_n_threads)
+fplus_curry_define_fn_1(drop_if_parallelly)
+fplus_curry_define_fn_2(drop_if_parallelly_n_threads)
+fplus_curry_define_fn_1(partition_parallelly)
+fplus_curry_define_fn_2(partition_parallelly_n_threads)
+fplus_curry_define_fn_1(sort_by_parallelly)
+fplus_curry_define_fn_2(sort_by_parallelly_n_threads)
+fplus_curry_define_fn_1(sort_on_parallelly)
+fplus_curry_define_fn_2(sort_on_parallelly_n_threads)
+fplus_curry_define_fn_0(sort_parallelly)
+fplus_curry_define_fn_1(sort_parallelly_n_threads)
+fplus_curry_define_fn_1(stable_sort_by_parallelly)
+fplus_curry_define_fn_2(stable_sort_by_parallelly_n_threads)
+fplus_curry_define_fn_1(stable_sort_on_parallelly)
+fplus_curry_define_fn_2(stable_sort_on_parallelly_n_threads)
+fplus_curry_define_fn_0(stable_sort_parallelly)
+fplus_curry_define_fn_1(stable_sort_parallelly_n_threads)
 fplus_curry_define_fn_3(transform_reduce)
 fplus_curry_define_fn_2(transform_reduce_1)
 fplus_curry_define_fn_3(transform_reduce_parallelly)
@@ -15189,6 +20331,7 @@ fplus_curry_define_fn_2(replace_if)
 fplus_curry_define_fn_2(replace_elem_at_idx)
 fplus_curry_define_fn_2(replace_elems)
 fplus_curry_define_fn_2(replace_tokens)
+fplus_curry_define_fn_2(replace_tokens_many)
 fplus_curry_define_fn_0(is_letter_or_digit)
 fplus_curry_define_fn_0(is_whitespace)
 fplus_curry_define_fn_0(is_line_break)
@@ -15207,6 +20350,7 @@ fplus_curry_define_fn_2(to_string_fill_right)
 fplus_curry_define_fn_1(for_each)
 fplus_curry_define_fn_1(parallel_for_each)
 fplus_curry_define_fn_2(parallel_for_each_n_threads)
+fplus_curry_define_fn_2(parallel_for_each_placed)
 fplus_curry_define_fn_1(trees_from_sequence)
 fplus_curry_define_fn_1(are_trees_equal)
 fplus_curry_define_fn_0(tree_size)
@@ -15228,6 +20372,11 @@ fplus_curry_define_fn_0(flatten_tree_breadth_first)
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 namespace fplus {
 namespace fwd {
 
@@ -15453,12 +20602,15 @@ fplus_fwd_define_fn_1(all_the_same_on)
 fplus_fwd_define_fn_0(all_the_same)
 fplus_fwd_define_fn_2(numbers_step)
 fplus_fwd_define_fn_1(numbers)
+fplus_fwd_define_fn_2(numbers_step_lazy)
+fplus_fwd_define_fn_1(numbers_lazy)
 fplus_fwd_define_fn_0(singleton_seq)
 fplus_fwd_define_fn_0(all_idxs)
 fplus_fwd_define_fn_0(init)
 fplus_fwd_define_fn_0(tail)
 fplus_fwd_define_fn_0(head)
 fplus_fwd_define_fn_0(last)
+fplus_fwd_define_fn_0(get_running_stats)
 fplus_fwd_define_fn_0(mean_stddev)
 fplus_fwd_define_fn_1(count_occurrences_by)
 fplus_fwd_define_fn_0(count_occurrences)
@@ -15509,8 +20661,11 @@ fplus_fwd_define_fn_1(adjacent_drop_fst_if)
 fplus_fwd_define_fn_1(adjacent_drop_snd_if)
 fplus_fwd_define_fn_1(adjacent_keep_fst_if)
 fplus_fwd_define_fn_1(generate_by_idx)
+fplus_fwd_define_fn_1(generate_by_idx_lazy)
 fplus_fwd_define_fn_1(repeat)
+fplus_fwd_define_fn_1(repeat_lazy)
 fplus_fwd_define_fn_1(infixes)
+fplus_fwd_define_fn_1(infixes_view)
 fplus_fwd_define_fn_3(carthesian_product_with_where)
 fplus_fwd_define_fn_2(carthesian_product_with)
 fplus_fwd_define_fn_2(carthesian_product_where)
@@ -15521,6 +20676,7 @@ fplus_fwd_define_fn_1(combinations)
 fplus_fwd_define_fn_1(combinations_with_replacement)
 fplus_fwd_define_fn_0(power_set)
 fplus_fwd_define_fn_2(iterate)
+fplus_fwd_define_fn_2(iterate_lazy)
 fplus_fwd_define_fn_1(iterate_maybe)
 fplus_fwd_define_fn_1(adjacent_difference_by)
 fplus_fwd_define_fn_0(adjacent_difference)
@@ -15609,9 +20765,12 @@ fplus_fwd_define_fn_1(find_first_idx)
 fplus_fwd_define_fn_1(find_last_idx)
 fplus_fwd_define_fn_1(find_all_idxs_by)
 fplus_fwd_define_fn_1(find_all_idxs_of)
+fplus_fwd_define_fn_0(compile_token)
 fplus_fwd_define_fn_1(find_all_instances_of_token)
 fplus_fwd_define_fn_1(find_all_instances_of_token_non_overlapping)
 fplus_fwd_define_fn_1(find_first_instance_of_token)
+fplus_fwd_define_fn_0(compile_tokens)
+fplus_fwd_define_fn_1(find_all_instances_of_tokens)
 fplus_fwd_define_fn_1(set_includes)
 fplus_fwd_define_fn_1(unordered_set_includes)
 fplus_fwd_define_fn_1(set_merge)
@@ -15659,6 +20818,7 @@ fplus_fwd_define_fn_0(mean_obj_div_size_t)
 fplus_fwd_define_fn_0(mean_obj_div_double)
 fplus_fwd_define_fn_0(mean_using_doubles)
 fplus_fwd_define_fn_0(median)
+fplus_fwd_define_fn_1(quantiles)
 fplus_fwd_define_fn_1(all_unique_by_less)
 fplus_fwd_define_fn_0(all_unique_less)
 fplus_fwd_define_fn_1(is_infix_of)
@@ -15733,15 +20893,20 @@ fplus_fwd_define_fn_2(insert_at_idx)
 fplus_fwd_define_fn_1(partition)
 fplus_fwd_define_fn_1(split_at_idxs)
 fplus_fwd_define_fn_1(split_every)
+fplus_fwd_define_fn_1(split_every_view)
 fplus_fwd_define_fn_1(split_evenly)
+fplus_fwd_define_fn_1(split_evenly_view)
 fplus_fwd_define_fn_2(split_by_token)
 fplus_fwd_define_fn_1(run_length_encode_by)
 fplus_fwd_define_fn_0(run_length_encode)
 fplus_fwd_define_fn_0(run_length_decode)
 fplus_fwd_define_fn_1(span)
 fplus_fwd_define_fn_2(divvy)
+fplus_fwd_define_fn_2(divvy_view)
 fplus_fwd_define_fn_1(aperture)
+fplus_fwd_define_fn_1(aperture_view)
 fplus_fwd_define_fn_1(stride)
+fplus_fwd_define_fn_1(stride_view)
 fplus_fwd_define_fn_1(winsorize)
 fplus_fwd_define_fn_1(separate_on)
 fplus_fwd_define_fn_0(separate)
@@ -15760,12 +20925,43 @@ fplus_fwd_define_fn_1(apply_functions)
 fplus_fwd_define_fn_2(apply_function_n_times)
 fplus_fwd_define_fn_1(transform_parallelly)
 fplus_fwd_define_fn_2(transform_parallelly_n_threads)
+fplus_fwd_define_fn_2(transform_parallelly_placed)
 fplus_fwd_define_fn_2(reduce_parallelly)
 fplus_fwd_define_fn_3(reduce_parallelly_n_threads)
 fplus_fwd_define_fn_1(reduce_1_parallelly)
 fplus_fwd_define_fn_2(reduce_1_parallelly_n_threads)
+fplus_fwd_define_fn_2(scan_left_parallelly)
+fplus_fwd_define_fn_3(scan_left_parallelly_n_threads)
+fplus_fwd_define_fn_1(scan_left_1_parallelly)
+fplus_fwd_define_fn_2(scan_left_1_parallelly_n_threads)
+fplus_fwd_define_fn_1(any_by_parallelly)
+fplus_fwd_define_fn_2(any_by_parallelly_n_threads)
+fplus_fwd_define_fn_1(none_by_parallelly)
+fplus_fwd_define_fn_2(none_by_parallelly_n_threads)
+fplus_fwd_define_fn_1(all_by_parallelly)
+fplus_fwd_define_fn_2(all_by_parallelly_n_threads)
+fplus_fwd_define_fn_1(find_first_idx_by_parallelly)
+fplus_fwd_define_fn_2(find_first_idx_by_parallelly_n_threads)
+fplus_fwd_define_fn_1(find_first_by_parallelly)
+fplus_fwd_define_fn_2(find_first_by_parallelly_n_threads)
 fplus_fwd_define_fn_1(keep_if_parallelly)
 fplus_fwd_define_fn_2(keep_if_parallelly_n_threads)
+fplus_fwd_define_fn_1(drop_if_parallelly)
+fplus_fwd_define_fn_2(drop_if_parallelly_n_threads)
+fplus_fwd_define_fn_1(partition_parallelly)
+fplus_fwd_define_fn_2(partition_parallelly_n_threads)
+fplus_fwd_define_fn_1(sort_by_parallelly)
+fplus_fwd_define_fn_2(sort_by_parallelly_n_threads)
+fplus_fwd_define_fn_1(sort_on_parallelly)
+fplus_fwd_define_fn_2(sort_on_parallelly_n_threads)
+fplus_fwd_define_fn_0(sort_parallelly)
+fplus_fwd_define_fn_1(sort_parallelly_n_threads)
+fplus_fwd_define_fn_1(stable_sort_by_parallelly)
+fplus_fwd_define_fn_2(stable_sort_by_parallelly_n_threads)
+fplus_fwd_define_fn_1(stable_sort_on_parallelly)
+fplus_fwd_define_fn_2(stable_sort_on_parallelly_n_threads)
+fplus_fwd_define_fn_0(stable_sort_parallelly)
+fplus_fwd_define_fn_1(stable_sort_parallelly_n_threads)
 fplus_fwd_define_fn_3(transform_reduce)
 fplus_fwd_define_fn_2(transform_reduce_1)
 fplus_fwd_define_fn_3(transform_reduce_parallelly)
@@ -15798,6 +20994,7 @@ fplus_fwd_define_fn_2(replace_if)
 fplus_fwd_define_fn_2(replace_elem_at_idx)
 fplus_fwd_define_fn_2(replace_elems)
 fplus_fwd_define_fn_2(replace_tokens)
+fplus_fwd_define_fn_2(replace_tokens_many)
 fplus_fwd_define_fn_0(is_letter_or_digit)
 fplus_fwd_define_fn_0(is_whitespace)
 fplus_fwd_define_fn_0(is_line_break)
@@ -15816,6 +21013,7 @@ fplus_fwd_define_fn_2(to_string_fill_right)
 fplus_fwd_define_fn_1(for_each)
 fplus_fwd_define_fn_1(parallel_for_each)
 fplus_fwd_define_fn_2(parallel_for_each_n_threads)
+fplus_fwd_define_fn_2(parallel_for_each_placed)
 fplus_fwd_define_fn_1(trees_from_sequence)
 fplus_fwd_define_fn_1(are_trees_equal)
 fplus_fwd_define_fn_0(tree_size)
@@ -15889,6 +21087,7 @@ fplus_fwd_flip_define_fn_1(all_by)
 fplus_fwd_flip_define_fn_1(all_the_same_by)
 fplus_fwd_flip_define_fn_1(all_the_same_on)
 fplus_fwd_flip_define_fn_1(numbers)
+fplus_fwd_flip_define_fn_1(numbers_lazy)
 fplus_fwd_flip_define_fn_1(count_occurrences_by)
 fplus_fwd_flip_define_fn_1(lexicographical_less)
 fplus_fwd_flip_define_fn_1(replicate)
@@ -15921,8 +21120,11 @@ fplus_fwd_flip_define_fn_1(adjacent_drop_fst_if)
 fplus_fwd_flip_define_fn_1(adjacent_drop_snd_if)
 fplus_fwd_flip_define_fn_1(adjacent_keep_fst_if)
 fplus_fwd_flip_define_fn_1(generate_by_idx)
+fplus_fwd_flip_define_fn_1(generate_by_idx_lazy)
 fplus_fwd_flip_define_fn_1(repeat)
+fplus_fwd_flip_define_fn_1(repeat_lazy)
 fplus_fwd_flip_define_fn_1(infixes)
+fplus_fwd_flip_define_fn_1(infixes_view)
 fplus_fwd_flip_define_fn_1(carthesian_product)
 fplus_fwd_flip_define_fn_1(carthesian_product_n)
 fplus_fwd_flip_define_fn_1(permutations)
@@ -15954,6 +21156,7 @@ fplus_fwd_flip_define_fn_1(find_all_idxs_of)
 fplus_fwd_flip_define_fn_1(find_all_instances_of_token)
 fplus_fwd_flip_define_fn_1(find_all_instances_of_token_non_overlapping)
 fplus_fwd_flip_define_fn_1(find_first_instance_of_token)
+fplus_fwd_flip_define_fn_1(find_all_instances_of_tokens)
 fplus_fwd_flip_define_fn_1(set_includes)
 fplus_fwd_flip_define_fn_1(unordered_set_includes)
 fplus_fwd_flip_define_fn_1(set_merge)
@@ -15984,6 +21187,7 @@ fplus_fwd_flip_define_fn_1(minimum_on)
 fplus_fwd_flip_define_fn_1(minimum_on_maybe)
 fplus_fwd_flip_define_fn_1(maximum_on)
 fplus_fwd_flip_define_fn_1(maximum_on_maybe)
+fplus_fwd_flip_define_fn_1(quantiles)
 fplus_fwd_flip_define_fn_1(all_unique_by_less)
 fplus_fwd_flip_define_fn_1(is_infix_of)
 fplus_fwd_flip_define_fn_1(is_subsequence_of)
@@ -16033,11 +21237,15 @@ fplus_fwd_flip_define_fn_1(split_at_idx)
 fplus_fwd_flip_define_fn_1(partition)
 fplus_fwd_flip_define_fn_1(split_at_idxs)
 fplus_fwd_flip_define_fn_1(split_every)
+fplus_fwd_flip_define_fn_1(split_every_view)
 fplus_fwd_flip_define_fn_1(split_evenly)
+fplus_fwd_flip_define_fn_1(split_evenly_view)
 fplus_fwd_flip_define_fn_1(run_length_encode_by)
 fplus_fwd_flip_define_fn_1(span)
 fplus_fwd_flip_define_fn_1(aperture)
+fplus_fwd_flip_define_fn_1(aperture_view)
 fplus_fwd_flip_define_fn_1(stride)
+fplus_fwd_flip_define_fn_1(stride_view)
 fplus_fwd_flip_define_fn_1(winsorize)
 fplus_fwd_flip_define_fn_1(separate_on)
 fplus_fwd_flip_define_fn_1(transform_with_idx)
@@ -16050,7 +21258,21 @@ fplus_fwd_flip_define_fn_1(random_element)
 fplus_fwd_flip_define_fn_1(apply_functions)
 fplus_fwd_flip_define_fn_1(transform_parallelly)
 fplus_fwd_flip_define_fn_1(reduce_1_parallelly)
+fplus_fwd_flip_define_fn_1(scan_left_1_parallelly)
+fplus_fwd_flip_define_fn_1(any_by_parallelly)
+fplus_fwd_flip_define_fn_1(none_by_parallelly)
+fplus_fwd_flip_define_fn_1(all_by_parallelly)
+fplus_fwd_flip_define_fn_1(find_first_idx_by_parallelly)
+fplus_fwd_flip_define_fn_1(find_first_by_parallelly)
 fplus_fwd_flip_define_fn_1(keep_if_parallelly)
+fplus_fwd_flip_define_fn_1(drop_if_parallelly)
+fplus_fwd_flip_define_fn_1(partition_parallelly)
+fplus_fwd_flip_define_fn_1(sort_by_parallelly)
+fplus_fwd_flip_define_fn_1(sort_on_parallelly)
+fplus_fwd_flip_define_fn_1(sort_parallelly_n_threads)
+fplus_fwd_flip_define_fn_1(stable_sort_by_parallelly)
+fplus_fwd_flip_define_fn_1(stable_sort_on_parallelly)
+fplus_fwd_flip_define_fn_1(stable_sort_parallelly_n_threads)
 fplus_fwd_flip_define_fn_1(show_cont_with)
 fplus_fwd_flip_define_fn_1(elem_at_idx_or_nothing)
 fplus_fwd_flip_define_fn_1(elem_at_idx_or_replicate)
@@ -16066,5 +21288,362 @@ fplus_fwd_flip_define_fn_1(parallel_for_each)
 fplus_fwd_flip_define_fn_1(trees_from_sequence)
 fplus_fwd_flip_define_fn_1(are_trees_equal)
 
+    // Lazy pipelines, fusing all element-wise stages into one loop.
+    // fwd::apply(numbers(0, 100),
+    //     fwd::lazy::transform(times_3),
+    //     fwd::lazy::drop_if(is_odd_int),
+    //     fwd::lazy::sum())
+    // A stage applied to a container (or to the result of another stage)
+    // does not process anything. It only returns a lazy_view
+    // remembering the source and the stages.
+    // A terminal (sum, product, fold_left, convert_container) then runs
+    // the source through all stages element by element,
+    // so no intermediate containers are allocated.
+    // A temporary source container is moved into the view,
+    // a named one is only referenced and thus must outlive the view.
+    namespace internal {
+        template <typename Source, typename... Stages>
+        class lazy_view;
+
+        template <typename T, typename... Stages>
+        struct lazy_output_type {
+            typedef T type;
+        };
+
+        template <typename T, typename Stage, typename... Stages>
+        struct lazy_output_type<T, Stage, Stages...>
+            : lazy_output_type<typename Stage::template output_t<T>, Stages...> {
+        };
+
+        template <typename Source, typename... Stages>
+        class lazy_view {
+        public:
+            typedef typename std::decay_t<Source>::value_type source_value_type;
+            typedef typename lazy_output_type<source_value_type, Stages...>::type value_type;
+
+            lazy_view(Source source, std::tuple<Stages...> stages)
+                : source_(std::forward<Source>(source))
+                , stages_(std::move(stages))
+            {
+            }
+
+            template <typename Stage>
+            lazy_view<Source, Stages..., Stage> append(const Stage& stage) const&
+            {
+                return { source_, std::tuple_cat(stages_, std::make_tuple(stage)) };
+            }
+
+            template <typename Stage>
+            lazy_view<Source, Stages..., Stage> append(const Stage& stage) &&
+            {
+                return { std::forward<Source>(source_),
+                    std::tuple_cat(std::move(stages_), std::make_tuple(stage)) };
+            }
+
+            // Feeds the elements through all stages into sink,
+            // until the source is exhausted or a stage or the sink returns false.
+            template <typename Sink>
+            void run(Sink sink) const
+            {
+                auto fused = wrap_stages<0>(std::move(sink),
+                    std::integral_constant<bool, sizeof...(Stages) == 0>());
+                for (const auto& x : source_) {
+                    if (!fused(x)) {
+                        return;
+                    }
+                }
+            }
+
+        private:
+            template <std::size_t Idx, typename Sink>
+            Sink wrap_stages(Sink sink, std::true_type) const
+            {
+                return sink;
+            }
+
+            template <std::size_t Idx, typename Sink>
+            auto wrap_stages(Sink sink, std::false_type) const
+            {
+                return std::get<Idx>(stages_).wrap(wrap_stages<Idx + 1>(std::move(sink),
+                    std::integral_constant<bool, Idx + 1 == sizeof...(Stages)>()));
+            }
+
+            Source source_;
+            std::tuple<Stages...> stages_;
+        };
+
+        template <typename T>
+        struct is_lazy_view : std::false_type {
+        };
+
+        template <typename Source, typename... Stages>
+        struct is_lazy_view<lazy_view<Source, Stages...>> : std::true_type {
+        };
+
+        template <typename View>
+        View&& as_lazy_view(View&& view, std::true_type)
+        {
+            return std::forward<View>(view);
+        }
+
+        template <typename Container>
+        lazy_view<const Container&> as_lazy_view(const Container& xs, std::false_type)
+        {
+            return { xs, std::tuple<>() };
+        }
+
+        template <typename Container,
+            typename = std::enable_if_t<!std::is_lvalue_reference<Container>::value>>
+        lazy_view<Container> as_lazy_view(Container&& xs, std::false_type)
+        {
+            return { std::move(xs), std::tuple<>() };
+        }
+
+        template <typename X>
+        decltype(auto) as_lazy_view(X&& x)
+        {
+            return as_lazy_view(std::forward<X>(x),
+                is_lazy_view<std::decay_t<X>>());
+        }
+
+        // Base of all stages, appending the stage to the view it is applied to.
+        template <typename Stage>
+        struct lazy_stage {
+            template <typename X>
+            auto operator()(X&& x) const
+            {
+                return as_lazy_view(std::forward<X>(x))
+                    .append(static_cast<const Stage&>(*this));
+            }
+        };
+
+        template <typename F>
+        struct lazy_transform_stage : lazy_stage<lazy_transform_stage<F>> {
+            explicit lazy_transform_stage(F f)
+                : f_(f)
+            {
+            }
+            template <typename T>
+            using output_t = std::decay_t<fplus::internal::invoke_result_t<F, T>>;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [f = f_, sink](auto&& x) mutable {
+                    return sink(fplus::internal::invoke(f, std::forward<decltype(x)>(x)));
+                };
+            }
+            F f_;
+        };
+
+        template <typename F>
+        struct lazy_transform_with_idx_stage : lazy_stage<lazy_transform_with_idx_stage<F>> {
+            explicit lazy_transform_with_idx_stage(F f)
+                : f_(f)
+            {
+            }
+            template <typename T>
+            using output_t = std::decay_t<fplus::internal::invoke_result_t<F, std::size_t, T>>;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [f = f_, sink, idx = std::size_t(0)](auto&& x) mutable {
+                    return sink(fplus::internal::invoke(f, idx++, std::forward<decltype(x)>(x)));
+                };
+            }
+            F f_;
+        };
+
+        template <typename Pred, bool Keep>
+        struct lazy_filter_stage : lazy_stage<lazy_filter_stage<Pred, Keep>> {
+            explicit lazy_filter_stage(Pred pred)
+                : pred_(pred)
+            {
+            }
+            template <typename T>
+            using output_t = T;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [pred = pred_, sink](auto&& x) mutable {
+                    if (static_cast<bool>(fplus::internal::invoke(pred, x)) != Keep) {
+                        return true;
+                    }
+                    return static_cast<bool>(sink(std::forward<decltype(x)>(x)));
+                };
+            }
+            Pred pred_;
+        };
+
+        struct lazy_take_stage : lazy_stage<lazy_take_stage> {
+            explicit lazy_take_stage(std::size_t n)
+                : n_(n)
+            {
+            }
+            template <typename T>
+            using output_t = T;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [n = n_, sink, taken = std::size_t(0)](auto&& x) mutable {
+                    if (taken == n) {
+                        return false;
+                    }
+                    ++taken;
+                    return sink(std::forward<decltype(x)>(x)) && taken < n;
+                };
+            }
+            std::size_t n_;
+        };
+
+        struct lazy_drop_stage : lazy_stage<lazy_drop_stage> {
+            explicit lazy_drop_stage(std::size_t n)
+                : n_(n)
+            {
+            }
+            template <typename T>
+            using output_t = T;
+            template <typename Sink>
+            auto wrap(Sink sink) const
+            {
+                return [n = n_, sink, dropped = std::size_t(0)](auto&& x) mutable {
+                    if (dropped < n) {
+                        ++dropped;
+                        return true;
+                    }
+                    return static_cast<bool>(sink(std::forward<decltype(x)>(x)));
+                };
+            }
+            std::size_t n_;
+        };
+
+        template <typename F, typename Acc>
+        struct lazy_fold_left_terminal {
+            template <typename X>
+            Acc operator()(X&& x) const
+            {
+                Acc acc = init_;
+                as_lazy_view(std::forward<X>(x)).run([this, &acc](auto&& y) {
+                    acc = fplus::internal::invoke(f_, std::move(acc), std::forward<decltype(y)>(y));
+                    return true;
+                });
+                return acc;
+            }
+            F f_;
+            Acc init_;
+        };
+
+        struct lazy_sum_terminal {
+            template <typename X>
+            auto operator()(X&& x) const
+            {
+                typedef typename std::decay_t<decltype(as_lazy_view(std::forward<X>(x)))>::value_type T;
+                T result = T();
+                as_lazy_view(std::forward<X>(x)).run([&result](const auto& y) {
+                    result = result + y;
+                    return true;
+                });
+                return result;
+            }
+        };
+
+        struct lazy_product_terminal {
+            template <typename X>
+            auto operator()(X&& x) const
+            {
+                typedef typename std::decay_t<decltype(as_lazy_view(std::forward<X>(x)))>::value_type T;
+                T result = T(1);
+                as_lazy_view(std::forward<X>(x)).run([&result](const auto& y) {
+                    result *= y;
+                    return true;
+                });
+                return result;
+            }
+        };
+
+        template <typename ContainerOut>
+        struct lazy_convert_container_terminal {
+            template <typename X>
+            ContainerOut operator()(X&& x) const
+            {
+                ContainerOut ys;
+                auto it = fplus::internal::get_back_inserter<ContainerOut>(ys);
+                as_lazy_view(std::forward<X>(x)).run([&it](auto&& y) {
+                    *it = std::forward<decltype(y)>(y);
+                    return true;
+                });
+                return ys;
+            }
+        };
+    } // namespace internal
+
+    namespace lazy {
+        // Lazy version of fwd::transform.
+        template <typename F>
+        auto transform(F f)
+        {
+            return internal::lazy_transform_stage<F>(f);
+        }
+
+        // Lazy version of fwd::transform_with_idx.
+        template <typename F>
+        auto transform_with_idx(F f)
+        {
+            return internal::lazy_transform_with_idx_stage<F>(f);
+        }
+
+        // Lazy version of fwd::keep_if.
+        template <typename Pred>
+        auto keep_if(Pred pred)
+        {
+            return internal::lazy_filter_stage<Pred, true>(pred);
+        }
+
+        // Lazy version of fwd::drop_if.
+        template <typename Pred>
+        auto drop_if(Pred pred)
+        {
+            return internal::lazy_filter_stage<Pred, false>(pred);
+        }
+
+        // Lazy version of fwd::take.
+        // Stops consuming the source after n elements.
+        inline auto take(std::size_t n)
+        {
+            return internal::lazy_take_stage(n);
+        }
+
+        // Lazy version of fwd::drop.
+        inline auto drop(std::size_t n)
+        {
+            return internal::lazy_drop_stage(n);
+        }
+
+        // Runs a lazy pipeline like fwd::fold_left.
+        template <typename F, typename Acc>
+        auto fold_left(F f, const Acc& init)
+        {
+            return internal::lazy_fold_left_terminal<F, Acc> { f, init };
+        }
+
+        // Runs a lazy pipeline like fwd::sum.
+        inline auto sum()
+        {
+            return internal::lazy_sum_terminal();
+        }
+
+        // Runs a lazy pipeline like fwd::product.
+        inline auto product()
+        {
+            return internal::lazy_product_terminal();
+        }
+
+        // Runs a lazy pipeline, collecting the results in a ContainerOut.
+        template <typename ContainerOut>
+        auto convert_container()
+        {
+            return internal::lazy_convert_container_terminal<ContainerOut>();
+        }
+    } // namespace lazy
+
 } // namespace fwd
 } // namespace fplus
@@ -650,6 +650,39 @@ TEST_CASE("container_common_test - nub")
     REQUIRE_EQ(nub_on(int_mod_10, IntVector({ 12, 32, 15 })), IntVector({ 12, 15 }));
 }
 
+TEST_CASE("container_common_test - hashed and non-hashed keys")
+{
+    using namespace fplus;
+    static_assert(internal::is_hashable<int>::value, "int must be hashable");
+    static_assert(!internal::is_hashable<IntPair>::value, "pair must not be hashable");
+    const IntList ys = { 5, 3, 5, 1, 3, 5 };
+    REQUIRE_EQ(nub(ys), IntList({ 5, 3, 1 }));
+    REQUIRE_EQ(nub(std::string("mississippi")), std::string("misp"));
+    REQUIRE_EQ(all_unique(std::string("abc")), true);
+    REQUIRE_EQ(all_unique(std::string("abca")), false);
+
+    const auto to_pair = [](int x) { return IntPair(x % 2, 0); };
+    REQUIRE_EQ(nub_on(to_pair, ys), nub_on(is_even_int, ys));
+    REQUIRE_EQ(nub_on(to_pair, IntVector({ 12, 33, 15 })), IntVector({ 12, 33 }));
+    REQUIRE_EQ(all_unique_on(to_pair, IntVector({ 12, 33 })), true);
+    REQUIRE_EQ(all_unique_on(to_pair, IntVector({ 12, 33, 15 })), false);
+    REQUIRE_EQ(nub(IntPairs({ { 1, 2 }, { 1, 2 }, { 2, 1 } })), IntPairs({ { 1, 2 }, { 2, 1 } }));
+
+    const IntVector zs = { 4, 11, 24, 7, 14, 1 };
+    REQUIRE_EQ(group_globally(IntVector({ 3, 1, 3, 2, 1 })),
+        IntVectors({ IntVector({ 3, 3 }), IntVector({ 1, 1 }), IntVector({ 2 }) }));
+    const auto mod_10_pair = [](int x) { return IntPair(x % 10, 0); };
+    REQUIRE_EQ(group_globally_on(int_mod_10, zs), group_globally_on(mod_10_pair, zs));
+    REQUIRE_EQ(group_globally_on(int_mod_10, zs),
+        IntVectors({ IntVector({ 4, 24, 14 }), IntVector({ 11, 1 }), IntVector({ 7 }) }));
+    typedef std::vector<std::pair<int, IntVector>> LabeledGroups;
+    REQUIRE_EQ(group_globally_on_labeled(int_mod_10, zs),
+        LabeledGroups({ { 4, IntVector({ 4, 24, 14 }) }, { 1, IntVector({ 11, 1 }) }, { 7, IntVector({ 7 }) } }));
+    typedef std::vector<std::pair<IntPair, IntVector>> PairLabeledGroups;
+    REQUIRE_EQ(group_globally_on_labeled(to_pair, IntVector({ 4, 11, 24 })),
+        PairLabeledGroups({ { IntPair(0, 0), IntVector({ 4, 24 }) }, { IntPair(1, 0), IntVector({ 11 }) } }));
+}
+
 TEST_CASE("container_common_test - coucount_occurrences_bynt_occurrences_on")
 {
     using namespace fplus;
@@ -727,6 +760,37 @@ TEST_CASE("container_common_test - stride")
     REQUIRE_EQ(divvy(1, 3, IntVector({ 0, 1, 2, 3, 4, 5, 6, 7 })), IntVectors({ { 0 }, { 3 }, { 6 } }));
 }
 
+TEST_CASE("container_common_test - window views")
+{
+    using namespace fplus;
+    const auto to_vectors = [](const auto& windows) {
+        return transform([](const auto& w) { return IntVector(std::begin(w), std::end(w)); }, windows);
+    };
+    const IntVector xs = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    const IntVector empty;
+    for (std::size_t n = 1; n < 12; ++n) {
+        REQUIRE_EQ(to_vectors(aperture_view(n, xs)), n > xs.size() ? IntVectors() : aperture(n, xs));
+        REQUIRE_EQ(to_vectors(split_every_view(n, xs)), split_every(n, xs));
+        REQUIRE_EQ(to_vectors(split_evenly_view(n, xs)), split_evenly(n, xs));
+        REQUIRE_EQ(convert_container<IntVector>(stride_view(n, xs)), stride(n, xs));
+        for (std::size_t step = 1; step < 4 && n <= xs.size(); ++step) {
+            REQUIRE_EQ(to_vectors(divvy_view(n, step, xs)), divvy(n, step, xs));
+        }
+    }
+    REQUIRE(aperture_view(3, empty).empty());
+    REQUIRE_EQ(to_vectors(split_every_view(3, empty)), split_every(3, empty));
+    REQUIRE_EQ(to_vectors(split_evenly_view(3, empty)), split_evenly(3, empty));
+    REQUIRE(stride_view(3, empty).empty());
+
+    const auto windows = aperture_view(3, xs);
+    REQUIRE_EQ(windows.size(), 8);
+    REQUIRE_EQ(&*windows[2].begin(), &xs[2]);
+    REQUIRE_EQ(windows[2][1], 3);
+    REQUIRE_EQ(transform(sum<IntVector>, to_vectors(windows)), transform([](const auto& w) { return sum(w); }, windows));
+    const IntList ys = { 0, 1, 2, 3, 4 };
+    REQUIRE_EQ(to_vectors(divvy_view(2, 3, ys)), IntVectors({ { 0, 1 }, { 3, 4 } }));
+}
+
 TEST_CASE("composition_test - instead_of_if_empty")
 {
     using namespace fplus;
@@ -6,6 +6,7 @@
 
 #include <doctest/doctest.h>
 #include <fplus/fplus.hpp>
+#include <list>
 #include <vector>
 
 namespace {
@@ -108,6 +109,9 @@ TEST_CASE("container_properties_test - mean")
     REQUIRE(is_in_interval(3.49, 3.51, mean<double>(DoubleVector({ 3, 4 }))));
     REQUIRE_EQ(median(IntVector({ 3, 9, 5 })), 5);
     REQUIRE_EQ(median(xs), 2);
+    REQUIRE_EQ(median(std::list<int>({ 4, 1, 3, 2 })), 2);
+    REQUIRE(is_in_interval(2.49, 2.51, median<std::list<int>, double>(std::list<int>({ 4, 1, 3, 2 }))));
+    REQUIRE_EQ(median(IntVector({ 5, 6, 4, 3, 2, 6, 7, 9, 3 })), 5);
     REQUIRE_EQ(sum(convert_container_and_elems<std::vector<int>>(std::string("hello"))), 532);
     REQUIRE(is_in_interval(5.99, 6.01, mean_stddev<double>(DoubleVector({ 4, 8 })).first));
     REQUIRE(is_in_interval(1.99, 2.01, mean_stddev<double>(DoubleVector({ 4, 8 })).second));
@@ -115,6 +119,74 @@ TEST_CASE("container_properties_test - mean")
     REQUIRE(is_in_interval(2.16f, 2.17f, mean_stddev<float>(IntVector({ 1, 3, 7, 4 })).second));
 }
 
+TEST_CASE("container_properties_test - quantiles")
+{
+    using namespace fplus;
+    typedef std::vector<double> DoubleVector;
+    REQUIRE_EQ(quantiles(DoubleVector({ 0, 0.5, 1 }), IntVector({ 1, 3, 2, 4, 5 })), IntVector({ 1, 3, 5 }));
+    REQUIRE_EQ(quantiles(DoubleVector({ 0.9, 0.1 }), IntVector({ 1, 3, 2, 4, 5 })), IntVector({ 5, 1 }));
+    REQUIRE_EQ(quantiles(DoubleVector({ -1, 2 }), IntVector({ 7 })), IntVector({ 7, 7 }));
+    REQUIRE_EQ(quantiles(DoubleVector(), IntVector({ 7 })), IntVector());
+    const auto qs = quantiles(DoubleVector({ 0.9, 0.25, 0.5 }), DoubleVector({ 1, 3, 2, 4, 5 }));
+    REQUIRE(is_in_interval(4.59, 4.61, qs[0]));
+    REQUIRE(is_in_interval(1.99, 2.01, qs[1]));
+    REQUIRE(is_in_interval(2.99, 3.01, qs[2]));
+
+    // Compare with sorting for many fractions on a larger input.
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back((i * 7919) % 1009);
+    const auto sorted = sort(values);
+    DoubleVector ps;
+    for (int i = 0; i <= 100; ++i)
+        ps.push_back(i / 100.0);
+    const auto result = quantiles(ps, std::list<int>(std::begin(values), std::end(values)));
+    for (std::size_t i = 0; i < ps.size(); ++i) {
+        const double position = ps[i] * 999.0;
+        const auto lower = static_cast<std::size_t>(position);
+        const auto upper = std::min<std::size_t>(lower + 1, 999);
+        const double expected = sorted[lower] + (position - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+        REQUIRE(std::abs(result[i] - expected) <= 0.5);
+    }
+}
+
+TEST_CASE("container_properties_test - running_stats")
+{
+    using namespace fplus;
+    REQUIRE(is_in_interval(2.16, 2.17, mean_stddev<double>(std::list<int>({ 1, 3, 7, 4 })).second));
+
+    // Welford's update stays exact where the naive sum of squares
+    // loses all precision due to the large offset.
+    const std::vector<double> offset_values = { 1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16 };
+    const auto offset_stats = get_running_stats(offset_values);
+    REQUIRE_EQ(offset_stats.count(), 4);
+    REQUIRE_EQ(offset_stats.mean(), 1e9 + 10);
+    REQUIRE_EQ(offset_stats.variance(), 22.5);
+    REQUIRE_EQ(offset_stats.sample_variance(), 30.0);
+    REQUIRE_EQ(offset_stats.minimum(), 1e9 + 4);
+    REQUIRE_EQ(offset_stats.maximum(), 1e9 + 16);
+
+    const std::vector<int> values = { 5, -3, 8, 1, 9, 2, 2, 7, -6 };
+    const auto all_stats = get_running_stats(values);
+    running_stats<double> merged;
+    merged.merge(running_stats<double>());
+    for (const auto& part : split_every(4, values)) {
+        merged.merge(get_running_stats(part));
+    }
+    merged.merge(running_stats<double>());
+    REQUIRE_EQ(merged.count(), all_stats.count());
+    REQUIRE(is_in_interval(all_stats.mean() - 1e-12, all_stats.mean() + 1e-12, merged.mean()));
+    REQUIRE(is_in_interval(all_stats.variance() - 1e-12, all_stats.variance() + 1e-12, merged.variance()));
+    REQUIRE_EQ(merged.minimum(), -6.0);
+    REQUIRE_EQ(merged.maximum(), 9.0);
+    REQUIRE(is_in_interval(2.77f, 2.78f, get_running_stats<float>(values).mean()));
+
+    running_stats<double> single;
+    single.add(3);
+    REQUIRE_EQ(single.mean(), 3.0);
+    REQUIRE_EQ(single.stddev(), 0.0);
+}
+
 TEST_CASE("container_properties_test - all_unique_less")
 {
     using namespace fplus;
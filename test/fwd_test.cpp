@@ -222,3 +222,46 @@ TEST_CASE("fwd_test - append")
 
     REQUIRE_EQ(fwd::append(xs)(ys), xs_append_ys);
 }
+
+TEST_CASE("fwd_test - lazy")
+{
+    using namespace fplus;
+
+    const auto result_eager = fwd::apply(
+        numbers(0, 1000), fwd::transform(times_3), fwd::drop_if(is_odd_int), fwd::transform(as_string_length), fwd::sum());
+    const auto result_lazy = fwd::apply(
+        numbers(0, 1000), fwd::lazy::transform(times_3), fwd::lazy::drop_if(is_odd_int), fwd::lazy::transform(as_string_length), fwd::lazy::sum());
+    REQUIRE_EQ(result_lazy, result_eager);
+
+    const IntVector xs = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::keep_if(is_even_int), fwd::lazy::convert_container<IntVector>()), IntVector({ 2, 4, 6, 8 }));
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::drop(2), fwd::lazy::take(3), fwd::lazy::convert_container<std::list<int>>()), std::list<int>({ 3, 4, 5 }));
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::take(0), fwd::lazy::sum()), 0);
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::drop(20), fwd::lazy::product()), 1);
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::take(4), fwd::lazy::product()), 24);
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::transform_with_idx([](std::size_t idx, int x) { return static_cast<int>(idx) * x; }), fwd::lazy::convert_container<IntVector>()),
+        IntVector({ 0, 2, 6, 12, 20, 30, 42, 56 }));
+    REQUIRE_EQ(fwd::apply(xs, fwd::lazy::transform([](int x) { return std::to_string(x); }), fwd::lazy::fold_left(append<std::string>, std::string())),
+        "12345678");
+    REQUIRE_EQ(fwd::lazy::sum()(xs), 36);
+
+    const auto pipeline = fwd::compose(
+        fwd::lazy::transform(times_3_lambda),
+        fwd::lazy::keep_if(is_odd_int_lambda),
+        fwd::lazy::take(2),
+        fwd::lazy::convert_container<IntVector>());
+    REQUIRE_EQ(pipeline(xs), IntVector({ 3, 9 }));
+    REQUIRE_EQ(pipeline(IntVector({ 1 })), IntVector({ 3 }));
+
+    std::size_t evaluations = 0;
+    const auto counting_times_3 = [&evaluations](int x) {
+        ++evaluations;
+        return 3 * x;
+    };
+    REQUIRE_EQ(fwd::apply(numbers(0, 1000), fwd::lazy::transform(counting_times_3), fwd::lazy::take(5), fwd::lazy::sum()), 30);
+    REQUIRE_EQ(evaluations, 5);
+
+    const auto view = fwd::lazy::transform(times_3)(xs);
+    REQUIRE_EQ(fwd::lazy::sum()(view), 108);
+    REQUIRE_EQ(fwd::apply(view, fwd::lazy::drop(7), fwd::lazy::convert_container<IntVector>()), IntVector({ 24 }));
+}
@@ -70,6 +70,17 @@ TEST_CASE("generate_test - infixes_with_size_less_than_length")
     REQUIRE(result.empty());
 }
 
+TEST_CASE("generate_test - infixes_view")
+{
+    const std::vector<int> v = { 1, 2, 3, 4, 5, 6 };
+    const auto result = fplus::infixes_view(3, v);
+    REQUIRE_EQ(4u, result.size());
+    REQUIRE_EQ(std::vector<int>(result[1].begin(), result[1].end()), std::vector<int>({ 2, 3, 4 }));
+    REQUIRE_EQ(result[3].begin(), v.begin() + 3);
+    const std::vector<int> short_v = { 1, 2 };
+    REQUIRE(fplus::infixes_view(3, short_v).empty());
+}
+
 TEST_CASE("generate_test - carthesian_product_with_where")
 {
     const std::vector<char> v1 = { 'A', 'B', 'C' };
@@ -374,3 +385,37 @@ TEST_CASE("generate_test - numbers")
     REQUIRE_EQ(fplus::numbers<int>(2, 5), ints({ 2, 3, 4 }));
     REQUIRE_EQ(fplus::numbers_step<int>(0, 6, 2), ints({ 0, 2, 4 }));
 }
+
+TEST_CASE("generate_test - lazy ranges")
+{
+    using namespace fplus;
+    typedef std::vector<int> ints;
+    const auto as_ints = [](const auto& xs) { return convert_container<ints>(xs); };
+
+    REQUIRE_EQ(as_ints(numbers_lazy(2, 9)), numbers(2, 9));
+    REQUIRE_EQ(as_ints(numbers_lazy(5, 2)), ints());
+    REQUIRE_EQ(as_ints(numbers_step_lazy(2, 9, 2)), numbers_step(2, 9, 2));
+    REQUIRE_EQ(as_ints(numbers_step_lazy(0, 6, 2)), ints({ 0, 2, 4 }));
+    REQUIRE_EQ(as_ints(numbers_step_lazy(0, 6, -1)), ints());
+    REQUIRE_EQ(convert_container<std::vector<double>>(numbers_step_lazy(0.0, 1.0, 0.25)), std::vector<double>({ 0.0, 0.25, 0.5, 0.75 }));
+    REQUIRE_EQ(as_ints(repeat_lazy(3, ints({ 1, 2 }))), repeat(3, ints({ 1, 2 })));
+    REQUIRE_EQ(as_ints(repeat_lazy(3, std::list<int>())), ints());
+    REQUIRE_EQ(as_ints(iterate_lazy([](int x) { return 2 * x; }, 5, 3)), ints({ 3, 6, 12, 24, 48 }));
+    REQUIRE_EQ(as_ints(iterate_lazy([](int x) { return 2 * x; }, 0, 3)), ints());
+    const auto plus_10 = [](std::size_t i) { return static_cast<int>(i) + 10; };
+    REQUIRE_EQ(as_ints(generate_by_idx_lazy(plus_10, 4)), ints({ 10, 11, 12, 13 }));
+
+    // Reading functions accept lazy ranges directly.
+    const auto xs = numbers_lazy<std::int64_t>(0, 15000000);
+    REQUIRE_EQ(size_of_cont(xs), 15000000);
+    REQUIRE_EQ(sum(xs), std::int64_t(112499992500000));
+    REQUIRE_EQ(elem_at_idx(7, xs), 7);
+    REQUIRE_EQ(maximum(numbers_lazy(3, 8)), 7);
+    REQUIRE_EQ(transform(plus_10, numbers_lazy<std::size_t>(0, 3)), ints({ 10, 11, 12 }));
+    REQUIRE_EQ(transform_parallelly(plus_10, numbers_lazy<std::size_t>(0, 3)), ints({ 10, 11, 12 }));
+    REQUIRE_EQ(transform_parallelly_n_threads(2, [](int x) { return x + 1; }, iterate_lazy([](int x) { return 2 * x; }, 4, 1)), ints({ 2, 3, 5, 9 }));
+    REQUIRE_EQ(fold_left(std::plus<int>(), 0, repeat_lazy(1000, ints({ 1, 2 }))), 3000);
+    REQUIRE_EQ(find_first_by([](int x) { return x > 100; }, iterate_lazy([](int x) { return 3 * x; }, 10, 1)), just(243));
+    REQUIRE(all_by([](int x) { return x >= 10; }, generate_by_idx_lazy(plus_10, 100)));
+    REQUIRE_EQ(fwd::apply(numbers_lazy(0, 1000), fwd::lazy::keep_if([](int x) { return x % 3 == 0; }), fwd::lazy::sum()), 166833);
+}
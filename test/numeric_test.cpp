@@ -6,6 +6,7 @@
 
 #include <doctest/doctest.h>
 #include <fplus/fplus.hpp>
+#include <list>
 #include <vector>
 
 namespace {
@@ -499,7 +500,14 @@ TEST_CASE("numeric_test - winsorize")
     REQUIRE_EQ(winsorize(0.34, Doubles({ 1, 2, 3 })), Doubles({ 2, 2, 2 }));
     REQUIRE_EQ(winsorize(0.1, Doubles({ 1, 3, 4, 4, 4, 4, 4, 4, 6, 8 })), Doubles({ 3, 3, 4, 4, 4, 4, 4, 4, 6, 6 }));
     REQUIRE_EQ(winsorize(-0.1, Doubles({ 1, 3, 4, 4, 4, 4, 4, 4, 6, 8 })), Doubles({ 1, 3, 4, 4, 4, 4, 4, 4, 6, 8 }));
-    REQUIRE_EQ(winsorize(0.1, Doubles({ 4, 4, 4, 3, 8, 4, 6, 4, 3, 4 })), Doubles({ 3, 3, 4, 4, 4, 4, 4, 4, 6, 6 }));
+    REQUIRE_EQ(winsorize(0.1, Doubles({ 4, 4, 4, 3, 8, 4, 6, 4, 3, 4 })), Doubles({ 4, 4, 4, 3, 6, 4, 6, 4, 3, 4 }));
+    REQUIRE_EQ(winsorize(0.2, std::list<int>({ 9, 1, 5, 2, 7, 3, 8, 4, 6, 0 })), std::list<int>({ 7, 2, 5, 2, 7, 3, 7, 4, 6, 2 }));
+
+    Doubles values = { 8, 1, 4, 4, 4, 3, 4, 4, 6, 4 };
+    const double* const values_data = values.data();
+    const auto clamped = winsorize(0.1, std::move(values));
+    REQUIRE_EQ(clamped, Doubles({ 6, 3, 4, 4, 4, 3, 4, 4, 6, 4 }));
+    REQUIRE_EQ(clamped.data(), values_data);
     REQUIRE_EQ(winsorize(0, Doubles({ 1, 3, 4, 4, 4, 4, 4, 4, 6, 8 })), Doubles({ 1, 3, 4, 4, 4, 4, 4, 4, 6, 8 }));
 
     const auto median_result = winsorize(0.6, Doubles({ 1, 2 }));
@@ -39,3 +39,52 @@ TEST_CASE("read_test - read_value_result")
     REQUIRE(is_error(read_value_result<int>("twenty")));
     REQUIRE(is_error(read_value_result<int>("3 thousand")));
 }
+
+TEST_CASE("read_test - read_value_result fast path")
+{
+    using namespace fplus;
+    REQUIRE_EQ(read_value_result<int>("2147483647"), (ok<int, std::string>(2147483647)));
+    REQUIRE_EQ(read_value_result<int>("-2147483648"), (ok<int, std::string>(-2147483647 - 1)));
+    REQUIRE(is_error(read_value_result<int>("2147483648")));
+    REQUIRE(is_error(read_value_result<int>("-2147483649")));
+    REQUIRE_EQ(read_value_result<long long>("-9223372036854775808"),
+        (ok<long long, std::string>(-9223372036854775807LL - 1)));
+    REQUIRE_EQ(read_value_result<unsigned long long>("18446744073709551615"),
+        (ok<unsigned long long, std::string>(18446744073709551615ULL)));
+    REQUIRE(is_error(read_value_result<unsigned long long>("18446744073709551616")));
+    REQUIRE(is_error(read_value_result<int>("")));
+    REQUIRE(is_error(read_value_result<int>("-")));
+    REQUIRE(is_error(read_value_result<int>("4-2")));
+
+    // Inputs accepted by the standard functions only still work.
+    REQUIRE_EQ(read_value_result<int>("+5"), (ok<int, std::string>(5)));
+    REQUIRE_EQ(read_value_result<int>(" 7"), (ok<int, std::string>(7)));
+    REQUIRE_EQ(read_value_result<double>("0x10"), (ok<double, std::string>(16.0)));
+
+    REQUIRE_EQ(read_value_result<double>("-42.25"), (ok<double, std::string>(-42.25)));
+    REQUIRE_EQ(read_value_result<double>("1e3"), (ok<double, std::string>(1000.0)));
+    REQUIRE_EQ(read_value_result<float>("0.5"), (ok<float, std::string>(0.5f)));
+    REQUIRE(is_error(read_value_result<double>("1.5.")));
+
+    // Subnormal and out-of-range values are rejected like by std::stod.
+    REQUIRE(is_error(read_value_result<double>("1e-310")));
+    REQUIRE(is_error(read_value_result<float>("1e-40")));
+    REQUIRE(is_error(read_value_result<double>("1e-400")));
+    REQUIRE(is_error(read_value_result<double>("1e400")));
+}
+
+TEST_CASE("read_test - read_values")
+{
+    using namespace fplus;
+    typedef std::vector<int> IntVector;
+    typedef std::vector<double> DoubleVector;
+    REQUIRE_EQ(read_values<int>(',', "1,-2,3"), (ok<IntVector, std::string>({ 1, -2, 3 })));
+    REQUIRE_EQ(read_values<int>('\n', "1\n2\n"), (ok<IntVector, std::string>({ 1, 2 })));
+    REQUIRE_EQ(read_values<int>(',', ""), (ok<IntVector, std::string>({})));
+    REQUIRE_EQ(read_values<int>(',', "1, 2,+3"), (ok<IntVector, std::string>({ 1, 2, 3 })));
+    REQUIRE_EQ(read_values<double>(';', "0.5;1e1"), (ok<DoubleVector, std::string>({ 0.5, 10.0 })));
+    const auto failed = read_values<int>(',', "1,x,3");
+    REQUIRE(is_error(failed));
+    REQUIRE(is_prefix_of(std::string("Field 1: "), unsafe_get_error(failed)));
+    REQUIRE(is_error(read_values<int>(',', "1,,3")));
+}
@@ -48,3 +48,31 @@ TEST_CASE("replace_test - replace_tokens")
     auto result = fplus::replace_tokens(source, dest, input);
     REQUIRE_EQ(result, std::string("oh, hihiha!"));
 }
+
+TEST_CASE("replace_test - replace_tokens_many")
+{
+    typedef std::vector<std::string> strings;
+    REQUIRE_EQ(fplus::replace_tokens_many(strings({ "haha", "h" }), strings({ "hihi", "H" }), std::string("oh, hahaha!")),
+        std::string("oH, hihiHa!"));
+    REQUIRE_EQ(fplus::replace_tokens_many(strings({ "he", "she", "his", "hers" }), strings({ "1", "2", "3", "4" }), std::string("ushers and his")),
+        std::string("u2rs and 3"));
+    REQUIRE_EQ(fplus::replace_tokens_many(strings({ "", "b" }), strings({ "x", "" }), std::string("abcb")), std::string("ac"));
+    REQUIRE_EQ(fplus::replace_tokens_many(strings(), strings(), std::string("abc")), std::string("abc"));
+    for (const auto& source : strings({ "a", "ab", "aa", "aba", "abab" })) {
+        for (const auto& input : strings({ "", "a", "aaaa", "abababa", "xabaabx" })) {
+            REQUIRE_EQ(fplus::replace_tokens_many(strings({ source }), strings({ "<>" }), input),
+                fplus::replace_tokens(source, std::string("<>"), input));
+        }
+    }
+
+    const auto secrets = fplus::compile_tokens(strings({ "password", "pass", "token" }));
+    const strings redacted(3, "***");
+    REQUIRE_EQ(fplus::replace_tokens_many(secrets, redacted, std::string("token=abc password=x pass=y")),
+        std::string("***=abc ***=x ***=y"));
+    REQUIRE_EQ(fplus::fwd::apply(std::string("a token"), fplus::fwd::replace_tokens_many(secrets, redacted)),
+        std::string("a ***"));
+
+    typedef std::vector<int> ints;
+    REQUIRE_EQ(fplus::replace_tokens_many(std::vector<ints>({ { 1, 2 }, { 2, 3, 4 } }), std::vector<ints>({ { 0 }, { 9, 9 } }), ints({ 1, 2, 3, 4, 2, 3, 4 })),
+        ints({ 0, 3, 4, 9, 9 }));
+}
@@ -6,6 +6,7 @@
 
 #include <doctest/doctest.h>
 #include <fplus/fplus.hpp>
+#include <stdexcept>
 #include <vector>
 
 namespace {
@@ -41,6 +42,27 @@ private:
     int x_;
 };
 
+// Copying throws while throw_on_copy is set.
+struct throwing_copy {
+    explicit throwing_copy(int x)
+        : x_(x)
+    {
+    }
+    throwing_copy(const throwing_copy& other)
+        : x_(other.x_)
+    {
+        if (throw_on_copy)
+            throw std::runtime_error("copy failed");
+    }
+    throwing_copy(throwing_copy&&) noexcept = default;
+    throwing_copy& operator=(const throwing_copy&) = default;
+    throwing_copy& operator=(throwing_copy&&) noexcept = default;
+    bool operator==(const throwing_copy& other) const { return x_ == other.x_; }
+    static bool throw_on_copy;
+    int x_;
+};
+bool throwing_copy::throw_on_copy = false;
+
 TEST_CASE("result_test - ok_with_default")
 {
     using namespace fplus;
@@ -232,3 +254,57 @@ TEST_CASE("result_test - copy")
     result_int_string_error_copy_2 = result_int_string_error_copy;
     REQUIRE_EQ(result_int_string_error_copy_2, (error<int, std::string>("error")));
 }
+
+TEST_CASE("result_test - move")
+{
+    using namespace fplus;
+    result<std::string, std::string> result_ok = ok<std::string, std::string>("value");
+    result<std::string, std::string> result_moved(std::move(result_ok));
+    REQUIRE_EQ(result_moved, (ok<std::string, std::string>("value")));
+
+    result<std::string, std::string> result_error = error<std::string, std::string>("error");
+    result_moved = std::move(result_error);
+    REQUIRE_EQ(result_moved, (error<std::string, std::string>("error")));
+    result_moved = result_moved;
+    REQUIRE_EQ(result_moved, (error<std::string, std::string>("error")));
+
+    std::vector<result<std::vector<int>, std::string>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(i % 3 == 0 ? error<std::vector<int>, std::string>("no")
+                                     : ok<std::vector<int>, std::string>({ i, i }));
+    }
+    REQUIRE_EQ(oks(results).size(), 66);
+}
+
+TEST_CASE("result_test - trivially_copyable")
+{
+    using namespace fplus;
+    static_assert(std::is_trivially_copyable<result<int, double>>::value,
+        "result of trivially copyable types must be trivially copyable");
+    static_assert(!std::is_trivially_copyable<result<int, std::string>>::value,
+        "result of non-trivial types must not be trivially copyable");
+    REQUIRE_EQ((ok<int, double>(3)), (ok<int, double>(3)));
+    REQUIRE_EQ((error<int, double>(1.5)), (error<int, double>(1.5)));
+    REQUIRE_FALSE((ok<int, int>(1) == error<int, int>(1)));
+}
+
+TEST_CASE("result_test - throwing_copy")
+{
+    using namespace fplus;
+    using res = result<throwing_copy, std::string>;
+    const res source_ok = ok<throwing_copy, std::string>(throwing_copy(1));
+    res r = error<throwing_copy, std::string>("error");
+    throwing_copy::throw_on_copy = true;
+    REQUIRE_THROWS(r = source_ok);
+    throwing_copy::throw_on_copy = false;
+    REQUIRE_EQ(r, (error<throwing_copy, std::string>("error")));
+
+    r = ok<throwing_copy, std::string>(throwing_copy(2));
+    throwing_copy::throw_on_copy = true;
+    REQUIRE_THROWS(r = source_ok);
+    throwing_copy::throw_on_copy = false;
+    REQUIRE_EQ(r, (ok<throwing_copy, std::string>(throwing_copy(2))));
+
+    r = source_ok;
+    REQUIRE_EQ(r, source_ok);
+}
@@ -6,6 +6,8 @@
 
 #include <doctest/doctest.h>
 #include <fplus/fplus.hpp>
+#include <list>
+#include <random>
 #include <vector>
 
 namespace {
@@ -182,3 +184,125 @@ TEST_CASE("search_test - find_first_instance_of_token_oversized_token")
     auto result = fplus::find_first_instance_of_token(token, input);
     REQUIRE_EQ(result, fplus::nothing<size_t>());
 }
+
+namespace {
+template <typename Container>
+std::vector<std::size_t> find_all_instances_of_token_reference(
+    const Container& token, const Container& xs)
+{
+    std::vector<std::size_t> result;
+    const auto ys = fplus::convert_container<std::vector<typename Container::value_type>>(xs);
+    const auto ts = fplus::convert_container<std::vector<typename Container::value_type>>(token);
+    for (std::size_t idx = 0; idx + ts.size() <= ys.size(); ++idx) {
+        if (std::equal(std::begin(ts), std::end(ts), std::begin(ys) + static_cast<std::ptrdiff_t>(idx)))
+            result.push_back(idx);
+    }
+    return result;
+}
+
+// Compares all token search strategies with the reference implementation
+// for all tokens up to a length of 6 over a two-element alphabet
+// on random inputs over a three-element alphabet.
+template <typename Container, typename F>
+void check_token_search(F make_elem)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, 2);
+    std::vector<Container> inputs;
+    for (std::size_t n = 0; n < 40; ++n) {
+        Container xs;
+        for (std::size_t i = 0; i < n; ++i)
+            *fplus::internal::get_back_inserter(xs) = make_elem(dis(gen));
+        inputs.push_back(xs);
+    }
+    inputs.push_back(fplus::convert_container<Container>(
+        std::vector<typename Container::value_type>(30, make_elem(0))));
+    for (int token_size = 0; token_size <= 6; ++token_size) {
+        for (int bits = 0; bits < (1 << token_size); ++bits) {
+            Container token;
+            for (int i = 0; i < token_size; ++i)
+                *fplus::internal::get_back_inserter(token) = make_elem((bits >> i) & 1);
+            const auto compiled = fplus::compile_token(token);
+            for (const auto& xs : inputs) {
+                const auto expected = find_all_instances_of_token_reference(token, xs);
+                REQUIRE_EQ(fplus::find_all_instances_of_token(token, xs), expected);
+                REQUIRE_EQ(fplus::find_all_instances_of_token(compiled, xs), expected);
+                REQUIRE_EQ(fplus::find_first_instance_of_token(compiled, xs),
+                    expected.empty() ? fplus::nothing<std::size_t>() : fplus::just(expected.front()));
+            }
+        }
+    }
+}
+}
+
+TEST_CASE("search_test - token search strategies")
+{
+    typedef fplus::internal::token_search_strategy strategy;
+    using fplus::internal::token_search_engine;
+    REQUIRE(token_search_engine<char>({}).strategy() == strategy::empty);
+    REQUIRE(token_search_engine<char>({ 'a', 'b' }).strategy() == strategy::byte_scan);
+    REQUIRE(token_search_engine<char>({ 'a', 'b', 'c', 'd' }).strategy() == strategy::byte_horspool);
+    REQUIRE(token_search_engine<int>({ 1, 2 }).strategy() == strategy::two_way);
+    REQUIRE(token_search_engine<std::string>({ "a", "b" }).strategy() == strategy::hashed_horspool);
+    REQUIRE(token_search_engine<std::pair<int, int>>({ { 1, 2 } }).strategy() == strategy::naive);
+
+    check_token_search<std::string>([](int x) { return static_cast<char>('a' + x); });
+    check_token_search<std::vector<unsigned char>>([](int x) { return static_cast<unsigned char>(200 + x); });
+    check_token_search<std::vector<int>>([](int x) { return x - 1; });
+    check_token_search<std::vector<std::string>>([](int x) { return std::string(1, static_cast<char>('a' + x)); });
+    check_token_search<std::vector<std::pair<int, int>>>([](int x) { return std::make_pair(x, 0); });
+    check_token_search<std::list<char>>([](int x) { return static_cast<char>('a' + x); });
+}
+
+TEST_CASE("search_test - compiled token")
+{
+    const auto token = fplus::compile_token(std::string("haha"));
+    REQUIRE_EQ(token.token(), std::string("haha"));
+    REQUIRE_EQ(fplus::find_all_instances_of_token(token, std::string("oh, hahaha!")), std::vector<std::size_t>({ 4, 6 }));
+    REQUIRE_EQ(fplus::find_all_instances_of_token_non_overlapping(token, std::string("oh, hahaha!")), std::vector<std::size_t>({ 4 }));
+    REQUIRE_EQ(fplus::find_all_instances_of_token_non_overlapping(token, std::string("hahahahaha")), std::vector<std::size_t>({ 0, 4 }));
+    REQUIRE_EQ(fplus::find_first_instance_of_token(token, std::string("ha, haha")), fplus::just<std::size_t>(4));
+    REQUIRE_EQ(fplus::fwd::apply(std::string("hahaha"), fplus::fwd::find_all_instances_of_token(token)), std::vector<std::size_t>({ 0, 2 }));
+    const std::vector<std::size_t> every_idx = { 0, 1, 2 };
+    REQUIRE_EQ(fplus::find_all_instances_of_token(std::string(), std::string("ab")), every_idx);
+}
+
+TEST_CASE("search_test - find_all_instances_of_tokens")
+{
+    typedef std::vector<std::pair<std::size_t, std::size_t>> IdxPairs;
+    typedef std::vector<std::string> strings;
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(strings({ "haha", "ah" }), std::string("oh, hahaha!")),
+        IdxPairs({ { 4, 0 }, { 5, 1 }, { 6, 0 }, { 7, 1 } }));
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(strings({ "he", "she", "his", "hers", "", "he" }), std::string("ushers")),
+        IdxPairs({ { 1, 1 }, { 2, 0 }, { 2, 3 } }));
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(strings(), std::string("abc")), IdxPairs());
+
+    const auto tokens = fplus::compile_tokens(std::vector<std::vector<int>>({ { 1, 1 }, { 1 }, { 2, 1 } }));
+    REQUIRE_EQ(tokens.size(), 3);
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(tokens, std::vector<int>({ 2, 1, 1, 3 })),
+        IdxPairs({ { 0, 2 }, { 1, 0 }, { 1, 1 }, { 2, 1 } }));
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(tokens, std::vector<int>()), IdxPairs());
+
+    // All tokens over a two-element alphabet up to a length of 4,
+    // compared with searching every token on its own.
+    strings all_tokens;
+    for (int token_size = 1; token_size <= 4; ++token_size) {
+        for (int bits = 0; bits < (1 << token_size); ++bits) {
+            std::string token;
+            for (int i = 0; i < token_size; ++i)
+                token.push_back(static_cast<char>('a' + ((bits >> i) & 1)));
+            all_tokens.push_back(token);
+        }
+    }
+    const std::string input = "abaababbbaabaaaab";
+    IdxPairs expected;
+    for (std::size_t token_idx = 0; token_idx < all_tokens.size(); ++token_idx) {
+        for (const auto idx : fplus::find_all_instances_of_token(all_tokens[token_idx], input))
+            expected.emplace_back(idx, token_idx);
+    }
+    std::sort(std::begin(expected), std::end(expected));
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(all_tokens, input), expected);
+    const auto as_lists = fplus::transform_convert<std::vector<std::list<char>>>(
+        fplus::convert_container<std::list<char>, std::string>, all_tokens);
+    REQUIRE_EQ(fplus::find_all_instances_of_tokens(as_lists, fplus::convert_container<std::list<char>>(input)), expected);
+}
@@ -90,3 +90,71 @@ TEST_CASE("show_test - show_float")
     std::list<std::string> lt1 = stream(t1);
     REQUIRE_EQ(show_cont(lt1), "[10, Test, 3.14]");
 }
+
+namespace {
+template <typename T>
+std::string show_by_stream(const T& x)
+{
+    std::ostringstream ss;
+    ss << x;
+    return ss.str();
+}
+
+template <typename T>
+void check_show_integral()
+{
+    const T values[] = { std::numeric_limits<T>::min(), std::numeric_limits<T>::max(),
+        T(0), T(1), T(9), T(10), T(99), T(100), static_cast<T>(std::numeric_limits<T>::max() / 3) };
+    for (const T x : values) {
+        REQUIRE_EQ(fplus::show(x), show_by_stream(x));
+    }
+}
+}
+
+TEST_CASE("show_test - show numbers")
+{
+    using namespace fplus;
+    check_show_integral<short>();
+    check_show_integral<unsigned short>();
+    check_show_integral<int>();
+    check_show_integral<unsigned int>();
+    check_show_integral<long>();
+    check_show_integral<unsigned long>();
+    check_show_integral<long long>();
+    check_show_integral<unsigned long long>();
+    REQUIRE_EQ(show(-1), "-1");
+
+    for (const double x : { 0.0, -0.0, 0.1, -42.3, 1.0 / 3.0, 1e-5, 123456.0, 1234567.0, 1e300, 5e-324,
+             std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() }) {
+        REQUIRE_EQ(show(x), show_by_stream(x));
+    }
+    REQUIRE_EQ(show(3.14f), show_by_stream(3.14f));
+    REQUIRE_EQ(show(2.5L), show_by_stream(2.5L));
+
+    REQUIRE_EQ(show('a'), "a");
+    REQUIRE_EQ(show(true), "1");
+}
+
+TEST_CASE("show_test - show_cont_to")
+{
+    using namespace fplus;
+    std::ostringstream ss;
+    show_cont_to(ss, xs);
+    REQUIRE_EQ(ss.str(), xsShown);
+
+    const auto many = numbers(-20000, 20000);
+    std::ostringstream many_ss;
+    show_cont_to(many_ss, many);
+    REQUIRE_EQ(many_ss.str(), show_cont(many));
+    REQUIRE_EQ(show_cont(many).size(), many_ss.str().size());
+
+    std::ostringstream framed_ss;
+    show_cont_with_frame_to(framed_ss, " => ", "{", "}", stringVec);
+    REQUIRE_EQ(framed_ss.str(), "{foo => bar}");
+
+    std::string buffer = "x: ";
+    show_to_buffer(buffer, 42);
+    show_to_buffer(buffer, std::string(", "));
+    show_to_buffer(buffer, xs);
+    REQUIRE_EQ(buffer, "x: 42, " + xsShown);
+}
@@ -32,6 +32,7 @@ TEST_CASE("side_effects_test - execute_parallelly")
     using namespace fplus;
     auto return_one = [&]() { return 1; };
     REQUIRE_EQ(execute_parallelly(replicate(4, return_one))(), std::vector<int>({ 1, 1, 1, 1 }));
+    REQUIRE_EQ(execute_parallelly_placed(compact_thread_placement(2), replicate(4, return_one))(), std::vector<int>({ 1, 1, 1, 1 }));
 }
 
 TEST_CASE("side_effects_test - execute_max_n_times_until_success")
@@ -82,7 +83,7 @@ TEST_CASE("side_effects_test - for_each (serial and parallel")
     using namespace fplus;
     constexpr size_t nb_elems = 100;
 
-    for (auto i : fplus::numbers(0, 3)) {
+    for (auto i : fplus::numbers(0, 4)) {
         std::vector<int> xs(nb_elems, 0);
         auto idxs = fplus::numbers<size_t>(0, nb_elems);
         auto fill_one_cell = [&](size_t idx) { xs[idx] = 1; };
@@ -92,7 +93,133 @@ TEST_CASE("side_effects_test - for_each (serial and parallel")
             fplus::parallel_for_each(fill_one_cell, idxs);
         else if (i == 2)
             fplus::parallel_for_each_n_threads(size_t(4), fill_one_cell, idxs);
+        else if (i == 3)
+            fplus::parallel_for_each_placed(fplus::scatter_thread_placement(4), fill_one_cell, idxs);
         size_t nb_filled = fplus::count_if([](int v) { return v == 1; }, xs);
         REQUIRE_EQ(nb_filled, nb_elems);
     }
 }
+
+TEST_CASE("side_effects_test - read_mapped_file")
+{
+    using namespace fplus;
+    const std::string filename = "side_effects_test_mapped_file.txt";
+    const std::string content = "Hi,\nI am a\r\nmapped\n\nfile.";
+    REQUIRE(write_text_file(filename, content)());
+
+    const auto file = read_mapped_file(file_access_hint::sequential, filename)();
+    REQUIRE_EQ(file.size(), content.size());
+    REQUIRE_EQ(std::string(file.begin(), file.end()), content);
+    REQUIRE_EQ(file[4], 'I');
+    REQUIRE_EQ(count('\n', file), 4);
+    REQUIRE(file.advise(file_access_hint::random));
+#if __cplusplus >= 201703L
+    REQUIRE_EQ(split_lines_view(false, file.str()).size(), 4);
+    REQUIRE_EQ(split_lines_view(false, file.str())[2].data(), file.data() + 12);
+#endif
+
+    const mapped_file copy = file;
+    REQUIRE_EQ(copy.data(), file.data());
+
+    REQUIRE(write_text_file(filename, "")());
+    const auto empty_file = read_mapped_file_maybe(file_access_hint::normal, filename)();
+    REQUIRE(empty_file.is_just());
+    REQUIRE(empty_file.unsafe_get_just().empty());
+
+    std::remove(filename.c_str());
+    REQUIRE(read_mapped_file_maybe(file_access_hint::normal, filename)().is_nothing());
+    REQUIRE(read_mapped_file(file_access_hint::normal, filename)().empty());
+}
+
+TEST_CASE("side_effects_test - read_text_file_lines_lazy")
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    const std::string filename = "side_effects_test_lazy_lines.txt";
+    const Strings contents = { "", "\n", "a", "a\n", "\r\n\r\n", "Hi,\nI am a\r\n***strange***\n\rstring.\r", "ab\r\rcd\n\nef\r\n" };
+    for (const auto& content : contents) {
+        REQUIRE(write_text_file(filename, content)());
+        for (const bool allow_empty : { false, true }) {
+            const auto expected = read_text_file_lines(allow_empty, filename)();
+            for (std::size_t chunk_size = 1; chunk_size < 8; ++chunk_size) {
+                const internal::text_file_line_range lines(filename, allow_empty, chunk_size);
+                REQUIRE_EQ(Strings(lines.begin(), lines.end()), expected);
+            }
+            const auto lines = read_text_file_lines_lazy(allow_empty, filename);
+            REQUIRE_EQ(Strings(lines.begin(), lines.end()), expected);
+            REQUIRE_EQ(Strings(lines.begin(), lines.end()), expected);
+        }
+    }
+
+    REQUIRE(write_text_file_lines(false, filename, { "1", "22", "", "333" })());
+    REQUIRE_EQ(fwd::apply(read_text_file_lines_lazy(false, filename),
+                   fwd::lazy::transform([](const std::string& line) { return line.size(); }),
+                   fwd::lazy::keep_if([](std::size_t n) { return n > 1; }),
+                   fwd::lazy::sum()),
+        5);
+
+    std::atomic<std::size_t> n_chars(0);
+    std::atomic<std::size_t> n_lines(0);
+    REQUIRE(for_each_line_parallelly([&](const std::string& line) { n_chars += line.size(); ++n_lines; }, true, filename));
+    REQUIRE_EQ(n_chars.load(), 6);
+    REQUIRE_EQ(n_lines.load(), 4);
+
+    std::remove(filename.c_str());
+    const auto missing = read_text_file_lines_lazy(false, filename);
+    REQUIRE(missing.begin() == missing.end());
+    REQUIRE_FALSE(for_each_line_parallelly([](const std::string&) {}, true, filename));
+}
+
+TEST_CASE("side_effects_test - file writers")
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    const std::string filename = "side_effects_test_writers.txt";
+    const Strings lines = { "first", "", std::string(100, 'x'), "last" };
+    const std::string expected = join(std::string("\n"), lines) + "\n";
+
+    REQUIRE(write_text_file_lines(true, filename, lines)());
+    REQUIRE_EQ(read_text_file(filename)(), expected);
+    REQUIRE(write_text_file_lines(false, filename, lines)());
+    REQUIRE_EQ(read_text_file(filename)(), join(std::string("\n"), lines));
+    REQUIRE(write_text_file_lines(true, filename, {})());
+    REQUIRE_EQ(read_text_file(filename)(), "\n");
+
+    for (std::size_t buffer_size = 1; buffer_size < 12; buffer_size += 5) {
+        {
+            buffered_file_writer writer(filename, buffer_size);
+            for (const auto& line : lines) {
+                writer.write_line(line);
+            }
+            REQUIRE_EQ(writer.flush(), (ok<std::size_t, std::string>(expected.size())));
+            REQUIRE_EQ(read_text_file(filename)(), expected);
+            writer.write('!');
+            REQUIRE_EQ(writer.close(), (ok<std::size_t, std::string>(expected.size() + 1)));
+            writer.write("too late");
+            REQUIRE(is_error(writer.close()));
+        }
+        REQUIRE_EQ(read_text_file(filename)(), expected + "!");
+        {
+            async_file_writer writer(filename, buffer_size, 2);
+            for (const auto& line : lines) {
+                writer.write_line(line);
+            }
+            REQUIRE_EQ(writer.flush(), (ok<std::size_t, std::string>(expected.size())));
+            REQUIRE_EQ(read_text_file(filename)(), expected);
+            writer.write('!');
+            REQUIRE_EQ(writer.close(), (ok<std::size_t, std::string>(expected.size() + 1)));
+            writer.write("too late");
+            REQUIRE(is_error(writer.close()));
+        }
+        REQUIRE_EQ(read_text_file(filename)(), expected + "!");
+    }
+    std::remove(filename.c_str());
+
+    const std::string bad_filename = "side_effects_test_missing_dir/file.txt";
+    buffered_file_writer bad_writer(bad_filename);
+    bad_writer.write_line("foo");
+    REQUIRE(is_error(bad_writer.close()));
+    async_file_writer bad_async_writer(bad_filename);
+    bad_async_writer.write_line("foo");
+    REQUIRE(is_error(bad_async_writer.close()));
+}
@@ -65,6 +65,44 @@ TEST_CASE("stringtools_test -  split")
     REQUIRE_EQ(split_one_of(std::string { " ,\r\n" }, false, text), textSplitBySpaceAndCommaAndLine);
 }
 
+#if __cplusplus >= 201703L
+TEST_CASE("stringtools_test -  split_view")
+{
+    using namespace fplus;
+    typedef std::vector<std::string> Strings;
+    const auto to_strings = [](const std::vector<std::string_view>& views) {
+        return transform([](std::string_view v) { return std::string(v); }, views);
+    };
+    const std::string text = "Hi,\nI am a\r\n***strange***\n\rstring.";
+    const std::string_view text_view = text;
+    const auto lines = split_lines_view(true, text);
+    REQUIRE_EQ(to_strings(lines), split_lines(true, text));
+    REQUIRE_EQ(lines[1].data(), text.data() + 4);
+    REQUIRE_EQ(to_strings(split_lines_view(false, text)), split_lines(false, text));
+    REQUIRE_EQ(to_strings(split_lines_view(true, text_view)), split_lines(true, text));
+    REQUIRE_EQ(split_lines_view(false, std::string_view("")).size(), 0);
+    REQUIRE_EQ(split_lines_view(true, std::string_view("")).size(), 1);
+    REQUIRE_EQ(to_strings(split_lines_view(true, std::string_view("a\r\r\nb\r"))), Strings({ "a", "", "b", "" }));
+    REQUIRE_EQ(to_strings(split_words_view(false, text)), split_words(false, text));
+    REQUIRE_EQ(to_strings(split_words_view(true, text)), split_words(true, text));
+
+    for (const bool allow_empty : { false, true }) {
+        for (const std::string s : { "", ",", "a", ",a,,b,", "a,b" }) {
+            REQUIRE_EQ(to_strings(split_view(',', allow_empty, s)), split(',', allow_empty, s));
+            REQUIRE_EQ(to_strings(split_by_view(is_equal_to(','), allow_empty, s)), split(',', allow_empty, s));
+            REQUIRE_EQ(to_strings(split_one_of_view(std::string(",b"), allow_empty, s)),
+                split_one_of(std::string(",b"), allow_empty, s));
+        }
+        for (const std::string s : { "", ", ", "foo, bar, baz", ", ,  , ", "aaa" }) {
+            REQUIRE_EQ(to_strings(split_by_token_view(std::string(", "), allow_empty, s)),
+                split_by_token(std::string(", "), allow_empty, s));
+        }
+    }
+    REQUIRE_EQ(to_strings(split_by_token_view(std::string("aa"), true, std::string_view("aaa"))), Strings({ "", "a" }));
+    REQUIRE_EQ(to_strings(split_by_token_view(std::string(), true, text_view)), Strings({ text }));
+}
+#endif
+
 TEST_CASE("stringtools_test -  to_string_filled")
 {
     using namespace fplus;
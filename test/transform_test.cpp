@@ -153,11 +153,230 @@ TEST_CASE("transform_test - transform")
     REQUIRE_EQ(transform(squareLambda, xs_array), IntArray5({ { 1, 4, 4, 9, 4 } }));
 }
 
+TEST_CASE("transform_test - transform_parallelly")
+{
+    using namespace fplus;
+    const auto ints = numbers(0, 10000);
+    REQUIRE_EQ(transform_parallelly(squareLambda, ints), transform(squareLambda, ints));
+    REQUIRE_EQ(transform_parallelly(squareLambda, IntVector()), IntVector());
+    REQUIRE_EQ(transform_parallelly([](int x) { return x % 2 == 0; }, IntVector({ 1, 2, 4 })), std::vector<bool>({ false, true, true }));
+
+    const auto nested = transform_parallelly([&](int x) {
+        return sum(transform_parallelly(squareLambda, numbers(0, x)));
+    },
+        numbers(0, 100));
+    REQUIRE_EQ(nested, transform([](int x) { return sum(transform(squareLambda, numbers(0, x))); }, numbers(0, 100)));
+
+    const auto throw_on_42 = [](int x) -> int {
+        if (x == 42) {
+            throw std::runtime_error("42");
+        }
+        return x;
+    };
+    REQUIRE_THROWS(transform_parallelly(throw_on_42, ints));
+}
+
+TEST_CASE("transform_test - parallel_schedule")
+{
+    using namespace fplus;
+    std::vector<parallel_schedule> schedules;
+    const auto previous = set_parallel_schedule_observer(
+        [&schedules](const parallel_schedule& schedule) {
+            schedules.push_back(schedule);
+        });
+    REQUIRE_FALSE(previous);
+
+    const std::size_t max_threads = internal::default_thread_pool().size() + 1;
+    const auto ints = numbers(0, 1000);
+    REQUIRE_EQ(transform_parallelly(squareLambda, ints), transform(squareLambda, ints));
+    REQUIRE_EQ(schedules.size(), 1);
+    const auto& schedule = schedules.back();
+    REQUIRE_GE(schedule.n_sampled_chunks, 1);
+    REQUIRE_LE(schedule.n_sampled_chunks, schedule.n_chunks);
+    REQUIRE_GE(schedule.n_threads, 1);
+    REQUIRE_LE(schedule.n_threads, max_threads);
+    REQUIRE_GE(schedule.chunks_per_task, 1);
+
+    // Jobs with no more elements than threads are not sampled.
+    const auto two_ints = numbers(0, 2);
+    REQUIRE_EQ(transform_parallelly(squareLambda, two_ints), transform(squareLambda, two_ints));
+    REQUIRE_EQ(schedules.size(), 2);
+    if (max_threads >= 2) {
+        REQUIRE_EQ(schedules.back().n_sampled_chunks, 0);
+        REQUIRE_EQ(schedules.back().n_threads, 2);
+    }
+    REQUIRE_EQ(transform_parallelly(squareLambda, IntVector()), IntVector());
+    REQUIRE_EQ(schedules.size(), 2);
+
+    set_parallel_schedule_observer(previous);
+    REQUIRE_EQ(transform_parallelly(squareLambda, ints), transform(squareLambda, ints));
+    REQUIRE_EQ(schedules.size(), 2);
+}
+
+TEST_CASE("transform_test - adaptive_schedule")
+{
+    using fplus::internal::adaptive_schedule;
+    // 125 cheap chunks sampled in 1 microsecond: not worth a second thread.
+    const auto cheap = adaptive_schedule(1000, 125, 1e-6, 875, 7);
+    REQUIRE_EQ(cheap.n_threads, 1);
+    REQUIRE_EQ(cheap.chunks_per_task, 875);
+
+    // 200 microseconds per chunk: all threads, one chunk per task.
+    const auto slow = adaptive_schedule(100, 12, 12 * 200e-6, 80, 7);
+    REQUIRE_EQ(slow.n_threads, 8);
+    REQUIRE_EQ(slow.chunks_per_task, 1);
+    REQUIRE_GT(slow.estimated_remaining_seconds, 0);
+
+    // 5 microseconds per chunk: the work justifies 4 threads.
+    // 10 chunks would reach 50 microseconds per task,
+    // but tasks are kept small enough to leave 4 per thread.
+    const auto medium = adaptive_schedule(1000, 10, 50e-6, 90, 7);
+    REQUIRE_EQ(medium.n_threads, 4);
+    REQUIRE_EQ(medium.chunks_per_task, 5);
+
+    // Nothing left after sampling.
+    const auto done = adaptive_schedule(10, 3, 1.0, 0, 7);
+    REQUIRE_EQ(done.n_threads, 1);
+    REQUIRE_EQ(done.chunks_per_task, 1);
+}
+
+TEST_CASE("transform_test - transform_parallelly_n_threads")
+{
+    using namespace fplus;
+    const auto ints = numbers(0, 10000);
+    REQUIRE_EQ(transform_parallelly_n_threads(4, squareLambda, ints), transform(squareLambda, ints));
+    REQUIRE_EQ(transform_parallelly_n_threads(4, squareLambda, IntVector()), IntVector());
+    REQUIRE_EQ(transform_parallelly_n_threads(0, squareLambda, xs), IntVector({ 1, 4, 4, 9, 4 }));
+    REQUIRE_EQ(transform_parallelly_n_threads(16, squareLambda, xs), IntVector({ 1, 4, 4, 9, 4 }));
+    REQUIRE_EQ(transform_parallelly_n_threads(3, [](int x) { return x % 2 == 0; }, IntVector({ 1, 2, 4 })), std::vector<bool>({ false, true, true }));
+
+    struct no_default_ctor {
+        explicit no_default_ctor(int v)
+            : value(v)
+        {
+        }
+        int value;
+    };
+    const auto wrapped = transform_parallelly_n_threads(3, [](int x) { return no_default_ctor(x); }, ints);
+    REQUIRE_EQ(transform([](const no_default_ctor& x) { return x.value; }, wrapped), ints);
+
+    const auto throw_on_42 = [](int x) -> int {
+        if (x == 42) {
+            throw std::runtime_error("42");
+        }
+        return x;
+    };
+    REQUIRE_THROWS(transform_parallelly_n_threads(4, throw_on_42, ints));
+}
+
+TEST_CASE("transform_test - transform_parallelly_placed")
+{
+    using namespace fplus;
+    REQUIRE_EQ(compact_thread_placement(3).cpus.size(), 3);
+    REQUIRE_EQ(scatter_thread_placement(5).cpus.size(), 5);
+    REQUIRE_EQ(thread_placement_on_cpus({ 0, 0 }).cpus, std::vector<std::size_t>({ 0, 0 }));
+
+    const auto ints = numbers(0, 1000);
+    const auto squares = transform(squareLambda, ints);
+    REQUIRE_EQ(transform_parallelly_placed(compact_thread_placement(4), squareLambda, ints), squares);
+    REQUIRE_EQ(transform_parallelly_placed(scatter_thread_placement(3), squareLambda, ints), squares);
+    REQUIRE_EQ(transform_parallelly_placed(thread_placement_on_cpus({ 0, 0, 0 }), squareLambda, IntList({ 1, 2 })), IntList({ 1, 4 }));
+    REQUIRE_EQ(transform_parallelly_placed(compact_thread_placement(2), squareLambda, IntVector()), IntVector());
+
+    std::mutex mutex;
+    std::vector<std::thread::id> thread_ids;
+    transform_parallelly_placed(scatter_thread_placement(4), [&](int x) {
+        std::lock_guard<std::mutex> lock(mutex);
+        thread_ids.push_back(std::this_thread::get_id());
+        return x;
+    },
+        ints);
+    REQUIRE_EQ(nub(thread_ids).size(), 4);
+}
+
 TEST_CASE("transform_test - reduce")
 {
     using namespace fplus;
     REQUIRE_EQ(reduce_parallelly(std::plus<int>(), 100, xs), 110);
     REQUIRE_EQ(reduce_1_parallelly(std::plus<int>(), xs), 10);
+    REQUIRE_EQ(reduce_parallelly(std::plus<int>(), 100, IntVector()), 100);
+    REQUIRE_EQ(reduce_parallelly_n_threads(3, std::plus<int>(), 100, xs), 110);
+    REQUIRE_EQ(reduce_1_parallelly_n_threads(3, std::plus<int>(), intList), 10);
+    REQUIRE_EQ(reduce_1_parallelly(std::plus<int>(), IntVector({ 7 })), 7);
+
+    const auto ints = numbers(0, 10000);
+    REQUIRE_EQ(reduce_parallelly(std::plus<int>(), 1, ints), reduce(std::plus<int>(), 1, ints));
+    REQUIRE_EQ(reduce_1_parallelly_n_threads(4, std::plus<int>(), ints), reduce_1(std::plus<int>(), ints));
+
+    // Associative but not commutative.
+    const auto strs = transform(show<int>, ints);
+    REQUIRE_EQ(reduce_parallelly(std::plus<std::string>(), std::string("x"), strs), reduce(std::plus<std::string>(), std::string("x"), strs));
+    REQUIRE_EQ(reduce_1_parallelly_n_threads(5, std::plus<std::string>(), strs), concat(strs));
+    REQUIRE_EQ(transform_reduce_1_parallelly(show<int>, std::plus<std::string>(), ints), concat(strs));
+    REQUIRE_EQ(transform_reduce_parallelly_n_threads(3, show<int>, std::plus<std::string>(), std::string("x"), ints), "x" + concat(strs));
+}
+
+TEST_CASE("transform_test - scan_left_parallelly")
+{
+    using namespace fplus;
+    REQUIRE_EQ(scan_left_parallelly(std::plus<int>(), 20, xs), scan_left(std::plus<int>(), 20, xs));
+    REQUIRE_EQ(scan_left_parallelly_n_threads(3, std::plus<int>(), 20, intList), scan_left(std::plus<int>(), 20, intList));
+    REQUIRE_EQ(scan_left_parallelly_n_threads(3, std::plus<int>(), 20, IntVector()), IntVector({ 20 }));
+    REQUIRE_EQ(scan_left_1_parallelly(std::plus<int>(), xs), scan_left_1(std::plus<int>(), xs));
+    REQUIRE_EQ(scan_left_1_parallelly_n_threads(16, std::plus<int>(), IntVector({ 4 })), IntVector({ 4 }));
+
+    const auto ints = numbers<std::int64_t>(-5000, 10000);
+    REQUIRE_EQ(scan_left_parallelly_n_threads(4, std::plus<std::int64_t>(), std::int64_t(7), ints), scan_left(std::plus<std::int64_t>(), std::int64_t(7), ints));
+    REQUIRE_EQ(scan_left_1_parallelly_n_threads(5, std::plus<std::int64_t>(), ints), scan_left_1(std::plus<std::int64_t>(), ints));
+
+    // Associative but not commutative.
+    const auto strs = transform(show<int>, numbers(0, 1000));
+    REQUIRE_EQ(scan_left_1_parallelly_n_threads(4, std::plus<std::string>(), strs), scan_left_1(std::plus<std::string>(), strs));
+}
+
+TEST_CASE("transform_test - find_first_by_parallelly")
+{
+    using namespace fplus;
+    const auto is_even_int = [](int x) { return x % 2 == 0; };
+    REQUIRE_EQ(find_first_idx_by_parallelly(is_even_int, IntVector({ 1, 3, 4, 6, 9 })), just<std::size_t>(2));
+    REQUIRE_EQ(find_first_idx_by_parallelly_n_threads(4, is_even_int, IntVector({ 1, 3, 5, 7, 9 })), nothing<std::size_t>());
+    REQUIRE_EQ(find_first_idx_by_parallelly_n_threads(4, is_even_int, IntVector()), nothing<std::size_t>());
+    REQUIRE_EQ(find_first_by_parallelly(is_even_int, IntList({ 1, 3, 4, 6, 9 })), just(4));
+    REQUIRE_EQ(find_first_by_parallelly_n_threads(3, is_even_int, IntVector({ 1, 3, 5, 7, 9 })), nothing<int>());
+
+    const auto ints = numbers(0, 10000);
+    for (const int first_hit : { 0, 1, 2499, 2500, 5003, 9999 }) {
+        const auto is_hit = [first_hit](int x) { return x >= first_hit && x % 7 == first_hit % 7; };
+        REQUIRE_EQ(find_first_idx_by_parallelly(is_hit, ints), find_first_idx_by(is_hit, ints));
+        REQUIRE_EQ(find_first_idx_by_parallelly_n_threads(4, is_hit, ints), just(static_cast<std::size_t>(first_hit)));
+        REQUIRE_EQ(find_first_by_parallelly_n_threads(5, is_hit, ints), just(first_hit));
+    }
+}
+
+TEST_CASE("transform_test - any_by_parallelly")
+{
+    using namespace fplus;
+    const auto is_even_int = [](int x) { return x % 2 == 0; };
+    REQUIRE_FALSE(any_by_parallelly(is_odd<int>, IntVector({ 2, 4, 6 })));
+    REQUIRE(any_by_parallelly_n_threads(3, is_odd<int>, IntVector({ 2, 4, 5 })));
+    REQUIRE_FALSE(any_by_parallelly_n_threads(3, is_odd<int>, IntVector()));
+    REQUIRE_FALSE(none_by_parallelly(is_even_int, IntVector({ 3, 4, 5 })));
+    REQUIRE(none_by_parallelly_n_threads(2, is_even_int, IntVector({ 3, 5 })));
+    REQUIRE(all_by_parallelly(is_even_int, IntVector({ 2, 4, 6 })));
+    REQUIRE_FALSE(all_by_parallelly_n_threads(4, is_even_int, IntVector({ 2, 4, 7 })));
+    REQUIRE(all_by_parallelly_n_threads(4, is_even_int, IntVector()));
+
+    const auto ints = numbers(0, 10000);
+    REQUIRE(any_by_parallelly_n_threads(4, is_equal_to(7777), ints));
+    REQUIRE_FALSE(any_by_parallelly_n_threads(4, is_equal_to(-1), ints));
+
+    std::atomic<std::size_t> evaluations(0);
+    const auto counting_is_zero = [&evaluations](int x) {
+        ++evaluations;
+        return x == 0;
+    };
+    REQUIRE(any_by_parallelly_n_threads(4, counting_is_zero, numbers(0, 100000)));
+    REQUIRE_LT(evaluations.load(), 100000);
 }
 
 TEST_CASE("transform_test - keep_if_parallelly")
@@ -165,6 +384,71 @@ TEST_CASE("transform_test - keep_if_parallelly")
     const std::vector<int> v = { 1, 2, 3, 2, 4, 5 };
     auto result = fplus::keep_if_parallelly(is_even, v);
     REQUIRE_EQ(result, std::vector<int>({ 2, 2, 4 }));
+    REQUIRE_EQ(fplus::keep_if_parallelly_n_threads(3, is_even, v), std::vector<int>({ 2, 2, 4 }));
+    REQUIRE_EQ(fplus::keep_if_parallelly(is_even, IntList({ 1, 2, 3, 2, 4, 5 })), IntList({ 2, 2, 4 }));
+    REQUIRE_EQ(fplus::keep_if_parallelly(is_even, IntVector()), IntVector());
+
+    const auto ints = fplus::numbers(0, 10000);
+    const auto is_multiple_of_7 = [](int x) { return x % 7 == 0; };
+    REQUIRE_EQ(fplus::keep_if_parallelly(is_multiple_of_7, ints), fplus::keep_if(is_multiple_of_7, ints));
+    REQUIRE_EQ(fplus::keep_if_parallelly_n_threads(4, is_multiple_of_7, ints), fplus::keep_if(is_multiple_of_7, ints));
+    const auto bools = fplus::transform(is_multiple_of_7, ints);
+    REQUIRE_EQ(fplus::keep_if_parallelly(fplus::identity<bool>, bools), fplus::keep_if(fplus::identity<bool>, bools));
+}
+
+TEST_CASE("transform_test - drop_if_parallelly")
+{
+    const std::vector<int> v = { 1, 2, 3, 2, 4, 5 };
+    REQUIRE_EQ(fplus::drop_if_parallelly(is_even, v), std::vector<int>({ 1, 3, 5 }));
+    REQUIRE_EQ(fplus::drop_if_parallelly_n_threads(3, is_even, v), std::vector<int>({ 1, 3, 5 }));
+
+    const auto strs = fplus::transform(fplus::show<int>, fplus::numbers(0, 10000));
+    const auto has_7 = [](const std::string& str) { return fplus::is_elem_of('7', str); };
+    REQUIRE_EQ(fplus::drop_if_parallelly(has_7, strs), fplus::drop_if(has_7, strs));
+}
+
+TEST_CASE("transform_test - partition_parallelly")
+{
+    typedef std::pair<IntVector, IntVector> IntVectorPair;
+    const IntVector v = { 0, 1, 1, 3, 7, 2, 3, 4 };
+    REQUIRE_EQ(fplus::partition_parallelly(is_even, v), IntVectorPair({ 0, 2, 4 }, { 1, 1, 3, 7, 3 }));
+    REQUIRE_EQ(fplus::partition_parallelly_n_threads(3, is_even, v), IntVectorPair({ 0, 2, 4 }, { 1, 1, 3, 7, 3 }));
+    REQUIRE_EQ(fplus::partition_parallelly(is_even, IntVector()), IntVectorPair());
+
+    const auto ints = fplus::numbers(0, 10000);
+    const auto is_multiple_of_3 = [](int x) { return x % 3 == 0; };
+    REQUIRE_EQ(fplus::partition_parallelly(is_multiple_of_3, ints), fplus::partition(is_multiple_of_3, ints));
+}
+
+TEST_CASE("transform_test - sort_parallelly")
+{
+    using namespace fplus;
+    const auto ints = shuffle(std::mt19937::default_seed, numbers(0, 10000));
+    REQUIRE_EQ(sort_parallelly(ints), sort(ints));
+    REQUIRE_EQ(sort_parallelly_n_threads(4, ints), sort(ints));
+    REQUIRE_EQ(sort_parallelly_n_threads(3, IntVector(ints)), sort(ints));
+    REQUIRE_EQ(sort_parallelly_n_threads(4, IntVector()), IntVector());
+    REQUIRE_EQ(sort_parallelly_n_threads(4, IntVector({ 2 })), IntVector({ 2 }));
+    REQUIRE_EQ(sort_parallelly_n_threads(4, IntList({ 3, 1, 2 })), IntList({ 1, 2, 3 }));
+    REQUIRE_EQ(sort_by_parallelly_n_threads(5, std::greater<int>(), ints), reverse(sort(ints)));
+    REQUIRE_EQ(sort_on_parallelly_n_threads(7, std::negate<int>(), ints), reverse(sort(ints)));
+    REQUIRE_EQ(sort_on_parallelly(std::negate<int>(), xs), IntVector({ 3, 2, 2, 2, 1 }));
+}
+
+TEST_CASE("transform_test - stable_sort_parallelly")
+{
+    using namespace fplus;
+    typedef std::pair<int, int> IntPair;
+    const auto pairs = transform([](int x) { return IntPair(x % 100, x); },
+        shuffle(std::mt19937::default_seed, numbers(0, 10000)));
+    const auto first_less = [](const IntPair& a, const IntPair& b) { return a.first < b.first; };
+    auto expected = pairs;
+    std::stable_sort(std::begin(expected), std::end(expected), first_less);
+    REQUIRE_EQ(stable_sort_by_parallelly(first_less, pairs), expected);
+    REQUIRE_EQ(stable_sort_by_parallelly_n_threads(4, first_less, pairs), expected);
+    REQUIRE_EQ(stable_sort_on_parallelly_n_threads(3, fst<int, int>, std::vector<IntPair>(pairs)), expected);
+    REQUIRE_EQ(stable_sort_parallelly_n_threads(4, pairs), sort(pairs));
+    REQUIRE_EQ(stable_sort_parallelly(xs), IntVector({ 1, 2, 2, 2, 3 }));
 }
 
 TEST_CASE("transform_test - transform_reduce")
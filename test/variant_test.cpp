@@ -6,6 +6,7 @@
 
 #include <doctest/doctest.h>
 #include <fplus/fplus.hpp>
+#include <stdexcept>
 
 namespace {
 std::string print_output;
@@ -47,6 +48,27 @@ std::string show_string(const std::string& str)
 {
     return fplus::show(str);
 }
+
+// Copying throws while throw_on_copy is set.
+struct throwing_copy {
+    explicit throwing_copy(int x)
+        : x_(x)
+    {
+    }
+    throwing_copy(const throwing_copy& other)
+        : x_(other.x_)
+    {
+        if (throw_on_copy)
+            throw std::runtime_error("copy failed");
+    }
+    throwing_copy(throwing_copy&&) noexcept = default;
+    throwing_copy& operator=(const throwing_copy&) = default;
+    throwing_copy& operator=(throwing_copy&&) noexcept = default;
+    bool operator==(const throwing_copy& other) const { return x_ == other.x_; }
+    static bool throw_on_copy;
+    int x_;
+};
+bool throwing_copy::throw_on_copy = false;
 }
 
 TEST_CASE("variant_test - visit_one")
@@ -94,6 +116,8 @@ TEST_CASE("variant_test - equality_test")
     fplus::variant<int, std::string> int_or_string_s(std::string("hi"));
     REQUIRE(int_or_string_i == int_or_string_i);
     REQUIRE_FALSE(int_or_string_i == int_or_string_s);
+    REQUIRE(int_or_string_s == fplus::variant<int, std::string>(std::string("hi")));
+    REQUIRE_FALSE(int_or_string_s == fplus::variant<int, std::string>(std::string("ho")));
 }
 
 TEST_CASE("variant_test - inequality_test")
@@ -180,4 +204,58 @@ TEST_CASE("variant_test - get")
     // should not compile (type not in variant)
     // REQUIRE_EQ(int_or_string_i.get<char>(), nothing<char>());
     // REQUIRE_EQ(int_or_string_s.get<char>(), nothing<char>());
-}
\ No newline at end of file
+}
+
+TEST_CASE("variant_test - copy_and_move")
+{
+    using namespace fplus;
+    using int_or_string = fplus::variant<int, std::string>;
+    const std::string long_str(100, 'x');
+    int_or_string a(long_str);
+    int_or_string b(a);
+    REQUIRE_EQ(b.get<std::string>(), just(long_str));
+    int_or_string c(std::move(b));
+    REQUIRE_EQ(c.get<std::string>(), just(long_str));
+    c = int_or_string(42);
+    REQUIRE_EQ(c.get<int>(), just(42));
+    c = a;
+    REQUIRE_EQ(c, a);
+    c = c;
+    REQUIRE_EQ(c.get<std::string>(), just(long_str));
+
+    std::vector<int_or_string> xs;
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2 == 0)
+            xs.push_back(int_or_string(i));
+        else
+            xs.push_back(int_or_string(std::to_string(i)));
+    }
+    const auto shown = fplus::transform([](const int_or_string& x) {
+        return x.visit(show_int, show_string);
+    },
+        xs);
+    REQUIRE_EQ(shown[98], "98");
+    REQUIRE_EQ(shown[99], "99");
+    REQUIRE_EQ(fplus::count_if([](const int_or_string& x) { return x.is<int>(); }, xs), 50);
+}
+
+TEST_CASE("variant_test - throwing_copy")
+{
+    using namespace fplus;
+    using var = fplus::variant<throwing_copy, std::string>;
+    const var source(throwing_copy(1));
+    var v(std::string("string"));
+    throwing_copy::throw_on_copy = true;
+    REQUIRE_THROWS(v = source);
+    throwing_copy::throw_on_copy = false;
+    REQUIRE_EQ(v.get<std::string>(), just(std::string("string")));
+
+    v = var(throwing_copy(2));
+    throwing_copy::throw_on_copy = true;
+    REQUIRE_THROWS(v = source);
+    throwing_copy::throw_on_copy = false;
+    REQUIRE_EQ(v.get<throwing_copy>(), just(throwing_copy(2)));
+
+    v = source;
+    REQUIRE_EQ(v, source);
+}